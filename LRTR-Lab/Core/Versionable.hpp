@@ -0,0 +1,24 @@
+#pragma once
+
+#include <atomic>
+
+namespace LRTR {
+
+	//the version of object is unique in all objects and changed when the object is changed
+	//so we can find the object is changed or replaced by comparing the version
+	class Versionable {
+	public:
+		Versionable() : mVersion(++mGlobalVersion) {}
+
+		virtual ~Versionable() = default;
+
+		auto version() const noexcept -> size_t { return mVersion; }
+	protected:
+		void updateVersion() noexcept { mVersion = ++mGlobalVersion; }
+	private:
+		static inline std::atomic<size_t> mGlobalVersion = 0;
+
+		size_t mVersion = 0;
+	};
+	
+}
\ No newline at end of file
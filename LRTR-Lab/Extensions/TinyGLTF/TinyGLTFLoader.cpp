@@ -5,12 +5,18 @@
 #include "../../Scenes/Components/Materials/WireframeMaterial.hpp"
 #include "../../Scenes/Components/LinesMesh/CoordinateSystem.hpp"
 #include "../../Scenes/Components/MeshData/TrianglesMesh.hpp"
+#include "../../Scenes/Components/TransformHierarchy.hpp"
 #include "../../Scenes/Components/CollectionLabel.hpp"
 #include "../../Scenes/Cameras/Camera.hpp"
 
 #include "../../Shared/Graphics/ResourceHelper.hpp"
 #include "../../Shared/Textures/ConstantTexture.hpp"
 #include "../../Shared/Textures/ImageTexture.hpp"
+#include "../../Shared/Meshes/MeshletBuilder.hpp"
+#include "../../Shared/Meshes/MeshOptimizer.hpp"
+
+#include "../../Workflow/Meshes/MeshLevelOfDetailWorkflow.hpp"
+#include "../../Workflow/Meshes/MeshTangentWorkflow.hpp"
 
 #define TINY_GLTF_HAS_VALUE(value) (value >= 0)
 #define TINY_GLTF_TRY_READ_MATERIAL_VALUE(texture, value) \
@@ -91,6 +97,63 @@ namespace LRTR {
 		}
 	}
 
+	//the w of tangent in glTF is the handedness, it is 1 if the accessor does not have w
+	void readTangentSignAccessor(std::vector<float>& data, const tinygltf::Accessor* accessor, const tinygltf::Model* scene) {
+		data = std::vector<float>(accessor->count, 1.0f);
+
+		if (accessor->type != 4) return;
+
+		std::vector<Vector4f> tempData;
+
+		readAccessor(tempData, accessor, scene);
+
+		for (size_t index = 0; index < tempData.size(); index++)
+			data[index] = tempData[index].w < 0 ? -1.0f : 1.0f;
+	}
+
+	//reorder the triangles for vertex cache, overdraw and meshlets, then reorder the vertices in the order they are used
+	void optimizeMesh(
+		const std::string& name,
+		std::vector<Vector3f>& positions,
+		std::vector<Vector3f>& texCoords,
+		std::vector<Vector3f>& tangents,
+		std::vector<Vector3f>& normals,
+		std::vector<float>& signs,
+		std::vector<unsigned>& indices,
+		std::vector<Meshlet>& meshlets) {
+		std::vector<unsigned> clusters;
+
+		const auto original = MeshOptimizer::analyzeVertexCache(indices, positions.size());
+
+		indices = MeshOptimizer::optimizeVertexCache(indices, positions.size(), &clusters);
+
+		const auto vertexCache = MeshOptimizer::analyzeVertexCache(indices, positions.size());
+
+		indices = MeshOptimizer::optimizeOverdraw(indices, positions, clusters);
+
+		const auto overdraw = MeshOptimizer::analyzeVertexCache(indices, positions.size());
+
+		//the meshlets reorder the triangles again, but they keep the triangles near in cache order together
+		//we build them before the vertex fetch, so the vertices are in the order the final indices use them
+		meshlets = MeshletBuilder::build(positions, indices);
+
+		const auto remap = MeshOptimizer::optimizeVertexFetch(indices, positions.size());
+
+		MeshOptimizer::remapVertices(texCoords, remap);
+		MeshOptimizer::remapVertices(tangents, remap);
+		MeshOptimizer::remapVertices(normals, remap);
+		MeshOptimizer::remapVertices(signs, remap);
+		MeshOptimizer::remapVertices(positions, remap);
+		MeshOptimizer::remapIndices(indices, remap);
+
+		//the final result is measured with the indices we upload, after the meshlets and vertex fetch
+		const auto optimized = MeshOptimizer::analyzeVertexCache(indices, positions.size());
+		
+		LRTR_INFO("Optimize mesh {0}, ACMR {1:.3f} -> {2:.3f} -> {3:.3f} -> {4:.3f}, ATVR {5:.3f} -> {6:.3f} -> {7:.3f} -> {8:.3f}.", name,
+			original.ACMR, vertexCache.ACMR, overdraw.ACMR, optimized.ACMR,
+			original.ATVR, vertexCache.ATVR, overdraw.ATVR, optimized.ATVR);
+	}
+	
 	auto readMaterialValue(
 		const std::shared_ptr<RuntimeSharing>& sharing,
 		const tinygltf::Parameter& parameter,
@@ -171,7 +234,7 @@ namespace LRTR {
 		auto normalMapTexture = readMaterialTextureValue(sharing, material->additionalValues, scene, "normalTexture");
 		auto emissiveTexture = readMaterialTextureValue(sharing, material->additionalValues, scene, "emissiveTexture");
 
-		return std::make_shared<PhysicalBasedMaterial>(
+		return makeComponent<PhysicalBasedMaterial>(
 			metallicFactor, baseColorFactor, roughnessFactor, emissiveFactor,
 			metallicRoughnessTexture, baseColorTexture, metallicRoughnessTexture,
 			occlusionTexture, normalMapTexture, emissiveTexture);
@@ -180,9 +243,10 @@ namespace LRTR {
 	void TinyGLTFBuildScene(
 		const std::shared_ptr<RuntimeSharing>& sharing,
 		const std::shared_ptr<TinyGLTFScene>& tinyGLTFScene,
-		const Matrix4x4f& transform,
+		const ShapeHandle& parent,
 		const tinygltf::Model* scene,
-		const tinygltf::Node* node)
+		const tinygltf::Node* node,
+		ThreadPool& threadPool)
 	{
 		auto translation = node->translation.empty() ? Vector3f() :
 			Vector3f(
@@ -206,22 +270,33 @@ namespace LRTR {
 		const auto angle = glm::angle(rotation);
 		const auto axis = glm::axis(rotation);
 		
-		const auto currentTransform = transform * Transform(translation, glm::angleAxis(angle,
-			Vector3f(axis.z, axis.x, axis.y)), scale).matrix();
+		//the node keeps its local transform, the world matrix is computed by transform graph of scene
+		const auto nodeShape = std::make_shared<Shape>();
+
+		nodeShape->component<CollectionLabel>()->set(node->name, "Node");
 		
-		MathUtility::decompose(currentTransform, translation, rotation, scale);
+		nodeShape->addComponent(makeComponent<TransformWrap>(
+			translation, glm::angleAxis(angle, Vector3f(axis.z, axis.x, axis.y)), scale));
+		nodeShape->addComponent(makeComponent<TransformHierarchy>(parent));
 
+		//we add the node first, so the primitives can use the handle of it
+		const auto nodeHandle = tinyGLTFScene->add(nodeShape);
+		
 		if (TINY_GLTF_HAS_VALUE(node->mesh)) {
 			const auto& mesh = scene->meshes[node->mesh];
 			
 			for (size_t index = 0; index < mesh.primitives.size(); index++) {
 				const auto& primitives = mesh.primitives[index];
-				const auto meshShape = std::make_shared<Shape>();
+
+				//if the mesh has only one primitive, we add it to node directly
+				//otherwise, each primitive is a child of node with identity transform
+				const auto meshShape = mesh.primitives.size() == 1 ? nodeShape : std::make_shared<Shape>();
 
 				std::vector<Vector3f> positions;
 				std::vector<Vector3f> texCoords;
 				std::vector<Vector3f> tangents;
 				std::vector<Vector3f> normals;
+				std::vector<float> signs;
 
 				std::vector<unsigned> indices;
 
@@ -235,6 +310,11 @@ namespace LRTR {
 					readVector3fAccessor(tangents, &scene->accessors[primitives.attributes.at("TANGENT")], scene)
 				);
 
+				LRTR_TRY_EXECUTE(
+					primitives.attributes.find("TANGENT") != primitives.attributes.end(),
+					readTangentSignAccessor(signs, &scene->accessors[primitives.attributes.at("TANGENT")], scene)
+				);
+
 				LRTR_TRY_EXECUTE(
 					primitives.attributes.find("NORMAL") != primitives.attributes.end(),
 					readVector3fAccessor(normals, &scene->accessors[primitives.attributes.at("NORMAL")], scene)
@@ -249,21 +329,76 @@ namespace LRTR {
 
 				meshShape->component<CollectionLabel>()->set(node->name, mesh.name + std::to_string(index));
 
-				meshShape->addComponent(std::make_shared<TransformWrap>(
-					translation, rotation, scale));
-				meshShape->addComponent(std::make_shared<TrianglesMesh>(
-					positions, texCoords, tangents, normals, indices));
+				if (meshShape != nodeShape) {
+					meshShape->addComponent(makeComponent<TransformWrap>());
+					meshShape->addComponent(makeComponent<TransformHierarchy>(nodeHandle));
+				}
+				
+				//the normals and tangents are generated if the file does not have them, they are read from cache
+				//if we generated them for the same mesh before
+				if (normals.size() < positions.size() || (tangents.size() < positions.size() && texCoords.size() >= positions.size())) {
+					WorkflowStartup<MeshTangentInput> startup;
+					MeshTangentWorkflow workflow;
+
+					startup.InputData = MeshTangentInput(positions, texCoords, normals, indices, &threadPool);
+
+					auto frames = workflow.start(startup);
+
+					if (tangents.size() < positions.size()) {
+						//the vertices on mirrored seams are split, the new vertices copy the input vertices
+						for (const auto& split : frames.Splits) {
+							const auto position = positions[split];
+							const auto texCoord = texCoords[split];
+
+							positions.push_back(position);
+							texCoords.push_back(texCoord);
+						}
+
+						tangents = std::move(frames.Tangents);
+						signs = std::move(frames.Signs);
+						indices = std::move(frames.Indices);
+					}
+
+					//the split vertices are after the input vertices, so the tangents from file use the first normals
+					frames.Normals.resize(positions.size());
+
+					normals = std::move(frames.Normals);
+
+					LRTR_INFO("Generate tangent frames of mesh {0}.", mesh.name + std::to_string(index));
+				}
+				
+				std::vector<Meshlet> meshlets;
+
+				optimizeMesh(mesh.name + std::to_string(index), positions, texCoords, tangents, normals, signs, indices, meshlets);
+
+				LRTR_INFO("Build mesh {0} into {1} meshlets.", mesh.name + std::to_string(index), meshlets.size());
+				
+				const auto trianglesMesh = makeComponent<TrianglesMesh>(
+					positions, texCoords, tangents, normals, indices);
+
+				trianglesMesh->setMeshlets(meshlets);
+				trianglesMesh->setTangentSigns(signs);
+
+				//the levels of detail are read from cache if we simplified the same mesh before
+				WorkflowStartup<MeshLevelOfDetailInput> startup;
+				MeshLevelOfDetailWorkflow workflow;
+
+				startup.InputData = MeshLevelOfDetailInput(trianglesMesh);
+				
+				trianglesMesh->setLevelsOfDetail(workflow.start(startup));
+				
+				meshShape->addComponent(trianglesMesh);
 				meshShape->addComponent(
 					TINY_GLTF_HAS_VALUE(primitives.material) ? readMaterial(
 						sharing, &scene->materials[primitives.material], scene) :
-					std::make_shared<PhysicalBasedMaterial>());
+					makeComponent<PhysicalBasedMaterial>());
 				
-				tinyGLTFScene->add(meshShape);
+				if (meshShape != nodeShape) tinyGLTFScene->add(meshShape);
 			}
 		}
 
 		for (const auto& child : node->children) {
-			TinyGLTFBuildScene(sharing, tinyGLTFScene, currentTransform, scene, &scene->nodes[child]);
+			TinyGLTFBuildScene(sharing, tinyGLTFScene, nodeHandle, scene, &scene->nodes[child], threadPool);
 		}
 	}
 	
@@ -289,8 +424,25 @@ auto LRTR::TinyGLTFLoader::loadScene(
 	
 	auto tinyGLTFScene = std::make_shared<TinyGLTFScene>(sharing, sceneName, 2);
 
+	//the root of all nodes, so we can move the whole model with it
+	const auto rootShape = std::make_shared<Shape>();
+
+	Vector3f translation;
+	QuaternionF rotation;
+	Vector3f scale;
+
+	MathUtility::decompose(transform.matrix(), translation, rotation, scale);
+
+	rootShape->component<CollectionLabel>()->set(sceneName, "Root");
+	rootShape->addComponent(makeComponent<TransformWrap>(translation, rotation, scale));
+
+	const auto rootHandle = tinyGLTFScene->add(rootShape);
+	
 	std::vector<bool> isRoot(model.nodes.size(), true);
 
+	//the tangent frames of meshes are generated with the thread pool of scene, so we do not start another pool
+	const auto threadPool = tinyGLTFScene->threadPool();
+
 	for (size_t index = 0; index < model.nodes.size(); index++) {
 		for (const auto& child : model.nodes[index].children) {
 			isRoot[child] = false;
@@ -300,7 +452,7 @@ auto LRTR::TinyGLTFLoader::loadScene(
 	for (size_t index = 0; index < model.nodes.size(); index++) {
 		if (!isRoot[index]) continue;
 
-		TinyGLTFBuildScene(sharing, tinyGLTFScene, transform.matrix(), &model, &model.nodes[index]);
+		TinyGLTFBuildScene(sharing, tinyGLTFScene, rootHandle, &model, &model.nodes[index], *threadPool);
 	}
 
 	return tinyGLTFScene;
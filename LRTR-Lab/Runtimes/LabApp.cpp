@@ -140,7 +140,7 @@ void LRTR::LabApp::runLoop()
 
 void LRTR::LabApp::initializeLogComponents()
 {
-	const auto sink = std::make_shared<SinkStorageSingleThread>();
+	const auto sink = std::make_shared<SinkStorageMultiThread>();
 
 	//initialize spd-log interface
 	spdlog::default_logger()->sinks().push_back(sink);
@@ -174,6 +174,7 @@ void LRTR::LabApp::initializeManagerComponents()
 
 void LRTR::LabApp::update(float delta)
 {
+	mAssetManager->update(delta);
 	mSceneManager->update(delta);
 	mUIManager->update(delta);
 }
@@ -5,7 +5,8 @@
 LRTR::AssetManager::AssetManager(const std::shared_ptr<RuntimeSharing>& sharing) :
 	Manager(sharing)
 {
-	const auto meshDataAssetComponent = std::make_shared<MeshDataAssetComponent>(sharing, sharing->device());
+	const auto meshDataAssetComponent = std::make_shared<MeshDataAssetComponent>(sharing, sharing->device(),
+		MeshDataFormat::Compressed);
 
 	addComponent("MeshData", meshDataAssetComponent);
 
@@ -13,7 +14,8 @@ LRTR::AssetManager::AssetManager(const std::shared_ptr<RuntimeSharing>& sharing)
 
 void LRTR::AssetManager::update(float delta)
 {
-	
+	//the frame before is finished, so the meshes released before the frames in flight can be freed
+	std::static_pointer_cast<MeshDataAssetComponent>(mComponents.at("MeshData"))->retire();
 }
 
 void LRTR::AssetManager::addComponent(const std::string& name, const std::shared_ptr<AssetComponent>& component)
@@ -2,116 +2,138 @@
 
 #include <CodeRed/Core/CodeRedGraphics.hpp>
 
-#include "../../../../Scenes/Components/MeshData/SphereMesh.hpp"
-#include "../../../../Scenes/Components/MeshData/QuadMesh.hpp"
-#include "../../../../Scenes/Components/MeshData/BoxMesh.hpp"
+#include "../../../../Scenes/Components/MeshData/TrianglesMesh.hpp"
+#include "../../../../Scenes/Components/MeshData/ProceduralMeshCache.hpp"
 #include "../../../../Shared/Graphics/ResourceHelper.hpp"
 
-#define LRTR_INSERT_VERTEX_PROPERTY(condition, dest, source0, source1) \
-	if (condition) dest.insert(dest.end(), source0.begin(), source0.end()); \
-	else dest.insert(dest.end(), source1.begin(), source1.end());
+#include <cstring>
 
-LRTR::MeshDataAssetComponent::MeshDataAssetComponent(
-	const std::shared_ptr<RuntimeSharing> & sharing,
-	const std::shared_ptr<CodeRed::GpuLogicalDevice> & device) :
-	AssetComponent(sharing), mDevice(device)
-{
-	mProperties = std::vector<std::shared_ptr<CodeRed::GpuBuffer>>(4);
-
-	for (size_t index = 0; index < mProperties.size(); index++) {
-		mProperties[index] = mDevice->createBuffer(
-			CodeRed::ResourceInfo::VertexBuffer(
-				sizeof(Vector3f),
-				10000,
-				CodeRed::MemoryHeap::Upload
-			)
-		);
+namespace LRTR {
+
+	//the max number of vertices that a mesh can have to use short indices
+	constexpr size_t MaxShortIndexVertices = 65536;
+
+	//the pool is defragmented only if the unused elements are more than this ratio of used elements
+	constexpr float MinDefragmentUnusedRatio = 0.125f;
+
+	//the indices of mesh and its levels of detail, the level 0 is the mesh itself
+	auto meshIndexLevels(const std::shared_ptr<const MeshData>& meshData) -> std::vector<const std::vector<unsigned>*>
+	{
+		auto levels = std::vector<const std::vector<unsigned>*>{ &meshData->indices() };
+
+		if (const auto trianglesMesh = std::dynamic_pointer_cast<const TrianglesMesh>(meshData); trianglesMesh != nullptr) {
+			for (const auto& level : trianglesMesh->levelsOfDetail())
+				levels.push_back(&level.Indices);
+		}
+
+		return levels;
 	}
 
-	mIndices = mDevice->createBuffer(
-		CodeRed::ResourceInfo::IndexBuffer(
-			sizeof(unsigned),
-			30000,
-			CodeRed::MemoryHeap::Upload
-		)
-	);
+	//the number of elements in one page of pools, the meshes larger than a page have their own pages
+	constexpr size_t VertexPageSize = 262144;
+	constexpr size_t IndexPageSize = 1048576;
+
+	//copy the elements of relocation in buffer, the ranges do not overlap because the destination was free
+	void moveBufferRange(const std::shared_ptr<CodeRed::GpuBuffer>& buffer, const RangeRelocation& relocation)
+	{
+		const auto memory = static_cast<unsigned char*>(CodeRed::ResourceHelper::mappedMemory(buffer));
+
+		std::memmove(
+			memory + relocation.To * buffer->stride(),
+			memory + relocation.From * buffer->stride(),
+			relocation.Count * buffer->stride());
+	}
+	
+}
 
+LRTR::MeshDataAssetComponent::MeshDataAssetComponent(
+	const std::shared_ptr<RuntimeSharing> & sharing,
+	const std::shared_ptr<CodeRed::GpuLogicalDevice> & device,
+	const MeshDataFormat format,
+	const size_t maxFrameCount) :
+	AssetComponent(sharing), mDevice(device),
+	mVertices(device, std::vector<size_t>(4, sizeof(Vector3f)), false, VertexPageSize),
+	mIndices(device, { sizeof(unsigned) }, true, IndexPageSize),
+	mPackedVertices(device, { sizeof(PackedPosition), sizeof(PackedTexCoord), sizeof(PackedDirection), sizeof(PackedDirection) }, false, VertexPageSize),
+	mShortIndices(device, { sizeof(unsigned short) }, true, IndexPageSize),
+	mMaxFrameCount(maxFrameCount), mFormat(format)
+{
+	//the pages are created when the meshes are allocated, so the packed pools are empty for full format
+	//the built-in meshes are allocated first, so they are in the first pages of full format
 	beginAllocating();
 	
-	allocate(mMeshes["SkyBox"] = std::make_shared<BoxMesh>(2.0f, 2.0f, 2.0f));
-	allocate(mMeshes["Quad"] = std::make_shared<QuadMesh>(2.0f, 2.0f));
-	allocate(mMeshes["Sphere"] = std::make_shared<SphereMesh>(1.0f, 64, 64));
+	//the built-in meshes are from procedural mesh cache, so the shapes using the same primitive share their ranges
+	allocate(mMeshes["SkyBox"] = ProceduralMeshCache::box(2.0f, 2.0f, 2.0f), MeshDataFormat::Full);
+	allocate(mMeshes["Quad"] = ProceduralMeshCache::quad(2.0f, 2.0f), MeshDataFormat::Full);
+	allocate(mMeshes["Sphere"] = ProceduralMeshCache::sphere(1.0f, 64, 64), MeshDataFormat::Full);
 	
 	endAllocating();
 }
 
 void LRTR::MeshDataAssetComponent::beginAllocating()
 {
-	mPropertiesAllocateCache = std::vector<std::vector<Vector3f>>(4);
-	mIndicesAllocateCache = std::vector<unsigned>();
+	//the meshes destroyed since last allocating are released, so their ranges can be used in this allocating
+	std::vector<Identity> expired;
+
+	for (const auto& reference : mMeshReferences)
+		if (reference.second.expired()) expired.push_back(reference.first);
+
+	for (const auto& identity : expired) release(identity);
+
+	mReleases = expired.size();
 }
 
 void LRTR::MeshDataAssetComponent::endAllocating()
 {
-	//expand the buffer if the count is not enough
-	for (size_t index = 0; index < mProperties.size(); index++) {
-		mProperties[index] = CodeRed::ResourceHelper::expandAndCopyBuffer(mDevice, mProperties[index], mVertexLocation);
+	//the meshes are uploaded when they are allocated, so we only need to defragment the pools
+	auto budget = mDefragmentBudget;
 
-		CodeRed::ResourceHelper::updateBuffer(mProperties[index], mPropertiesAllocateCache[index].data(),
-			sizeof(Vector3f) * (mVertexLocation - mPropertiesAllocateCache[index].size()),
-			sizeof(Vector3f) * mPropertiesAllocateCache[index].size());
-	}
-	
-	mIndices = CodeRed::ResourceHelper::expandAndCopyBuffer(mDevice, mIndices, mIndexLocation);
+	mRelocations = 0;
 
-	CodeRed::ResourceHelper::updateBuffer(mIndices, mIndicesAllocateCache.data(),
-		sizeof(unsigned) * (mIndexLocation - mIndicesAllocateCache.size()),
-		sizeof(unsigned) * mIndicesAllocateCache.size());
-	
-	mPropertiesAllocateCache.clear();
-	mIndicesAllocateCache.clear();
+	defragment(mVertices, true, budget);
+	defragment(mIndices, false, budget);
+	defragment(mPackedVertices, true, budget);
+	defragment(mShortIndices, false, budget);
 }
 
-void LRTR::MeshDataAssetComponent::allocate(const std::shared_ptr<MeshData>& meshData)
+void LRTR::MeshDataAssetComponent::allocate(const std::shared_ptr<const MeshData>& meshData)
 {
-	if (mMeshDataInfos.find(meshData->identity()) != mMeshDataInfos.end()) return;
+	allocate(meshData, mFormat);
+}
 
-	//the zero array is used to fill properties that mesh does not have.
-	//when we create the mesh, we will test the size of properties,
-	//so the size of properties will be greater or equal than positions
-	const auto zeroArray = std::vector<Vector3f>(
-		meshData->positions().size() > meshData->texCoords().size() ||
-		meshData->positions().size() > meshData->tangents().size() ||
-		meshData->positions().size() > meshData->normals().size() ?
-		meshData->positions().size() : 0, Vector3f());
+void LRTR::MeshDataAssetComponent::release(const std::shared_ptr<const MeshData>& meshData)
+{
+	release(meshData->identity());
+}
+
+void LRTR::MeshDataAssetComponent::setDefragmentBudget(const size_t budget)
+{
+	mDefragmentBudget = budget;
+}
 
-	LRTR_INSERT_VERTEX_PROPERTY(
-		meshData->positions().size() >= meshData->positions().size(),
-		mPropertiesAllocateCache[0], meshData->positions(), zeroArray);
+void LRTR::MeshDataAssetComponent::retire()
+{
+	mCurrentFrame++;
 
-	LRTR_INSERT_VERTEX_PROPERTY(
-		meshData->positions().size() >= meshData->texCoords().size(),
-		mPropertiesAllocateCache[1], meshData->texCoords(), zeroArray);
+	//the ranges are in the order of frames, so we stop at the first range that may be still used
+	size_t retired = 0;
 
-	LRTR_INSERT_VERTEX_PROPERTY(
-		meshData->positions().size() >= meshData->tangents().size(),
-		mPropertiesAllocateCache[2], meshData->tangents(), zeroArray);
+	while (retired < mRetiredRanges.size() && mCurrentFrame - mRetiredRanges[retired].Frame > mMaxFrameCount) {
+		const auto& retiredRange = mRetiredRanges[retired];
 
-	LRTR_INSERT_VERTEX_PROPERTY(
-		meshData->positions().size() >= meshData->normals().size(),
-		mPropertiesAllocateCache[3], meshData->normals(), zeroArray);
+		retiredRange.Pool->release(retiredRange.Range);
 
-	mIndicesAllocateCache.insert(mIndicesAllocateCache.end(),
-		meshData->indices().begin(), meshData->indices().end());
+		//the other ranges of page were retired before, so no frame in flight binds its buffers
+		//the page is destroyed if it is empty, so the pools shrink when the meshes are unloaded
+		retiredRange.Pool->destroyPage(retiredRange.Range.Page);
 
-	mMeshDataInfos.insert({ meshData->identity(),
-		{ mVertexLocation, mIndexLocation, meshData->indices().size() } });
-	
-	mVertexLocation = mVertexLocation + meshData->positions().size();
-	mIndexLocation = mIndexLocation + meshData->indices().size();
+		retired++;
+	}
+
+	mRetiredRanges.erase(mRetiredRanges.begin(), mRetiredRanges.begin() + retired);
 }
 
-auto LRTR::MeshDataAssetComponent::get(const std::shared_ptr<MeshData>& meshData) -> MeshDataInfo
+auto LRTR::MeshDataAssetComponent::get(const std::shared_ptr<const MeshData>& meshData) -> MeshDataInfo
 {
 	assert(mMeshDataInfos.find(meshData->identity()) != mMeshDataInfos.end());
 
@@ -125,27 +147,296 @@ auto LRTR::MeshDataAssetComponent::get(const std::string& meshName) -> MeshDataI
 	return get(mMeshes[meshName]);
 }
 
+auto LRTR::MeshDataAssetComponent::get(const std::shared_ptr<const MeshData>& meshData, const size_t level) -> MeshDataInfo
+{
+	assert(mMeshLevelInfos.find(meshData->identity()) != mMeshLevelInfos.end());
+
+	const auto& levelInfos = mMeshLevelInfos[meshData->identity()];
+
+	return levelInfos[std::min(level, levelInfos.size() - 1)];
+}
+
+auto LRTR::MeshDataAssetComponent::levels(const std::shared_ptr<const MeshData>& meshData) -> size_t
+{
+	assert(mMeshLevelInfos.find(meshData->identity()) != mMeshLevelInfos.end());
+
+	return mMeshLevelInfos[meshData->identity()].size();
+}
+
+auto LRTR::MeshDataAssetComponent::meshlets(const std::shared_ptr<const MeshData>& meshData) -> const std::vector<Meshlet>&
+{
+	assert(mMeshlets.find(meshData->identity()) != mMeshlets.end());
+
+	return mMeshlets[meshData->identity()];
+}
+
 auto LRTR::MeshDataAssetComponent::positions() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>
 {
-	return mProperties[0];
+	return mVertices.buffer(0, 0);
 }
 
 auto LRTR::MeshDataAssetComponent::texCoords() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>
 {
-	return mProperties[1];
+	return mVertices.buffer(0, 1);
 }
 
-auto LRTR::MeshDataAssetComponent::tangents() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>
+auto LRTR::MeshDataAssetComponent::indices() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>
 {
-	return mProperties[2];
+	return mIndices.buffer(0, 0);
 }
 
-auto LRTR::MeshDataAssetComponent::normals() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>
+auto LRTR::MeshDataAssetComponent::vertexBuffers(const MeshDataInfo& info) const -> const std::vector<std::shared_ptr<CodeRed::GpuBuffer>>&
 {
-	return mProperties[3];
+	return info.Format == MeshDataFormat::Compressed ?
+		mPackedVertices.buffers(info.VertexPage) :
+		mVertices.buffers(info.VertexPage);
 }
 
-auto LRTR::MeshDataAssetComponent::indices() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>
+auto LRTR::MeshDataAssetComponent::positions(const MeshDataInfo& info) const -> std::shared_ptr<CodeRed::GpuBuffer>
+{
+	return vertexBuffers(info)[0];
+}
+
+auto LRTR::MeshDataAssetComponent::indices(const MeshDataInfo& info) const -> std::shared_ptr<CodeRed::GpuBuffer>
 {
-	return mIndices;
+	return info.ShortIndices ?
+		mShortIndices.buffer(info.IndexPage, 0) :
+		mIndices.buffer(info.IndexPage, 0);
+}
+
+auto LRTR::MeshDataAssetComponent::format() const noexcept -> MeshDataFormat
+{
+	return mFormat;
+}
+
+auto LRTR::MeshDataAssetComponent::statistics() const noexcept -> MeshDataStatistics
+{
+	MeshDataStatistics statistics;
+
+	statistics.Meshes = mMeshReferences.size();
+	statistics.Vertices = mVertices.used() + mPackedVertices.used();
+	statistics.UnusedVertices = mVertices.unused() + mPackedVertices.unused();
+	statistics.Indices = mIndices.used() + mShortIndices.used();
+	statistics.UnusedIndices = mIndices.unused() + mShortIndices.unused();
+	statistics.VertexFragmentation = std::max(mVertices.fragmentation(), mPackedVertices.fragmentation());
+	statistics.IndexFragmentation = std::max(mIndices.fragmentation(), mShortIndices.fragmentation());
+	statistics.Releases = mReleases;
+	statistics.Relocations = mRelocations;
+	statistics.RetiringRanges = mRetiredRanges.size();
+
+	return statistics;
+}
+
+void LRTR::MeshDataAssetComponent::release(const Identity& identity)
+{
+	const auto it = mMeshLevelInfos.find(identity);
+
+	if (it == mMeshLevelInfos.end()) return;
+
+	//the level 0 has the start locations of ranges, the indices of other levels are in the same range
+	const auto& info = it->second.front();
+
+	//the infos are removed at once, so the mesh is not drawn again and its ranges are freed in retire
+	retireRange(info.Format == MeshDataFormat::Compressed ? mPackedVertices : mVertices,
+		PagedRange(info.VertexPage, info.StartVertexLocation));
+	retireRange(info.ShortIndices ? mShortIndices : mIndices,
+		PagedRange(info.IndexPage, info.StartIndexLocation));
+
+	mMeshLevelInfos.erase(it);
+	mMeshDataInfos.erase(identity);
+	mMeshlets.erase(identity);
+	mMeshReferences.erase(identity);
+}
+
+void LRTR::MeshDataAssetComponent::retireRange(PagedBuffer& pool, const PagedRange& range)
+{
+	//the range is kept without owner, so the defragmentation does not move it before it is released
+	pool.keep(range);
+
+	RetiredRange retiredRange;
+
+	retiredRange.Pool = &pool;
+	retiredRange.Range = range;
+	retiredRange.Frame = mCurrentFrame;
+
+	mRetiredRanges.push_back(retiredRange);
+}
+
+void LRTR::MeshDataAssetComponent::defragment(PagedBuffer& pool, const bool vertices, size_t& budget)
+{
+	if (static_cast<float>(pool.unused()) <= static_cast<float>(pool.used()) * MinDefragmentUnusedRatio) return;
+
+	RangeRelocation relocation;
+
+	//the ranges are moved in their pages, so the pages of meshes are not changed
+	//the old ranges are kept by allocator until they are retired, so the new meshes do not overwrite them
+	for (size_t page = 0; page < pool.pages(); page++) {
+		while (budget != 0 && pool.relocateLast(page, relocation, true)) {
+			retireRange(pool, PagedRange(page, relocation.From));
+
+			budget = budget - std::min(budget, relocation.Count);
+
+			//the range without mesh is not used by any frame, so the new range is released at once
+			const auto levelInfos = mMeshLevelInfos.find(relocation.Owner);
+
+			if (levelInfos == mMeshLevelInfos.end()) { pool.release(PagedRange(page, relocation.To)); continue; }
+
+			for (const auto& buffer : pool.buffers(page)) moveBufferRange(buffer, relocation);
+
+			//the ranges of all levels are moved together, so the locations of levels keep their offsets
+			for (auto& info : levelInfos->second) {
+				auto& location = vertices ? info.StartVertexLocation : info.StartIndexLocation;
+
+				location = location - relocation.From + relocation.To;
+			}
+
+			mMeshDataInfos[relocation.Owner] = levelInfos->second.front();
+
+			mRelocations++;
+		}
+	}
+}
+
+void LRTR::MeshDataAssetComponent::allocate(const std::shared_ptr<const MeshData>& meshData, const MeshDataFormat format)
+{
+	if (mMeshDataInfos.find(meshData->identity()) != mMeshDataInfos.end()) return;
+
+	//the info of level 0 is the info of mesh
+	std::vector<MeshDataInfo> levelInfos;
+
+	if (format == MeshDataFormat::Compressed) allocateCompressed(meshData, levelInfos);
+	else allocateFull(meshData, levelInfos);
+
+	mMeshDataInfos.insert({ meshData->identity(), levelInfos.front() });
+	mMeshLevelInfos.insert({ meshData->identity(), levelInfos });
+	mMeshReferences.insert({ meshData->identity(), meshData });
+
+	//the meshlets are ranges of indices, so they do not need to be uploaded
+	const auto trianglesMesh = std::dynamic_pointer_cast<const TrianglesMesh>(meshData);
+
+	mMeshlets.insert({ meshData->identity(), trianglesMesh != nullptr ? trianglesMesh->meshlets() : std::vector<Meshlet>() });
+}
+
+void LRTR::MeshDataAssetComponent::allocateFull(const std::shared_ptr<const MeshData>& meshData, std::vector<MeshDataInfo>& levelInfos)
+{
+	const auto levels = meshIndexLevels(meshData);
+	const auto vertexCount = meshData->positions().size();
+
+	auto indexCount = static_cast<size_t>(0);
+
+	for (const auto& indices : levels) indexCount = indexCount + indices->size();
+
+	const auto vertexRange = mVertices.allocate(vertexCount, meshData->identity());
+	const auto indexRange = mIndices.allocate(indexCount, meshData->identity());
+
+	//the properties that are not enough for all vertices are filled with zero
+	//when we create the mesh, we will test the size of properties,
+	//so the size of properties will be greater or equal than positions
+	const std::vector<Vector3f>* properties[] = {
+		&meshData->positions(),
+		&meshData->texCoords(),
+		&meshData->tangents(),
+		&meshData->normals()
+	};
+
+	const auto zeroArray = std::vector<Vector3f>(
+		properties[1]->size() < vertexCount ||
+		properties[2]->size() < vertexCount ||
+		properties[3]->size() < vertexCount ?
+		vertexCount : 0, Vector3f());
+
+	for (size_t index = 0; index < 4; index++) {
+		mVertices.upload(index, vertexRange,
+			properties[index]->size() >= vertexCount ? properties[index]->data() : zeroArray.data(),
+			vertexCount);
+	}
+
+	//the indices of levels are after the indices of mesh in one range, they use the same start vertex location
+	auto location = indexRange.Offset;
+	
+	for (const auto& indices : levels) {
+		mIndices.upload(0, PagedRange(indexRange.Page, location), indices->data(), indices->size());
+
+		auto info = MeshDataInfo{ vertexRange.Offset, location, indices->size() };
+
+		info.VertexPage = vertexRange.Page;
+		info.IndexPage = indexRange.Page;
+
+		levelInfos.push_back(info);
+
+		location = location + indices->size();
+	}
+}
+
+void LRTR::MeshDataAssetComponent::allocateCompressed(const std::shared_ptr<const MeshData>& meshData, std::vector<MeshDataInfo>& levelInfos)
+{
+	const auto& positions = meshData->positions();
+	const auto& texCoords = meshData->texCoords();
+	const auto& tangents = meshData->tangents();
+	const auto& normals = meshData->normals();
+
+	const auto count = positions.size();
+	const auto quantization = VertexCompression::quantization(positions);
+	const auto shortIndices = count <= MaxShortIndexVertices;
+
+	//the properties that are not enough for all vertices are filled with zero like full format
+	const auto hasTexCoords = texCoords.size() >= count;
+	const auto hasTangents = tangents.size() >= count;
+	const auto hasNormals = normals.size() >= count;
+
+	//the handedness of tangent is stored in the w of position, the meshes without signs are right handed
+	const auto trianglesMesh = std::dynamic_pointer_cast<const TrianglesMesh>(meshData);
+	const auto hasSigns = trianglesMesh != nullptr && trianglesMesh->tangentSigns().size() >= count;
+
+	std::vector<PackedPosition> packedPositions(count);
+	std::vector<PackedTexCoord> packedTexCoords(count);
+	std::vector<PackedDirection> packedTangents(count);
+	std::vector<PackedDirection> packedNormals(count);
+
+	for (size_t index = 0; index < count; index++) {
+		packedPositions[index] = VertexCompression::encodePosition(positions[index], quantization,
+			hasSigns ? trianglesMesh->tangentSigns()[index] : 1.0f);
+		packedTexCoords[index] = VertexCompression::encodeTexCoord(hasTexCoords ? texCoords[index] : Vector3f());
+		packedTangents[index] = VertexCompression::encodeDirection(hasTangents ? tangents[index] : Vector3f());
+		packedNormals[index] = VertexCompression::encodeDirection(hasNormals ? normals[index] : Vector3f());
+	}
+
+	const auto levels = meshIndexLevels(meshData);
+
+	auto indexCount = static_cast<size_t>(0);
+
+	for (const auto& indices : levels) indexCount = indexCount + indices->size();
+
+	const auto vertexRange = mPackedVertices.allocate(count, meshData->identity());
+	const auto indexRange = shortIndices ?
+		mShortIndices.allocate(indexCount, meshData->identity()) :
+		mIndices.allocate(indexCount, meshData->identity());
+
+	mPackedVertices.upload(0, vertexRange, packedPositions.data(), count);
+	mPackedVertices.upload(1, vertexRange, packedTexCoords.data(), count);
+	mPackedVertices.upload(2, vertexRange, packedTangents.data(), count);
+	mPackedVertices.upload(3, vertexRange, packedNormals.data(), count);
+
+	auto location = indexRange.Offset;
+	
+	for (const auto& indices : levels) {
+		auto info = MeshDataInfo{ vertexRange.Offset, location, indices->size() };
+
+		info.Format = MeshDataFormat::Compressed;
+		info.ShortIndices = shortIndices;
+		info.Quantization = quantization;
+		info.VertexPage = vertexRange.Page;
+		info.IndexPage = indexRange.Page;
+
+		if (shortIndices) {
+			std::vector<unsigned short> levelIndices(indices->begin(), indices->end());
+
+			mShortIndices.upload(0, PagedRange(indexRange.Page, location), levelIndices.data(), levelIndices.size());
+		}
+		else mIndices.upload(0, PagedRange(indexRange.Page, location), indices->data(), indices->size());
+
+		location = location + indices->size();
+
+		levelInfos.push_back(info);
+	}
 }
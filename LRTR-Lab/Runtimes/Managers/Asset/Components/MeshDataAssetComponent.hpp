@@ -1,22 +1,72 @@
 #pragma once
 
 #include "../../../../Scenes/Components/MeshData/MeshData.hpp"
+#include "../../../../Shared/Graphics/PagedBuffer.hpp"
+#include "../../../../Shared/Meshes/VertexCompression.hpp"
+#include "../../../../Shared/Meshes/MeshletBuilder.hpp"
 #include "../../../../Shared/Accelerators/Group.hpp"
 #include "AssetComponent.hpp"
 
 namespace LRTR {
 
+	//the full format uses float3 for all properties (48 bytes per vertex)
+	//the compressed format uses quantized positions, half texture coordinates and octahedral directions (20 bytes per vertex)
+	enum class MeshDataFormat : unsigned {
+		Full = 0,
+		Compressed = 1
+	};
+	
 	struct MeshDataInfo {
 		size_t StartVertexLocation;
 		size_t StartIndexLocation;
 		size_t IndexCount;
+
+		//the compressed vertices are in the packed buffers, the locations are the locations in them
+		MeshDataFormat Format = MeshDataFormat::Full;
+
+		//the indices are in the short index buffer if the vertices of mesh are not more than 65536
+		bool ShortIndices = false;
+
+		//the pages of vertex and index pools, the locations are the locations in the buffers of pages
+		size_t VertexPage = 0;
+		size_t IndexPage = 0;
+
+		//the positions of compressed vertices are quantized in the bound of mesh
+		PositionQuantization Quantization;
 	};
 
+	//the statistics of vertex and index pools, the counts are the sums of pools of all formats
+	//the fragmentation is the largest one of pools
+	struct MeshDataStatistics {
+		size_t Meshes = 0;
+
+		size_t Vertices = 0;
+		size_t UnusedVertices = 0;
+		size_t Indices = 0;
+		size_t UnusedIndices = 0;
+
+		float VertexFragmentation = 0;
+		float IndexFragmentation = 0;
+
+		//the meshes released and the ranges relocated by defragmentation in last allocating
+		size_t Releases = 0;
+		size_t Relocations = 0;
+
+		//the ranges released but still used by the frames in flight, they are freed by retire
+		size_t RetiringRanges = 0;
+	};
+	
+	//the vertices and indices of meshes are sub-allocated from the paged pools by range allocators
+	//the pools grow by adding pages, so the buffers of meshes allocated before are not copied
+	//the ranges of mesh are released when the mesh is destroyed, so the space is reused by other meshes
+	//the frames in flight may still read the ranges released or moved, so they are freed after max frame count frames
 	class MeshDataAssetComponent : public AssetComponent {
 	public:
 		explicit MeshDataAssetComponent(
 			const std::shared_ptr<RuntimeSharing>& sharing,
-			const std::shared_ptr<CodeRed::GpuLogicalDevice>& device);
+			const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
+			const MeshDataFormat format = MeshDataFormat::Full,
+			const size_t maxFrameCount = 2);
 
 		~MeshDataAssetComponent() = default;
 
@@ -24,34 +74,105 @@ namespace LRTR {
 
 		void endAllocating();
 
-		void allocate(const std::shared_ptr<MeshData>& meshData);
+		void allocate(const std::shared_ptr<const MeshData>& meshData);
+
+		//release the ranges of mesh, the meshes destroyed are released in beginAllocating automatically
+		void release(const std::shared_ptr<const MeshData>& meshData);
+
+		//the max number of elements moved by defragmentation in each endAllocating, 0 disables it
+		void setDefragmentBudget(const size_t budget);
+
+		//finish the current frame, the ranges released more than max frame count frames ago are freed
+		//so the allocating in next frames can reuse them, it should be called once per frame
+		void retire();
 		
-		auto get(const std::shared_ptr<MeshData>& meshData) -> MeshDataInfo;
+		auto get(const std::shared_ptr<const MeshData>& meshData) -> MeshDataInfo;
 
 		auto get(const std::string& meshName) -> MeshDataInfo;
+
+		//the range of level of detail, the level 0 is the mesh itself and the level is clamped to the last level
+		//the levels share the vertices of mesh, so they only have different index ranges
+		auto get(const std::shared_ptr<const MeshData>& meshData, const size_t level) -> MeshDataInfo;
+
+		//the number of levels of mesh, include the level 0
+		auto levels(const std::shared_ptr<const MeshData>& meshData) -> size_t;
+
+		//the meshlets of level 0, the index offsets are relative to the start index location of level 0
+		//it is empty if the mesh is not built into meshlets, so we draw the mesh as a whole
+		auto meshlets(const std::shared_ptr<const MeshData>& meshData) -> const std::vector<Meshlet>&;
 		
+		//the buffers of first page of full format, the built-in meshes are always in them
 		auto positions() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>;
 
 		auto texCoords() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>;
 
-		auto tangents() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>;
+		auto indices() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>;
 
-		auto normals() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>;
+		//the vertex buffers (positions, texture coordinates, tangents and normals) of the page and format of mesh
+		auto vertexBuffers(const MeshDataInfo& info) const -> const std::vector<std::shared_ptr<CodeRed::GpuBuffer>>&;
 
-		auto indices() const noexcept -> std::shared_ptr<CodeRed::GpuBuffer>;
+		auto positions(const MeshDataInfo& info) const -> std::shared_ptr<CodeRed::GpuBuffer>;
+
+		//the index buffer the mesh uses, it is in the short index pool if the mesh uses short indices
+		auto indices(const MeshDataInfo& info) const -> std::shared_ptr<CodeRed::GpuBuffer>;
+
+		//the format of meshes we allocate, the built-in meshes are always full format
+		//because the screen passes bind them with float3 input layout
+		auto format() const noexcept -> MeshDataFormat;
+
+		auto statistics() const noexcept -> MeshDataStatistics;
+	private:
+		void release(const Identity& identity);
+
+		//the range is freed in retire when no frame in flight uses it
+		void retireRange(PagedBuffer& pool, const PagedRange& range);
+
+		//move the last ranges of each page into the free ranges before them until the budget is used up
+		//the free ranges are not used by the frames in flight, so the ranges are copied and remapped at once
+		//the old ranges may be still read by the frames in flight, so they are retired instead of released
+		void defragment(PagedBuffer& pool, const bool vertices, size_t& budget);
+
+		void allocate(const std::shared_ptr<const MeshData>& meshData, const MeshDataFormat format);
+
+		void allocateFull(const std::shared_ptr<const MeshData>& meshData, std::vector<MeshDataInfo>& levelInfos);
+
+		void allocateCompressed(const std::shared_ptr<const MeshData>& meshData, std::vector<MeshDataInfo>& levelInfos);
+	private:
+		struct RetiredRange {
+			PagedBuffer* Pool = nullptr;
+			PagedRange Range;
+
+			size_t Frame = 0;
+		};
 	private:
 		std::shared_ptr<CodeRed::GpuLogicalDevice> mDevice;
-		std::shared_ptr<CodeRed::GpuBuffer> mIndices;
-		std::vector<std::shared_ptr<CodeRed::GpuBuffer>> mProperties;
 
-		std::vector<std::vector<Vector3f>> mPropertiesAllocateCache;
-		std::vector<unsigned> mIndicesAllocateCache;
-		size_t mVertexLocation = 0;
-		size_t mIndexLocation = 0;
+		//the pools of full vertices, full indices, compressed vertices and short indices
+		PagedBuffer mVertices;
+		PagedBuffer mIndices;
+		PagedBuffer mPackedVertices;
+		PagedBuffer mShortIndices;
+
+		size_t mDefragmentBudget = 65536;
+		size_t mReleases = 0;
+		size_t mRelocations = 0;
 
-		Group<std::string, std::shared_ptr<MeshData>> mMeshes;
+		//the ranges waiting for the frames in flight, they are in the order of frames
+		std::vector<RetiredRange> mRetiredRanges;
+
+		size_t mMaxFrameCount = 2;
+		size_t mCurrentFrame = 0;
+
+		MeshDataFormat mFormat = MeshDataFormat::Full;
+
+		Group<std::string, std::shared_ptr<const MeshData>> mMeshes;
 		
 		Group<Identity, MeshDataInfo> mMeshDataInfos;
+		Group<Identity, std::vector<MeshDataInfo>> mMeshLevelInfos;
+		Group<Identity, std::vector<Meshlet>> mMeshlets;
+
+		//the meshes we allocated, the ranges of mesh are released when its reference is expired
+		Group<Identity, std::weak_ptr<const MeshData>> mMeshReferences;
 	};
 	
 }
\ No newline at end of file
@@ -16,8 +16,7 @@
 #include "../../../Scenes/Components/Materials/WireframeMaterial.hpp"
 #include "../../../Scenes/Components/LightSources/PointLightSource.hpp"
 #include "../../../Scenes/Components/MeshData/TrianglesMesh.hpp"
-#include "../../../Scenes/Components/MeshData/QuadMesh.hpp"
-#include "../../../Scenes/Components/MeshData/BoxMesh.hpp"
+#include "../../../Scenes/Components/MeshData/ProceduralMeshCache.hpp"
 #include "../../../Scenes/Components/Environment/SkyBox.hpp"
 #include "../../../Scenes/Components/CollectionLabel.hpp"
 #include "../../../Scenes/Components/CameraGroup.hpp"
@@ -65,45 +64,45 @@ LRTR::SceneManager::SceneManager(
 	const auto box2 = std::make_shared<Shape>();
 	const auto box3 = std::make_shared<Shape>();
 	
-	quad->addComponent<TrianglesMesh>(std::make_shared<QuadMesh>(20.f, 20.f));
-	quad->addComponent(std::make_shared<TransformWrap>());
-	quad->addComponent(std::make_shared<PhysicalBasedMaterial>(
+	quad->addComponent<TrianglesMesh>(ProceduralMeshCache::quad(20.f, 20.f));
+	quad->addComponent(makeComponent<TransformWrap>());
+	quad->addComponent(makeComponent<PhysicalBasedMaterial>(
 		Vector4f(0), Vector4f(1), Vector4f(0.7f), Vector4f(0)
 		));
 	quad->component<CollectionLabel>()->set("Objects", "Quad");
 
-	box0->addComponent<TrianglesMesh>(std::make_shared<BoxMesh>(1.f, 1.f, 1.f));
-	box0->addComponent(std::make_shared<TransformWrap>(
+	box0->addComponent<TrianglesMesh>(ProceduralMeshCache::box(1.f, 1.f, 1.f));
+	box0->addComponent(makeComponent<TransformWrap>(
 		Vector3f(1, 0, 0.5f), Vector4f(), Vector3f(1)
 		));
-	box0->addComponent(std::make_shared<PhysicalBasedMaterial>(
+	box0->addComponent(makeComponent<PhysicalBasedMaterial>(
 		Vector4f(0.f), Vector4f(0.7f, 0.6f, 0.65f, 1.0f), Vector4f(0.7f), Vector4f(0)
 		));
 	box0->component<CollectionLabel>()->set("Objects", "Box0");
 
-	box1->addComponent<TrianglesMesh>(std::make_shared<BoxMesh>(1.f, 1.f, 1.f));
-	box1->addComponent(std::make_shared<TransformWrap>(
+	box1->addComponent<TrianglesMesh>(ProceduralMeshCache::box(1.f, 1.f, 1.f));
+	box1->addComponent(makeComponent<TransformWrap>(
 		Vector3f(-1, 0, 0.5f), Vector4f(), Vector3f(1)
 		));
-	box1->addComponent(std::make_shared<PhysicalBasedMaterial>(
+	box1->addComponent(makeComponent<PhysicalBasedMaterial>(
 		Vector4f(0.f), Vector4f(0.7f, 0.6f, 0.65f, 1.0f), Vector4f(0.7f), Vector4f(0)
 		));
 	box1->component<CollectionLabel>()->set("Objects", "Box1");
 
-	box2->addComponent<TrianglesMesh>(std::make_shared<BoxMesh>(1.f, 1.f, 1.f));
-	box2->addComponent(std::make_shared<TransformWrap>(
+	box2->addComponent<TrianglesMesh>(ProceduralMeshCache::box(1.f, 1.f, 1.f));
+	box2->addComponent(makeComponent<TransformWrap>(
 		Vector3f(0, 1, 0.5f), Vector4f(), Vector3f(1)
 		));
-	box2->addComponent(std::make_shared<PhysicalBasedMaterial>(
+	box2->addComponent(makeComponent<PhysicalBasedMaterial>(
 		Vector4f(0.f), Vector4f(0.7f, 0.6f, 0.65f, 1.0f), Vector4f(0.7f), Vector4f(0)
 		));
 	box2->component<CollectionLabel>()->set("Objects", "Box2");
 
-	box3->addComponent<TrianglesMesh>(std::make_shared<BoxMesh>(1.f, 1.f, 1.f));
-	box3->addComponent(std::make_shared<TransformWrap>(
+	box3->addComponent<TrianglesMesh>(ProceduralMeshCache::box(1.f, 1.f, 1.f));
+	box3->addComponent(makeComponent<TransformWrap>(
 		Vector3f(0, -1, 0.5f), Vector4f(), Vector3f(1)
 		));
-	box3->addComponent(std::make_shared<PhysicalBasedMaterial>(
+	box3->addComponent(makeComponent<PhysicalBasedMaterial>(
 		Vector4f(0.f), Vector4f(0.7f, 0.6f, 0.65f, 1.0f), Vector4f(0.7f), Vector4f(0)
 		));
 	box3->component<CollectionLabel>()->set("Objects", "Box3");
@@ -113,25 +112,25 @@ LRTR::SceneManager::SceneManager(
 	//box2->component<PhysicalBasedMaterial>()->IsBlurred = true;
 	//box3->component<PhysicalBasedMaterial>()->IsBlurred = true;
 	
-	light0->addComponent(std::make_shared<PointLightSource>(Vector3f(20)));
+	light0->addComponent(makeComponent<PointLightSource>(Vector3f(20)));
 	light0->component<CollectionLabel>()->set("Light", "Point0");
-	light0->addComponent(std::make_shared<TransformWrap>(
+	light0->addComponent(makeComponent<TransformWrap>(
 		Vector3f(0, 5.f, 3.f),
 		Vector4f(1, 0, 0, 0),
 		Vector3f(1)
 		));
 
-	light1->addComponent(std::make_shared<PointLightSource>(Vector3f(20)));
+	light1->addComponent(makeComponent<PointLightSource>(Vector3f(20)));
 	light1->component<CollectionLabel>()->set("Light", "Point1");
-	light1->addComponent(std::make_shared<TransformWrap>(
+	light1->addComponent(makeComponent<TransformWrap>(
 		Vector3f(5.f, 0.f, 3.f),
 		Vector4f(1, 0, 0, 0),
 		Vector3f(1)
 		));
 
-	light2->addComponent(std::make_shared<PointLightSource>(Vector3f(20)));
+	light2->addComponent(makeComponent<PointLightSource>(Vector3f(20)));
 	light2->component<CollectionLabel>()->set("Light", "Point2");
-	light2->addComponent(std::make_shared<TransformWrap>(
+	light2->addComponent(makeComponent<TransformWrap>(
 		Vector3f(0.f, 0.f, 3.5f),
 		Vector4f(1, 0, 0, 0),
 		Vector3f(1)
@@ -148,24 +147,24 @@ LRTR::SceneManager::SceneManager(
 	//mScenes["Scene"]->add(light2);
 	
 	const auto camera = std::make_shared<MotionCamera>(
-		std::make_shared<TransformWrap>(
+		makeComponent<TransformWrap>(
 			Vector3f(0.081f, 1.995f, 5.649f),
 			QuaternionF(0.029f, 0.006f, 0.209f, 0.978f),
 			Vector3f(1)),
-		std::make_shared<Perspective>(
+		makeComponent<Perspective>(
 			MathUtility::pi<float>() * 0.25f,
 			1920.0f,
 			1080.0f,
 			0.001f,
 			1000.0f),
-		std::make_shared<MotionProperty>(0.01f, 3.f, 
+		makeComponent<MotionProperty>(0.01f, 3.f, 
 			std::array<bool, 3>{ true, true, false }));
 
 	camera->component<CollectionLabel>()->set("Collection", "Camera");
 
-	mScenes["Scene"]->property()->addComponent(std::make_shared<SkyBox>(output.EnvironmentMap));
+	mScenes["Scene"]->property()->addComponent(makeComponent<SkyBox>(output.EnvironmentMap));
 	
-	/*mScenes["Scene"]->property()->addComponent(std::make_shared<SkyBox>(
+	/*mScenes["Scene"]->property()->addComponent(makeComponent<SkyBox>(
 		CodeRed::ResourceHelper::loadSkyBox(
 			sharing->device(),
 			sharing->allocator(),
@@ -209,12 +208,12 @@ auto LRTR::SceneManager::render(float delta) ->
 
 	if (sceneTexture == nullptr) return {};
 
-	const auto camera = mScenes["Scene"]->property()
-		->component<CameraGroup>()->current();
+	const auto camera = mScenes["Scene"]->shapes().get(
+		mScenes["Scene"]->property()->component<CameraGroup>()->current());
 	
 	return mScenes["Scene"]->render(sceneTexture,
 		camera == nullptr ? nullptr : 
-		std::static_pointer_cast<SceneCamera>(camera),
+		std::static_pointer_cast<SceneCamera>(*camera),
 		delta);
 }
 
@@ -14,6 +14,19 @@ LRTR::SceneShapeUIComponent::SceneShapeUIComponent(const std::shared_ptr<Runtime
 		std::bind(&SceneShapeUIComponent::update, this));
 }
 
+void LRTR::SceneShapeUIComponent::select(const ShapeHandle& handle)
+{
+	const auto& scene = mRuntimeSharing->sceneManager()->scenes().at("Scene");
+	const auto instance = scene->shapes().get(handle);
+
+	mSelected = handle;
+
+	if (instance != nullptr)
+		std::static_pointer_cast<PropertyUIComponent>(
+			mRuntimeSharing->uiManager()->components().at("View.Property"))
+			->showProperty(*instance);
+}
+
 void LRTR::SceneShapeUIComponent::update()
 {
 	if (mShow == false) return;
@@ -41,7 +54,8 @@ void LRTR::SceneShapeUIComponent::update()
 		mainMenuHeight
 	));
 
-	const auto &systems = mRuntimeSharing->sceneManager()->scenes().at("Scene")->systems();
+	const auto& scene = mRuntimeSharing->sceneManager()->scenes().at("Scene");
+	const auto& systems = scene->systems();
 
 	for (const auto& system : systems) {
 		if (system->typeIndex() != typeid(CollectionUpdateSystem)) continue;
@@ -52,15 +66,14 @@ void LRTR::SceneShapeUIComponent::update()
 			if (ImGui::TreeNodeEx(collection.first.c_str(), treeNodeFlags)) {
 
 				for (const auto& shape : collection.second) {
-					const auto status = mSelected == shape.first ? true : false;
+					const auto status = mSelected == shape.second ? true : false;
 
-					if (ImGui::Selectable(shape.first.c_str(), status)) {
-						mSelected = shape.first;
+					//the names of shapes may be same, so we use the index of handle as id
+					ImGui::PushID(static_cast<int>(shape.second.Index));
+					
+					if (ImGui::Selectable(shape.first.c_str(), status)) select(shape.second);
 
-						std::static_pointer_cast<PropertyUIComponent>(
-							mRuntimeSharing->uiManager()->components().at("View.Property"))
-							->showProperty(shape.second);
-					}
+					ImGui::PopID();
 				}
 
 				ImGui::TreePop();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../../../../Scenes/Shape.hpp"
+
 #include "UIComponent.hpp"
 
 namespace LRTR {
@@ -9,10 +11,13 @@ namespace LRTR {
 		explicit SceneShapeUIComponent(const std::shared_ptr<RuntimeSharing>& sharing);
 
 		~SceneShapeUIComponent() = default;
+
+		//select the shape and show its property, it is used when we pick the shape in scene view
+		void select(const ShapeHandle& handle);
 	private:
 		void update();
 	private:
-		std::string mSelected;
+		ShapeHandle mSelected;
 	};
 	
 }
\ No newline at end of file
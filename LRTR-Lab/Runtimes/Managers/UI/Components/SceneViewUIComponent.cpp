@@ -1,7 +1,14 @@
 #include "SceneViewUIComponent.hpp"
 
+#include "../../../../Scenes/Components/CameraGroup.hpp"
+#include "../../../../Scenes/Scene.hpp"
+#include "../../Scene/SceneManager.hpp"
 #include "../UIManager.hpp"
 
+#include "SceneShapeUIComponent.hpp"
+
+#include <chrono>
+
 LRTR::SceneViewUIComponent::SceneViewUIComponent(const std::shared_ptr<RuntimeSharing>& sharing) :
 	UIComponent(sharing)
 {
@@ -14,6 +21,44 @@ auto LRTR::SceneViewUIComponent::sceneTexture() const noexcept -> std::shared_pt
 	return mSceneTexture;
 }
 
+void LRTR::SceneViewUIComponent::pick(const Vector2f& position) const
+{
+	const auto& scene = mRuntimeSharing->sceneManager()->scenes().at("Scene");
+
+	if (!scene->property()->hasComponent<CameraGroup>()) return;
+
+	const auto camera = scene->shape(scene->property()->component<CameraGroup>()->current());
+
+	if (camera == nullptr || !camera->hasComponent<Projective>() || !camera->hasComponent<TransformWrap>()) return;
+
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	//transform the points of ndc on near plane and far plane to world space
+	const auto inverse = glm::inverse(
+		camera->component<Projective>()->toScreen().matrix() *
+		camera->component<TransformWrap>()->transform().inverseMatrix());
+
+	const auto ndc = Vector2f(position.x * 2.0f - 1.0f, 1.0f - position.y * 2.0f);
+	const auto nearPoint = inverse * Vector4f(ndc.x, ndc.y, -1.0f, 1.0f);
+	const auto farPoint = inverse * Vector4f(ndc.x, ndc.y, 1.0f, 1.0f);
+
+	const auto origin = Vector3f(nearPoint) / nearPoint.w;
+	const auto direction = Vector3f(farPoint) / farPoint.w - origin;
+
+	//the ray ends at far plane, so the max distance is 1
+	const auto result = scene->boundingVolumes().intersect(RayF(origin, direction), 1.0f, scene->threadPool().get());
+
+	const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::high_resolution_clock::now() - start);
+
+	LRTR_INFO("Pick the scene at ({0}, {1}) in {2} us.", position.x, position.y, duration.count());
+
+	if (!result.valid()) return;
+
+	std::static_pointer_cast<SceneShapeUIComponent>(
+		mRuntimeSharing->uiManager()->components().at("View.Shape"))->select(result.Shape);
+}
+
 void LRTR::SceneViewUIComponent::update()
 {
 	if (mShow == false) return;
@@ -63,6 +108,16 @@ void LRTR::SceneViewUIComponent::update()
 
 	ImGui::Image(mSceneTexture.get(), contentSize);
 
+	//the left button picks the shape, the right button is used to rotate the camera
+	if (ImGui::IsItemClicked(0)) {
+		const auto mousePosition = ImGui::GetMousePos();
+		const auto imageMin = ImGui::GetItemRectMin();
+
+		pick(Vector2f(
+			(mousePosition.x - imageMin.x) / contentSize.x,
+			(mousePosition.y - imageMin.y) / contentSize.y));
+	}
+
 	updateProperties();
 	
 	ImGui::End();
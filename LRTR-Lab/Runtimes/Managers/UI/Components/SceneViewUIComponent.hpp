@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../../../../Shared/Math/Math.hpp"
+
 #include "UIComponent.hpp"
 
 #include <CodeRed/Interface/GpuResource/GpuTexture.hpp>
@@ -15,6 +17,9 @@ namespace LRTR {
 		auto sceneTexture() const noexcept -> std::shared_ptr<CodeRed::GpuTexture>;
 	private:
 		void update();
+
+		//pick the closest shape at the position of scene view, the position is in [0, 1]
+		void pick(const Vector2f& position) const;
 	private:
 		std::shared_ptr<CodeRed::GpuTexture> mSceneTexture;
 	};
@@ -0,0 +1,54 @@
+#pragma pack_matrix(row_major)
+
+struct MeshBufferData {
+	matrix Transform;
+};
+
+struct Output {
+	float4 Position : SV_POSITION;
+};
+
+struct View {
+	matrix View;
+};
+
+struct Config {
+	float4 Color;
+	uint Index;
+	float OffsetX;
+	float OffsetY;
+	float OffsetZ;
+	float ScaleX;
+	float ScaleY;
+	float ScaleZ;
+};
+
+StructuredBuffer<MeshBufferData> meshBuffer : register(t0);
+ConstantBuffer<View> view : register(b1);
+[[vk::push_constant]] ConstantBuffer<Config> config : register(b2);
+
+//the packed properties are bound as 8 bits unorm, so we rebuild the bytes and combine them into 16 bits values
+uint2 unpackWords(float4 value)
+{
+	uint4 bytes = (uint4)round(value * 255.0f);
+
+	return bytes.xz | (bytes.yw << 8);
+}
+
+Output main(
+	float4 positionXY : POSITIONXY,
+	float4 positionZW : POSITIONZW)
+{
+	Output result;
+
+	uint2 xy = unpackWords(positionXY);
+	uint2 zw = unpackWords(positionZW);
+
+	float3 position = float3(config.OffsetX, config.OffsetY, config.OffsetZ) +
+		float3(xy, zw.x) / 65535.0f * float3(config.ScaleX, config.ScaleY, config.ScaleZ);
+
+	result.Position = mul(float4(position, 1.0f), meshBuffer[config.Index].Transform);
+	result.Position = mul(result.Position, view.View);
+	
+	return result;
+}
\ No newline at end of file
@@ -18,9 +18,25 @@ struct Light
 	float FarPlane;
 	uint Index;
 	uint Type;
+	float Range;
+
+	//the top-left texels of faces in shadow atlas, packed as x | (y << 16)
+	uint Tiles[6];
+	uint Resolution;
 	uint Unused;
 };
 
+struct LightCluster
+{
+	uint Offset;
+	uint Count;
+};
+
+struct View
+{
+	matrix View[4];
+};
+
 struct Config
 {
     uint HasEnvironmentLight;
@@ -29,6 +45,11 @@ struct Config
     float EyePositionZ;
     uint MipLevels;
 	uint Lights;
+	uint ClusterWidth;
+	uint ClusterHeight;
+	uint ClusterDepth;
+	float ZNear;
+	float ZFar;
 };
 
 float3 mix(float3 x, float3 y, float3 a)
@@ -109,6 +130,11 @@ float3 ComputePointLight(Light light, Material material, float3 position, float3
 	float ndotl = max(dot(lightVector, normal), 0.0f);
 	float distance = length(light.Position.xyz - position);
 	float attenuation = 1.0f / (distance * distance);
+
+	//fade the light to zero at its range, so the clusters out of range do not need the light
+	float fade = saturate(1.0f - pow(distance / light.Range, 4.0f));
+
+	attenuation = attenuation * fade * fade;
 	
 	return CookTorranceBRDF(material, light.Intensity.xyz * attenuation * ndotl, lightVector, normal, toEye, F0);
 }
@@ -143,6 +169,7 @@ float3 InverseGammaCorrect(float3 value)
 }
 
 StructuredBuffer<Light> lights : register(t0);
+ConstantBuffer<View> view : register(b1);
 
 Texture2D baseColorAndRoughnessTexture : register(t2);
 Texture2D positionAndOcclusionTexture : register(t3);
@@ -153,11 +180,57 @@ Texture2D ssaoTexture : register(t7);
 TextureCube irradianceMap : register(t8);
 TextureCube preFilteringMap : register(t9);
 Texture2D preComputingBRDF : register(t10);
-TextureCubeArray pointShadowMaps : register(t11);
+Texture2D pointShadowAtlas : register(t11);
+StructuredBuffer<LightCluster> lightClusters : register(t12);
+StructuredBuffer<uint> lightIndices : register(t13);
 
 SamplerState textureSampler : register(s0, space1);
 [[vk::push_constant]] ConstantBuffer<Config> config : register(b0, space2);
 
+float SampleShadowAtlas(Light light, float3 direction)
+{
+	//the forward and up of faces, they are the same as the view matrices of point shadow map workflow
+	const float3 faceForward[6] = {
+		float3(+1, 0, 0), float3(-1, 0, 0), float3(0, +1, 0),
+		float3(0, -1, 0), float3(0, 0, +1), float3(0, 0, -1)
+	};
+
+	const float3 faceUp[6] = {
+		float3(0, -1, 0), float3(0, -1, 0), float3(0, 0, +1),
+		float3(0, 0, -1), float3(0, -1, 0), float3(0, -1, 0)
+	};
+
+	float3 absDirection = abs(direction);
+	uint face = 0;
+
+	if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z) face = direction.x > 0 ? 0 : 1;
+	else if (absDirection.y >= absDirection.z) face = direction.y > 0 ? 2 : 3;
+	else face = direction.z > 0 ? 4 : 5;
+
+	//project the direction to the face as the look at matrix and 90 degrees perspective matrix do
+	float3 forward = faceForward[face];
+	float3 side = normalize(cross(forward, faceUp[face]));
+	float3 up = cross(side, forward);
+	float depth = dot(forward, direction);
+
+	//the y of clip space is flipped when we render the face, so the y of texture is the same as y of view space
+	float2 ndc = float2(dot(side, direction), dot(up, direction)) / depth;
+	float2 uv = float2(ndc.x * 0.5 + 0.5, ndc.y * 0.5 + 0.5);
+
+	//we clamp the uv in the tile, so the sampler does not read the texels of other tiles
+	float resolution = light.Resolution;
+	float2 texel = clamp(uv * resolution, 0.5, resolution - 0.5);
+
+	uint tile = light.Tiles[face];
+	float2 origin = float2(tile & 0xffff, tile >> 16);
+
+	float width, height;
+
+	pointShadowAtlas.GetDimensions(width, height);
+
+	return pointShadowAtlas.SampleLevel(textureSampler, (origin + texel) / float2(width, height), 0).r;
+}
+
 float ShadowCalculation(float3 position, float viewDistance, uint index)
 {
 	const float3 gridSamplingDisk[20] = {
@@ -179,12 +252,10 @@ float ShadowCalculation(float3 position, float viewDistance, uint index)
 	float shadow = 0.0;
 	uint samples = 20;
 
-	float mapIndex = lights[index].Index - 1;
-
 	for (uint i = 0; i < samples; i++)
 	{
 		float closest = lights[index].FarPlane * 
-			pointShadowMaps.Sample(textureSampler, float4(fragToLight + gridSamplingDisk[i] * diskRadius, mapIndex)).r;
+			SampleShadowAtlas(lights[index], fragToLight + gridSamplingDisk[i] * diskRadius);
 		
 		if (current - bias > closest) shadow = shadow + 1.0;
 	}
@@ -192,6 +263,19 @@ float ShadowCalculation(float3 position, float viewDistance, uint index)
 	return shadow / float(samples);
 }
 
+uint ClusterIndex(float2 texCoord, float3 position)
+{
+	//the depth of slices grows exponentially, the same as the light cluster grid on CPU
+	float depth = -mul(float4(position, 1.0f), view.View[1]).z;
+	float slice = depth <= config.ZNear ? 0 : log(depth / config.ZNear) / log(config.ZFar / config.ZNear) * config.ClusterDepth;
+
+	uint x = min(uint(saturate(texCoord.x) * config.ClusterWidth), config.ClusterWidth - 1);
+	uint y = min(uint(saturate(texCoord.y) * config.ClusterHeight), config.ClusterHeight - 1);
+	uint z = min(uint(slice), config.ClusterDepth - 1);
+
+	return (z * config.ClusterHeight + y) * config.ClusterWidth + x;
+}
+
 struct Output {
 	float4 Color0 : SV_TARGET0;
 	float4 Color1 : SV_TARGET1;
@@ -225,10 +309,26 @@ Output main(
     
 	F0 = lerp(F0, material.BaseColor.xyz, material.Metallic.a);
     
-	[loop]
-	for (uint index = 0; index < config.Lights; index++)
+	if (config.ClusterDepth != 0)
+	{
+		//only the lights in the cluster of pixel can light it
+		LightCluster cluster = lightClusters[ClusterIndex(texCoord.xy, position)];
+
+		[loop]
+		for (uint index = 0; index < cluster.Count; index++)
+		{
+			uint light = lightIndices[cluster.Offset + index];
+
+			color = color + ComputePointLight(lights[light], material, position, normal, toEye, F0) * (1.0 - ShadowCalculation(position, viewDistance, light));
+		}
+	}
+	else 
 	{
-		color = color + ComputePointLight(lights[index], material, position, normal, toEye, F0) * (1.0 - ShadowCalculation(position, viewDistance, index));
+		[loop]
+		for (uint index = 0; index < config.Lights; index++)
+		{
+			color = color + ComputePointLight(lights[index], material, position, normal, toEye, F0) * (1.0 - ShadowCalculation(position, viewDistance, index));
+		}
 	}
 	
 	//ambient lighting with environment map
@@ -13,6 +13,11 @@ struct Config
     float EyePositionZ;
     uint MipLevels;
     uint Lights;
+    uint ClusterWidth;
+    uint ClusterHeight;
+    uint ClusterDepth;
+    float ZNear;
+    float ZFar;
 };
 
 struct Output
@@ -0,0 +1,47 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout (set = 0, binding = 0) buffer Transform
+{
+    mat4 Transform[];
+} transforms;
+
+layout (set = 0, binding = 1) uniform View
+{
+    mat4 View;
+} view;
+
+layout (push_constant) uniform Config
+{
+	vec4 Color;
+	uint Index;
+	float OffsetX;
+	float OffsetY;
+	float OffsetZ;
+	float ScaleX;
+	float ScaleY;
+	float ScaleZ;
+} config;
+
+layout (location = 0) in vec4 inPositionXY;
+layout (location = 1) in vec4 inPositionZW;
+
+//the packed properties are bound as 8 bits unorm, so we rebuild the bytes and combine them into 16 bits values
+uvec2 unpackWords(vec4 value)
+{
+	uvec4 bytes = uvec4(round(value * 255.0));
+
+	return bytes.xz | (bytes.yw << 8);
+}
+
+void main()
+{
+	uvec2 xy = unpackWords(inPositionXY);
+	uvec2 zw = unpackWords(inPositionZW);
+
+	vec3 position = vec3(config.OffsetX, config.OffsetY, config.OffsetZ) +
+		vec3(xy, zw.x) / 65535.0 * vec3(config.ScaleX, config.ScaleY, config.ScaleZ);
+
+    gl_Position = (transforms.Transform[config.Index] * vec4(position, 1.0));
+    gl_Position = (view.View * gl_Position);
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma pack_matrix(row_major)
+
+struct Transform
+{
+	matrix Transform;
+};
+
+struct View
+{
+	matrix View[4];
+};
+
+struct Config
+{
+    uint HasBaseColor;
+    uint HasRoughness;
+    uint HasOcclusion;
+    uint HasNormalMap;
+    uint HasMetallic;
+    uint HasEmissive;
+	uint HasBlurred;
+    uint Index;
+	float OffsetX;
+	float OffsetY;
+	float OffsetZ;
+	float ScaleX;
+	float ScaleY;
+	float ScaleZ;
+};
+
+struct Output
+{
+	float4 SVPosition : SV_POSITION;
+	float3 VPosition : POSITION0;
+	float3 Position : POSITION1;
+	float3 TexCoord : TEXCOORD;
+	float4 Tangent : TANGENT;
+	float3 Normal : NORMAL;
+};
+
+StructuredBuffer<Transform> transforms : register(t1);
+ConstantBuffer<View> view : register(b2);
+
+[[vk::push_constant]] ConstantBuffer<Config> config : register(b0, space2);
+
+//the packed properties are bound as 8 bits unorm, so we rebuild the bytes and combine them into 16 bits values
+uint2 unpackWords(float4 value)
+{
+	uint4 bytes = (uint4)round(value * 255.0f);
+
+	return bytes.xz | (bytes.yw << 8);
+}
+
+float3 decodePosition(float4 positionXY, float4 positionZW)
+{
+	uint2 xy = unpackWords(positionXY);
+	uint2 zw = unpackWords(positionZW);
+
+	return float3(config.OffsetX, config.OffsetY, config.OffsetZ) +
+		float3(xy, zw.x) / 65535.0f * float3(config.ScaleX, config.ScaleY, config.ScaleZ);
+}
+
+float3 decodeDirection(float4 value)
+{
+	int2 words = (int2)(unpackWords(value) ^ 0x8000) - 0x8000;
+
+	float2 octahedron = max(float2(words) / 32767.0f, -1.0f);
+	float3 direction = float3(octahedron, 1.0f - abs(octahedron.x) - abs(octahedron.y));
+	float fold = max(-direction.z, 0.0f);
+
+	direction.x += direction.x >= 0.0f ? -fold : fold;
+	direction.y += direction.y >= 0.0f ? -fold : fold;
+
+	return normalize(direction);
+}
+
+Output main(
+    float4 positionXY : POSITIONXY,
+	float4 positionZW : POSITIONZW,
+	float4 texCoord : TEXCOORD,
+    float4 tangent : TANGENT,
+    float4 normal : NORMAL)
+{
+	Output result;
+
+	float3 position = decodePosition(positionXY, positionZW);
+	
+	result.Position = mul(float4(position, 1.0f), transforms[config.Index].Transform).xyz;
+	result.VPosition = mul(float4(result.Position, 1.0f), view.View[1]).xyz;
+	result.SVPosition = mul(float4(result.VPosition, 1.0f), view.View[2]);
+	result.Normal = mul(decodeDirection(normal), (float3x3)transforms[config.Index].Transform); //no scale transform
+	result.Tangent = float4(mul(decodeDirection(tangent), (float3x3)transforms[config.Index].Transform), //no scale transform
+		unpackWords(positionZW).y >= 32768 ? 1.0f : -1.0f); //the handedness of tangent is in the w of position
+	result.TexCoord = float3(f16tof32(unpackWords(texCoord)), 0.0f);
+
+	return result;
+}
\ No newline at end of file
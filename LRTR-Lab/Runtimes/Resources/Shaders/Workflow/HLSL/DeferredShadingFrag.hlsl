@@ -61,15 +61,15 @@ float3 InverseGammaCorrect(float3 value)
 		InverseGammaCorrect(value.z));
 }
 
-float3 getNormal(float3 normal, float2 texcoord, float3 tangent)
+float3 getNormal(float3 normal, float2 texcoord, float4 tangent)
 {
     if (config.HasNormalMap == 0) return normal;
 
     float3 tangentNormal = normalMapTexture.Sample(materialSampler, texcoord).xyz * 2.0 - 1.0;
     
     float3 N = normalize(normal);
-    float3 T = normalize(tangent - dot(tangent, N) * N);
-    float3 B = cross(N, T);
+    float3 T = normalize(tangent.xyz - dot(tangent.xyz, N) * N);
+    float3 B = cross(N, T) * tangent.w; //the w is -1 if the texture coordinates are mirrored
     float3x3 TBN = float3x3(T, B, N);
 
     return mul(tangentNormal, TBN);
@@ -88,7 +88,7 @@ Output main(
     float3 vPosition : POSITION0,
 	float3 position : POSITION1,
 	float3 texCoord : TEXCOORD,
-	float3 tangent : TANGENT,
+	float4 tangent : TANGENT,
 	float3 normal : NORMAL)
 {
     Output result;
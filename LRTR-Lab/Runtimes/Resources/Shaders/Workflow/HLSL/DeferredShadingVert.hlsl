@@ -28,7 +28,7 @@ struct Output
 	float3 VPosition : POSITION0;
 	float3 Position : POSITION1;
 	float3 TexCoord : TEXCOORD;
-	float3 Tangent : TANGENT;
+	float4 Tangent : TANGENT;
 	float3 Normal : NORMAL;
 };
 
@@ -49,7 +49,7 @@ Output main(
 	result.VPosition = mul(float4(result.Position, 1.0f), view.View[1]).xyz;
 	result.SVPosition = mul(float4(result.VPosition, 1.0f), view.View[2]);
 	result.Normal = mul(normal, (float3x3)transforms[config.Index].Transform); //no scale transform
-	result.Tangent = mul(tangent, (float3x3)transforms[config.Index].Transform); //no scale transform
+	result.Tangent = float4(mul(tangent, (float3x3)transforms[config.Index].Transform), 1.0f); //no scale transform
 	result.TexCoord = texCoord;
 
 	return result;
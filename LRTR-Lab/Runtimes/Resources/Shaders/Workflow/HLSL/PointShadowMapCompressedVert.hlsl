@@ -0,0 +1,65 @@
+#pragma pack_matrix(row_major)
+
+struct Transform
+{
+	matrix Transform;
+};
+
+struct View
+{
+    matrix View[8];
+};
+
+struct Config
+{
+    uint face;
+    uint index;
+    float farPlane;
+    float positionX;
+    float positionY;
+    float positionZ;
+    float offsetX;
+    float offsetY;
+    float offsetZ;
+    float scaleX;
+    float scaleY;
+    float scaleZ;
+};
+
+struct Output
+{
+    float4 SVPosition : SV_POSITION;
+    float3 Position : POSITION;
+};
+
+ConstantBuffer<View> view : register(b0, space0);
+StructuredBuffer<Transform> transforms : register(t1, space0);
+
+[[vk::push_constant]] ConstantBuffer<Config> config : register(b0, space2);
+
+//the packed properties are bound as 8 bits unorm, so we rebuild the bytes and combine them into 16 bits values
+uint2 unpackWords(float4 value)
+{
+    uint4 bytes = (uint4)round(value * 255.0f);
+
+    return bytes.xz | (bytes.yw << 8);
+}
+
+Output main(
+    float4 positionXY : POSITIONXY,
+    float4 positionZW : POSITIONZW)
+{
+    Output result;
+
+    uint2 xy = unpackWords(positionXY);
+    uint2 zw = unpackWords(positionZW);
+
+    float3 position = float3(config.offsetX, config.offsetY, config.offsetZ) +
+        float3(xy, zw.x) / 65535.0f * float3(config.scaleX, config.scaleY, config.scaleZ);
+
+    result.Position = mul(float4(position, 1.0f), transforms[config.index].Transform).xyz;
+    result.SVPosition = mul(float4(result.Position, 1.0f), view.View[config.face]);
+    result.SVPosition.y = -result.SVPosition.y;
+
+    return result;
+}
\ No newline at end of file
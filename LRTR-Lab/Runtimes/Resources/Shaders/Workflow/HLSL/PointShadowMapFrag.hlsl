@@ -14,6 +14,8 @@ struct Config
 
 float main(float4 svPosition : SV_POSITION, float3 position : POSITION) : SV_DEPTH
 {
+    if (config.face >= 6) return 1.0f;
+
     float distance = length(position - float3(config.positionX, config.positionY, config.positionZ));
 
     return distance / config.farPlane;
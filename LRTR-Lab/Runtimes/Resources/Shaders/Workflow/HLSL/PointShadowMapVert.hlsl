@@ -35,6 +35,15 @@ Output main(float3 position : POSITION)
 {
     Output result;
 
+    //the face 6 means we clear the tile of face with a full quad in max depth
+    if (config.face >= 6)
+    {
+        result.Position = float3(0.0f, 0.0f, 0.0f);
+        result.SVPosition = float4(position.xy, 1.0f, 1.0f);
+
+        return result;
+    }
+
     result.Position = mul(float4(position, 1.0f), transforms[config.index].Transform).xyz;
     result.SVPosition = mul(float4(result.Position, 1.0f), view.View[config.face]);
     result.SVPosition.y = -result.SVPosition.y;
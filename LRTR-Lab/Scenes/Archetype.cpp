@@ -0,0 +1,241 @@
+#include "Archetype.hpp"
+
+#include "Shape.hpp"
+
+#include <cassert>
+
+LRTR::Archetype::Archetype(const ComponentSignature& signature) :
+	mSignature(signature), mColumns(signature.count())
+{
+	size_t column = 0;
+	
+	for (ComponentID id = 0; id < MaxComponentTypes; id++)
+		if (mSignature.test(id)) mColumnsIndex[id] = column++;
+}
+
+auto LRTR::Archetype::add(Shape* shape) -> size_t
+{
+	for (ComponentID id = 0; id < MaxComponentTypes; id++)
+		if (mSignature.test(id)) mColumns[mColumnsIndex[id]].push_back(shape->component(id).get());
+
+	mShapes.push_back(shape);
+
+	return mShapes.size() - 1;
+}
+
+auto LRTR::Archetype::remove(const size_t row) -> Shape*
+{
+	assert(row < mShapes.size());
+
+	const auto last = mShapes.size() - 1;
+
+	//swap the last one to the row we removed, so the columns are still packed
+	if (row != last) {
+		for (auto& column : mColumns) column[row] = column[last];
+
+		mShapes[row] = std::move(mShapes[last]);
+	}
+
+	for (auto& column : mColumns) column.pop_back();
+
+	mShapes.pop_back();
+
+	return row != last ? mShapes[row] : nullptr;
+}
+
+auto LRTR::Archetype::set(const size_t row, const ComponentID id, Component* component) -> bool
+{
+	assert(mSignature.test(id));
+
+	auto& current = mColumns[mColumnsIndex[id]][row];
+
+	if (current == component) return false;
+
+	current = component;
+
+	return true;
+}
+
+auto LRTR::Archetype::shapes() const noexcept -> const std::vector<Shape*>&
+{
+	return mShapes;
+}
+
+auto LRTR::Archetype::signature() const noexcept -> const ComponentSignature&
+{
+	return mSignature;
+}
+
+auto LRTR::Archetype::size() const noexcept -> size_t
+{
+	return mShapes.size();
+}
+
+auto LRTR::Archetype::empty() const noexcept -> bool
+{
+	return mShapes.empty();
+}
+
+LRTR::ArchetypeQuery::ArchetypeQuery(const ComponentSignature& signature) :
+	mSignature(signature)
+{
+}
+
+void LRTR::ArchetypeQuery::add(const std::shared_ptr<Archetype>& archetype)
+{
+	assert((archetype->signature() & mSignature) == mSignature);
+	
+	mArchetypes.push_back(archetype);
+}
+
+void LRTR::ArchetypeQuery::each(const std::function<void(const Archetype&)>& function) const
+{
+	for (const auto& archetype : mArchetypes) 
+		if (!archetype->empty()) function(*archetype);
+}
+
+void LRTR::ArchetypeQuery::parallelEach(
+	ThreadPool& threadPool, 
+	const size_t grain,
+	const std::function<void(const Archetype&, size_t, size_t)>& function) const
+{
+	for (const auto& archetype : mArchetypes) {
+		threadPool.parallelFor(archetype->size(), grain, [&](size_t begin, size_t end)
+			{
+				function(*archetype, begin, end);
+			});
+	}
+}
+
+void LRTR::ArchetypeQuery::eachShape(const std::function<void(Shape*)>& function) const
+{
+	for (const auto& archetype : mArchetypes)
+		for (const auto shape : archetype->shapes()) function(shape);
+}
+
+auto LRTR::ArchetypeQuery::archetypes() const noexcept -> const std::vector<std::shared_ptr<Archetype>>&
+{
+	return mArchetypes;
+}
+
+auto LRTR::ArchetypeQuery::signature() const noexcept -> const ComponentSignature&
+{
+	return mSignature;
+}
+
+auto LRTR::ArchetypeQuery::size() const noexcept -> size_t
+{
+	size_t size = 0;
+
+	for (const auto& archetype : mArchetypes) size = size + archetype->size();
+
+	return size;
+}
+
+LRTR::ArchetypeStorage::~ArchetypeStorage()
+{
+	//the shapes may live longer than the storage, so we need detach them
+	for (const auto& location : mLocations)
+		location.second.Owner->shapes()[location.second.Row]->mStorage = nullptr;
+}
+
+void LRTR::ArchetypeStorage::add(Shape* shape)
+{
+	assert(mLocations.find(shape->identity()) == mLocations.end());
+
+	const auto owner = archetype(shape->signature());
+
+	mLocations.insert({ shape->identity(), { owner, owner->add(shape) } });
+
+	shape->mStorage = this;
+
+	mVersion++;
+}
+
+void LRTR::ArchetypeStorage::remove(const Identity& identity)
+{
+	if (mLocations.find(identity) == mLocations.end()) return;
+
+	const auto location = mLocations.at(identity);
+
+	location.Owner->shapes()[location.Row]->mStorage = nullptr;
+
+	const auto moved = location.Owner->remove(location.Row);
+
+	if (moved != nullptr) mLocations.at(moved->identity()).Row = location.Row;
+
+	mLocations.erase(identity);
+
+	mVersion++;
+}
+
+void LRTR::ArchetypeStorage::refresh(const Shape& shape)
+{
+	if (mLocations.find(shape.identity()) == mLocations.end()) return;
+
+	const auto location = mLocations.at(shape.identity());
+	const auto& signature = shape.signature();
+
+	//the signature is not changed, but the component may be replaced
+	//the version is only changed if it is replaced, so the caches keyed by version are not rebuilt every time
+	if (location.Owner->signature() == signature) {
+		auto replaced = false;
+
+		for (ComponentID id = 0; id < MaxComponentTypes; id++)
+			if (signature.test(id) && location.Owner->set(location.Row, id, shape.component(id).get())) replaced = true;
+
+		if (replaced) mVersion++;
+
+		return;
+	}
+
+	//the shape is moved to another archetype, remove and add will change the version
+	const auto instance = location.Owner->shapes()[location.Row];
+
+	remove(shape.identity());
+	add(instance);
+}
+
+auto LRTR::ArchetypeStorage::archetypes() const noexcept -> const Group<ComponentSignature, std::shared_ptr<Archetype>>&
+{
+	return mArchetypes;
+}
+
+auto LRTR::ArchetypeStorage::version() const noexcept -> size_t
+{
+	return mVersion;
+}
+
+auto LRTR::ArchetypeStorage::query(const ComponentSignature& signature) const -> const ArchetypeQuery&
+{
+	std::lock_guard<std::mutex> lock(mQueriesMutex);
+
+	const auto it = mQueries.find(signature);
+
+	if (it != mQueries.end()) return *it->second;
+
+	const auto instance = std::make_shared<ArchetypeQuery>(signature);
+
+	//the archetypes created before the query also need to be matched
+	for (const auto& archetype : mArchetypes)
+		if ((archetype.first & signature) == signature) instance->add(archetype.second);
+
+	return *(mQueries[signature] = instance);
+}
+
+auto LRTR::ArchetypeStorage::archetype(const ComponentSignature& signature) -> std::shared_ptr<Archetype>
+{
+	const auto it = mArchetypes.find(signature);
+
+	if (it != mArchetypes.end()) return it->second;
+
+	const auto instance = std::make_shared<Archetype>(signature);
+
+	//update the queries that match the new archetype
+	std::lock_guard<std::mutex> lock(mQueriesMutex);
+	
+	for (const auto& query : mQueries)
+		if ((signature & query.first) == query.first) query.second->add(instance);
+	
+	return mArchetypes[signature] = instance;
+}
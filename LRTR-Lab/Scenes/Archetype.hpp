@@ -0,0 +1,172 @@
+#pragma once
+
+#include "../Shared/Parallel/ThreadPool.hpp"
+#include "../Shared/Accelerators/Group.hpp"
+#include "../Core/Noncopyable.hpp"
+#include "Component.hpp"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cassert>
+#include <array>
+
+namespace LRTR {
+
+	class Shape;
+
+	//an archetype stores all shapes that have the same signature
+	//the components of one type are packed in one column, so the row of a shape
+	//is the index of it in all columns, systems can scan the columns linearly
+	//the shapes own the components, the columns only keep the pointers so scanning them does not touch reference counts
+	//the components created by makeComponent are in the blocks of their type, so the pointers are mostly sequential
+	class Archetype : public Noncopyable {
+	public:
+		explicit Archetype(const ComponentSignature& signature);
+
+		~Archetype() = default;
+
+		auto add(Shape* shape) -> size_t;
+
+		//remove the shape at row, the last shape will be moved to the row
+		//return the shape moved to the row, nullptr if the row is the last one
+		auto remove(const size_t row) -> Shape*;
+
+		//return true if the component in the row is replaced
+		auto set(const size_t row, const ComponentID id, Component* component) -> bool;
+
+		auto shapes() const noexcept -> const std::vector<Shape*>&;
+
+		auto signature() const noexcept -> const ComponentSignature&;
+
+		auto size() const noexcept -> size_t;
+
+		auto empty() const noexcept -> bool;
+
+		template<typename TComponent>
+		auto has() const -> bool;
+
+		template<typename TComponent>
+		auto column() const -> const std::vector<Component*>&;
+
+		template<typename TComponent>
+		auto get(const size_t row) const -> TComponent*;
+	private:
+		ComponentSignature mSignature;
+
+		//the shapes are owned by scene, so we do not hold the references of them
+		std::vector<Shape*> mShapes;
+		std::vector<std::vector<Component*>> mColumns;
+
+		//the index of column for each component id
+		std::array<size_t, MaxComponentTypes> mColumnsIndex = {};
+	};
+
+	//the query caches the archetypes that have all components of signature
+	//the storage adds new archetypes to the query when they are created
+	//so the systems only iterate the shapes they need
+	class ArchetypeQuery : public Noncopyable {
+	public:
+		explicit ArchetypeQuery(const ComponentSignature& signature);
+
+		~ArchetypeQuery() = default;
+
+		void add(const std::shared_ptr<Archetype>& archetype);
+
+		//call the function for all matched archetypes that are not empty
+		void each(const std::function<void(const Archetype&)>& function) const;
+
+		//split the rows of matched archetypes into chunks and call the function in thread pool
+		//the function will be called with [begin, end) rows of archetype
+		void parallelEach(
+			ThreadPool& threadPool,
+			const size_t grain,
+			const std::function<void(const Archetype&, size_t, size_t)>& function) const;
+		
+		//call the function for all matched shapes
+		void eachShape(const std::function<void(Shape*)>& function) const;
+		
+		auto archetypes() const noexcept -> const std::vector<std::shared_ptr<Archetype>>&;
+
+		auto signature() const noexcept -> const ComponentSignature&;
+
+		//the number of matched shapes
+		auto size() const noexcept -> size_t;
+	private:
+		ComponentSignature mSignature;
+
+		std::vector<std::shared_ptr<Archetype>> mArchetypes;
+	};
+	
+	//the archetype storage is owned by scene, it groups the shapes by signature
+	//and moves the shape to another archetype when the components of shape changed
+	class ArchetypeStorage : public Noncopyable {
+	public:
+		ArchetypeStorage() = default;
+
+		~ArchetypeStorage();
+
+		void add(Shape* shape);
+
+		void remove(const Identity& identity);
+
+		void refresh(const Shape& shape);
+
+		//call the function for all archetypes that have all TComponents
+		template<typename... TComponents>
+		void each(const std::function<void(const Archetype&)>& function) const;
+
+		//get the cached query of signature, the query is created when we first use it
+		auto query(const ComponentSignature& signature) const -> const ArchetypeQuery&;
+
+		auto archetypes() const noexcept -> const Group<ComponentSignature, std::shared_ptr<Archetype>>&;
+
+		//the version is changed when shapes are added, removed or their components are changed
+		auto version() const noexcept -> size_t;
+	private:
+		auto archetype(const ComponentSignature& signature) -> std::shared_ptr<Archetype>;
+	private:
+		struct Location {
+			std::shared_ptr<Archetype> Owner;
+			size_t Row = 0;
+		};
+
+		Group<ComponentSignature, std::shared_ptr<Archetype>> mArchetypes;
+
+		Group<Identity, Location> mLocations;
+
+		size_t mVersion = 0;
+
+		//the queries may be created by systems during update, so we need a lock
+		mutable Group<ComponentSignature, std::shared_ptr<ArchetypeQuery>> mQueries;
+		mutable std::mutex mQueriesMutex;
+	};
+
+	template <typename TComponent>
+	auto Archetype::has() const -> bool
+	{
+		return mSignature.test(ComponentType<TComponent>::id());
+	}
+
+	template <typename TComponent>
+	auto Archetype::column() const -> const std::vector<Component*>&
+	{
+		assert(has<TComponent>());
+
+		return mColumns[mColumnsIndex[ComponentType<TComponent>::id()]];
+	}
+
+	template <typename TComponent>
+	auto Archetype::get(const size_t row) const -> TComponent*
+	{
+		//the component in column is stored with the type TComponent, so static cast is safe
+		return static_cast<TComponent*>(column<TComponent>()[row]);
+	}
+
+	template <typename ... TComponents>
+	void ArchetypeStorage::each(const std::function<void(const Archetype&)>& function) const
+	{
+		query(signatureOf<TComponents...>()).each(function);
+	}
+}
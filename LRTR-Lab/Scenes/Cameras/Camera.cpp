@@ -1,6 +1,6 @@
 #include "Camera.hpp"
 
-LRTR::Camera::Camera() : Camera(std::make_shared<TransformWrap>())
+LRTR::Camera::Camera() : Camera(makeComponent<TransformWrap>())
 {
 }
 
@@ -39,8 +39,8 @@ auto LRTR::ProjectiveCamera::typeIndex() const noexcept -> std::type_index
 
 LRTR::PerspectiveCamera::PerspectiveCamera() :
 	PerspectiveCamera(
-		std::make_shared<TransformWrap>(),
-		std::make_shared<Perspective>())
+		makeComponent<TransformWrap>(),
+		makeComponent<Perspective>())
 {
 }
 
@@ -9,3 +9,12 @@ auto LRTR::Component::typeIndex() const noexcept -> std::type_index
 {
 	return typeid(Component);
 }
+
+auto LRTR::ComponentTypes::allocate() -> ComponentID
+{
+	const auto id = mCount++;
+
+	LRTR_ERROR_IF(id >= MaxComponentTypes, "the number of component types is out of range.");
+	
+	return id;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../Shared/Allocators/BlockAllocator.hpp"
 #include "../Shared/Accelerators/Group.hpp"
 
 #include "../Core/Propertyable.hpp"
@@ -10,8 +11,18 @@
 #include <type_traits>
 #include <typeindex>
 #include <string>
+#include <bitset>
+#include <atomic>
+#include <memory>
 
 namespace LRTR {
+
+	//the max number of component types, the signature of shape is a bitset with this size
+	constexpr size_t MaxComponentTypes = 64;
+
+	//the dense id of component type, it is the index of bit in signature
+	using ComponentID = size_t;
+	using ComponentSignature = std::bitset<MaxComponentTypes>;
 	
 	class Component : public Noncopyable, public Propertyable, public TypeInfo {
 	public:
@@ -28,4 +39,46 @@ namespace LRTR {
 
 	template<typename Type>
 	using IsComponent = std::is_base_of<Component, Type>;
+
+	class ComponentTypes {
+	public:
+		//allocate a new dense id, the ids are allocated from zero
+		static auto allocate() -> ComponentID;
+	private:
+		static inline std::atomic<ComponentID> mCount = 0;
+	};
+
+	template<typename TComponent>
+	class ComponentType {
+	public:
+		//the id is allocated when we first use the type, so the ids are dense
+		static auto id() -> ComponentID
+		{
+			static_assert(IsComponent<TComponent>::value, "The Component should be based of Component.");
+
+			static const auto id = ComponentTypes::allocate();
+
+			return id;
+		}
+	};
+
+	//create the component in the blocks of its type, so the components of one type are packed together
+	//the shapes and archetypes only keep the pointers of them, the shared pointer is the owner of component
+	template<typename TComponent, typename... Args>
+	auto makeComponent(Args&&... args) -> std::shared_ptr<TComponent>
+	{
+		static_assert(IsComponent<TComponent>::value, "The Component should be based of Component.");
+
+		return std::allocate_shared<TComponent>(BlockAllocatorAdapter<TComponent>(), std::forward<Args>(args)...);
+	}
+
+	template<typename... TComponents>
+	auto signatureOf() -> ComponentSignature
+	{
+		auto signature = ComponentSignature();
+
+		(signature.set(ComponentType<TComponents>::id()), ...);
+
+		return signature;
+	}
 }
@@ -3,31 +3,35 @@
 #include "../Components/CollectionLabel.hpp"
 #include "../../Extensions/ImGui/ImGui.hpp"
 
-#include "../Shape.hpp"
+#include <algorithm>
 
+LRTR::CameraGroup::CameraGroup(const ShapeSlotMap& shapes) :
+	mShapes(&shapes)
+{
+}
 
-void LRTR::CameraGroup::addCamera(const std::shared_ptr<Shape>& shape)
+void LRTR::CameraGroup::addCamera(const ShapeHandle& handle)
 {
-	if (mCameras.empty()) mCurrent = shape->identity();
+	if (mCameras.empty()) mCurrent = handle;
 	
-	mCameras.insert({ shape->identity(), shape });
+	mCameras.push_back(handle);
 }
 
-void LRTR::CameraGroup::removeCamera(const Identity& identity)
+void LRTR::CameraGroup::removeCamera(const ShapeHandle& handle)
 {
-	mCameras.erase(identity);
+	mCameras.erase(std::remove(mCameras.begin(), mCameras.end(), handle), mCameras.end());
 
-	if (mCameras.empty()) mCurrent = std::numeric_limits<Identity>::max();
+	if (mCurrent == handle) mCurrent = mCameras.empty() ? ShapeHandle() : mCameras.front();
 }
 
-auto LRTR::CameraGroup::cameras() const noexcept -> const Group<Identity, std::shared_ptr<Shape>>& 
+auto LRTR::CameraGroup::cameras() const noexcept -> const std::vector<ShapeHandle>& 
 {
 	return mCameras;
 }
 
-auto LRTR::CameraGroup::current() const noexcept -> std::shared_ptr<Shape>
+auto LRTR::CameraGroup::current() const noexcept -> ShapeHandle
 {
-	return mCurrent == std::numeric_limits<Identity>::max() ? nullptr : mCameras.at(mCurrent);
+	return mCurrent;
 }
 
 auto LRTR::CameraGroup::typeName() const noexcept -> std::string
@@ -46,20 +50,15 @@ void LRTR::CameraGroup::onProperty()
 
 	ImGui::Property("Camera", [&]()
 		{
-			const auto currentName = mCurrent == std::numeric_limits<Identity>::max() ? "Empty" :
-				(current()->hasComponent<CollectionLabel>() ?
-					current()->component<CollectionLabel>()->name() :
-					"Unknown");
+			const auto currentName = mCurrent.valid() ? cameraName(mCurrent) : "Empty";
 		
 			if (ImGui::BeginCombo("##Camera", currentName.c_str())) {
 				for (const auto& camera : mCameras) {
-					const auto selected = (mCurrent == camera.first);
-					const auto name = camera.second->hasComponent<CollectionLabel>() ?
-						camera.second->component<CollectionLabel>()->name() :
-						"Unknown";
+					const auto selected = (mCurrent == camera);
+					const auto name = cameraName(camera);
 					
 					if (ImGui::Selectable(name.c_str(), selected))
-						mCurrent = camera.first;
+						mCurrent = camera;
 					
 					if (selected) ImGui::SetItemDefaultFocus();
 				}
@@ -69,3 +68,12 @@ void LRTR::CameraGroup::onProperty()
 
 	ImGui::EndPropertyTable();
 }
+
+auto LRTR::CameraGroup::cameraName(const ShapeHandle& handle) const -> std::string
+{
+	const auto camera = mShapes->get(handle);
+
+	return camera != nullptr && (*camera)->hasComponent<CollectionLabel>() ?
+		(*camera)->component<CollectionLabel>()->name() :
+		"Unknown";
+}
@@ -2,24 +2,25 @@
 
 #include "../../Shared/Accelerators/Group.hpp"
 #include "../Component.hpp"
+#include "../Shape.hpp"
 
 namespace LRTR {
 
-	class Shape;
-	
 	class CameraGroup : public Component {
 	public:
-		CameraGroup() = default;
+		//the shapes of scene, we use it to find the cameras with handles
+		explicit CameraGroup(const ShapeSlotMap& shapes);
 
 		~CameraGroup() = default;
 
-		void addCamera(const std::shared_ptr<Shape>& shape);
+		void addCamera(const ShapeHandle& handle);
 
-		void removeCamera(const Identity& identity);
+		void removeCamera(const ShapeHandle& handle);
 
-		auto cameras() const noexcept -> const Group<Identity, std::shared_ptr<Shape>>&;
+		auto cameras() const noexcept -> const std::vector<ShapeHandle>&;
 
-		auto current() const noexcept -> std::shared_ptr<Shape>;
+		//the handle of current camera, it is not valid if there is no camera
+		auto current() const noexcept -> ShapeHandle;
 
 		auto typeName() const noexcept -> std::string override;
 
@@ -27,9 +28,13 @@ namespace LRTR {
 	protected:
 		void onProperty() override;
 	private:
-		Group<Identity, std::shared_ptr<Shape>> mCameras;
+		auto cameraName(const ShapeHandle& handle) const -> std::string;
+	private:
+		const ShapeSlotMap* mShapes = nullptr;
+		
+		std::vector<ShapeHandle> mCameras;
 
-		Identity mCurrent;
+		ShapeHandle mCurrent;
 	};
 	
-}
\ No newline at end of file
+}
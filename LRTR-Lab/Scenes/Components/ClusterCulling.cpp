@@ -0,0 +1,29 @@
+#include "ClusterCulling.hpp"
+
+#include "../../Extensions/ImGui/ImGui.hpp"
+
+auto LRTR::ClusterCulling::typeName() const noexcept -> std::string
+{
+	return "ClusterCulling";
+}
+
+auto LRTR::ClusterCulling::typeIndex() const noexcept -> std::type_index
+{
+	return typeid(ClusterCulling);
+}
+
+void LRTR::ClusterCulling::onProperty()
+{
+	ImGui::BeginPropertyTable("ClusterCulling");
+	ImGui::Property("Enable", [&]() { ImGui::Checkbox("##Enable", &IsEnabled); });
+	ImGui::Property("Cone", [&]() { ImGui::Checkbox("##Cone", &IsConeCulled); });
+	ImGui::Property("Occlusion", [&]() { ImGui::Checkbox("##Occlusion", &IsOcclusionCulled); });
+	ImGui::Property("Clusters", [&]() { ImGui::Text("%zu", Clusters); });
+	ImGui::Property("Frustum Culled", [&]() { ImGui::Text("%zu", FrustumCulled); });
+	ImGui::Property("Back Facing", [&]() { ImGui::Text("%zu", BackFacing); });
+	ImGui::Property("Occluded", [&]() { ImGui::Text("%zu", Occluded); });
+	ImGui::Property("Ranges", [&]() { ImGui::Text("%zu", Ranges); });
+	ImGui::Property("Shadow Clusters", [&]() { ImGui::Text("%zu", ShadowClusters); });
+	ImGui::Property("Shadow Culled", [&]() { ImGui::Text("%zu", ShadowCulled); });
+	ImGui::EndPropertyTable();
+}
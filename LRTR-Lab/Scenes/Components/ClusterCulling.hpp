@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../Component.hpp"
+
+namespace LRTR {
+
+	//the setting and statistics of cluster culling in last frame, it is a component of scene property
+	//the render systems test the meshlets of visible meshes and only draw the index ranges of visible meshlets
+	//the cone culling assumes the triangles are wound outward, so it can be disabled for the meshes that are not
+	class ClusterCulling : public Component {
+	public:
+		ClusterCulling() = default;
+
+		~ClusterCulling() = default;
+
+		auto typeName() const noexcept -> std::string override;
+
+		auto typeIndex() const noexcept -> std::type_index override;
+	protected:
+		void onProperty() override;
+	public:
+		bool IsEnabled = true;
+		bool IsConeCulled = true;
+		bool IsOcclusionCulled = true;
+
+		//the meshlets of camera view, the culled ones are counted by the first test that culls them
+		size_t Clusters = 0;
+		size_t FrustumCulled = 0;
+		size_t BackFacing = 0;
+		size_t Occluded = 0;
+		size_t Ranges = 0;
+
+		//the meshlets of shadow faces rendered in last frame
+		size_t ShadowClusters = 0;
+		size_t ShadowCulled = 0;
+	};
+	
+}
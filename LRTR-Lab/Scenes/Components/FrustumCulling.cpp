@@ -0,0 +1,23 @@
+#include "FrustumCulling.hpp"
+
+#include "../../Extensions/ImGui/ImGui.hpp"
+
+auto LRTR::FrustumCulling::typeName() const noexcept -> std::string
+{
+	return "FrustumCulling";
+}
+
+auto LRTR::FrustumCulling::typeIndex() const noexcept -> std::type_index
+{
+	return typeid(FrustumCulling);
+}
+
+void LRTR::FrustumCulling::onProperty()
+{
+	ImGui::BeginPropertyTable("Culling");
+	ImGui::Property("Enable", [&]() { ImGui::Checkbox("##Enable", &IsEnabled); });
+	ImGui::Property("Tested", [&]() { ImGui::Text("%zu", Tested); });
+	ImGui::Property("Culled", [&]() { ImGui::Text("%zu", Culled); });
+	ImGui::Property("Visible", [&]() { ImGui::Text("%zu", Visible); });
+	ImGui::EndPropertyTable();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "../Component.hpp"
+
+namespace LRTR {
+
+	//the setting and statistics of frustum culling in last frame, it is a component of scene property
+	//the render systems only emit the draw calls of shapes whose world bound intersects the camera frustum
+	class FrustumCulling : public Component {
+	public:
+		FrustumCulling() = default;
+
+		~FrustumCulling() = default;
+
+		auto typeName() const noexcept -> std::string override;
+
+		auto typeIndex() const noexcept -> std::type_index override;
+	protected:
+		void onProperty() override;
+	public:
+		bool IsEnabled = true;
+
+		size_t Tested = 0;
+		size_t Culled = 0;
+		size_t Visible = 0;
+	};
+	
+}
@@ -0,0 +1,23 @@
+#include "LevelOfDetail.hpp"
+
+#include "../../Extensions/ImGui/ImGui.hpp"
+
+auto LRTR::LevelOfDetail::typeName() const noexcept -> std::string
+{
+	return "LevelOfDetail";
+}
+
+auto LRTR::LevelOfDetail::typeIndex() const noexcept -> std::type_index
+{
+	return typeid(LevelOfDetail);
+}
+
+void LRTR::LevelOfDetail::onProperty()
+{
+	ImGui::BeginPropertyTable("LevelOfDetail");
+	ImGui::Property("Enable", [&]() { ImGui::Checkbox("##Enable", &IsEnabled); });
+	ImGui::Property("Pixel Error", [&]() { ImGui::InputFloat("##PixelError", &MaxPixelError); });
+	ImGui::Property("Triangles", [&]() { ImGui::Text("%zu", Triangles); });
+	ImGui::Property("Full Triangles", [&]() { ImGui::Text("%zu", FullTriangles); });
+	ImGui::EndPropertyTable();
+}
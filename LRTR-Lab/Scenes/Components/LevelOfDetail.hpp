@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../Component.hpp"
+
+namespace LRTR {
+
+	//the setting and statistics of level of detail in last frame, it is a component of scene property
+	//the render systems draw the coarsest level of mesh whose error on screen is not larger than max pixel error
+	class LevelOfDetail : public Component {
+	public:
+		LevelOfDetail() = default;
+
+		~LevelOfDetail() = default;
+
+		auto typeName() const noexcept -> std::string override;
+
+		auto typeIndex() const noexcept -> std::type_index override;
+	protected:
+		void onProperty() override;
+	public:
+		bool IsEnabled = true;
+
+		float MaxPixelError = 1.0f;
+
+		//the triangles we draw and the triangles we draw if we always use level 0
+		size_t Triangles = 0;
+		size_t FullTriangles = 0;
+	};
+	
+}
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "../../../Shared/Math/Math.hpp"
+#include "../../../Core/Versionable.hpp"
 #include "../../../Core/Shadowable.hpp"
 
 #include "../../Component.hpp"
 
 namespace LRTR {
 
-	class LightSource : public Component, public Shadowable {
+	class LightSource : public Component, public Shadowable, public Versionable {
 	public:
 		explicit LightSource(const Vector3f& intensity) :
 			mIntensity(intensity) {}
@@ -2,6 +2,13 @@
 
 #include "../../../Extensions/ImGui/ImGui.hpp"
 
+namespace LRTR {
+
+	//the irradiance we treat as zero, the shader fades the light to zero at the range
+	constexpr float IrradianceCutoff = 0.01f;
+	
+}
+
 LRTR::PointLightSource::PointLightSource(const Vector3f& intensity) :
 	LightSource(intensity)
 {
@@ -12,6 +19,14 @@ auto LRTR::PointLightSource::intensity() const noexcept -> Vector3f
 	return mIntensity;
 }
 
+auto LRTR::PointLightSource::range() const noexcept -> float
+{
+	//the irradiance is intensity / (distance * distance)
+	const auto intensity = MathUtility::max(mIntensity.x, MathUtility::max(mIntensity.y, mIntensity.z));
+
+	return std::sqrt(MathUtility::max(intensity, 0.0f) / IrradianceCutoff);
+}
+
 auto LRTR::PointLightSource::typeName() const noexcept -> std::string
 {
 	return "PointLight";
@@ -24,6 +39,9 @@ auto LRTR::PointLightSource::typeIndex() const noexcept -> std::type_index
 
 void LRTR::PointLightSource::onProperty()
 {
+	const auto lastIntensity = mIntensity;
+	const auto lastShadowed = IsShadowed;
+	
 	ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0, 0, 0, 0.1f));
 	
 	ImGui::BeginPropertyTable("Intensity");
@@ -36,4 +54,6 @@ void LRTR::PointLightSource::onProperty()
 	ImGui::EndPropertyTable();
 
 	ImGui::PopStyleColor();
+
+	if (lastIntensity != mIntensity || lastShadowed != IsShadowed) updateVersion();
 }
@@ -9,6 +9,10 @@ namespace LRTR {
 		explicit PointLightSource(const Vector3f& intensity);
 
 		auto intensity() const noexcept -> Vector3f;
+
+		//the distance where the irradiance of light falls below the cutoff
+		//the shapes out of the range are not lit by the light
+		auto range() const noexcept -> float;
 		
 		auto typeName() const noexcept -> std::string override;
 
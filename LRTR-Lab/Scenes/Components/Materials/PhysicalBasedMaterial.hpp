@@ -3,13 +3,16 @@
 #include "../../../Shared/Textures/ConstantTexture.hpp"
 #include "../../../Shared/Textures/ImageTexture.hpp"
 
+#include "../../../Core/Versionable.hpp"
 #include "../../../Core/Shadowable.hpp"
 
 #include "Material.hpp"
 
 namespace LRTR {
 
-	class PhysicalBasedMaterial : public Material, public Shadowable {
+	//the version of material is changed when the factors or textures are changed
+	//the visibility, shadow cast and blur are not stored in gpu buffers, so they do not change version
+	class PhysicalBasedMaterial : public Material, public Shadowable, public Versionable {
 	public:
 		explicit PhysicalBasedMaterial();
 
@@ -59,6 +59,8 @@ LRTR::BoxMesh::BoxMesh(const float width, const float height, const float depth)
 		16, 17, 18, 16, 18, 19,
 		20, 21, 22, 20, 22, 23
 	};
+
+	updateBound();
 }
 
 auto LRTR::BoxMesh::typeName() const noexcept -> std::string
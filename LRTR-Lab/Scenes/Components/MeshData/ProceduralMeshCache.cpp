@@ -0,0 +1,91 @@
+#include "ProceduralMeshCache.hpp"
+
+#include <cstring>
+
+namespace LRTR {
+
+	//the key uses the bits of parameters, so the parameters are equal only if they are the same float
+	template<typename... Args>
+	auto proceduralMeshKey(const std::string& generator, Args... args) -> std::string
+	{
+		auto key = generator;
+
+		const auto append = [&](auto value)
+		{
+			unsigned bits = 0;
+
+			static_assert(sizeof(value) == sizeof(bits), "The parameter should be 32 bits.");
+
+			std::memcpy(&bits, &value, sizeof(bits));
+
+			key = key + " " + std::to_string(bits);
+		};
+
+		(append(args), ...);
+
+		return key;
+	}
+	
+}
+
+template <typename TMesh, typename ... Args>
+auto LRTR::ProceduralMeshCache::get(const std::string& key, Args... args) -> std::shared_ptr<const TMesh>
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	const auto it = mMeshes.find(key);
+
+	if (it != mMeshes.end()) {
+		if (const auto mesh = it->second.lock(); mesh != nullptr) return std::static_pointer_cast<const TMesh>(mesh);
+	}
+
+	//the meshes destroyed are removed before we insert, so the cache does not grow with the keys used once
+	trimExpired();
+
+	const auto mesh = makeComponent<TMesh>(args...);
+
+	mMeshes[key] = mesh;
+
+	return mesh;
+}
+
+auto LRTR::ProceduralMeshCache::sphere(const float radius, const int slice, const int stack) -> std::shared_ptr<const SphereMesh>
+{
+	return get<SphereMesh>(proceduralMeshKey("SphereMesh", radius, slice, stack), radius, slice, stack);
+}
+
+auto LRTR::ProceduralMeshCache::box(const float width, const float height, const float depth) -> std::shared_ptr<const BoxMesh>
+{
+	return get<BoxMesh>(proceduralMeshKey("BoxMesh", width, height, depth), width, height, depth);
+}
+
+auto LRTR::ProceduralMeshCache::quad(const float width, const float height) -> std::shared_ptr<const QuadMesh>
+{
+	return get<QuadMesh>(proceduralMeshKey("QuadMesh", width, height), width, height);
+}
+
+void LRTR::ProceduralMeshCache::trim()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	trimExpired();
+}
+
+auto LRTR::ProceduralMeshCache::size() -> size_t
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	size_t count = 0;
+
+	for (const auto& mesh : mMeshes) if (!mesh.second.expired()) count++;
+
+	return count;
+}
+
+void LRTR::ProceduralMeshCache::trimExpired()
+{
+	for (auto it = mMeshes.begin(); it != mMeshes.end();) {
+		if (it->second.expired()) it = mMeshes.erase(it);
+		else ++it;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "SphereMesh.hpp"
+#include "QuadMesh.hpp"
+#include "BoxMesh.hpp"
+
+#include <memory>
+#include <mutex>
+
+namespace LRTR {
+
+	//the procedural meshes are keyed by their generator and parameters, the same key returns the same mesh
+	//so the shapes with same primitive share one mesh and the mesh data asset component uploads it once
+	//the meshes are shared by shapes, so they are returned as const and must not be changed after they are created
+	//the cache only holds weak references, the mesh is destroyed when the last shape using it is destroyed
+	class ProceduralMeshCache {
+	public:
+		static auto sphere(const float radius, const int slice = 32, const int stack = 32) -> std::shared_ptr<const SphereMesh>;
+
+		static auto box(const float width, const float height, const float depth) -> std::shared_ptr<const BoxMesh>;
+
+		static auto quad(const float width, const float height) -> std::shared_ptr<const QuadMesh>;
+
+		//remove the keys whose meshes are destroyed, the keys are also removed when new meshes are inserted
+		static void trim();
+
+		//the number of meshes in cache that are still alive
+		static auto size() -> size_t;
+	private:
+		template<typename TMesh, typename... Args>
+		static auto get(const std::string& key, Args... args) -> std::shared_ptr<const TMesh>;
+
+		static void trimExpired();
+	private:
+		static inline std::mutex mMutex;
+
+		static inline StringGroup<std::weak_ptr<TrianglesMesh>> mMeshes;
+	};
+	
+}
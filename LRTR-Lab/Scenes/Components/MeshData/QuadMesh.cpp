@@ -33,6 +33,8 @@ LRTR::QuadMesh::QuadMesh(const float width, const float height) :
 	};
 	
 	mTangents = std::vector<Vector3f>(4);
+
+	updateBound();
 }
 
 auto LRTR::QuadMesh::typeName() const noexcept -> std::string
@@ -1,48 +1,86 @@
 #include "SphereMesh.hpp"
 
+#include <cmath>
+
 LRTR::SphereMesh::SphereMesh(const float radius, const int slice, const int stack) :
 	mRadius(radius)
 {
-	mPositions.push_back(Vector3f(0.0f, +mRadius, 0.0f));
-	mTexCoords.push_back(Vector3f(0.0f, 0.0f, 0.0f));
-	mTangents.push_back(Vector3f(0.0f, 0.0f, 0.0f));
-	mNormals.push_back(Vector3f(0.0f, +1.0f, 0.0f));
-
 	const auto phiStep = MathUtility::pi<float>() / stack;
 	const auto thetaStep = MathUtility::two_pi<float>() / slice;
 
+	const auto ringVertexCount = static_cast<size_t>(slice) + 1;
+	const auto vertexCount = (static_cast<size_t>(stack) - 1) * ringVertexCount + 2;
+
+	mPositions.resize(vertexCount);
+	mTexCoords.resize(vertexCount);
+	mTangents.resize(vertexCount);
+	mNormals.resize(vertexCount);
+
+	mPositions.front() = Vector3f(0.0f, +mRadius, 0.0f);
+	mTexCoords.front() = Vector3f(0.0f, 0.0f, 0.0f);
+	mTangents.front() = Vector3f(0.0f, 0.0f, 0.0f);
+	mNormals.front() = Vector3f(0.0f, +1.0f, 0.0f);
+
+	//the sine and cosine of theta are same for all rings, so we compute them once
+	//the next angle is the rotation of last angle by step, so we do not call sine and cosine for each vertex
+	//the recurrence is in double, so its error is far less than the precision of float
+	std::vector<float> sinTheta(ringVertexCount);
+	std::vector<float> cosTheta(ringVertexCount);
+
+	const auto rotate = [](double& sin, double& cos, const double stepSin, const double stepCos)
+	{
+		const auto next = cos * stepCos - sin * stepSin;
+
+		sin = sin * stepCos + cos * stepSin;
+		cos = next;
+	};
+
+	{
+		const auto stepSin = std::sin(static_cast<double>(thetaStep));
+		const auto stepCos = std::cos(static_cast<double>(thetaStep));
+
+		auto sin = 0.0, cos = 1.0;
+
+		for (size_t index = 0; index < ringVertexCount; index++) {
+			sinTheta[index] = static_cast<float>(sin);
+			cosTheta[index] = static_cast<float>(cos);
+
+			rotate(sin, cos, stepSin, stepCos);
+		}
+	}
+
+	const auto stepSinPhi = std::sin(static_cast<double>(phiStep));
+	const auto stepCosPhi = std::cos(static_cast<double>(phiStep));
+
+	auto sinPhi = stepSinPhi, cosPhi = stepCosPhi;
+
 	for (size_t index0 = 1; index0 < stack; index0++) {
-		const auto phi = index0 * phiStep;
-
-		for (size_t index1 = 0; index1 <= slice; index1++) {
-			const auto theta = index1 * thetaStep;
-
-			mPositions.push_back(Vector3f(
-				mRadius * MathUtility::sin(phi) * MathUtility::cos(theta),
-				mRadius * MathUtility::cos(phi),
-				mRadius * MathUtility::sin(phi) * MathUtility::sin(theta)
-			));
-
-			mTexCoords.push_back(Vector3f(
-				theta / MathUtility::two_pi<float>() * 4,
-				phi / MathUtility::pi<float>() * 2,
-				0.0f
-			));
-
-			mTangents.push_back(MathUtility::normalize(Vector3f(
-				-mRadius * MathUtility::sin(phi) * MathUtility::sin(theta),
-				0.0f,
-				+mRadius * MathUtility::sin(phi) * MathUtility::cos(theta)
-			)));
-
-			mNormals.push_back(MathUtility::normalize(mPositions[mPositions.size() - 1]));
+		const auto ringSin = static_cast<float>(sinPhi);
+		const auto ringCos = static_cast<float>(cosPhi);
+		const auto ringV = index0 * phiStep / MathUtility::pi<float>() * 2;
+
+		const auto positions = mPositions.data() + 1 + (index0 - 1) * ringVertexCount;
+		const auto texCoords = mTexCoords.data() + 1 + (index0 - 1) * ringVertexCount;
+		const auto tangents = mTangents.data() + 1 + (index0 - 1) * ringVertexCount;
+		const auto normals = mNormals.data() + 1 + (index0 - 1) * ringVertexCount;
+
+		//the ring loop only reads the tables and writes the arrays, so the compiler can vectorize it
+		for (size_t index1 = 0; index1 < ringVertexCount; index1++) {
+			normals[index1] = Vector3f(ringSin * cosTheta[index1], ringCos, ringSin * sinTheta[index1]);
+			positions[index1] = mRadius * normals[index1];
+			texCoords[index1] = Vector3f(index1 * thetaStep / MathUtility::two_pi<float>() * 4, ringV, 0.0f);
+			tangents[index1] = Vector3f(-sinTheta[index1], 0.0f, cosTheta[index1]);
 		}
+
+		rotate(sinPhi, cosPhi, stepSinPhi, stepCosPhi);
 	}
 	
-	mPositions.push_back(Vector3f(0.0f, -mRadius, 0.0f));
-	mTexCoords.push_back(Vector3f(0.0f, 1.0f, 0.0f));
-	mTangents.push_back(Vector3f(0.0f, 0.0f, 0.0f));
-	mNormals.push_back(Vector3f(0.0f, -1.0f, 0.0f));
+	mPositions.back() = Vector3f(0.0f, -mRadius, 0.0f);
+	mTexCoords.back() = Vector3f(0.0f, 1.0f, 0.0f);
+	mTangents.back() = Vector3f(0.0f, 0.0f, 0.0f);
+	mNormals.back() = Vector3f(0.0f, -1.0f, 0.0f);
+
+	mIndices.reserve((static_cast<size_t>(stack) - 1) * static_cast<size_t>(slice) * 6);
 
 	for (size_t index = 1; index <= slice; index++) {
 		mIndices.push_back(0);
@@ -51,7 +89,6 @@ LRTR::SphereMesh::SphereMesh(const float radius, const int slice, const int stac
 	}
 
 	size_t baseIndex = 1;
-	size_t ringVertexCount = slice + 1;
 
 	for (size_t index0 = 0; index0 < stack - 2; index0++) {
 		for (size_t index1 = 0; index1 < slice; index1++) {
@@ -74,6 +111,8 @@ LRTR::SphereMesh::SphereMesh(const float radius, const int slice, const int stac
 		mIndices.push_back(static_cast<unsigned>(baseIndex + index));
 		mIndices.push_back(static_cast<unsigned>(baseIndex + index + 1));
 	}
+
+	updateBound();
 }
 
 auto LRTR::SphereMesh::typeName() const noexcept -> std::string
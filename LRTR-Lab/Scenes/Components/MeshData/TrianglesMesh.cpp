@@ -1,44 +1,41 @@
 #include "TrianglesMesh.hpp"
 
+#include "../../../Shared/Meshes/VertexWelder.hpp"
 #include "../../../Extensions/ImGui/ImGui.hpp"
 
-LRTR::TrianglesMesh::TrianglesMesh(const std::vector<TriangleF>& triangles)
+#include <algorithm>
+
+LRTR::TrianglesMesh::TrianglesMesh(
+	const std::vector<TriangleF>& triangles,
+	const float epsilon,
+	ThreadPool* threadPool)
 {
 	mPrimitive = CodeRed::PrimitiveTopology::TriangleList;
-	
-	using sort_pair = std::pair<Vector3f, size_t>;
-	
-	auto vertices = std::vector<sort_pair>(triangles.size() * 3);
+
+	mPositions = std::vector<Vector3f>(triangles.size() * 3);
 
 	for (size_t index = 0; index < triangles.size(); index++) {
-		const auto& triangle = triangles[index];
-		
-		vertices[index * 3 + 0] = { triangle.Vertices[0], index * 3 + 0 };
-		vertices[index * 3 + 1] = { triangle.Vertices[1], index * 3 + 1 };
-		vertices[index * 3 + 2] = { triangle.Vertices[2], index * 3 + 2 };
+		mPositions[index * 3 + 0] = triangles[index].Vertices[0];
+		mPositions[index * 3 + 1] = triangles[index].Vertices[1];
+		mPositions[index * 3 + 2] = triangles[index].Vertices[2];
 	}
 
-	std::sort(vertices.begin(), vertices.end(),
-		[](const sort_pair& left, const sort_pair& right)
-		{
-			if (left.first.x == right.first.x) {
-				if (left.first.y == right.first.y)
-					return left.first.z < right.first.z;
-
-				return left.first.y < right.first.y;
-			}
-
-			return left.first.x < right.first.x;
-		});
-
-	mIndices = std::vector<unsigned>(triangles.size() * 3);
-
-	for (size_t index = 0; index < vertices.size(); index++) {
-		if (index == 0 || vertices[index].first != vertices[index - 1].first)
-			mPositions.push_back(vertices[index].first);
+	weldVertices(epsilon, threadPool);
+	updateBound();
+}
 
-		mIndices[vertices[index].second] = static_cast<unsigned>(mPositions.size() - 1);
-	}
+LRTR::TrianglesMesh::TrianglesMesh(
+	const std::vector<Vector3f>& positions,
+	const std::vector<Vector3f>& texCoords,
+	const std::vector<Vector3f>& tangents,
+	const std::vector<Vector3f>& normals,
+	const float epsilon,
+	ThreadPool* threadPool) :
+	MeshData(positions, texCoords, tangents, normals, {},
+		CodeRed::PrimitiveTopology::TriangleList)
+{
+	weldVertices(epsilon, threadPool);
+	updateBound();
 }
 
 LRTR::TrianglesMesh::TrianglesMesh(
@@ -46,7 +43,7 @@ LRTR::TrianglesMesh::TrianglesMesh(
 	const std::vector<unsigned>& indices) :
 	MeshData(positions, indices, CodeRed::PrimitiveTopology::TriangleList)
 {
-	
+	updateBound();
 }
 
 LRTR::TrianglesMesh::TrianglesMesh(
@@ -58,6 +55,7 @@ LRTR::TrianglesMesh::TrianglesMesh(
 	MeshData(positions, texCoords, tangents, normals, indices,
 		CodeRed::PrimitiveTopology::TriangleList)
 {
+	updateBound();
 }
 
 auto LRTR::TrianglesMesh::triangle(const size_t index) const -> TriangleF
@@ -74,6 +72,53 @@ auto LRTR::TrianglesMesh::size() const noexcept -> size_t
 	return mIndices.size() / 3;
 }
 
+auto LRTR::TrianglesMesh::bound() const noexcept -> Bound3f
+{
+	return mBound;
+}
+
+auto LRTR::TrianglesMesh::hierarchy(ThreadPool* threadPool) const -> const TriangleHierarchy&
+{
+	std::lock_guard<std::mutex> lock(mHierarchyMutex);
+
+	if (mHierarchy != nullptr) return *mHierarchy;
+
+	mHierarchy = std::make_unique<TriangleHierarchy>();
+	mHierarchy->build(mPositions, mIndices, threadPool);
+
+	return *mHierarchy;
+}
+
+void LRTR::TrianglesMesh::setLevelsOfDetail(const std::vector<MeshLevelOfDetail>& levels)
+{
+	mLevelsOfDetail = levels;
+}
+
+auto LRTR::TrianglesMesh::levelsOfDetail() const noexcept -> const std::vector<MeshLevelOfDetail>&
+{
+	return mLevelsOfDetail;
+}
+
+void LRTR::TrianglesMesh::setMeshlets(const std::vector<Meshlet>& meshlets)
+{
+	mMeshlets = meshlets;
+}
+
+auto LRTR::TrianglesMesh::meshlets() const noexcept -> const std::vector<Meshlet>&
+{
+	return mMeshlets;
+}
+
+void LRTR::TrianglesMesh::setTangentSigns(const std::vector<float>& signs)
+{
+	mTangentSigns = signs;
+}
+
+auto LRTR::TrianglesMesh::tangentSigns() const noexcept -> const std::vector<float>&
+{
+	return mTangentSigns;
+}
+
 auto LRTR::TrianglesMesh::typeName() const noexcept -> std::string
 {
 	return "TrianglesMesh";
@@ -98,9 +143,14 @@ void LRTR::TrianglesMesh::onProperty()
 		ImGuiColorEditFlags_AlphaPreview |
 		ImGuiColorEditFlags_Float;
 
-	mCurrentTriangle = MathUtility::clamp(mCurrentTriangle, static_cast<size_t>(0), mIndices.size() / 3);
+	//the selected triangle is the state of ui, it is in the storage of ImGui with the id of shape
+	//so the shapes sharing the mesh (e.g. the meshes of procedural mesh cache) do not share the selection
+	auto& selectedTriangle = *ImGui::GetStateStorage()->GetIntRef(ImGui::GetID("CurrentTriangle"), 0);
+
+	const auto currentTriangle = MathUtility::clamp(static_cast<size_t>(std::max(selectedTriangle, 0)),
+		static_cast<size_t>(0), std::max(mIndices.size() / 3, static_cast<size_t>(1)) - 1);
 
-	auto currentName = mIndices.empty() ? "Empty" : TriangleName(mCurrentTriangle);
+	auto currentName = mIndices.empty() ? "Empty" : TriangleName(currentTriangle);
 	auto count = static_cast<int>(size());
 
 	ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0, 0, 0, 0.1f));
@@ -110,6 +160,8 @@ void LRTR::TrianglesMesh::onProperty()
 		{
 			ImGui::InputInt("##Count", &count, 0, 0, ImGuiInputTextFlags_ReadOnly);
 		});
+	ImGui::Property("Levels", [&]() { ImGui::Text("%zu", mLevelsOfDetail.size()); });
+	ImGui::Property("Meshlets", [&]() { ImGui::Text("%zu", mMeshlets.size()); });
 
 	ImGui::PopStyleColor();
 
@@ -118,29 +170,29 @@ void LRTR::TrianglesMesh::onProperty()
 		{
 			if (ImGui::BeginCombo("##Triangle", currentName.c_str())) {
 				for (size_t index = 0; index < mIndices.size() / 3; index++) {
-					const auto selected = (mCurrentTriangle == index);
+					const auto selected = (currentTriangle == index);
 
 					if (ImGui::Selectable(TriangleName(index).c_str(), selected))
-						mCurrentTriangle = index;
+						selectedTriangle = static_cast<int>(index);
 					if (selected) ImGui::SetItemDefaultFocus();
 				}
 				ImGui::EndCombo();
 			}
 		});
 
-	auto triangle = mIndices.empty() ? TriangleF() : TrianglesMesh::triangle(mCurrentTriangle);
+	auto triangle = mIndices.empty() ? TriangleF() : TrianglesMesh::triangle(currentTriangle);
 
 	ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0, 0, 0, 0.1f));
 	
-	ImGui::BeginPropertyTable(TriangleName(mCurrentTriangle).c_str());
+	ImGui::BeginPropertyTable(TriangleName(currentTriangle).c_str());
 	ImGui::Property("V[0]     X", [&]() { DrawFloat("##X0", &triangle.Vertices[0].x); });
 	ImGui::Property("         Y", [&]() { DrawFloat("##Y0", &triangle.Vertices[0].y); });
 	ImGui::Property("         Z", [&]() { DrawFloat("##Z0", &triangle.Vertices[0].z); });
-	ImGui::BeginPropertyTable(TriangleName(mCurrentTriangle).c_str());
+	ImGui::BeginPropertyTable(TriangleName(currentTriangle).c_str());
 	ImGui::Property("V[1]     X", [&]() { DrawFloat("##X1", &triangle.Vertices[1].x); });
 	ImGui::Property("         Y", [&]() { DrawFloat("##Y1", &triangle.Vertices[1].y); });
 	ImGui::Property("         Z", [&]() { DrawFloat("##Z1", &triangle.Vertices[1].z); });
-	ImGui::BeginPropertyTable(TriangleName(mCurrentTriangle).c_str());
+	ImGui::BeginPropertyTable(TriangleName(currentTriangle).c_str());
 	ImGui::Property("V[2]     X", [&]() { DrawFloat("##X2", &triangle.Vertices[2].x); });
 	ImGui::Property("         Y", [&]() { DrawFloat("##Y2", &triangle.Vertices[2].y); });
 	ImGui::Property("         Z", [&]() { DrawFloat("##Z2", &triangle.Vertices[2].z); });
@@ -149,3 +201,35 @@ void LRTR::TrianglesMesh::onProperty()
 
 	ImGui::PopStyleColor();
 }
+
+void LRTR::TrianglesMesh::weldVertices(const float epsilon, ThreadPool* threadPool)
+{
+	const auto welded = VertexWelder::weld(mPositions, { &mTexCoords, &mTangents, &mNormals }, epsilon, threadPool);
+
+	//the property that is not enough for all vertices is not used by the mesh, so we do not compact it
+	const auto compact = [&](std::vector<Vector3f>& property)
+	{
+		if (property.size() < mPositions.size()) return;
+
+		auto compacted = std::vector<Vector3f>(welded.Vertices.size());
+
+		for (size_t index = 0; index < welded.Vertices.size(); index++)
+			compacted[index] = property[welded.Vertices[index]];
+
+		property = std::move(compacted);
+	};
+
+	compact(mTexCoords);
+	compact(mTangents);
+	compact(mNormals);
+	compact(mPositions);
+
+	mIndices = welded.Remap;
+}
+
+void LRTR::TrianglesMesh::updateBound()
+{
+	mBound = Bound3f();
+
+	for (const auto& position : mPositions) mBound.merge(position);
+}
@@ -1,17 +1,37 @@
 #pragma once
 
+#include "../../../Shared/Accelerators/TriangleHierarchy.hpp"
+#include "../../../Shared/Meshes/MeshSimplifier.hpp"
+#include "../../../Shared/Meshes/MeshletBuilder.hpp"
 #include "../../../Shared/Triangle.hpp"
+#include "../../../Shared/Bound.hpp"
 
 #include "MeshData.hpp"
 
+#include <memory>
+#include <mutex>
+
 namespace LRTR {
 
 	class TrianglesMesh : public MeshData {
 	public:
 		TrianglesMesh() = default;
 		
+		//the vertices of triangles are welded if their positions are in epsilon
+		explicit TrianglesMesh(
+			const std::vector<TriangleF>& triangles,
+			const float epsilon = 0,
+			ThreadPool* threadPool = nullptr);
+
+		//the triangle soup with attributes, the vertex i of triangle t is the (t * 3 + i) of arrays
+		//the vertices are welded if their positions and attributes are in epsilon
 		explicit TrianglesMesh(
-			const std::vector<TriangleF>& triangles);
+			const std::vector<Vector3f>& positions,
+			const std::vector<Vector3f>& texCoords,
+			const std::vector<Vector3f>& tangents,
+			const std::vector<Vector3f>& normals,
+			const float epsilon,
+			ThreadPool* threadPool = nullptr);
 
 		explicit TrianglesMesh(
 			const std::vector<Vector3f>& positions,
@@ -30,13 +50,50 @@ namespace LRTR {
 
 		auto size() const noexcept -> size_t;
 
+		//the bound of positions in local space, it is computed when the mesh is created
+		auto bound() const noexcept -> Bound3f;
+
+		//the triangle hierarchy in local space, it is built when we first use it and cached with the mesh
+		//the mesh is not changed after it is created, so we do not need to rebuild it
+		auto hierarchy(ThreadPool* threadPool = nullptr) const -> const TriangleHierarchy&;
+
+		//the simplified levels of mesh, the level 0 is the mesh itself and it is not in the levels
+		//the levels use the vertices of mesh, so they only have their own indices
+		void setLevelsOfDetail(const std::vector<MeshLevelOfDetail>& levels);
+
+		auto levelsOfDetail() const noexcept -> const std::vector<MeshLevelOfDetail>&;
+
+		//the meshlets are ranges of indices of level 0, they are empty if the indices are not built into meshlets
+		void setMeshlets(const std::vector<Meshlet>& meshlets);
+
+		auto meshlets() const noexcept -> const std::vector<Meshlet>&;
+
+		//the handedness of tangent frames, the bitangent is cross(normal, tangent) * sign
+		//they are empty if the mesh does not have them, all signs are 1 in this case
+		void setTangentSigns(const std::vector<float>& signs);
+
+		auto tangentSigns() const noexcept -> const std::vector<float>&;
+
 		auto typeName() const noexcept -> std::string override;
 
 		auto typeIndex() const noexcept -> std::type_index override;
 	protected:
 		void onProperty() override;
+
+		//the meshes derived from it generate positions in their constructors, so they need update the bound
+		void updateBound();
+
+		//weld the vertices of triangle soup in properties and build the indices
+		void weldVertices(const float epsilon, ThreadPool* threadPool);
+	protected:
+		Bound3f mBound;
 	private:
-		size_t mCurrentTriangle = 0;
+		mutable std::unique_ptr<TriangleHierarchy> mHierarchy;
+		mutable std::mutex mHierarchyMutex;
+
+		std::vector<MeshLevelOfDetail> mLevelsOfDetail;
+		std::vector<Meshlet> mMeshlets;
+		std::vector<float> mTangentSigns;
 	};
 	
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "OcclusionCulling.hpp"
+
+#include "../../Extensions/ImGui/ImGui.hpp"
+
+auto LRTR::OcclusionCulling::typeName() const noexcept -> std::string
+{
+	return "OcclusionCulling";
+}
+
+auto LRTR::OcclusionCulling::typeIndex() const noexcept -> std::type_index
+{
+	return typeid(OcclusionCulling);
+}
+
+void LRTR::OcclusionCulling::onProperty()
+{
+	ImGui::BeginPropertyTable("Occlusion");
+	ImGui::Property("Enable", [&]() { ImGui::Checkbox("##Enable", &IsEnabled); });
+	ImGui::Property("Occluders", [&]() { ImGui::Text("%zu", Occluders); });
+	ImGui::Property("Triangles", [&]() { ImGui::Text("%zu", Triangles); });
+	ImGui::Property("Tested", [&]() { ImGui::Text("%zu", Tested); });
+	ImGui::Property("Occluded", [&]() { ImGui::Text("%zu", Occluded); });
+	ImGui::EndPropertyTable();
+}
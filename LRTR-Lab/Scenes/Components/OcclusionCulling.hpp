@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../Component.hpp"
+
+namespace LRTR {
+
+	//the setting and statistics of occlusion culling in last frame, it is a component of scene property
+	//the render systems rasterize the largest visible shapes as occluders into a small depth buffer on CPU
+	//and do not emit the draw calls of shapes whose world bound is hidden by them
+	class OcclusionCulling : public Component {
+	public:
+		OcclusionCulling() = default;
+
+		~OcclusionCulling() = default;
+
+		auto typeName() const noexcept -> std::string override;
+
+		auto typeIndex() const noexcept -> std::type_index override;
+	protected:
+		void onProperty() override;
+	public:
+		bool IsEnabled = true;
+
+		//the max number of occluders and the max triangles of them we rasterize in one frame
+		size_t MaxOccluders = 32;
+		size_t MaxTriangles = 65536;
+
+		size_t Occluders = 0;
+		size_t Triangles = 0;
+		size_t Tested = 0;
+		size_t Occluded = 0;
+	};
+	
+}
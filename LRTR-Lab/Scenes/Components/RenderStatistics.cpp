@@ -0,0 +1,42 @@
+#include "RenderStatistics.hpp"
+
+#include "../../Extensions/ImGui/ImGui.hpp"
+
+auto LRTR::RenderStatistics::typeName() const noexcept -> std::string
+{
+	return "Statistics";
+}
+
+auto LRTR::RenderStatistics::typeIndex() const noexcept -> std::type_index
+{
+	return typeid(RenderStatistics);
+}
+
+void LRTR::RenderStatistics::onProperty()
+{
+	ImGui::BeginPropertyTable("Upload");
+	ImGui::Property("Upload Bytes", [&]() { ImGui::Text("%zu", UploadBytes); });
+	ImGui::EndPropertyTable();
+
+	ImGui::BeginPropertyTable("Shadow");
+	ImGui::Property("Faces", [&]() { ImGui::Text("%zu", ShadowFaces); });
+	ImGui::Property("Skipped Faces", [&]() { ImGui::Text("%zu", SkippedShadowFaces); });
+	ImGui::Property("Draws", [&]() { ImGui::Text("%zu", ShadowDraws); });
+	ImGui::Property("Skipped Draws", [&]() { ImGui::Text("%zu", SkippedShadowDraws); });
+	ImGui::Property("Atlas Slots", [&]() { ImGui::Text("%zu", ShadowAtlasSlots); });
+	ImGui::Property("Atlas Texels", [&]() { ImGui::Text("%zu", ShadowAtlasUsage); });
+	ImGui::Property("Atlas Evictions", [&]() { ImGui::Text("%zu", ShadowAtlasEvictions); });
+	ImGui::EndPropertyTable();
+
+	ImGui::BeginPropertyTable("Mesh");
+	ImGui::Property("Vertices", [&]() { ImGui::Text("%zu", MeshVertices); });
+	ImGui::Property("Unused Vertices", [&]() { ImGui::Text("%zu", UnusedMeshVertices); });
+	ImGui::Property("Vertex Fragmentation", [&]() { ImGui::Text("%.3f", MeshVertexFragmentation); });
+	ImGui::Property("Indices", [&]() { ImGui::Text("%zu", MeshIndices); });
+	ImGui::Property("Unused Indices", [&]() { ImGui::Text("%zu", UnusedMeshIndices); });
+	ImGui::Property("Index Fragmentation", [&]() { ImGui::Text("%.3f", MeshIndexFragmentation); });
+	ImGui::Property("Releases", [&]() { ImGui::Text("%zu", MeshReleases); });
+	ImGui::Property("Relocations", [&]() { ImGui::Text("%zu", MeshRelocations); });
+	ImGui::Property("Retiring Ranges", [&]() { ImGui::Text("%zu", RetiringMeshRanges); });
+	ImGui::EndPropertyTable();
+}
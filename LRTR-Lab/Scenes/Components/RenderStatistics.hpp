@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../Component.hpp"
+
+namespace LRTR {
+
+	//the statistics of render systems in last frame, it is a component of scene property
+	//each render system only writes the statistics it owns
+	class RenderStatistics : public Component {
+	public:
+		RenderStatistics() = default;
+
+		~RenderStatistics() = default;
+
+		auto typeName() const noexcept -> std::string override;
+
+		auto typeIndex() const noexcept -> std::type_index override;
+	protected:
+		void onProperty() override;
+	public:
+		//the bytes of transforms, materials and lights uploaded by physical based render system
+		size_t UploadBytes = 0;
+
+		//the faces of point shadow maps rendered and skipped, the face is skipped if its casters are not moved
+		size_t ShadowFaces = 0;
+		size_t SkippedShadowFaces = 0;
+
+		//the draws of shadow casters, the draw is skipped if the caster is culled or its face is skipped
+		size_t ShadowDraws = 0;
+		size_t SkippedShadowDraws = 0;
+
+		//the slots kept in shadow atlas, the texels used by them and the slots evicted in this frame
+		size_t ShadowAtlasSlots = 0;
+		size_t ShadowAtlasUsage = 0;
+		size_t ShadowAtlasEvictions = 0;
+
+		//the elements allocated in mesh pools and the unused elements in free ranges between them
+		//the meshes released and the ranges moved by defragmentation in this frame
+		//the ranges released but not freed, because the frames in flight may still read them
+		size_t MeshVertices = 0;
+		size_t UnusedMeshVertices = 0;
+		size_t MeshIndices = 0;
+		size_t UnusedMeshIndices = 0;
+		size_t MeshReleases = 0;
+		size_t MeshRelocations = 0;
+		size_t RetiringMeshRanges = 0;
+
+		float MeshVertexFragmentation = 0;
+		float MeshIndexFragmentation = 0;
+	};
+	
+}
@@ -0,0 +1,34 @@
+#include "TransformHierarchy.hpp"
+
+#include "../../Extensions/ImGui/ImGui.hpp"
+
+LRTR::TransformHierarchy::TransformHierarchy(const ShapeHandle& parent) :
+	mParent(parent)
+{
+}
+
+auto LRTR::TransformHierarchy::parent() const noexcept -> ShapeHandle
+{
+	return mParent;
+}
+
+auto LRTR::TransformHierarchy::typeName() const noexcept -> std::string
+{
+	return "Hierarchy";
+}
+
+auto LRTR::TransformHierarchy::typeIndex() const noexcept -> std::type_index
+{
+	return typeid(TransformHierarchy);
+}
+
+void LRTR::TransformHierarchy::onProperty()
+{
+	ImGui::BeginPropertyTable("Hierarchy");
+	ImGui::Property("Parent", [&]()
+		{
+			if (mParent.valid()) ImGui::Text("%u (%u)", mParent.Index, mParent.Generation);
+			else ImGui::Text("None");
+		});
+	ImGui::EndPropertyTable();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../Component.hpp"
+#include "../Shape.hpp"
+
+namespace LRTR {
+
+	//the parent of shape in transform graph, the parent should have TransformWrap
+	//the parent can not be changed, if we want to change it, we need replace the component
+	class TransformHierarchy : public Component {
+	public:
+		TransformHierarchy() = default;
+
+		explicit TransformHierarchy(const ShapeHandle& parent);
+
+		~TransformHierarchy() = default;
+
+		auto parent() const noexcept -> ShapeHandle;
+
+		auto typeName() const noexcept -> std::string override;
+
+		auto typeIndex() const noexcept -> std::type_index override;
+	protected:
+		void onProperty() override;
+	private:
+		ShapeHandle mParent;
+	};
+	
+}
@@ -19,6 +19,8 @@ void LRTR::TransformWrap::set(const Vector3f& translation, const Vector4f& rotat
 	mScale = scale;
 
 	mTransform = Transform(mTranslation, mRotation, mScale);
+
+	updateVersion();
 }
 
 void LRTR::TransformWrap::set(const Vector3f& translation, const QuaternionF& rotation, const Vector3f& scale)
@@ -28,6 +30,8 @@ void LRTR::TransformWrap::set(const Vector3f& translation, const QuaternionF& ro
 	mScale = scale;
 
 	mTransform = Transform(mTranslation, mRotation, mScale);
+
+	updateVersion();
 }
 
 auto LRTR::TransformWrap::translation() const noexcept -> Vector3f
@@ -50,6 +54,11 @@ auto LRTR::TransformWrap::transform() const noexcept -> Transform
 	return mTransform;
 }
 
+auto LRTR::TransformWrap::world() const noexcept -> Matrix4x4f
+{
+	return mLinked ? mWorld : mTransform.matrix();
+}
+
 auto LRTR::TransformWrap::typeName() const noexcept -> std::string
 {
 	return "Transform";
@@ -62,6 +71,10 @@ auto LRTR::TransformWrap::typeIndex() const noexcept -> std::type_index
 
 void LRTR::TransformWrap::onProperty()
 {
+	const auto lastTranslation = mTranslation;
+	const auto lastRotation = mRotation;
+	const auto lastScale = mScale;
+	
 	ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0, 0, 0, 0.1f));
 	
 	ImGui::BeginPropertyTable("Translate");
@@ -83,5 +96,17 @@ void LRTR::TransformWrap::onProperty()
 
 	ImGui::PopStyleColor();
 
+	//only update the transform and version when the values are changed
+	if (lastTranslation == mTranslation && lastRotation == mRotation && lastScale == mScale) return;
+	
 	mTransform = Transform(mTranslation, mRotation, mScale);
+
+	updateVersion();
+}
+
+void LRTR::TransformWrap::setWorld(const Matrix4x4f& world)
+{
+	mWorld = world;
+
+	updateVersion();
 }
@@ -1,11 +1,12 @@
 #pragma once
 
 #include "../../Shared/Transform.hpp"
+#include "../../Core/Versionable.hpp"
 #include "../Component.hpp"
 
 namespace LRTR {
 
-	class TransformWrap : public Component {
+	class TransformWrap : public Component, public Versionable {
 	public:
 		TransformWrap() = default;
 
@@ -37,14 +38,27 @@ namespace LRTR {
 		
 		auto transform() const noexcept -> Transform;
 
+		//the matrix from local space to world space, if the shape does not have parent
+		//it is the same as the matrix of transform, otherwise it is computed by transform graph
+		auto world() const noexcept -> Matrix4x4f;
+
 		auto typeName() const noexcept->std::string override;
 		
 		auto typeIndex() const noexcept -> std::type_index override;
 	protected:
 		void onProperty() override;
+	private:
+		void setWorld(const Matrix4x4f& world);
+
+		friend class TransformGraph;
 	private:
 		Transform mTransform;
 
+		Matrix4x4f mWorld = Matrix4x4f(1);
+
+		//true if the world matrix is computed by transform graph
+		bool mLinked = false;
+
 		Vector3f mTranslation = Vector3f();
 		QuaternionF mRotation = QuaternionF();
 		Vector3f mScale = Vector3f(1, 1, 1);
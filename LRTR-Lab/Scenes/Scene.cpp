@@ -11,7 +11,8 @@ LRTR::Scene::Scene(
 	const std::string& name,
 	const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
 	const size_t maxFrameCount) :
-	mDevice(device), mMaxFrameCount(maxFrameCount), mName(name)
+	mDevice(device), mMaxFrameCount(maxFrameCount), mName(name),
+	mScheduler(std::make_shared<ThreadPool>())
 {
 	mCommandAllocators.push_back(mDevice->createCommandAllocator());
 	mCommandAllocators.push_back(mDevice->createCommandAllocator());
@@ -22,30 +23,60 @@ LRTR::Scene::Scene(
 	mCommandLists.push_back(mDevice->createGraphicsCommandList(mCommandAllocators[1]));
 	mCommandLists.push_back(mDevice->createGraphicsCommandList(mCommandAllocators[2]));
 
-	add(mProperty = std::make_shared<SceneProperty>());
+	add(mProperty = std::make_shared<SceneProperty>(mShapes));
 
 	mProperty->component<CollectionLabel>()->set("Collection", "Scene");
 }
 
-void LRTR::Scene::add(const std::shared_ptr<Shape>& shape)
+auto LRTR::Scene::add(const std::shared_ptr<Shape>& shape) -> ShapeHandle
 {
-	if (std::dynamic_pointer_cast<SceneCamera>(shape) != nullptr)
-		mProperty->component<CameraGroup>()->addCamera(shape);
+	const auto handle = mShapes.insert(shape);
+
+	shape->mHandle = handle;
+
+	if (dynamic_cast<SceneCamera*>(shape.get()) != nullptr)
+		mProperty->component<CameraGroup>()->addCamera(handle);
 	
-	mShapes.insert({ shape->identity(), shape });
+	mHandles.insert({ shape->identity(), handle });
+	mArchetypes.add(shape.get());
+
+	return handle;
 }
 
 void LRTR::Scene::addSystem(const std::shared_ptr<System>& system)
 {
 	mSystems.push_back(system);
+
+	//we cast the system when we add it, so we do not need cast it every frame
+	const auto updateSystem = std::dynamic_pointer_cast<UpdateSystem>(system);
+	const auto renderSystem = std::dynamic_pointer_cast<RenderSystem>(system);
+
+	if (updateSystem != nullptr) mScheduler.add(updateSystem);
+	if (renderSystem != nullptr) mRenderSystems.push_back(renderSystem);
 }
 
 void LRTR::Scene::remove(const Identity& identity)
 {
-	if (std::dynamic_pointer_cast<SceneCamera>(mShapes.at(identity)) != nullptr)
-		mProperty->component<CameraGroup>()->removeCamera(identity);
+	const auto it = mHandles.find(identity);
+
+	if (it != mHandles.end()) remove(it->second);
+}
+
+void LRTR::Scene::remove(const ShapeHandle& handle)
+{
+	const auto shape = this->shape(handle);
+
+	if (shape == nullptr) return;
 	
-	mShapes.erase(identity);
+	if (dynamic_cast<SceneCamera*>(shape) != nullptr)
+		mProperty->component<CameraGroup>()->removeCamera(handle);
+
+	mArchetypes.remove(shape->identity());
+	mHandles.erase(shape->identity());
+
+	shape->mHandle = ShapeHandle();
+
+	mShapes.erase(handle);
 }
 
 auto LRTR::Scene::name() const noexcept -> std::string
@@ -53,21 +84,55 @@ auto LRTR::Scene::name() const noexcept -> std::string
 	return mName;
 }
 
-auto LRTR::Scene::shapes() const noexcept -> const Group<Identity, std::shared_ptr<Shape>>&
+auto LRTR::Scene::shape(const ShapeHandle& handle) const noexcept -> Shape*
+{
+	const auto shape = mShapes.get(handle);
+
+	return shape != nullptr ? shape->get() : nullptr;
+}
+
+auto LRTR::Scene::handle(const Identity& identity) const -> ShapeHandle
+{
+	const auto it = mHandles.find(identity);
+
+	return it != mHandles.end() ? it->second : ShapeHandle();
+}
+
+auto LRTR::Scene::shapes() const noexcept -> const ShapeSlotMap&
 {
 	return mShapes;
 }
 
+auto LRTR::Scene::archetypes() const noexcept -> const ArchetypeStorage&
+{
+	return mArchetypes;
+}
+
 auto LRTR::Scene::systems() const noexcept -> const std::vector<std::shared_ptr<System>>& 
 {
 	return mSystems;
 }
 
-auto LRTR::Scene::property() const noexcept -> std::shared_ptr<Shape>
+auto LRTR::Scene::threadPool() const noexcept -> std::shared_ptr<ThreadPool>
+{
+	return mScheduler.threadPool();
+}
+
+auto LRTR::Scene::property() const noexcept -> const std::shared_ptr<Shape>&
 {
 	return mProperty;
 }
 
+auto LRTR::Scene::commands() const noexcept -> SceneCommandBuffer&
+{
+	return mCommands;
+}
+
+auto LRTR::Scene::boundingVolumes() const noexcept -> const SceneBoundingVolumeHierarchy&
+{
+	return mBoundingVolumes;
+}
+
 auto LRTR::Scene::currentFrameIndex() const noexcept -> size_t
 {
 	return mCurrentFrameIndex;
@@ -75,12 +140,16 @@ auto LRTR::Scene::currentFrameIndex() const noexcept -> size_t
 
 void LRTR::Scene::update(float delta)
 {
-	for (const auto& system : mSystems) {
-		auto updateSystem = std::dynamic_pointer_cast<UpdateSystem>(system);
+	//the world matrices should be ready before the systems use them
+	mTransformGraph.update(*this);
+
+	//the world bounds depend on the world matrices, so we update them after transform graph
+	mBoundingVolumes.update(*this);
+	
+	mScheduler.update(*this, delta);
 
-		if (updateSystem != nullptr)
-			updateSystem->update(mShapes, delta);
-	}
+	//the sync point of structural changes, all systems are finished
+	mCommands.execute(*this);
 }
 
 auto LRTR::Scene::render(
@@ -103,12 +172,8 @@ auto LRTR::Scene::render(
 	mCommandLists[1]->setViewPort(mFrameBuffer->fullViewPort());
 	mCommandLists[1]->setScissorRect(mFrameBuffer->fullScissorRect());
 
-	for (const auto& system : mSystems) {
-		auto renderSystem = std::dynamic_pointer_cast<RenderSystem>(system);
-
-		if (renderSystem != nullptr)
-			renderSystem->render(mCommandLists, mFrameBuffer, camera, delta);
-	}
+	for (const auto& renderSystem : mRenderSystems)
+		renderSystem->render(mCommandLists, mFrameBuffer, camera, delta);
 	
 	mCommandLists[1]->endRenderPass();
 
@@ -5,6 +5,11 @@
 #include "../Shared/Accelerators/Group.hpp"
 #include "../Core/Noncopyable.hpp"
 #include "Cameras/Camera.hpp"
+#include "SceneBoundingVolumeHierarchy.hpp"
+#include "SceneCommandBuffer.hpp"
+#include "SystemScheduler.hpp"
+#include "TransformGraph.hpp"
+#include "Archetype.hpp"
 #include "System.hpp"
 #include "Shape.hpp"
 
@@ -24,19 +29,45 @@ namespace LRTR {
 
 		virtual ~Scene() = default;
 
-		void add(const std::shared_ptr<Shape>& shape);
+		auto add(const std::shared_ptr<Shape>& shape) -> ShapeHandle;
 
 		void addSystem(const std::shared_ptr<System>& system);
 
 		void remove(const Identity& identity);
 
+		void remove(const ShapeHandle& handle);
+
 		auto name() const noexcept -> std::string;
 
-		auto shapes() const noexcept -> const Group<Identity, std::shared_ptr<Shape>>&;
+		//the shape of handle, return nullptr if the handle is stale
+		auto shape(const ShapeHandle& handle) const noexcept -> Shape*;
+
+		//the handle of shape with identity, return invalid handle if the shape is not in scene
+		auto handle(const Identity& identity) const -> ShapeHandle;
+		
+		auto shapes() const noexcept -> const ShapeSlotMap&;
+
+		auto archetypes() const noexcept -> const ArchetypeStorage&;
+
+		//the shapes that have all TComponents, the result is cached and updated
+		//when the shapes or components are changed
+		template<typename... TComponents>
+		auto query() const -> const ArchetypeQuery&;
 
 		auto systems() const noexcept -> const std::vector<std::shared_ptr<System>>&;
 
-		auto property() const noexcept -> std::shared_ptr<Shape>;
+		//the thread pool used to update systems, systems can also use it to split their work
+		auto threadPool() const noexcept -> std::shared_ptr<ThreadPool>;
+
+		auto property() const noexcept -> const std::shared_ptr<Shape>&;
+
+		//the systems record the structural changes into it during update, they are played back
+		//after all systems are finished, so the archetypes are not changed when systems iterate them
+		auto commands() const noexcept -> SceneCommandBuffer&;
+
+		//the world bounds of shapes with TrianglesMesh, it is updated before systems
+		//so the transforms changed by systems are used in next frame
+		auto boundingVolumes() const noexcept -> const SceneBoundingVolumeHierarchy&;
 		
 		auto currentFrameIndex() const noexcept -> size_t;
 	protected:
@@ -70,10 +101,31 @@ namespace LRTR {
 		std::string mName;
 
 		std::vector<std::shared_ptr<System>> mSystems;
+		std::vector<std::shared_ptr<RenderSystem>> mRenderSystems;
+
+		SystemScheduler mScheduler;
+
+		TransformGraph mTransformGraph;
+
+		SceneBoundingVolumeHierarchy mBoundingVolumes;
+
+		//recording commands does not change the scene, so we can record it in const scene
+		mutable SceneCommandBuffer mCommands;
 		
-		Group<Identity, std::shared_ptr<Shape>> mShapes;
+		ShapeSlotMap mShapes;
+
+		Group<Identity, ShapeHandle> mHandles;
+
+		//the archetypes use the shapes owned by slot map, so it should be destroyed before shapes
+		ArchetypeStorage mArchetypes;
 
 		std::shared_ptr<Shape> mProperty;
 	};
+
+	template <typename ... TComponents>
+	auto Scene::query() const -> const ArchetypeQuery&
+	{
+		return mArchetypes.query(signatureOf<TComponents...>());
+	}
 	
 }
\ No newline at end of file
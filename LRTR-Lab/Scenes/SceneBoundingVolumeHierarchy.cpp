@@ -0,0 +1,138 @@
+#include "SceneBoundingVolumeHierarchy.hpp"
+
+#include "Components/MeshData/TrianglesMesh.hpp"
+#include "Components/TransformWrap.hpp"
+
+#include "Scene.hpp"
+
+#include <atomic>
+
+namespace LRTR {
+
+	//the shapes in one task when we update the bounds in parallel
+	constexpr size_t BoundGrain = 1024;
+
+	//rebuild the hierarchy when the cost of refitted one is larger than the cost of built one by the factor
+	constexpr float RebuildFactor = 1.5f;
+	
+}
+
+void LRTR::SceneBoundingVolumeHierarchy::update(const Scene& scene)
+{
+	if (mStorageVersion != scene.archetypes().version()) { rebuild(scene); return; }
+
+	std::atomic<bool> moved = false;
+
+	const auto UpdateBounds = [&](const size_t begin, const size_t end)
+	{
+		auto changed = false;
+
+		for (size_t index = begin; index < end; index++) {
+			const auto& transform = mTransforms[index];
+
+			if (transform == nullptr || transform->version() == mVersions[index]) continue;
+
+			mBounds[index] = mMeshes[index]->bound().transform(transform->world());
+			mVersions[index] = transform->version();
+
+			changed = true;
+		}
+
+		if (changed) moved = true;
+	};
+
+	if (mShapes.size() < BoundGrain * 2) UpdateBounds(0, mShapes.size());
+	else scene.threadPool()->parallelFor(mShapes.size(), BoundGrain, UpdateBounds);
+
+	if (!moved) return;
+
+	mHierarchy.refit(mBounds);
+
+	if (mHierarchy.cost() <= mBuildCost * RebuildFactor) return;
+
+	mHierarchy.build(mBounds);
+	mBuildCost = mHierarchy.cost();
+}
+
+auto LRTR::SceneBoundingVolumeHierarchy::hierarchy() const noexcept -> const BoundingVolumeHierarchy&
+{
+	return mHierarchy;
+}
+
+auto LRTR::SceneBoundingVolumeHierarchy::shape(const size_t index) const -> Shape*
+{
+	return mShapes[index];
+}
+
+auto LRTR::SceneBoundingVolumeHierarchy::handle(const size_t index) const -> ShapeHandle
+{
+	return mShapes[index]->handle();
+}
+
+auto LRTR::SceneBoundingVolumeHierarchy::bound(const size_t index) const -> const Bound3f&
+{
+	return mBounds[index];
+}
+
+auto LRTR::SceneBoundingVolumeHierarchy::intersect(
+	const RayF& ray, const float distance, ThreadPool* threadPool) const -> SceneRayHit
+{
+	SceneRayHit result;
+
+	result.Hit.Distance = distance;
+
+	mHierarchy.intersect(ray, distance, [&](const size_t index, const float maxDistance)
+		{
+			//the direction is not normalized after transforming, so the distance is the same in both spaces
+			const auto local = mTransforms[index] != nullptr ? glm::inverse(mTransforms[index]->world()) : Matrix4x4f(1);
+			const auto localRay = RayF(
+				Vector3f(local * Vector4f(ray.Origin, 1.0f)),
+				Vector3f(local * Vector4f(ray.Direction, 0.0f)));
+
+			auto hit = TriangleHit();
+
+			hit.Distance = maxDistance;
+
+			if (!mMeshes[index]->hierarchy(threadPool).intersect(localRay, hit)) return maxDistance;
+
+			result.Shape = mShapes[index]->handle();
+			result.Hit = hit;
+
+			return hit.Distance;
+		});
+
+	return result;
+}
+
+auto LRTR::SceneBoundingVolumeHierarchy::size() const noexcept -> size_t
+{
+	return mShapes.size();
+}
+
+void LRTR::SceneBoundingVolumeHierarchy::rebuild(const Scene& scene)
+{
+	mStorageVersion = scene.archetypes().version();
+
+	mShapes.clear();
+	mTransforms.clear();
+	mMeshes.clear();
+	mVersions.clear();
+	mBounds.clear();
+
+	scene.query<TrianglesMesh>().each([&](const Archetype& archetype)
+		{
+			for (size_t row = 0; row < archetype.size(); row++) {
+				const auto mesh = archetype.shapes()[row]->component<const TrianglesMesh>();
+				const auto transform = archetype.shapes()[row]->component<TransformWrap>();
+
+				mShapes.push_back(archetype.shapes()[row]);
+				mTransforms.push_back(transform);
+				mMeshes.push_back(mesh);
+				mVersions.push_back(transform != nullptr ? transform->version() : 0);
+				mBounds.push_back(transform != nullptr ? mesh->bound().transform(transform->world()) : mesh->bound());
+			}
+		});
+
+	mHierarchy.build(mBounds);
+	mBuildCost = mHierarchy.cost();
+}
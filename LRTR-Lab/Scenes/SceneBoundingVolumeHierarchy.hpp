@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../Shared/Accelerators/BoundingVolumeHierarchy.hpp"
+#include "../Shared/Accelerators/TriangleHierarchy.hpp"
+#include "../Core/Noncopyable.hpp"
+#include "Shape.hpp"
+
+#include <memory>
+#include <vector>
+#include <limits>
+
+namespace LRTR {
+
+	class TrianglesMesh;
+	class TransformWrap;
+	class Scene;
+
+	//the closest hit of ray and shapes, the distance of hit is the parameter of ray in world space
+	struct SceneRayHit {
+		ShapeHandle Shape;
+		TriangleHit Hit;
+
+		auto valid() const noexcept -> bool { return Hit.valid(); }
+	};
+
+	//the bounding volume hierarchy of shapes with TrianglesMesh, it is owned by scene and updated before systems
+	//the world bound of shape is the local bound of mesh transformed by the world matrix of TransformWrap
+	//if only the transforms are changed, we refit the hierarchy and rebuild it when the quality is too bad
+	class SceneBoundingVolumeHierarchy : public Noncopyable {
+	public:
+		SceneBoundingVolumeHierarchy() = default;
+
+		~SceneBoundingVolumeHierarchy() = default;
+
+		void update(const Scene& scene);
+
+		//the item of hierarchy is the index of shape, we can use shape(item) to get the shape
+		auto hierarchy() const noexcept -> const BoundingVolumeHierarchy&;
+
+		auto shape(const size_t index) const -> Shape*;
+
+		auto handle(const size_t index) const -> ShapeHandle;
+
+		//the bound of shape in world space
+		auto bound(const size_t index) const -> const Bound3f&;
+
+		//find the closest triangle hit by ray in (0, distance], the ray is in world space
+		//we transform the ray into the local space of shapes, so the triangle hierarchies of meshes are shared
+		//the hierarchy of mesh is built when the mesh is first tested, it is built in parallel if the pool is not nullptr
+		auto intersect(
+			const RayF& ray,
+			const float distance = std::numeric_limits<float>::max(),
+			ThreadPool* threadPool = nullptr) const -> SceneRayHit;
+
+		auto size() const noexcept -> size_t;
+	private:
+		void rebuild(const Scene& scene);
+	private:
+		std::vector<Shape*> mShapes;
+
+		//the shape without TransformWrap uses the local bound of mesh
+		std::vector<std::shared_ptr<TransformWrap>> mTransforms;
+		std::vector<std::shared_ptr<const TrianglesMesh>> mMeshes;
+
+		//the version of transform when we computed the world bound
+		std::vector<size_t> mVersions;
+		std::vector<Bound3f> mBounds;
+
+		BoundingVolumeHierarchy mHierarchy;
+
+		//the cost of hierarchy when we built it
+		float mBuildCost = 0;
+
+		//the version of archetype storage when we built the hierarchy
+		size_t mStorageVersion = ~static_cast<size_t>(0);
+	};
+	
+}
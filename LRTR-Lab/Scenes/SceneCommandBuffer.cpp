@@ -0,0 +1,58 @@
+#include "SceneCommandBuffer.hpp"
+
+#include "Scene.hpp"
+
+LRTR::SceneCommandBuffer::SceneCommandBuffer() :
+	mIdentity(++mGlobalIdentity)
+{
+}
+
+void LRTR::SceneCommandBuffer::add(const std::shared_ptr<Shape>& shape)
+{
+	local().push_back([shape](Scene& scene) { scene.add(shape); });
+}
+
+void LRTR::SceneCommandBuffer::remove(const ShapeHandle& handle)
+{
+	local().push_back([handle](Scene& scene) { scene.remove(handle); });
+}
+
+void LRTR::SceneCommandBuffer::execute(Scene& scene)
+{
+	std::vector<Command> commands;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		for (const auto& buffer : mBuffers) {
+			commands.insert(commands.end(),
+				std::make_move_iterator(buffer->begin()),
+				std::make_move_iterator(buffer->end()));
+
+			buffer->clear();
+		}
+	}
+
+	for (const auto& command : commands) command(scene);
+}
+
+auto LRTR::SceneCommandBuffer::shape(Scene& scene, const ShapeHandle& handle) -> Shape*
+{
+	return scene.shape(handle);
+}
+
+auto LRTR::SceneCommandBuffer::local() -> std::vector<Command>&
+{
+	//the buffers of command buffers this thread recorded, the key is the identity of command buffer
+	thread_local Group<size_t, std::vector<Command>*> buffers;
+
+	const auto it = buffers.find(mIdentity);
+
+	if (it != buffers.end()) return *it->second;
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	mBuffers.push_back(std::make_unique<std::vector<Command>>());
+
+	return *(buffers[mIdentity] = mBuffers.back().get());
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../Shared/Accelerators/Group.hpp"
+#include "../Core/Noncopyable.hpp"
+#include "Shape.hpp"
+
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+namespace LRTR {
+
+	class Scene;
+
+	//the command buffer records the structural changes of scene during update
+	//each thread records the commands into its own buffer, so we do not need lock when recording
+	//the commands are played back by scene after all systems are finished
+	class SceneCommandBuffer : public Noncopyable {
+	public:
+		SceneCommandBuffer();
+
+		~SceneCommandBuffer() = default;
+
+		//the components of shape can be added before we record it, because it is not in scene
+		void add(const std::shared_ptr<Shape>& shape);
+
+		void remove(const ShapeHandle& handle);
+
+		template<typename TComponent>
+		void addComponent(const ShapeHandle& handle, const std::shared_ptr<TComponent>& component);
+
+		template<typename TComponent>
+		void setComponent(const ShapeHandle& handle, const std::shared_ptr<TComponent>& component);
+		
+		template<typename TComponent>
+		void removeComponent(const ShapeHandle& handle);
+
+		//play back the commands in the order of threads recorded first, then clear them
+		//the commands of shapes whose handles are stale will be skipped
+		void execute(Scene& scene);
+	private:
+		using Command = std::function<void(Scene&)>;
+
+		//the shape of handle, nullptr if the handle is stale
+		static auto shape(Scene& scene, const ShapeHandle& handle) -> Shape*;
+
+		//the buffer of current thread
+		auto local() -> std::vector<Command>&;
+	private:
+		std::vector<std::unique_ptr<std::vector<Command>>> mBuffers;
+
+		//we only lock it when a thread records the first time or we execute the commands
+		std::mutex mMutex;
+
+		//the identity of command buffer, the threads use it to find their buffers
+		size_t mIdentity = 0;
+
+		static inline std::atomic<size_t> mGlobalIdentity = 0;
+	};
+
+	template <typename TComponent>
+	void SceneCommandBuffer::addComponent(const ShapeHandle& handle, const std::shared_ptr<TComponent>& component)
+	{
+		local().push_back([handle, component](Scene& scene)
+			{
+				const auto instance = shape(scene, handle);
+
+				if (instance != nullptr) instance->addComponent(component);
+			});
+	}
+
+	template <typename TComponent>
+	void SceneCommandBuffer::setComponent(const ShapeHandle& handle, const std::shared_ptr<TComponent>& component)
+	{
+		local().push_back([handle, component](Scene& scene)
+			{
+				const auto instance = shape(scene, handle);
+
+				if (instance != nullptr) instance->setComponent(component);
+			});
+	}
+
+	template <typename TComponent>
+	void SceneCommandBuffer::removeComponent(const ShapeHandle& handle)
+	{
+		local().push_back([handle](Scene& scene)
+			{
+				const auto instance = shape(scene, handle);
+
+				if (instance != nullptr) instance->template removeComponent<TComponent>();
+			});
+	}
+	
+}
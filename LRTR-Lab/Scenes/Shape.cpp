@@ -1,16 +1,27 @@
 #include "Shape.hpp"
 
 #include "Components/CollectionLabel.hpp"
+#include "Archetype.hpp"
 #include "../Extensions/ImGui/ImGui.hpp"
 
 LRTR::Shape::Shape()
 {
-	addComponent(std::make_shared<CollectionLabel>());
+	addComponent(makeComponent<CollectionLabel>());
 }
 
-auto LRTR::Shape::components() const -> const Group<std::type_index, std::shared_ptr<Component>>& 
+auto LRTR::Shape::component(const ComponentID id) const -> std::shared_ptr<Component>
 {
-	return mComponents;
+	return mSignature.test(id) ? mComponents[id] : nullptr;
+}
+
+auto LRTR::Shape::signature() const noexcept -> const ComponentSignature&
+{
+	return mSignature;
+}
+
+auto LRTR::Shape::handle() const noexcept -> ShapeHandle
+{
+	return mHandle;
 }
 
 auto LRTR::Shape::typeName() const noexcept -> std::string
@@ -23,15 +34,20 @@ auto LRTR::Shape::typeIndex() const noexcept -> std::type_index
 	return typeid(Shape);
 }
 
+void LRTR::Shape::refreshStorage() const
+{
+	if (mStorage != nullptr) mStorage->refresh(*this);
+}
+
 void LRTR::Shape::onProperty()
 {	
-	auto orderComponents = std::vector<std::pair<std::type_index, size_t>>(
+	auto orderComponents = std::vector<std::pair<ComponentID, size_t>>(
 		mComponentsIndex.begin(), mComponentsIndex.end());
 
 	std::sort(orderComponents.begin(), orderComponents.end(),
 		[](
-			const std::pair<std::type_index, size_t>& first,
-			const std::pair<std::type_index, size_t>& second)
+			const std::pair<ComponentID, size_t>& first,
+			const std::pair<ComponentID, size_t>& second)
 		{
 			return  first.second < second.second;
 		});
@@ -46,6 +62,9 @@ void LRTR::Shape::onProperty()
 		ImGui::TreePop();
 	}
 	
+	//the components keep their ui states with the id of shape, because the shared components are in many shapes
+	ImGui::PushID(this);
+
 	for (auto component : orderComponents) {
 		if (ImGui::TreeNodeEx(mComponents[component.first]->typeName().c_str(), treeNodeFlags)) {
 
@@ -54,4 +73,6 @@ void LRTR::Shape::onProperty()
 			ImGui::TreePop();
 		}
 	}
+
+	ImGui::PopID();
 }
\ No newline at end of file
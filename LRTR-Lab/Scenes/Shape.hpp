@@ -1,13 +1,20 @@
 #pragma once
 
+#include "../Shared/Accelerators/SlotMap.hpp"
 #include "../Shared/Accelerators/Group.hpp"
 #include "Component.hpp"
 
 #include <typeindex>
 #include <memory>
+#include <vector>
 
 namespace LRTR {
 
+	class ArchetypeStorage;
+
+	//the generational handle of shape in scene, it is stale after the shape is removed
+	using ShapeHandle = SlotHandle;
+	
 	class Shape : public Noncopyable, public Propertyable, public TypeInfo {
 	public:
 		Shape();
@@ -17,19 +24,35 @@ namespace LRTR {
 		template<typename TComponent>
 		void addComponent(const std::shared_ptr<TComponent>& component);
 
+		//the shared components (e.g. the meshes of procedural mesh cache) are immutable
+		//they are only accessed with component<const TComponent>, so a shape can not change the others sharing them
+		template<typename TComponent>
+		void addComponent(const std::shared_ptr<const TComponent>& component);
+
 		template<typename TComponent>
 		void setComponent(const std::shared_ptr<TComponent>& component);
 		
 		template<typename TComponent>
 		void removeComponent();
 
+		//the TComponent can be const, the shared components return nullptr if the TComponent is not const
 		template<typename TComponent>
 		auto component() const -> std::shared_ptr<TComponent>;
 
 		template<typename TComponent>
 		auto hasComponent() const -> bool;
+
+		//the component is added as const, so it may be shared with other shapes
+		template<typename TComponent>
+		auto isShared() const -> bool;
 		
-		auto components() const -> const Group<std::type_index, std::shared_ptr<Component>>&;
+		//the component with dense id, return nullptr if the shape does not have it
+		auto component(const ComponentID id) const -> std::shared_ptr<Component>;
+
+		auto signature() const noexcept -> const ComponentSignature&;
+
+		//the handle of shape in scene, it is not valid if the shape is not in a scene
+		auto handle() const noexcept -> ShapeHandle;
 
 		auto typeName() const noexcept -> std::string override;
 
@@ -37,12 +60,29 @@ namespace LRTR {
 	protected:
 		void onProperty() override;
 	private:
-		Group<std::type_index, std::shared_ptr<Component>> mComponents;
-		Group<std::type_index, size_t> mComponentsIndex;
+		//tell the storage of scene that the components are changed
+		void refreshStorage() const;
+
+		friend class ArchetypeStorage;
+		friend class Scene;
+	private:
+		//the components are indexed by the dense id of component type
+		std::vector<std::shared_ptr<Component>> mComponents;
+		Group<ComponentID, size_t> mComponentsIndex;
 
+		ComponentSignature mSignature;
+		ComponentSignature mSharedSignature;
+
+		ArchetypeStorage* mStorage = nullptr;
+
+		ShapeHandle mHandle;
+		
 		size_t mOrder = 0;
 	};
 
+	//the scene owns the shapes in slot map, others use the handles to find them
+	using ShapeSlotMap = SlotMap<std::shared_ptr<Shape>>;
+	
 	template<typename Type>
 	using IsShape = std::is_base_of<Shape, Type>;
 
@@ -51,8 +91,28 @@ namespace LRTR {
 	{
 		static_assert(IsComponent<TComponent>::value, "The Component should be based of Component.");
 		
-		mComponents.insert({ typeid(TComponent), component });
-		mComponentsIndex.insert({ typeid(TComponent),  mOrder++ });
+		const auto id = ComponentType<TComponent>::id();
+
+		if (mSignature.test(id)) return;
+		if (mComponents.size() <= id) mComponents.resize(id + 1);
+
+		mComponents[id] = component;
+		mComponentsIndex.insert({ id,  mOrder++ });
+		mSignature.set(id);
+
+		refreshStorage();
+	}
+
+	template <typename TComponent>
+	void Shape::addComponent(const std::shared_ptr<const TComponent>& component)
+	{
+		//the columns of archetypes keep the pointers of all components, so we store it as others
+		//but the shape only gives it to the callers with const type
+		if (hasComponent<TComponent>()) return;
+
+		mSharedSignature.set(ComponentType<TComponent>::id());
+
+		addComponent(std::const_pointer_cast<TComponent>(component));
 	}
 
 	template <typename TComponent>
@@ -61,7 +121,12 @@ namespace LRTR {
 		static_assert(IsComponent<TComponent>::value, "The Component should be based of Component.");
 
 		if (!hasComponent<TComponent>()) addComponent(component);
-		else mComponents[typeid(TComponent)] = component;
+		else {
+			mComponents[ComponentType<TComponent>::id()] = component;
+			mSharedSignature.reset(ComponentType<TComponent>::id());
+
+			refreshStorage();
+		}
 	}
 
 	template <typename TComponent>
@@ -69,24 +134,52 @@ namespace LRTR {
 	{
 		static_assert(IsComponent<TComponent>::value, "The Component should be based of Component.");
 
-		mComponents.erase(typeid(TComponent));
-		mComponentsIndex.erase(typeid(TComponent));
+		const auto id = ComponentType<TComponent>::id();
+
+		if (!mSignature.test(id)) return;
+
+		mComponents[id] = nullptr;
+		mComponentsIndex.erase(id);
+		mSignature.reset(id);
+		mSharedSignature.reset(id);
+
+		refreshStorage();
 	}
 
 	template <typename TComponent>
 	auto Shape::component() const -> std::shared_ptr<TComponent>
 	{
-		static_assert(IsComponent<TComponent>::value, "The Component should be based of Component.");
+		using Type = std::remove_const_t<TComponent>;
+
+		static_assert(IsComponent<Type>::value, "The Component should be based of Component.");
 
-		return std::dynamic_pointer_cast<TComponent>(mComponents.at(typeid(TComponent)));
+		if (!hasComponent<Type>()) return nullptr;
+
+		//the shared component is immutable, so we do not give the mutable pointer of it
+		if (!std::is_const<TComponent>::value && isShared<Type>()) {
+			LRTR_ERROR("The shared component {0} is immutable, use component<const {0}> instead.", typeid(Type).name());
+
+			return nullptr;
+		}
+		
+		//the component is stored with the type TComponent, so static cast is safe
+		return std::static_pointer_cast<TComponent>(mComponents[ComponentType<Type>::id()]);
 	}
 
 	template <typename TComponent>
 	auto Shape::hasComponent() const -> bool
 	{
-		static_assert(IsComponent<TComponent>::value, "The Component should be based of Component.");
+		static_assert(IsComponent<std::remove_const_t<TComponent>>::value, "The Component should be based of Component.");
+
+		return mSignature.test(ComponentType<std::remove_const_t<TComponent>>::id());
+	}
+
+	template <typename TComponent>
+	auto Shape::isShared() const -> bool
+	{
+		static_assert(IsComponent<std::remove_const_t<TComponent>>::value, "The Component should be based of Component.");
 
-		return mComponents.find(typeid(TComponent)) != mComponents.end();
+		return mSharedSignature.test(ComponentType<std::remove_const_t<TComponent>>::id());
 	}
 
 }
@@ -2,16 +2,26 @@
 
 #include "../Components/LinesMesh/CoordinateSystem.hpp"
 #include "../Components/LinesMesh/LinesGrid.hpp"
+#include "../Components/OcclusionCulling.hpp"
+#include "../Components/ClusterCulling.hpp"
+#include "../Components/RenderStatistics.hpp"
+#include "../Components/LevelOfDetail.hpp"
+#include "../Components/FrustumCulling.hpp"
 #include "../Components/TransformWrap.hpp"
 #include "../Components/CameraGroup.hpp"
 
-LRTR::SceneProperty::SceneProperty()
+LRTR::SceneProperty::SceneProperty(const ShapeSlotMap& shapes)
 {
-	addComponent(std::make_shared<CoordinateSystem>());
-	addComponent(std::make_shared<CameraGroup>());
-	addComponent(std::make_shared<LinesGrid>(RectangleF(-5, -5, 5, 5), 10, 10,
+	addComponent(makeComponent<CoordinateSystem>());
+	addComponent(makeComponent<CameraGroup>(shapes));
+	addComponent(makeComponent<LinesGrid>(RectangleF(-5, -5, 5, 5), 10, 10,
 		Vector3f(1, 0, 0), Vector3f(0, 1, 0),
 		Vector3f(0, 0, -0.001f)));
+	addComponent(makeComponent<RenderStatistics>());
+	addComponent(makeComponent<FrustumCulling>());
+	addComponent(makeComponent<OcclusionCulling>());
+	addComponent(makeComponent<LevelOfDetail>());
+	addComponent(makeComponent<ClusterCulling>());
 }
 
 auto LRTR::SceneProperty::typeName() const noexcept -> std::string
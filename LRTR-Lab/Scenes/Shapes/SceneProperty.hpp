@@ -6,7 +6,7 @@ namespace LRTR {
 
 	class SceneProperty : public Shape {
 	public:
-		SceneProperty();
+		explicit SceneProperty(const ShapeSlotMap& shapes);
 
 		~SceneProperty() = default;
 
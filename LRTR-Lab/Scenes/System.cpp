@@ -1,5 +1,21 @@
 #include "System.hpp"
 
+#include <algorithm>
+
+auto LRTR::SystemAccess::conflict(const SystemAccess& other) const -> bool
+{
+	if (Exclusive || other.Exclusive) return true;
+
+	//the system writes the components that other system reads or writes
+	if ((Writes & (other.Reads | other.Writes)).any()) return true;
+	if ((other.Writes & Reads).any()) return true;
+
+	for (const auto& resource : Resources) 
+		if (std::find(other.Resources.begin(), other.Resources.end(), resource) != other.Resources.end()) return true;
+
+	return false;
+}
+
 LRTR::System::System(const std::shared_ptr<RuntimeSharing>& sharing) :
 	mRuntimeSharing(sharing)
 {
@@ -21,6 +37,17 @@ LRTR::UpdateSystem::UpdateSystem(const std::shared_ptr<RuntimeSharing>& sharing)
 {
 }
 
+auto LRTR::UpdateSystem::access() const noexcept -> const SystemAccess&
+{
+	return mAccess;
+}
+
+void LRTR::UpdateSystem::uses(const std::string& resource)
+{
+	mAccess.Resources.push_back(resource);
+	mAccess.Exclusive = false;
+}
+
 auto LRTR::UpdateSystem::typeName() const noexcept -> std::string
 {
 	return "UpdateSystem";
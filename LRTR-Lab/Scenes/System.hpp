@@ -17,6 +17,25 @@
 namespace LRTR {
 
 	using SceneCamera = ProjectiveCamera;
+
+	class Scene;
+
+	//the components and shared resources a system accesses in update
+	//the scheduler runs two systems at the same time only if they do not conflict
+	struct SystemAccess {
+		ComponentSignature Reads;
+		ComponentSignature Writes;
+
+		//the names of shared resources(e.g. asset components) the system modifies
+		std::vector<std::string> Resources;
+
+		//if the system is exclusive, it will not run with other systems
+		bool Exclusive = true;
+
+		SystemAccess() = default;
+
+		auto conflict(const SystemAccess& other) const -> bool;
+	};
 	
 	class System : public Noncopyable, public TypeInfo {
 	public:
@@ -37,13 +56,24 @@ namespace LRTR {
 
 		~UpdateSystem() = default;
 
-		virtual void update(
-			const Group<Identity, std::shared_ptr<Shape>>& shapes,
-			float delta) = 0;
+		virtual void update(const Scene& scene, float delta) = 0;
 
+		auto access() const noexcept -> const SystemAccess&;
+		
 		auto typeName() const noexcept -> std::string override;
 
 		auto typeIndex() const noexcept -> std::type_index override;
+	protected:
+		//a system that does not declare what it accesses is exclusive
+		template<typename... TComponents>
+		void reads();
+
+		template<typename... TComponents>
+		void writes();
+
+		void uses(const std::string& resource);
+	protected:
+		SystemAccess mAccess;
 	};
 
 	class RenderSystem : public UpdateSystem {
@@ -71,5 +101,19 @@ namespace LRTR {
 		
 		size_t mCurrentFrameIndex = 0;
 	};
+
+	template <typename ... TComponents>
+	void UpdateSystem::reads()
+	{
+		mAccess.Reads |= signatureOf<TComponents...>();
+		mAccess.Exclusive = false;
+	}
+
+	template <typename ... TComponents>
+	void UpdateSystem::writes()
+	{
+		mAccess.Writes |= signatureOf<TComponents...>();
+		mAccess.Exclusive = false;
+	}
 	
 }
\ No newline at end of file
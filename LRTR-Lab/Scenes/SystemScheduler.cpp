@@ -0,0 +1,110 @@
+#include "SystemScheduler.hpp"
+
+#include "Scene.hpp"
+
+#include <exception>
+
+namespace LRTR {
+
+	//call the function when the guard leaves the scope, even if the scope throws
+	template<typename Function>
+	class ScopeGuard : public Noncopyable {
+	public:
+		explicit ScopeGuard(Function function) : mFunction(std::move(function)) {}
+
+		~ScopeGuard() { mFunction(); }
+	private:
+		Function mFunction;
+	};
+
+}
+
+LRTR::SystemScheduler::SystemScheduler(const std::shared_ptr<ThreadPool>& threadPool) :
+	mThreadPool(threadPool)
+{
+}
+
+void LRTR::SystemScheduler::add(const std::shared_ptr<UpdateSystem>& system)
+{
+	mNodes.push_back({ system });
+
+	mDirty = true;
+}
+
+void LRTR::SystemScheduler::update(const Scene& scene, float delta)
+{
+	if (mDirty) build();
+
+	if (mNodes.empty()) return;
+
+	std::vector<std::atomic<size_t>> dependencies(mNodes.size());
+	std::atomic<size_t> remaining = mNodes.size();
+
+	for (size_t index = 0; index < mNodes.size(); index++)
+		dependencies[index] = mNodes[index].Dependencies;
+
+	//the first exception of systems, it is rethrown when all systems are finished
+	std::exception_ptr exception = nullptr;
+	std::mutex exceptionMutex;
+	std::atomic<bool> failed = false;
+
+	std::function<void(size_t)> execute = [&](size_t index)
+	{
+		//the successors and the remaining count must be released even if the system throws
+		//otherwise the wait below never finishes
+		const auto guard = ScopeGuard([&, index]()
+			{
+				//the successor is ready when all systems it depends on are finished
+				for (const auto successor : mNodes[index].Successors)
+					if (--dependencies[successor] == 0) mThreadPool->submit([&execute, successor]() { execute(successor); });
+
+				--remaining;
+			});
+
+		//the systems after a failed system are skipped, they may depend on the result of it
+		if (failed) return;
+
+		try {
+			mNodes[index].System->update(scene, delta);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(exceptionMutex);
+
+			if (exception == nullptr) exception = std::current_exception();
+
+			failed = true;
+		}
+	};
+
+	for (size_t index = 0; index < mNodes.size(); index++)
+		if (mNodes[index].Dependencies == 0) mThreadPool->submit([&execute, index]() { execute(index); });
+
+	mThreadPool->wait([&]() { return remaining == 0; });
+
+	if (exception != nullptr) std::rethrow_exception(exception);
+}
+
+auto LRTR::SystemScheduler::threadPool() const noexcept -> std::shared_ptr<ThreadPool>
+{
+	return mThreadPool;
+}
+
+void LRTR::SystemScheduler::build()
+{
+	for (auto& node : mNodes) {
+		node.Successors.clear();
+		node.Dependencies = 0;
+	}
+
+	//keep the order of systems we added if they conflict
+	for (size_t first = 0; first < mNodes.size(); first++) {
+		for (size_t second = first + 1; second < mNodes.size(); second++) {
+			if (!mNodes[first].System->access().conflict(mNodes[second].System->access())) continue;
+
+			mNodes[first].Successors.push_back(second);
+			mNodes[second].Dependencies++;
+		}
+	}
+
+	mDirty = false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../Shared/Parallel/ThreadPool.hpp"
+#include "../Core/Noncopyable.hpp"
+
+#include "System.hpp"
+
+namespace LRTR {
+
+	class Scene;
+
+	//the scheduler builds a graph of update systems, if two systems conflict
+	//the one added later depends on the one added earlier
+	//the systems without dependencies run at the same time in thread pool
+	class SystemScheduler : public Noncopyable {
+	public:
+		explicit SystemScheduler(const std::shared_ptr<ThreadPool>& threadPool);
+
+		~SystemScheduler() = default;
+
+		void add(const std::shared_ptr<UpdateSystem>& system);
+
+		void update(const Scene& scene, float delta);
+
+		auto threadPool() const noexcept -> std::shared_ptr<ThreadPool>;
+	private:
+		void build();
+	private:
+		struct SystemNode {
+			std::shared_ptr<UpdateSystem> System;
+			std::vector<size_t> Successors;
+			size_t Dependencies = 0;
+		};
+		
+		std::shared_ptr<ThreadPool> mThreadPool;
+
+		std::vector<SystemNode> mNodes;
+
+		bool mDirty = false;
+	};
+	
+}
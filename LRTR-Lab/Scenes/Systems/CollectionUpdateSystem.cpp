@@ -1,24 +1,32 @@
 #include "CollectionUpdateSystem.hpp"
 
+#include "../Scene.hpp"
+
 #include "../Components/CollectionLabel.hpp"
 
 LRTR::CollectionUpdateSystem::CollectionUpdateSystem(const std::shared_ptr<RuntimeSharing>& sharing) :
 	UpdateSystem(sharing)
 {
-	
+	reads<CollectionLabel>();
 }
 
-void LRTR::CollectionUpdateSystem::update(const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta)
+void LRTR::CollectionUpdateSystem::update(const Scene& scene, float delta)
 {
 	mCollections.clear();
 
-	for (const auto& shape : shapes) {
-		//if the shape does not have the component, we will think it has a label called "Collection"
-		const auto component = shape.second->hasComponent<CollectionLabel>() ?
-			shape.second->component<CollectionLabel>() : std::make_shared<CollectionLabel>();
-		
-		mCollections[component->label()].push_back({ component->name(), shape.second });
-	}
+	//the query without components matches all shapes
+	scene.query<>().each([&](const Archetype& archetype)
+		{
+			//if the shape does not have the component, we will think it has a label called "Collection"
+			const auto defaultLabel = makeComponent<CollectionLabel>();
+			const auto hasLabel = archetype.has<CollectionLabel>();
+			
+			for (size_t row = 0; row < archetype.size(); row++) {
+				const auto component = hasLabel ? archetype.get<CollectionLabel>(row) : defaultLabel.get();
+
+				mCollections[component->label()].push_back({ component->name(), archetype.shapes()[row]->handle() });
+			}
+		});
 }
 
 auto LRTR::CollectionUpdateSystem::collections() const noexcept -> const StringGroup<Collection>& 
@@ -8,16 +8,14 @@ namespace LRTR {
 	
 	class CollectionUpdateSystem : public UpdateSystem {
 	public:
-		using Collection = std::vector<std::pair<std::string, std::shared_ptr<Shape>>>;
+		using Collection = std::vector<std::pair<std::string, ShapeHandle>>;
 		
 		explicit CollectionUpdateSystem(
 			const std::shared_ptr<RuntimeSharing>& sharing);
 
 		~CollectionUpdateSystem() = default;
 
-		void update(
-			const Group<Identity, std::shared_ptr<Shape>>& shapes, 
-			float delta) override;
+		void update(const Scene& scene, float delta) override;
 
 		auto collections() const noexcept -> const StringGroup<Collection>&;
 		
@@ -1,5 +1,7 @@
 #include "LinesMeshRenderSystem.hpp"
 
+#include "../Scene.hpp"
+
 #include <CodeRed/Core/CodeRedGraphics.hpp>
 
 #include "../Components/LinesMesh/CoordinateSystem.hpp"
@@ -25,6 +27,8 @@ LRTR::LinesMeshRenderSystem::LinesMeshRenderSystem(
 	const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
 	size_t maxFrameCount) : RenderSystem(sharing, device, maxFrameCount)
 {
+	reads<TransformWrap, CoordinateSystem, LinesMesh, LinesGrid>();
+
 	mViewBuffer = mDevice->createBuffer(
 		CodeRed::ResourceInfo::ConstantBuffer(
 			sizeof(Matrix4x4f)
@@ -132,15 +136,15 @@ LRTR::LinesMeshRenderSystem::LinesMeshRenderSystem(
 	);
 }
 
-void LRTR::LinesMeshRenderSystem::update(const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta)
+void LRTR::LinesMeshRenderSystem::update(const Scene& scene, float delta)
 {
 	std::vector<Matrix4x4f> transforms;
 	std::vector<LineVertex> vertices;
 	std::vector<unsigned> indices;
 
-	static const auto ProcessLinesMeshComponent = [&](
+	const auto ProcessLinesMeshComponent = [&](
 		const Matrix4x4f& transform,
-		const std::shared_ptr<LinesMesh>& component)
+		const LinesMesh* component)
 	{
 		if (!component->IsRendered) return;
 
@@ -157,20 +161,33 @@ void LRTR::LinesMeshRenderSystem::update(const Group<Identity, std::shared_ptr<S
 		}
 	};
 	
-	for (const auto& shape : shapes) {
-		const auto transform =
-			shape.second->hasComponent<TransformWrap>() ? shape.second->component<TransformWrap>()->transform().matrix() :
-			Matrix4x4f(1);
-		
-		if (shape.second->hasComponent<CoordinateSystem>())
-			ProcessLinesMeshComponent(transform, shape.second->component<CoordinateSystem>());
+	//the column stores the components of TComponent, all of them are based of LinesMesh
+	const auto ProcessLinesMeshColumn = [&](const Archetype& archetype, 
+		const std::vector<Component*>& column)
+	{
+		const auto hasTransform = archetype.has<TransformWrap>();
 
-		if (shape.second->hasComponent<LinesMesh>())
-			ProcessLinesMeshComponent(transform, shape.second->component<LinesMesh>());
+		for (size_t row = 0; row < archetype.size(); row++) {
+			ProcessLinesMeshComponent(
+				hasTransform ? archetype.get<TransformWrap>(row)->world() : Matrix4x4f(1),
+				static_cast<LinesMesh*>(column[row]));
+		}
+	};
 
-		if (shape.second->hasComponent<LinesGrid>())
-			ProcessLinesMeshComponent(transform, shape.second->component<LinesGrid>());
-	}
+	scene.query<CoordinateSystem>().each([&](const Archetype& archetype)
+		{
+			ProcessLinesMeshColumn(archetype, archetype.column<CoordinateSystem>());
+		});
+
+	scene.query<LinesMesh>().each([&](const Archetype& archetype)
+		{
+			ProcessLinesMeshColumn(archetype, archetype.column<LinesMesh>());
+		});
+
+	scene.query<LinesGrid>().each([&](const Archetype& archetype)
+		{
+			ProcessLinesMeshColumn(archetype, archetype.column<LinesGrid>());
+		});
 
 	auto vertexBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("VertexBuffer");
 	auto indexBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("IndexBuffer");
@@ -13,8 +13,7 @@ namespace LRTR {
 			const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
 			size_t maxFrameCount = 2);
 
-		void update(
-			const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta) override;
+		void update(const Scene& scene, float delta) override;
 
 		void render(
 			const std::vector<std::shared_ptr<CodeRed::GpuGraphicsCommandList>>& commandLists,
@@ -1,5 +1,7 @@
 #include "MotionCameraUpdateSystem.hpp"
 
+#include "../Scene.hpp"
+
 #include "../../Runtimes/Managers/Input/InputManager.hpp"
 #include "../../Runtimes/Managers/UI/UIManager.hpp"
 
@@ -11,10 +13,11 @@
 LRTR::MotionCameraUpdateSystem::MotionCameraUpdateSystem(const std::shared_ptr<RuntimeSharing>& sharing) :
 	UpdateSystem(sharing)
 {
-	
+	reads<Projective, MotionProperty>();
+	writes<TransformWrap>();
 }
 
-void LRTR::MotionCameraUpdateSystem::update(const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta)
+void LRTR::MotionCameraUpdateSystem::update(const Scene& scene, float delta)
 {
 	const auto inputManager = mRuntimeSharing->inputManager();
 	const auto uiManager = mRuntimeSharing->uiManager();
@@ -29,56 +32,56 @@ void LRTR::MotionCameraUpdateSystem::update(const Group<Identity, std::shared_pt
 
 	const auto offset = mousePosition - mLastMousePosition;
 
-	for (const auto& shape : shapes) {
-		if (shape.second->hasComponent<Projective>() &&
-			shape.second->hasComponent<MotionProperty>() &&
-			shape.second->hasComponent<TransformWrap>()) {
-			const auto transform = shape.second->component<TransformWrap>();
-			const auto perspective = std::static_pointer_cast<Perspective>(shape.second->component<Projective>());
-			const auto motionProperty = shape.second->component<MotionProperty>();
+	//the cameras are independent, so we can update them in parallel
+	scene.query<Projective, MotionProperty, TransformWrap>().parallelEach(*scene.threadPool(), 64,
+		[&](const Archetype& archetype, size_t begin, size_t end)
+		{
+			for (size_t row = begin; row < end; row++) {
+				const auto transform = archetype.get<TransformWrap>(row);
+				const auto motionProperty = archetype.get<MotionProperty>(row);
 			
-			const auto axes = motionProperty->axes();
+				const auto axes = motionProperty->axes();
 			
-			auto realOffset = Vector2f();
+				auto realOffset = Vector2f();
 
-			// we only rotate the camera when the mouse is in region of scene view
-			if (sceneRegion.contain(mLastMousePosition) && sceneRegion.contain(mousePosition) &&
-				inputManager->keyState(KeyCode::RButton)) realOffset = motionProperty->sensitivity() * offset;
+				// we only rotate the camera when the mouse is in region of scene view
+				if (sceneRegion.contain(mLastMousePosition) && sceneRegion.contain(mousePosition) &&
+					inputManager->keyState(KeyCode::RButton)) realOffset = motionProperty->sensitivity() * offset;
 
-			auto yaw = glm::yaw(transform->rotation());
-			auto pitch = glm::pitch(transform->rotation()) - realOffset.y;
-			auto roll = glm::roll(transform->rotation()) - realOffset.x;
+				auto yaw = glm::yaw(transform->rotation());
+				auto pitch = glm::pitch(transform->rotation()) - realOffset.y;
+				auto roll = glm::roll(transform->rotation()) - realOffset.x;
 
-			if (pitch > glm::radians(179.f)) pitch = glm::radians(179.f);
-			if (pitch < glm::radians(1.f)) pitch = glm::radians(1.f);
+				if (pitch > glm::radians(179.f)) pitch = glm::radians(179.f);
+				if (pitch < glm::radians(1.f)) pitch = glm::radians(1.f);
 
-			const auto rotation = Transform(
-				Vector3f(0), 
-				QuaternionF(Vector3f(pitch, yaw, roll)), 
-				Vector3f(1));
+				const auto rotation = Transform(
+					Vector3f(0), 
+					QuaternionF(Vector3f(pitch, yaw, roll)), 
+					Vector3f(1));
 
-			const Vector3f xAxis = glm::normalize(rotation(Vector3f(1, 0, 0)));
-			const Vector3f zAxis = glm::normalize(rotation(Vector3f(0, 0, 1)));
+				const Vector3f xAxis = glm::normalize(rotation(Vector3f(1, 0, 0)));
+				const Vector3f zAxis = glm::normalize(rotation(Vector3f(0, 0, 1)));
 			
-			auto translate = Vector3f();
+				auto translate = Vector3f();
 
-			if (inputManager->keyState(KeyCode::D)) translate = translate + xAxis * delta * motionProperty->speed();
-			if (inputManager->keyState(KeyCode::A)) translate = translate - xAxis * delta * motionProperty->speed();
-			if (inputManager->keyState(KeyCode::W)) translate = translate - zAxis * delta * motionProperty->speed();
-			if (inputManager->keyState(KeyCode::S)) translate = translate + zAxis * delta * motionProperty->speed();
+				if (inputManager->keyState(KeyCode::D)) translate = translate + xAxis * delta * motionProperty->speed();
+				if (inputManager->keyState(KeyCode::A)) translate = translate - xAxis * delta * motionProperty->speed();
+				if (inputManager->keyState(KeyCode::W)) translate = translate - zAxis * delta * motionProperty->speed();
+				if (inputManager->keyState(KeyCode::S)) translate = translate + zAxis * delta * motionProperty->speed();
 			
-			translate.x = axes[0] ? translate.x : 0;
-			translate.y = axes[1] ? translate.y : 0;
-			translate.z = axes[2] ? translate.z : 0;
+				translate.x = axes[0] ? translate.x : 0;
+				translate.y = axes[1] ? translate.y : 0;
+				translate.z = axes[2] ? translate.z : 0;
 
-			if (inputManager->keyState(KeyCode::F)) translate = translate + Vector3f(0, 0, -1) * delta * motionProperty->speed();
-			if (inputManager->keyState(KeyCode::Space)) translate = translate + Vector3f(0, 0, 1) * delta * motionProperty->speed();
+				if (inputManager->keyState(KeyCode::F)) translate = translate + Vector3f(0, 0, -1) * delta * motionProperty->speed();
+				if (inputManager->keyState(KeyCode::Space)) translate = translate + Vector3f(0, 0, 1) * delta * motionProperty->speed();
 			
-			transform->set(transform->translation() + translate,
-				QuaternionF(Vector3f(pitch, yaw, roll)),
-				transform->scale());
-		}
-	}
+				transform->set(transform->translation() + translate,
+					QuaternionF(Vector3f(pitch, yaw, roll)),
+					transform->scale());
+			}
+		});
 
 
 	mLastMousePosition = mousePosition;
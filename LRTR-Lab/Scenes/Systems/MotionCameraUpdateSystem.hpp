@@ -10,7 +10,7 @@ namespace LRTR {
 
 		~MotionCameraUpdateSystem() = default;
 
-		void update(const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta) override;
+		void update(const Scene& scene, float delta) override;
 
 		auto typeName() const noexcept -> std::string override;
 
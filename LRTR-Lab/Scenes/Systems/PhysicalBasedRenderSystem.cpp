@@ -1,5 +1,7 @@
 #include "PhysicalBasedRenderSystem.hpp"
 
+#include "../Scene.hpp"
+
 #include <CodeRed/Core/CodeRedGraphics.hpp>
 
 #include "../../Runtimes/Managers/Asset/Components/MeshDataAssetComponent.hpp"
@@ -8,6 +10,12 @@
 #include "../../Scenes/Components/MeshData/TrianglesMesh.hpp"
 #include "../../Scenes/Components/LightSources/PointLightSource.hpp"
 #include "../../Scenes/Components/Materials/PhysicalBasedMaterial.hpp"
+#include "../../Scenes/Components/OcclusionCulling.hpp"
+#include "../../Scenes/Components/ClusterCulling.hpp"
+#include "../../Scenes/Components/RenderStatistics.hpp"
+#include "../../Scenes/Components/LevelOfDetail.hpp"
+#include "../../Scenes/Components/FrustumCulling.hpp"
+#include "../../Scenes/Components/CameraGroup.hpp"
 
 #include "../../Shared/Textures/ConstantTexture.hpp"
 #include "../../Shared/Graphics/ResourceHelper.hpp"
@@ -16,56 +24,64 @@
 
 #include "../../Workflow/Shaders/CompileShaderWorkflow.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <tuple>
+
 #define LRTR_RESET_BUFFER(buffer, name, binding) \
 	if (buffer != mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>(name)) { \
 		mFrameResources[mCurrentFrameIndex].set(name, buffer); \
 	}
 
 namespace LRTR {
-	
-	struct SharedMaterial {
-		Vector4f BaseColor;
-		Vector4f Roughness;
-		Vector4f Metallic;
-		Vector4f Emissive;
-	};
 
-	struct SharedLight {
-		Vector4f Position;
-		Vector4f Intensity;
+	//the version we use to mark the slot is not uploaded
+	constexpr size_t InvalidVersion = ~static_cast<size_t>(0);
+
+	//the memory of point shadow atlas, 64MB is a 4096 x 4096 depth texture
+	constexpr size_t PointShadowAtlasBudget = 64 * 1024 * 1024;
+
+	//the far plane of point shadows
+	constexpr float PointShadowRadius = 25.0f;
+
+	//the entry is an occluder only if the radius of its bound is not less than 0.1 of the distance to camera
+	constexpr float MinOccluderSize = 0.1f;
 
-		float FarPlane;
-		unsigned Index;
-		unsigned Type;
-		unsigned Unused;
+	//the components are read from the columns of archetype, so building entries does not touch reference counts
+	//the shape is only used to get the shared mesh for the draw calls and shadow casters
+	struct PhysicalBasedEntry {
+		const PhysicalBasedMaterial* Material;
+		const TransformWrap* Transform;
+		const TrianglesMesh* Mesh;
+		const Shape* Owner;
+
+		size_t Slot;
 	};
 	
 }
 
-LRTR::PointShadowMap::PointShadowMap(
-	const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
-	const size_t extent, const size_t length)
+LRTR::PhysicalBasedSlot::PhysicalBasedSlot(
+	const Identity& owner, const size_t lastSeen, const size_t maxFrameCount) :
+	TransformVersions(maxFrameCount, InvalidVersion), MaterialVersions(maxFrameCount, InvalidVersion),
+	Owner(owner), LastSeen(lastSeen)
+{
+}
+
+LRTR::PointShadowAtlas::PointShadowAtlas(
+	const std::shared_ptr<CodeRed::GpuLogicalDevice>& device, const size_t budget) :
+	Allocator(budget, sizeof(float))
 {
 	Texture = device->createTexture(
-		CodeRed::ResourceInfo::CubeMapArray(extent, extent, length, CodeRed::PixelFormat::Depth32BitFloat, 1,
-			CodeRed::ResourceUsage::DepthStencil)
+		CodeRed::ResourceInfo::DepthStencil(
+			Allocator.extent(),
+			Allocator.extent(),
+			CodeRed::PixelFormat::Depth32BitFloat,
+			CodeRed::ClearValue(1, 0)
+		)
 	);
 
-	for (size_t index = 0; index < length; index++) {
-		PointShadowFrameBuffer frameBuffer;
-
-		for (size_t face = 0; face < 6; face++) {
-			frameBuffer[face] = device->createFrameBuffer({}, Texture->reference(
-				CodeRed::TextureRefInfo(
-					CodeRed::ValueRange<size_t>(0, 1),
-					CodeRed::ValueRange<size_t>(index * 6 + face, index * 6 + face + 1),
-					CodeRed::TextureRefUsage::Common,
-					CodeRed::PixelFormat::Depth32BitFloat
-				)));
-		}
-
-		FrameBuffers.push_back(frameBuffer);
-	}
+	FrameBuffer = device->createFrameBuffer({}, Texture->reference());
 }
 
 LRTR::PhysicalBasedRenderSystem::PhysicalBasedRenderSystem(
@@ -73,6 +89,10 @@ LRTR::PhysicalBasedRenderSystem::PhysicalBasedRenderSystem(
 	const std::shared_ptr<CodeRed::GpuLogicalDevice>& device, 
 	size_t maxFrameCount) : RenderSystem(sharing, device, maxFrameCount)
 {
+	reads<TransformWrap, TrianglesMesh, PhysicalBasedMaterial, PointLightSource, Projective, CameraGroup>();
+	writes<RenderStatistics, FrustumCulling, OcclusionCulling, LevelOfDetail, ClusterCulling>();
+	uses("MeshData");
+
 	mViewBuffer = mDevice->createBuffer(
 		CodeRed::ResourceInfo::ConstantBuffer(
 			sizeof(Matrix4x4f) * 4
@@ -97,9 +117,12 @@ LRTR::PhysicalBasedRenderSystem::PhysicalBasedRenderSystem(
 	//resource 8 : irradiance map
 	//resource 9 : pre filtering map
 	//resource 10 : pre computingBRDF map
-	//resource 11 : point shadow map array
-	//resource 12 : sampler
-	//resource 13 : hasEnvironmentLight, eyePosition.x, eyePosition.y, eyePosition.z, MipLevels, nLights
+	//resource 11 : point shadow atlas
+	//resource 12 : light clusters
+	//resource 13 : light indices of clusters
+	//resource 14 : sampler
+	//resource 15 : hasEnvironmentLight, eyePosition.x, eyePosition.y, eyePosition.z, MipLevels, nLights,
+	//              clusterWidth, clusterHeight, clusterDepth, zNear, zFar
 	mResourceLayout = mDevice->createResourceLayout(
 		{
 			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::GroupBuffer, 0),
@@ -113,10 +136,12 @@ LRTR::PhysicalBasedRenderSystem::PhysicalBasedRenderSystem(
 			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::Texture, 8),
 			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::Texture, 9),
 			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::Texture, 10),
-			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::Texture, 11)
+			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::Texture, 11),
+			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::GroupBuffer, 12),
+			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::GroupBuffer, 13)
 		}, {
 			CodeRed::SamplerLayoutElement(mSampler, 0, 1)
-		}, CodeRed::Constant32Bits(6, 0, 2));
+		}, CodeRed::Constant32Bits(11, 0, 2));
 
 	mDescriptorHeap = mDevice->createDescriptorHeap(mResourceLayout);
 	
@@ -147,12 +172,34 @@ LRTR::PhysicalBasedRenderSystem::PhysicalBasedRenderSystem(
 			)
 		);
 
+		auto clusterBuffer = mDevice->createBuffer(
+			CodeRed::ResourceInfo::GroupBuffer(
+				sizeof(LightCluster),
+				mLightClusterGrid.clusters().size(),
+				CodeRed::MemoryHeap::Upload
+			)
+		);
+
+		auto lightIndexBuffer = mDevice->createBuffer(
+			CodeRed::ResourceInfo::GroupBuffer(
+				sizeof(unsigned),
+				1024,
+				CodeRed::MemoryHeap::Upload
+			)
+		);
+		
 		frameResource.set("DescriptorHeapPool", descriptorHeapPool);
 		frameResource.set("TransformBuffer", transformBuffer);
 		frameResource.set("MaterialBuffer", materialBuffer);
 		frameResource.set("LightBuffer", lightBuffer);
+		frameResource.set("ClusterBuffer", clusterBuffer);
+		frameResource.set("LightIndexBuffer", lightIndexBuffer);
 	}
 
+	mUploadedLightVersions = std::vector<std::vector<PhysicalBasedLightVersion>>(mFrameResources.size());
+	mUploadedClusters = std::vector<std::vector<LightCluster>>(mFrameResources.size());
+	mUploadedLightIndices = std::vector<std::vector<unsigned>>(mFrameResources.size());
+
 	mPipelineInfo = std::make_shared<CodeRed::PipelineInfo>(mDevice);
 
 	const auto pipelineFactory = mPipelineInfo->pipelineFactory();
@@ -211,56 +258,217 @@ LRTR::PhysicalBasedRenderSystem::PhysicalBasedRenderSystem(
 		)
 	);
 	
-	// in this version, we only support 2 point light for test
-	mPointShadowMap = std::make_shared<PointShadowMap>(mDevice, 1024, 5);
+	mPointShadowAtlas = std::make_shared<PointShadowAtlas>(mDevice, PointShadowAtlasBudget);
 
 	mSSAOWorkflow = std::make_shared<ScreenSpaceAmbientOcclusionWorkflow>(mDevice);
 	mDeferredShadingWorkflow = std::make_shared<DeferredShadingWorkflow>(mDevice);
 	mPointShadowMapWorkflow = std::make_shared<PointShadowMapWorkflow>(mDevice);
 
 	mDescriptorHeap->bindBuffer(mViewBuffer, 1);
-	mDescriptorHeap->bindTexture(mPointShadowMap->Texture->reference(
+	mDescriptorHeap->bindTexture(mPointShadowAtlas->Texture->reference(
 		CodeRed::TextureRefInfo(
-			CodeRed::TextureRefUsage::CubeMap,
+			CodeRed::TextureRefUsage::Common,
 			CodeRed::PixelFormat::Red32BitFloat
 		)
 	), 11);
 }
 
-void LRTR::PhysicalBasedRenderSystem::update(const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta)
+void LRTR::PhysicalBasedRenderSystem::update(const Scene& scene, float delta)
 {
 	mPointShadowAreas.clear();
 	mShadowCastInfos.clear();
+	mDrawRanges.clear();
 	mDrawCalls.clear();
+
+	mUpdateTimes++;
 	
-	std::vector<Matrix4x4f> transforms;
+	std::vector<PhysicalBasedEntry> entries;
 	std::vector<SharedLight> lights;
-	std::vector<SharedMaterial> materials;
+	std::vector<PhysicalBasedLightVersion> lightVersions;
 
 	auto descriptorHeapPool = mFrameResources[mCurrentFrameIndex].
 		get<std::vector<std::shared_ptr<CodeRed::GpuDescriptorHeap>>>("DescriptorHeapPool");
+
+	size_t uploadBytes = 0;
+	size_t drawTriangles = 0;
+	size_t fullTriangles = 0;
 	
-	static const auto ProcessTrianglesMeshComponent = [&](
-		const std::shared_ptr<PhysicalBasedMaterial>& physicalBasedMaterial,
-		const std::shared_ptr<TrianglesMesh>& trianglesMesh,
-		const Matrix4x4f& transform,
-		const size_t index)
-	{
-		if (!physicalBasedMaterial->IsRendered) return;
+	//the shapes with same components are packed in one archetype
+	//so we only scan the columns of archetypes that match the components we need
+	scene.query<PhysicalBasedMaterial, TrianglesMesh>().each([&](const Archetype& archetype)
+		{
+			const auto& materialColumn = archetype.column<PhysicalBasedMaterial>();
+			const auto& meshColumn = archetype.column<TrianglesMesh>();
+			const auto transformColumn = archetype.has<TransformWrap>() ? &archetype.column<TransformWrap>() : nullptr;
+
+			for (size_t row = 0; row < archetype.size(); row++) {
+				entries.push_back({
+					static_cast<PhysicalBasedMaterial*>(materialColumn[row]),
+					transformColumn != nullptr ? static_cast<TransformWrap*>((*transformColumn)[row]) : nullptr,
+					static_cast<const TrianglesMesh*>(meshColumn[row]),
+					archetype.shapes()[row],
+					allocateSlot(archetype.shapes()[row]->identity())
+					});
+			}
+		});
+
+	//the shapes that are not seen in this update are removed, so we can reuse their slots
+	releaseSlots();
+
+	const auto frustumCulling = scene.property()->hasComponent<FrustumCulling>() ?
+		scene.property()->component<FrustumCulling>() : nullptr;
+	const auto occlusionCulling = scene.property()->hasComponent<OcclusionCulling>() ?
+		scene.property()->component<OcclusionCulling>() : nullptr;
+	const auto levelOfDetail = scene.property()->hasComponent<LevelOfDetail>() ?
+		scene.property()->component<LevelOfDetail>() : nullptr;
+	const auto clusterCulling = scene.property()->hasComponent<ClusterCulling>() ?
+		scene.property()->component<ClusterCulling>() : nullptr;
+
+	//the current camera of scene, we use it to cull draw calls and cluster lights
+	const auto camera = getSceneCamera(scene);
+	const auto cameraView = camera != nullptr ?
+		camera->component<TransformWrap>()->transform().inverseMatrix() : Matrix4x4f(1);
+	const auto cameraProjection = camera != nullptr ?
+		camera->component<Projective>()->toScreen().matrix() : Matrix4x4f(1);
+	
+	auto visibleEntries = entries.size();
+	auto testedEntries = static_cast<size_t>(0);
+
+	//the bounds of entries in world space, we use them to cull draw calls and shadow casters
+	std::vector<Bound3f> bounds(entries.size());
+
+	for (size_t index = 0; index < entries.size(); index++) {
+		bounds[index] = entries[index].Transform != nullptr ?
+			entries[index].Mesh->bound().transform(entries[index].Transform->world()) : entries[index].Mesh->bound();
+	}
+	
+	mVisible.assign(entries.size(), 1);
+
+	//the culled entries still upload their transforms and materials, because they may cast shadows
+	if (frustumCulling != nullptr && frustumCulling->IsEnabled && camera != nullptr) {
+		mFrustumCuller.clear();
+		mFrustumCuller.reserve(entries.size());
+
+		for (const auto& bound : bounds) mFrustumCuller.add(bound);
+
+		visibleEntries = mFrustumCuller.cull(FrustumF(cameraProjection * cameraView), mVisible);
+		testedEntries = entries.size();
+	}
+
+	if (frustumCulling != nullptr) {
+		frustumCulling->Tested = testedEntries;
+		frustumCulling->Culled = entries.size() - visibleEntries;
+		frustumCulling->Visible = visibleEntries;
+	}
+
+	const auto occlusionCulled = occlusionCulling != nullptr && occlusionCulling->IsEnabled && camera != nullptr;
+	
+	if (occlusionCulled)
+		cullOccludedEntries(scene, entries, bounds, cameraProjection * cameraView, *occlusionCulling);
+	else if (occlusionCulling != nullptr) 
+		occlusionCulling->Occluders = occlusionCulling->Triangles = occlusionCulling->Tested = occlusionCulling->Occluded = 0;
+
+	//the meshlets of visible entries are tested with the same camera, the occlusion culler is rendered above
+	const auto clusterCulled = clusterCulling != nullptr && clusterCulling->IsEnabled && camera != nullptr;
+
+	mClusterCulled = clusterCulling != nullptr && clusterCulling->IsEnabled;
+	mConeCulled = clusterCulling != nullptr && clusterCulling->IsConeCulled;
+	
+	if (clusterCulled) {
+		mClusterCuller.begin(cameraProjection * cameraView,
+			Vector3f(camera->component<TransformWrap>()->world()[3]),
+			clusterCulling->IsConeCulled,
+			occlusionCulled && clusterCulling->IsOcclusionCulled ? &mOcclusionCuller : nullptr);
+	}
+
+	auto transformBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("TransformBuffer");
+	auto materialBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("MaterialBuffer");
+
+	//the data of slots are kept in buffers, so we need copy them when we expand the buffers
+	const auto newTransformBuffer = CodeRed::ResourceHelper::expandAndCopyBuffer(mDevice, transformBuffer, mSlots.size());
+	const auto newMaterialBuffer = CodeRed::ResourceHelper::expandAndCopyBuffer(mDevice, materialBuffer, mSlots.size());
+	const auto reallocated = newTransformBuffer != transformBuffer || newMaterialBuffer != materialBuffer;
 
-		const auto descriptorHeap = (*descriptorHeapPool)[index];
+	transformBuffer = newTransformBuffer;
+	materialBuffer = newMaterialBuffer;
+	
+	LRTR_RESET_BUFFER(transformBuffer, "TransformBuffer", 2);
+	LRTR_RESET_BUFFER(materialBuffer, "MaterialBuffer", 0);
+
+	//the descriptor heaps we created before need bind the new buffers
+	if (reallocated) {
+		for (const auto& descriptorHeap : *descriptorHeapPool) {
+			descriptorHeap->bindBuffer(materialBuffer, 0);
+			descriptorHeap->bindBuffer(transformBuffer, 1);
+		}
+	}
+
+	//each slot has its own descriptor heap, because the textures of materials are different
+	while (descriptorHeapPool->size() < mSlots.size()) {
+		const auto descriptorHeap = mDevice->createDescriptorHeap(mDeferredShadingWorkflow->resourceLayout());
+
+		descriptorHeap->bindBuffer(materialBuffer, 0);
+		descriptorHeap->bindBuffer(transformBuffer, 1);
+		descriptorHeap->bindBuffer(mViewBuffer, 2);
+
+		descriptorHeapPool->push_back(descriptorHeap);
+	}
+
+	//the buffers of frames are kept mapped, so the slots need to upload are written into them directly
+	const auto transforms = static_cast<Matrix4x4f*>(CodeRed::ResourceHelper::mappedMemory(transformBuffer));
+	const auto materials = static_cast<SharedMaterial*>(CodeRed::ResourceHelper::mappedMemory(materialBuffer));
+	
+	for (size_t index = 0; index < entries.size(); index++) {
+		const auto& entry = entries[index];
+		const auto physicalBasedMaterial = entry.Material;
+		const auto descriptorHeap = (*descriptorHeapPool)[entry.Slot];
 		
-		PhysicalBasedDrawCall drawCall = {
-			trianglesMesh
-		};
+		auto& slot = mSlots[entry.Slot];
 
-		SharedMaterial material;
+		//the shape without transform uses identity matrix, we use version 0 for it
+		const auto transformVersion = entry.Transform != nullptr ? entry.Transform->version() : 0;
+		
+		if (slot.TransformVersions[mCurrentFrameIndex] != transformVersion) {
+			transforms[entry.Slot] = entry.Transform != nullptr ? entry.Transform->world() : Matrix4x4f(1);
 
-		material.BaseColor = physicalBasedMaterial->baseColorFactor()->value();
-		material.Roughness = physicalBasedMaterial->roughnessFactor()->value();
-		material.Metallic = physicalBasedMaterial->metallicFactor()->value();
-		material.Emissive = physicalBasedMaterial->emissiveFactor()->value();
+			slot.TransformVersions[mCurrentFrameIndex] = transformVersion;
+			uploadBytes = uploadBytes + sizeof(Matrix4x4f);
+		}
+
+		if (slot.MaterialVersions[mCurrentFrameIndex] != physicalBasedMaterial->version()) {
+			materials[entry.Slot] = {
+				physicalBasedMaterial->baseColorFactor()->value(),
+				physicalBasedMaterial->roughnessFactor()->value(),
+				physicalBasedMaterial->metallicFactor()->value(),
+				physicalBasedMaterial->emissiveFactor()->value()
+			};
+
+			if (physicalBasedMaterial->metallicTexture() != nullptr) descriptorHeap->bindTexture(physicalBasedMaterial->metallicTexture()->value(), 3);
+			if (physicalBasedMaterial->baseColorTexture() != nullptr) descriptorHeap->bindTexture(physicalBasedMaterial->baseColorTexture()->value(), 4);
+			if (physicalBasedMaterial->roughnessTexture() != nullptr) descriptorHeap->bindTexture(physicalBasedMaterial->roughnessTexture()->value(), 5);
+			if (physicalBasedMaterial->occlusionTexture() != nullptr) descriptorHeap->bindTexture(physicalBasedMaterial->occlusionTexture()->value(), 6);
+			if (physicalBasedMaterial->normalMapTexture() != nullptr) descriptorHeap->bindTexture(physicalBasedMaterial->normalMapTexture()->value(), 7);
+			if (physicalBasedMaterial->emissiveTexture() != nullptr) descriptorHeap->bindTexture(physicalBasedMaterial->emissiveTexture()->value(), 8);
+
+			slot.MaterialVersions[mCurrentFrameIndex] = physicalBasedMaterial->version();
+			uploadBytes = uploadBytes + sizeof(SharedMaterial);
+		}
+
+		if (!physicalBasedMaterial->IsRendered) continue;
+
+		// only cast shadow that enable ShadowCast
+		// the bound in world space is used to cull the caster for each face of shadow maps
+		if (physicalBasedMaterial->IsShadowed) {
+			mShadowCastInfos.push_back({ entry.Owner->component<const TrianglesMesh>(), entry.Slot, bounds[index], transformVersion,
+				entry.Transform != nullptr ? entry.Transform->world() : Matrix4x4f(1) });
+		}
+
+		if (!mVisible[index]) continue;
 		
+		PhysicalBasedDrawCall drawCall = {
+			entry.Owner->component<const TrianglesMesh>()
+		};
+
 		drawCall.HasMetallic = physicalBasedMaterial->metallicTexture() != nullptr;
 		drawCall.HasBaseColor = physicalBasedMaterial->baseColorTexture() != nullptr;
 		drawCall.HasRoughness = physicalBasedMaterial->roughnessTexture() != nullptr;
@@ -269,86 +477,233 @@ void LRTR::PhysicalBasedRenderSystem::update(const Group<Identity, std::shared_p
 		drawCall.HasEmissive = physicalBasedMaterial->emissiveTexture() != nullptr;
 
 		drawCall.HasBlurred = physicalBasedMaterial->IsBlurred;
-		
-		if (drawCall.HasMetallic) descriptorHeap->bindTexture(physicalBasedMaterial->metallicTexture()->value(), 3);
-		if (drawCall.HasBaseColor) descriptorHeap->bindTexture(physicalBasedMaterial->baseColorTexture()->value(), 4);
-		if (drawCall.HasRoughness) descriptorHeap->bindTexture(physicalBasedMaterial->roughnessTexture()->value(), 5);
-		if (drawCall.HasOcclusion) descriptorHeap->bindTexture(physicalBasedMaterial->occlusionTexture()->value(), 6);
-		if (drawCall.HasNormalMap) descriptorHeap->bindTexture(physicalBasedMaterial->normalMapTexture()->value(), 7);
-		if (drawCall.HasEmissive) descriptorHeap->bindTexture(physicalBasedMaterial->emissiveTexture()->value(), 8);
+		drawCall.Index = static_cast<unsigned>(entry.Slot);
 
-		// only cast shadow that enable ShadowCast
-		if (physicalBasedMaterial->IsShadowed) mShadowCastInfos.push_back({ trianglesMesh, index });
+		const auto& levels = entry.Mesh->levelsOfDetail();
 
-		mDrawCalls.push_back(drawCall);
-		
-		transforms.push_back(transform);
-		materials.push_back(material);
-	};
+		//the error of level is relative to the diagonal of bound, we project it with the distance of bound center
+		//and use the coarsest level whose error is not larger than max pixel error, the camera in bound uses level 0
+		if (levelOfDetail != nullptr && levelOfDetail->IsEnabled && camera != nullptr && !bounds[index].empty()) {
+			const auto diagonal = glm::length(bounds[index].Max - bounds[index].Min);
+			const auto distance = (cameraProjection * cameraView * Vector4f(bounds[index].center(), 1.0f)).w;
 
-	for (const auto& shape : shapes) {
-		const auto transform =
-			shape.second->hasComponent<TransformWrap>() ? shape.second->component<TransformWrap>() : nullptr;
-		
-		if (shape.second->hasComponent<PhysicalBasedMaterial>() &&
-			shape.second->hasComponent<TrianglesMesh>())
-		{
-			if (descriptorHeapPool->size() == mDrawCalls.size()) 
-				descriptorHeapPool->push_back(mDevice->createDescriptorHeap(mDeferredShadingWorkflow->resourceLayout()));
-			
-			ProcessTrianglesMeshComponent(
-				shape.second->component<PhysicalBasedMaterial>(),
-				shape.second->component<TrianglesMesh>(),
-				transform != nullptr ? transform->transform().matrix() : Matrix4x4f(1),
-				mDrawCalls.size()
-			);
+			if (distance > diagonal * 0.5f) {
+				const auto pixelsPerUnit = cameraProjection[1][1] * 0.5f * static_cast<float>(mViewHeight) / distance;
+
+				while (drawCall.Level < levels.size() &&
+					levels[drawCall.Level].Error * diagonal * pixelsPerUnit <= levelOfDetail->MaxPixelError)
+					drawCall.Level++;
+			}
 		}
 
-		if (shape.second->hasComponent<PointLightSource>()) {
-			const auto pointLight = shape.second->component<PointLightSource>();
-			
-			//if index is zero means we do not cast shadow
-			//if is not zero, it indicate the index of shadow map.
-			lights.push_back({
-				transform != nullptr ? Vector4f(transform->translation(), 1.0f) : Vector4f(0),
-				Vector4f(pointLight->intensity(), 1.0f),
-				25.0f,
-				pointLight->IsShadowed ? static_cast<unsigned>(mPointShadowAreas.size() + 1) : 0,
-				0, });
-
-			if (pointLight->IsShadowed) 
-				mPointShadowAreas.push_back({ mPointShadowMap->FrameBuffers[mPointShadowAreas.size()], lights.back().Position, 25.0f });
+		auto triangles = drawCall.Level == 0 ? entry.Mesh->size() : levels[drawCall.Level - 1].Indices.size() / 3;
+
+		//the meshlets are ranges of level 0, so the coarser levels are drawn as a whole
+		//the entry is not drawn if all of its meshlets are culled
+		if (clusterCulled && drawCall.Level == 0 && entry.Mesh->meshlets().size() > 1) {
+			const auto rangeOffset = mDrawRanges.size();
+
+			if (mClusterCuller.cull(entry.Mesh->meshlets(),
+				entry.Transform != nullptr ? entry.Transform->world() : Matrix4x4f(1), mDrawRanges) == 0) continue;
+
+			drawCall.RangeOffset = static_cast<unsigned>(rangeOffset);
+			drawCall.RangeCount = static_cast<unsigned>(mDrawRanges.size() - rangeOffset);
+
+			triangles = 0;
+
+			for (auto range = rangeOffset; range < mDrawRanges.size(); range++)
+				triangles = triangles + mDrawRanges[range].Count / 3;
 		}
+		
+		drawTriangles = drawTriangles + triangles;
+		fullTriangles = fullTriangles + entry.Mesh->size();
+		
+		mDrawCalls.push_back(drawCall);
 	}
 
-	auto transformBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("TransformBuffer");
-	auto materialBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("MaterialBuffer");
-	auto lightBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("LightBuffer");
+	if (levelOfDetail != nullptr) {
+		levelOfDetail->Triangles = drawTriangles;
+		levelOfDetail->FullTriangles = fullTriangles;
+	}
 
-	transformBuffer = CodeRed::ResourceHelper::expandBuffer(mDevice, transformBuffer, transforms.size());
-	materialBuffer = CodeRed::ResourceHelper::expandBuffer(mDevice, materialBuffer, materials.size());
-	lightBuffer = CodeRed::ResourceHelper::expandBuffer(mDevice, lightBuffer, lights.size());
+	//the shadow faces are rendered in render(), so the statistics of them are from last frame
+	if (clusterCulling != nullptr) {
+		clusterCulling->Clusters = clusterCulled ? mClusterCuller.clusters() : 0;
+		clusterCulling->FrustumCulled = clusterCulled ? mClusterCuller.frustumCulled() : 0;
+		clusterCulling->BackFacing = clusterCulled ? mClusterCuller.backFacing() : 0;
+		clusterCulling->Occluded = clusterCulled ? mClusterCuller.occluded() : 0;
+		clusterCulling->Ranges = mDrawRanges.size();
+		clusterCulling->ShadowClusters = mShadowStatistics.Clusters;
+		clusterCulling->ShadowCulled = mShadowStatistics.CulledClusters;
+	}
 	
-	LRTR_RESET_BUFFER(transformBuffer, "TransformBuffer", 2);
-	LRTR_RESET_BUFFER(materialBuffer, "MaterialBuffer", 0);
-	LRTR_RESET_BUFFER(lightBuffer, "LightBuffer", 1);
+	//the spheres of lights in world space, we use them to build the light clusters
+	std::vector<Vector4f> lightSpheres;
 
-	for (size_t index = 0; index < mDrawCalls.size(); index++) {
-		const auto descriptorHeap = (*descriptorHeapPool)[index];
+	//the lights need shadow, (index of light, owner, resolution we want)
+	std::vector<std::tuple<size_t, Identity, size_t>> shadowedLights;
+	
+	scene.query<PointLightSource>().each([&](const Archetype& archetype)
+		{
+			const auto& lightColumn = archetype.column<PointLightSource>();
+			const auto transformColumn = archetype.has<TransformWrap>() ? &archetype.column<TransformWrap>() : nullptr;
 
-		descriptorHeap->bindBuffer(materialBuffer, 0);
-		descriptorHeap->bindBuffer(transformBuffer, 1);
-		descriptorHeap->bindBuffer(mViewBuffer, 2);
+			for (size_t row = 0; row < archetype.size(); row++) {
+				const auto pointLight = static_cast<PointLightSource*>(lightColumn[row]);
+				const auto transform = transformColumn != nullptr ?
+					static_cast<TransformWrap*>((*transformColumn)[row]) : nullptr;
+
+				//if index is zero means we do not cast shadow
+				//if is not zero, the tiles of light in shadow atlas are valid
+				lights.push_back({
+					transform != nullptr ? Vector4f(Vector3f(transform->world()[3]), 1.0f) : Vector4f(0),
+					Vector4f(pointLight->intensity(), 1.0f),
+					PointShadowRadius, 0, 0, pointLight->range(), {}, 0, 0 });
+
+				//the light without transform is at the origin, we use version 0 for it like the shapes
+				lightVersions.push_back({ pointLight->version(), transform != nullptr ? transform->version() : 0 });
+
+				lightSpheres.push_back(Vector4f(Vector3f(lights.back().Position), lights.back().Range));
+
+				if (!pointLight->IsShadowed) continue;
+
+				//the screen size of shadow sphere, the light contains the camera covers whole screen
+				auto screenSize = static_cast<float>(mViewHeight) * 2.0f;
+
+				if (camera != nullptr) {
+					const auto distance = glm::length(Vector3f(cameraView * lights.back().Position));
+
+					if (distance > PointShadowRadius)
+						screenSize = PointShadowRadius / distance * cameraProjection[1][1] * static_cast<float>(mViewHeight);
+				}
+
+				shadowedLights.push_back({ lights.size() - 1, archetype.shapes()[row]->identity(),
+					mPointShadowAtlas->Allocator.resolution(screenSize) });
+			}
+		});
+
+	//the lights with larger screen size are allocated first, so they are not reduced or dropped when atlas is full
+	std::stable_sort(shadowedLights.begin(), shadowedLights.end(), [](const auto& lhs, const auto& rhs)
+		{
+			return std::get<2>(lhs) > std::get<2>(rhs);
+		});
+
+	std::vector<ShadowAtlasRequest> shadowRequests;
+
+	for (const auto& shadowedLight : shadowedLights)
+		shadowRequests.push_back({ std::get<1>(shadowedLight), std::get<2>(shadowedLight) });
+
+	mPointShadowAtlas->Allocator.beginFrame();
+
+	const auto shadowSlots = mPointShadowAtlas->Allocator.allocate(shadowRequests);
+
+	for (size_t index = 0; index < shadowedLights.size(); index++) {
+		auto& light = lights[std::get<0>(shadowedLights[index])];
+		
+		const auto slot = shadowSlots[index];
+
+		//the light does not cast shadow if there is not enough space in atlas
+		if (slot == nullptr) continue;
+
+		for (size_t face = 0; face < slot->Tiles.size(); face++)
+			light.Tiles[face] = slot->Tiles[face].X | (slot->Tiles[face].Y << 16);
+
+		light.Index = 1;
+		light.Resolution = static_cast<unsigned>(slot->Resolution);
+		
+		mPointShadowAreas.push_back({ *slot, Vector3f(light.Position), PointShadowRadius });
 	}
 
-	CodeRed::ResourceHelper::updateBuffer(transformBuffer, transforms.data(),
-		sizeof(Matrix4x4f) * transforms.size());
-	CodeRed::ResourceHelper::updateBuffer(materialBuffer, materials.data(),
-		sizeof(SharedMaterial) * materials.size());
-	CodeRed::ResourceHelper::updateBuffer(lightBuffer, lights.data(),
-		sizeof(SharedLight) * lights.size());
+	auto lightBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("LightBuffer");
+	auto& uploadedLightVersions = mUploadedLightVersions[mCurrentFrameIndex];
+
+	const auto newLightBuffer = CodeRed::ResourceHelper::expandBuffer(mDevice, lightBuffer, lights.size());
+
+	//the new buffer does not have any light, so all lights are uploaded
+	if (newLightBuffer != lightBuffer) uploadedLightVersions.clear();
+
+	lightBuffer = newLightBuffer;
+
+	LRTR_RESET_BUFFER(lightBuffer, "LightBuffer", 1);
+
+	uploadedLightVersions.resize(lights.size());
+
+	const auto uploadedLights = static_cast<SharedLight*>(CodeRed::ResourceHelper::mappedMemory(lightBuffer));
+
+	//the light is uploaded only if the light, its transform or its shadow tiles are changed
+	for (size_t index = 0; index < lights.size(); index++) {
+		const auto& light = lights[index];
+
+		auto& uploaded = uploadedLightVersions[index];
+
+		if (uploaded.LightVersion == lightVersions[index].LightVersion &&
+			uploaded.TransformVersion == lightVersions[index].TransformVersion &&
+			uploaded.Tiles == light.Tiles && uploaded.Index == light.Index && uploaded.Resolution == light.Resolution)
+			continue;
+
+		uploadedLights[index] = light;
+		uploaded = { lightVersions[index].LightVersion, lightVersions[index].TransformVersion,
+			light.Tiles, light.Index, light.Resolution };
+		uploadBytes = uploadBytes + sizeof(SharedLight);
+	}
 
 	mLights = lights.size();
+	mClustered = camera != nullptr;
+
+	if (mClustered) {
+		mLightClusterGrid.update(cameraProjection);
+		mLightClusterGrid.build(cameraView, lightSpheres);
+
+		auto clusterBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("ClusterBuffer");
+		auto lightIndexBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("LightIndexBuffer");
+		
+		const auto& clusters = mLightClusterGrid.clusters();
+		const auto& lightIndices = mLightClusterGrid.indices();
+
+		auto& uploadedClusters = mUploadedClusters[mCurrentFrameIndex];
+		auto& uploadedLightIndices = mUploadedLightIndices[mCurrentFrameIndex];
+
+		const auto newLightIndexBuffer = CodeRed::ResourceHelper::expandBuffer(mDevice, lightIndexBuffer, lightIndices.size());
+
+		//the clusters are only changed when the camera or lights are moved
+		const auto clustersChanged = uploadedClusters.size() != clusters.size() ||
+			std::memcmp(uploadedClusters.data(), clusters.data(), sizeof(LightCluster) * clusters.size()) != 0;
+		const auto lightIndicesChanged = newLightIndexBuffer != lightIndexBuffer || uploadedLightIndices != lightIndices;
+
+		lightIndexBuffer = newLightIndexBuffer;
+
+		LRTR_RESET_BUFFER(lightIndexBuffer, "LightIndexBuffer", 13);
+
+		if (clustersChanged) {
+			CodeRed::ResourceHelper::updateBuffer(clusterBuffer, clusters.data(),
+				sizeof(LightCluster) * clusters.size());
+
+			uploadedClusters = clusters;
+			uploadBytes = uploadBytes + sizeof(LightCluster) * clusters.size();
+		}
+
+		if (lightIndicesChanged && !lightIndices.empty()) {
+			CodeRed::ResourceHelper::updateBuffer(lightIndexBuffer, lightIndices.data(),
+				sizeof(unsigned) * lightIndices.size());
+
+			uploadedLightIndices = lightIndices;
+			uploadBytes = uploadBytes + sizeof(unsigned) * lightIndices.size();
+		}
+	}
+
+	if (scene.property()->hasComponent<RenderStatistics>()) {
+		const auto renderStatistics = scene.property()->component<RenderStatistics>();
+
+		//the shadow maps are rendered in render(), so they are the statistics of last frame
+		renderStatistics->UploadBytes = uploadBytes;
+		renderStatistics->ShadowFaces = mShadowStatistics.Faces;
+		renderStatistics->SkippedShadowFaces = mShadowStatistics.SkippedFaces;
+		renderStatistics->ShadowDraws = mShadowStatistics.Draws;
+		renderStatistics->SkippedShadowDraws = mShadowStatistics.SkippedDraws;
+		renderStatistics->ShadowAtlasSlots = mPointShadowAtlas->Allocator.size();
+		renderStatistics->ShadowAtlasUsage = mPointShadowAtlas->Allocator.usedTexels();
+		renderStatistics->ShadowAtlasEvictions = mPointShadowAtlas->Allocator.evictions();
+	}
 
 	//update the vertex buffer we use
 	//we update the buffer to avoid issue 1
@@ -362,7 +717,26 @@ void LRTR::PhysicalBasedRenderSystem::update(const Group<Identity, std::shared_p
 	for (const auto& drawCall : mDrawCalls)
 		meshDataAssetComponent->allocate(drawCall.Mesh);
 
+	//the shadow casters outside the camera frustum do not have draw calls, but we still need their meshes
+	for (const auto& shadowCastInfo : mShadowCastInfos)
+		meshDataAssetComponent->allocate(shadowCastInfo.Mesh);
+
 	meshDataAssetComponent->endAllocating();
+
+	if (scene.property()->hasComponent<RenderStatistics>()) {
+		const auto renderStatistics = scene.property()->component<RenderStatistics>();
+		const auto meshStatistics = meshDataAssetComponent->statistics();
+
+		renderStatistics->MeshVertices = meshStatistics.Vertices;
+		renderStatistics->UnusedMeshVertices = meshStatistics.UnusedVertices;
+		renderStatistics->MeshIndices = meshStatistics.Indices;
+		renderStatistics->UnusedMeshIndices = meshStatistics.UnusedIndices;
+		renderStatistics->MeshReleases = meshStatistics.Releases;
+		renderStatistics->MeshRelocations = meshStatistics.Relocations;
+		renderStatistics->RetiringMeshRanges = meshStatistics.RetiringRanges;
+		renderStatistics->MeshVertexFragmentation = meshStatistics.VertexFragmentation;
+		renderStatistics->MeshIndexFragmentation = meshStatistics.IndexFragmentation;
+	}
 }
 
 void LRTR::PhysicalBasedRenderSystem::render(
@@ -374,6 +748,8 @@ void LRTR::PhysicalBasedRenderSystem::render(
 	updatePipeline(frameBuffer);
 	updateCamera(camera);
 
+	mViewHeight = frameBuffer->renderTarget(0)->height();
+	
 	// update deferred shading buffer and SSAO buffer
 	mDeferredShadingBuffer.update(mDevice, frameBuffer);
 	mSSAOBuffer.update(mDevice, frameBuffer);
@@ -383,11 +759,12 @@ void LRTR::PhysicalBasedRenderSystem::render(
 	
 	// pre build shadow map for lights
 	// in this version, we only test on point shadow map
-	mPointShadowMapWorkflow->start({
+	mShadowStatistics = mPointShadowMapWorkflow->start({
 		PointShadowMapInput(
-			commandLists[0], mPointShadowMap->Texture,
+			commandLists[0], mPointShadowAtlas->FrameBuffer,
 			mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("TransformBuffer"),
-			mRuntimeSharing, mPointShadowAreas , mShadowCastInfos) });
+			mRuntimeSharing, mPointShadowAreas , mShadowCastInfos,
+			mClusterCulled, mConeCulled) });
 
 	// pre build the deferred shading buffer(g-buffer)
 	// the SSAO buffer we do not build with it
@@ -397,6 +774,7 @@ void LRTR::PhysicalBasedRenderSystem::render(
 			commandLists[0],
 			mRuntimeSharing,
 			mDrawCalls,
+			mDrawRanges,
 			mDeferredShadingBuffer
 		)});
 
@@ -412,6 +790,8 @@ void LRTR::PhysicalBasedRenderSystem::render(
 	
 	// bind texture and buffer to descriptor heap used for shading
 	mDescriptorHeap->bindBuffer(mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("LightBuffer"), 0);
+	mDescriptorHeap->bindBuffer(mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("ClusterBuffer"), 12);
+	mDescriptorHeap->bindBuffer(mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("LightIndexBuffer"), 13);
 
 	mDescriptorHeap->bindTexture(mDeferredShadingBuffer.BaseColorAndRoughness, 2);
 	mDescriptorHeap->bindTexture(mDeferredShadingBuffer.PositionAndOcclusion, 3);
@@ -448,14 +828,20 @@ void LRTR::PhysicalBasedRenderSystem::render(
 		const auto drawProperty = meshDataAssetComponent->get("Quad");
 		const auto mipLevels = hasEnvironmentLight() ? mEnvironmentLight.PreFiltering->mipLevels() : 0;
 
-		//hasEnvironmentLight, eyePosition.x, eyePosition.y, eyePosition.z, MipLevels, nLights
+		//hasEnvironmentLight, eyePosition.x, eyePosition.y, eyePosition.z, MipLevels, nLights,
+		//clusterWidth, clusterHeight, clusterDepth, zNear, zFar, the depth is zero if lights are not clustered
 		commandList->setConstant32Bits({
 			hasEnvironmentLight(),
 			cameraPosition.x,
 			cameraPosition.y,
 			cameraPosition.z,
 			static_cast<unsigned>(mipLevels),
-			static_cast<unsigned>(mLights)
+			static_cast<unsigned>(mLights),
+			static_cast<unsigned>(mLightClusterGrid.width()),
+			static_cast<unsigned>(mLightClusterGrid.height()),
+			mClustered ? static_cast<unsigned>(mLightClusterGrid.depth()) : 0u,
+			mLightClusterGrid.zNear(),
+			mLightClusterGrid.zFar()
 		});
 
 		commandList->drawIndexed(drawProperty.IndexCount, 1,
@@ -530,9 +916,124 @@ auto LRTR::PhysicalBasedRenderSystem::getCameraViewMatrix(const std::shared_ptr<
 	return camera->component<TransformWrap>()->transform().inverseMatrix();
 }
 
+auto LRTR::PhysicalBasedRenderSystem::getSceneCamera(const Scene& scene) const -> Shape*
+{
+	if (!scene.property()->hasComponent<CameraGroup>()) return nullptr;
+
+	const auto camera = scene.shape(scene.property()->component<CameraGroup>()->current());
+
+	if (camera == nullptr || !camera->hasComponent<Projective>() || !camera->hasComponent<TransformWrap>()) return nullptr;
+
+	return camera;
+}
+
 auto LRTR::PhysicalBasedRenderSystem::hasEnvironmentLight() const noexcept -> bool
 {
 	return mEnvironmentLight.Irradiance != nullptr && 
 		mEnvironmentLight.PreFiltering != nullptr &&
 		mEnvironmentLight.PreComputingBRDF != nullptr;
 }
+
+auto LRTR::PhysicalBasedRenderSystem::allocateSlot(const Identity& identity) -> size_t
+{
+	const auto it = mSlotsIndex.find(identity);
+
+	if (it != mSlotsIndex.end()) {
+		mSlots[it->second].LastSeen = mUpdateTimes;
+
+		return it->second;
+	}
+
+	auto slot = mSlots.size();
+
+	if (!mFreeSlots.empty()) {
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else mSlots.emplace_back();
+
+	//the new slot is not uploaded in all frames
+	mSlots[slot] = PhysicalBasedSlot(identity, mUpdateTimes, mFrameResources.size());
+	mSlotsIndex.insert({ identity, slot });
+
+	return slot;
+}
+
+void LRTR::PhysicalBasedRenderSystem::releaseSlots()
+{
+	for (size_t slot = 0; slot < mSlots.size(); slot++) {
+		if (mSlots[slot].Owner == 0 || mSlots[slot].LastSeen == mUpdateTimes) continue;
+
+		mSlotsIndex.erase(mSlots[slot].Owner);
+		mSlots[slot] = PhysicalBasedSlot();
+		mFreeSlots.push_back(slot);
+	}
+}
+
+void LRTR::PhysicalBasedRenderSystem::cullOccludedEntries(
+	const Scene& scene,
+	const std::vector<PhysicalBasedEntry>& entries,
+	const std::vector<Bound3f>& bounds,
+	const Matrix4x4f& viewProjection,
+	OcclusionCulling& occlusionCulling)
+{
+	//the candidates of occluders, (size on screen, index of entry)
+	std::vector<std::pair<float, size_t>> candidates;
+
+	for (size_t index = 0; index < entries.size(); index++) {
+		if (!mVisible[index] || !entries[index].Material->IsRendered || bounds[index].empty()) continue;
+
+		//the w of clip space is the distance from camera along the view direction
+		const auto radius = glm::length(bounds[index].extent());
+		const auto distance = (viewProjection * Vector4f(bounds[index].center(), 1.0f)).w;
+
+		//the bound is behind the camera, it can not occlude anything
+		if (distance + radius <= 0) continue;
+		
+		const auto size = distance > radius ? radius / distance : std::numeric_limits<float>::max();
+
+		if (size >= MinOccluderSize) candidates.push_back({ size, index });
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+	mOcclusionCuller.clear(viewProjection);
+
+	size_t triangles = 0;
+
+	for (const auto& candidate : candidates) {
+		if (mOcclusionCuller.occluders() >= occlusionCulling.MaxOccluders) break;
+
+		const auto& entry = entries[candidate.second];
+		const auto count = entry.Mesh->indices().size() / 3;
+
+		//the meshes with too many triangles are not good occluders, we skip them
+		if (triangles + count > occlusionCulling.MaxTriangles) continue;
+
+		mOcclusionCuller.add(entry.Mesh->positions(), entry.Mesh->indices(),
+			entry.Transform != nullptr ? entry.Transform->world() : Matrix4x4f(1));
+
+		triangles = triangles + count;
+	}
+
+	mOcclusionCuller.render(scene.threadPool().get());
+
+	size_t tested = 0;
+	size_t occluded = 0;
+
+	for (size_t index = 0; index < entries.size(); index++) {
+		if (!mVisible[index]) continue;
+
+		tested++;
+
+		if (mOcclusionCuller.test(bounds[index])) continue;
+
+		mVisible[index] = 0;
+		occluded++;
+	}
+
+	occlusionCulling.Occluders = mOcclusionCuller.occluders();
+	occlusionCulling.Triangles = mOcclusionCuller.triangles();
+	occlusionCulling.Tested = tested;
+	occlusionCulling.Occluded = occluded;
+}
@@ -4,6 +4,11 @@
 #include "../../Workflow/Shadow/PointShadowMapWorkflow.hpp"
 #include "../../Workflow/PBR/DeferredShadingWorkflow.hpp"
 
+#include "../../Shared/Allocators/ShadowAtlasAllocator.hpp"
+#include "../../Shared/Accelerators/LightClusterGrid.hpp"
+#include "../../Shared/Accelerators/OcclusionCuller.hpp"
+#include "../../Shared/Accelerators/ClusterCuller.hpp"
+#include "../../Shared/Accelerators/FrustumCuller.hpp"
 #include "../../Shared/Graphics/PipelineInfo.hpp"
 #include "../../Shared/Accelerators/Group.hpp"
 
@@ -11,6 +16,58 @@
 
 namespace LRTR {
 
+	struct PhysicalBasedEntry;
+
+	class OcclusionCulling;
+	
+	struct SharedMaterial {
+		Vector4f BaseColor;
+		Vector4f Roughness;
+		Vector4f Metallic;
+		Vector4f Emissive;
+	};
+
+	//the tiles are the top-left texels of faces in shadow atlas, packed as x | (y << 16)
+	struct SharedLight {
+		Vector4f Position;
+		Vector4f Intensity;
+
+		float FarPlane;
+		unsigned Index;
+		unsigned Type;
+		float Range;
+
+		std::array<unsigned, 6> Tiles;
+		unsigned Resolution;
+		unsigned Unused;
+	};
+
+	//the slot of shape in transform and material buffers, the shape keeps the slot until it is removed
+	//so we only need upload the transform and material that changed since last upload
+	struct PhysicalBasedSlot {
+		//the versions uploaded to the buffers of each frame, 0 means identity transform
+		std::vector<size_t> TransformVersions;
+		std::vector<size_t> MaterialVersions;
+
+		Identity Owner = 0;
+		size_t LastSeen = 0;
+
+		PhysicalBasedSlot() = default;
+
+		PhysicalBasedSlot(const Identity& owner, const size_t lastSeen, const size_t maxFrameCount);
+	};
+	
+	//the versions of light and its transform uploaded to the light buffer of a frame
+	//the shadow tiles are assigned by the atlas every frame, so we compare them directly
+	struct PhysicalBasedLightVersion {
+		size_t LightVersion = 0;
+		size_t TransformVersion = 0;
+
+		std::array<unsigned, 6> Tiles = {};
+		unsigned Index = 0;
+		unsigned Resolution = 0;
+	};
+	
 	struct EnvironmentLight {
 		std::shared_ptr<CodeRed::GpuTexture> Irradiance;
 		std::shared_ptr<CodeRed::GpuTexture> PreFiltering;
@@ -37,13 +94,16 @@ namespace LRTR {
 			Position(position), Radius(radius) {}
 	};
 
-	struct PointShadowMap {
-		std::vector<PointShadowFrameBuffer> FrameBuffers;
+	//the shadow atlas is a depth texture shared by all point shadows, the tiles of it are assigned by allocator
+	struct PointShadowAtlas {
+		std::shared_ptr<CodeRed::GpuFrameBuffer> FrameBuffer;
 		std::shared_ptr<CodeRed::GpuTexture> Texture;
 
-		PointShadowMap(const std::shared_ptr<CodeRed::GpuLogicalDevice>& device, const size_t extent, const size_t length);
+		ShadowAtlasAllocator Allocator;
+
+		PointShadowAtlas(const std::shared_ptr<CodeRed::GpuLogicalDevice>& device, const size_t budget);
 
-		~PointShadowMap() = default;
+		~PointShadowAtlas() = default;
 	};
 	
 	class PhysicalBasedRenderSystem : public RenderSystem {
@@ -53,8 +113,7 @@ namespace LRTR {
 			const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
 			size_t maxFrameCount = 2);
 
-		void update(
-			const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta) override;
+		void update(const Scene& scene, float delta) override;
 
 		void render(
 			const std::vector<std::shared_ptr<CodeRed::GpuGraphicsCommandList>>& commandLists, 
@@ -77,8 +136,23 @@ namespace LRTR {
 		auto getCameraProjectionMatrix(const std::shared_ptr<SceneCamera>& camera) const -> Matrix4x4f;
 
 		auto getCameraViewMatrix(const std::shared_ptr<SceneCamera>& camera) const -> Matrix4x4f;
+
+		//the current camera of scene, return nullptr if it is not a projective camera with transform
+		auto getSceneCamera(const Scene& scene) const -> Shape*;
 		
 		auto hasEnvironmentLight() const noexcept -> bool;
+
+		auto allocateSlot(const Identity& identity) -> size_t;
+
+		void releaseSlots();
+
+		//rasterize the largest visible entries as occluders, the entries hidden by them are marked invisible
+		void cullOccludedEntries(
+			const Scene& scene,
+			const std::vector<PhysicalBasedEntry>& entries,
+			const std::vector<Bound3f>& bounds,
+			const Matrix4x4f& viewProjection,
+			OcclusionCulling& occlusionCulling);
 	private:
 		std::shared_ptr<CodeRed::GpuResourceLayout> mResourceLayout;
 		std::shared_ptr<CodeRed::GpuDescriptorHeap> mDescriptorHeap;
@@ -86,7 +160,7 @@ namespace LRTR {
 		std::shared_ptr<CodeRed::GpuBuffer> mViewBuffer;
 		std::shared_ptr<CodeRed::GpuSampler> mSampler;
 
-		std::shared_ptr<PointShadowMap> mPointShadowMap;
+		std::shared_ptr<PointShadowAtlas> mPointShadowAtlas;
 
 		std::shared_ptr<ScreenSpaceAmbientOcclusionWorkflow> mSSAOWorkflow;
 		std::shared_ptr<DeferredShadingWorkflow> mDeferredShadingWorkflow;
@@ -94,14 +168,49 @@ namespace LRTR {
 		
 		std::vector<PointShadowArea> mPointShadowAreas;
 		std::vector<PhysicalBasedDrawCall> mDrawCalls;
+		std::vector<IndexRange> mDrawRanges;
 		std::vector<ShadowCastInfo> mShadowCastInfos;
 
+		PointShadowMapOutput mShadowStatistics;
+
 		ScreenSpaceAmbientOcclusionBuffer mSSAOBuffer;
 		DeferredShadingBuffer mDeferredShadingBuffer;
 
 		EnvironmentLight mEnvironmentLight;
 
+		FrustumCuller mFrustumCuller;
+
+		OcclusionCuller mOcclusionCuller;
+
+		ClusterCuller mClusterCuller;
+
+		LightClusterGrid mLightClusterGrid;
+
+		//the visibility of entries in this update, 1 means the entry is visible
+		std::vector<unsigned char> mVisible;
+
+		std::vector<PhysicalBasedSlot> mSlots;
+		std::vector<size_t> mFreeSlots;
+
+		Group<Identity, size_t> mSlotsIndex;
+
+		//the versions of lights uploaded to the light buffer of each frame, indexed by the location of light
+		std::vector<std::vector<PhysicalBasedLightVersion>> mUploadedLightVersions;
+		std::vector<std::vector<LightCluster>> mUploadedClusters;
+		std::vector<std::vector<unsigned>> mUploadedLightIndices;
+		
 		size_t mLights = 0;
+
+		//the height of frame buffer in last render, we use it to find the screen size of lights
+		size_t mViewHeight = 1080;
+		
+		//the lights are clustered if the scene has camera, otherwise the shading pass uses all lights
+		bool mClustered = false;
+
+		//the shadow casters are cluster culled with the light of face, they do not need camera
+		bool mClusterCulled = false;
+		bool mConeCulled = false;
+		size_t mUpdateTimes = 0;
 	};
 	
 }
\ No newline at end of file
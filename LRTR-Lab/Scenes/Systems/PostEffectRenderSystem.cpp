@@ -1,5 +1,7 @@
 #include "PostEffectRenderSystem.hpp"
 
+#include "../Scene.hpp"
+
 #include "../../Runtimes/Managers/Asset/Components/MeshDataAssetComponent.hpp"
 #include "../../Runtimes/Managers/Asset/AssetManager.hpp"
 
@@ -16,6 +18,8 @@ LRTR::PostEffectRenderSystem::PostEffectRenderSystem(
 	const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
 	size_t maxFrameCount) : RenderSystem(sharing, device, maxFrameCount)
 {
+	reads<SkyBox>();
+
 	mViewBuffer = mDevice->createBuffer(
 		CodeRed::ResourceInfo::ConstantBuffer(
 			sizeof(Matrix4x4f) * 4
@@ -134,16 +138,17 @@ LRTR::PostEffectRenderSystem::PostEffectRenderSystem(
 	mGaussianBlurWorkflow = std::make_shared<GaussianBlurWorkflow>(mDevice);
 }
 
-void LRTR::PostEffectRenderSystem::update(const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta)
+void LRTR::PostEffectRenderSystem::update(const Scene& scene, float delta)
 {
 	mFrameResources[mCurrentFrameIndex].set<CodeRed::GpuTexture>("SkyBox", nullptr);
 	
-	for (const auto& shape : shapes) {
-		if (shape.second->hasComponent<SkyBox>() && shape.second->component<SkyBox>()->IsRendered) {
-			mFrameResources[mCurrentFrameIndex].set("SkyBox",
-				shape.second->component<SkyBox>()->cubeMap());
-		}
-	}
+	scene.query<SkyBox>().each([&](const Archetype& archetype)
+		{
+			for (size_t row = 0; row < archetype.size(); row++) {
+				if (archetype.get<SkyBox>(row)->IsRendered)
+					mFrameResources[mCurrentFrameIndex].set("SkyBox", archetype.get<SkyBox>(row)->cubeMap());
+			}
+		});
 
 	if (mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuTexture>("SkyBox") != nullptr) {
 		mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuDescriptorHeap>("DescriptorHeap")
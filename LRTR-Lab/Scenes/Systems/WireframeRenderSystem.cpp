@@ -1,5 +1,7 @@
 #include "WireframeRenderSystem.hpp"
 
+#include "../Scene.hpp"
+
 #include <CodeRed/Core/CodeRedGraphics.hpp>
 
 #include "../../Runtimes/Managers/Asset/Components/MeshDataAssetComponent.hpp"
@@ -24,6 +26,9 @@ LRTR::WireframeRenderSystem::WireframeRenderSystem(
 	const std::shared_ptr<CodeRed::GpuLogicalDevice>& device, 
 	size_t maxFrameCount) : RenderSystem(sharing, device, maxFrameCount)
 {
+	reads<TransformWrap, TrianglesMesh, WireframeMaterial>();
+	uses("MeshData");
+
 	mViewBuffer = mDevice->createBuffer(
 		CodeRed::ResourceInfo::ConstantBuffer(
 			sizeof(Matrix4x4f)
@@ -34,7 +39,7 @@ LRTR::WireframeRenderSystem::WireframeRenderSystem(
 		{
 			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::GroupBuffer, 0),
 			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::Buffer,1)
-		}, {}, CodeRed::Constant32Bits(5, 2));
+		}, {}, CodeRed::Constant32Bits(11, 2));
 
 	for (auto& frameResource : mFrameResources) {
 		auto descriptorHeap = mDevice->createDescriptorHeap(mResourceLayout);
@@ -99,6 +104,11 @@ LRTR::WireframeRenderSystem::WireframeRenderSystem(
 		"./Resources/Shaders/Systems/DirectX12/WireframeRenderSystemFrag.hlsl" :
 		"./Resources/Shaders/Systems/Vulkan/WireframeRenderSystemFrag.frag";
 
+	const auto cShaderFile =
+		sourceLanguage == SourceLanguage::eHLSL ?
+		"./Resources/Shaders/Systems/DirectX12/WireframeRenderSystemCompressedVert.hlsl" :
+		"./Resources/Shaders/Systems/Vulkan/WireframeRenderSystemCompressedVert.vert";
+
 
 	mPipelineInfo->setVertexShaderState(
 		pipelineFactory->createShaderState(
@@ -123,17 +133,47 @@ LRTR::WireframeRenderSystem::WireframeRenderSystem(
 			) })
 		)
 	);
+
+	//the meshes in compressed format use quantized positions, they are bound as two 8 bits unorm elements
+	mCompressedPipelineInfo = std::make_shared<CodeRed::PipelineInfo>(mDevice);
+
+	mCompressedPipelineInfo->setInputAssemblyState(
+		pipelineFactory->createInputAssemblyState(
+			{
+				CodeRed::InputLayoutElement("POSITIONXY", CodeRed::PixelFormat::RedGreenBlueAlpha8BitUnknown),
+				CodeRed::InputLayoutElement("POSITIONZW", CodeRed::PixelFormat::RedGreenBlueAlpha8BitUnknown)
+			},
+			CodeRed::PrimitiveTopology::TriangleList
+		)
+	);
+
+	mCompressedPipelineInfo->setRasterizationState(mPipelineInfo->rasterizationState());
+	mCompressedPipelineInfo->setBlendState(mPipelineInfo->blendState());
+	mCompressedPipelineInfo->setResourceLayout(mResourceLayout);
+	mCompressedPipelineInfo->setPixelShaderState(mPipelineInfo->pixelShaderState());
+
+	mCompressedPipelineInfo->setVertexShaderState(
+		pipelineFactory->createShaderState(
+			CodeRed::ShaderType::Vertex,
+			workflow.start({ CompileShaderInput(
+				cShaderFile,
+				CodeRed::ShaderType::Vertex,
+				sourceLanguage,
+				targetLanguage
+			) })
+		)
+	);
 }
 
-void LRTR::WireframeRenderSystem::update(const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta)
+void LRTR::WireframeRenderSystem::update(const Scene& scene, float delta)
 {
 	mDrawCalls.clear();
 
 	std::vector<Matrix4x4f> transforms;
 	
-	static const auto ProcessTrianglesMeshComponent = [&](
-		const std::shared_ptr<WireframeMaterial>& wireframeMaterial,
-		const std::shared_ptr<TrianglesMesh>& trianglesMesh,
+	const auto ProcessTrianglesMeshComponent = [&](
+		const WireframeMaterial* wireframeMaterial,
+		const std::shared_ptr<const TrianglesMesh>& trianglesMesh,
 		const Matrix4x4f& transform)
 	{
 		if (!wireframeMaterial->IsRendered) return;
@@ -146,21 +186,18 @@ void LRTR::WireframeRenderSystem::update(const Group<Identity, std::shared_ptr<S
 		transforms.push_back(transform);
 	};
 
-	for (const auto& shape : shapes) {
-		const auto transform =
-			shape.second->hasComponent<TransformWrap>() ? shape.second->component<TransformWrap>()->transform().matrix() :
-			Matrix4x4f(1);
-
-		if (shape.second->hasComponent<TrianglesMesh>() &&
-			shape.second->hasComponent<WireframeMaterial>())
+	scene.query<WireframeMaterial, TrianglesMesh>().each([&](const Archetype& archetype)
 		{
-			ProcessTrianglesMeshComponent(
-				shape.second->component<WireframeMaterial>(),
-				shape.second->component<TrianglesMesh>(),
-				transform
-			);
-		}
-	}
+			const auto hasTransform = archetype.has<TransformWrap>();
+
+			for (size_t row = 0; row < archetype.size(); row++) {
+				ProcessTrianglesMeshComponent(
+					archetype.get<WireframeMaterial>(row),
+					archetype.shapes()[row]->component<const TrianglesMesh>(),
+					hasTransform ? archetype.get<TransformWrap>(row)->world() : Matrix4x4f(1)
+				);
+			}
+		});
 
 	auto meshBuffer = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuBuffer>("MeshBuffer");
 
@@ -195,28 +232,53 @@ void LRTR::WireframeRenderSystem::render(
 		mRuntimeSharing->assetManager()->components().at("MeshData"));
 	
 	const auto descriptorHeap = mFrameResources[mCurrentFrameIndex].get<CodeRed::GpuDescriptorHeap>("DescriptorHeap");
-	const auto vertexBuffer = meshDataAssetComponent->positions();
-	const auto indexBuffer = meshDataAssetComponent->indices();
 
 	const auto commandList = commandLists[1];
 	
-	commandList->setGraphicsPipeline(mPipelineInfo->graphicsPipeline());
 	commandList->setResourceLayout(mResourceLayout);
 	commandList->setDescriptorHeap(descriptorHeap);
 
-	commandList->setVertexBuffer(vertexBuffer);
-	commandList->setIndexBuffer(indexBuffer);
+	//we only switch the pipeline and buffers when the format, vertex page or index buffer of mesh changes
+	std::shared_ptr<CodeRed::GpuBuffer> vertexBuffer;
+	std::shared_ptr<CodeRed::GpuBuffer> indexBuffer;
+
+	auto format = MeshDataFormat::Full;
+	auto formatBound = false;
 	
 	for (size_t index = 0; index < mDrawCalls.size();index++) {
 		const auto drawCall = mDrawCalls[index];
 		const auto meshDataInfo = meshDataAssetComponent->get(drawCall.Mesh);
+		const auto& quantization = meshDataInfo.Quantization;
+
+		if (!formatBound || meshDataInfo.Format != format) {
+			format = meshDataInfo.Format;
+			formatBound = true;
+
+			commandList->setGraphicsPipeline(format == MeshDataFormat::Compressed ?
+				mCompressedPipelineInfo->graphicsPipeline() :
+				mPipelineInfo->graphicsPipeline());
+		}
+
+		if (meshDataAssetComponent->positions(meshDataInfo) != vertexBuffer) {
+			vertexBuffer = meshDataAssetComponent->positions(meshDataInfo);
+
+			commandList->setVertexBuffer(vertexBuffer);
+		}
+
+		if (meshDataAssetComponent->indices(meshDataInfo) != indexBuffer) {
+			indexBuffer = meshDataAssetComponent->indices(meshDataInfo);
+
+			commandList->setIndexBuffer(indexBuffer);
+		}
 		
 		commandList->setConstant32Bits({
 			drawCall.Color.Red,
 			drawCall.Color.Green,
 			drawCall.Color.Blue,
 			drawCall.Color.Alpha,
-			static_cast<unsigned>(index)
+			static_cast<unsigned>(index),
+			quantization.Offset.x, quantization.Offset.y, quantization.Offset.z,
+			quantization.Scale.x, quantization.Scale.y, quantization.Scale.z
 		});
 
 		commandList->drawIndexed(meshDataInfo.IndexCount, 1,
@@ -245,6 +307,9 @@ void LRTR::WireframeRenderSystem::updatePipeline(const std::shared_ptr<CodeRed::
 
 	mPipelineInfo->setRenderPass(frameBuffer);
 	mPipelineInfo->updateState();
+
+	mCompressedPipelineInfo->setRenderPass(frameBuffer);
+	mCompressedPipelineInfo->updateState();
 }
 
 void LRTR::WireframeRenderSystem::updateCamera(const std::shared_ptr<SceneCamera>& camera) const
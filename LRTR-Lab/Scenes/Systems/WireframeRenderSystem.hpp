@@ -11,7 +11,7 @@ namespace LRTR {
 	class TrianglesMesh;
 
 	struct WireframeDrawCall {
-		std::shared_ptr<TrianglesMesh> Mesh;
+		std::shared_ptr<const TrianglesMesh> Mesh;
 		
 		ColorF Color;
 	};
@@ -23,8 +23,7 @@ namespace LRTR {
 			const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
 			size_t maxFrameCount = 2);
 
-		void update(
-			const Group<Identity, std::shared_ptr<Shape>>& shapes, float delta) override;
+		void update(const Scene& scene, float delta) override;
 
 		void render(
 			const std::vector<std::shared_ptr<CodeRed::GpuGraphicsCommandList>>& commandLists, 
@@ -42,6 +41,7 @@ namespace LRTR {
 	private:
 		std::shared_ptr<CodeRed::GpuResourceLayout> mResourceLayout;
 		std::shared_ptr<CodeRed::PipelineInfo> mPipelineInfo;
+		std::shared_ptr<CodeRed::PipelineInfo> mCompressedPipelineInfo;
 		std::shared_ptr<CodeRed::GpuBuffer> mViewBuffer;
 
 		std::vector<WireframeDrawCall> mDrawCalls;
@@ -0,0 +1,257 @@
+#include "TransformGraph.hpp"
+
+#include "Components/TransformHierarchy.hpp"
+#include "Components/TransformWrap.hpp"
+
+#include "../Core/Logging.hpp"
+
+#include "Scene.hpp"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__SSE__)
+#include <xmmintrin.h>
+#define __LRTR_TRANSFORM_GRAPH_SSE__
+#endif
+
+namespace LRTR {
+
+	constexpr size_t InvalidNode = ~static_cast<size_t>(0);
+	constexpr size_t InvalidVersion = ~static_cast<size_t>(0);
+
+	//the levels with fewer nodes are propagated in current thread
+	constexpr size_t PropagateGrain = 256;
+	
+	//result = left * right, the matrices are column major
+	inline void multiplyMatrix(const Matrix4x4f& left, const Matrix4x4f& right, Matrix4x4f& result)
+	{
+#ifdef __LRTR_TRANSFORM_GRAPH_SSE__
+		const auto leftData = &left[0][0];
+		const auto rightData = &right[0][0];
+		const auto resultData = &result[0][0];
+
+		const auto column0 = _mm_loadu_ps(leftData + 0);
+		const auto column1 = _mm_loadu_ps(leftData + 4);
+		const auto column2 = _mm_loadu_ps(leftData + 8);
+		const auto column3 = _mm_loadu_ps(leftData + 12);
+
+		//each column of result is the combination of columns of left
+		for (size_t index = 0; index < 4; index++) {
+			const auto factors = rightData + index * 4;
+
+			auto column = _mm_mul_ps(column0, _mm_set1_ps(factors[0]));
+
+			column = _mm_add_ps(column, _mm_mul_ps(column1, _mm_set1_ps(factors[1])));
+			column = _mm_add_ps(column, _mm_mul_ps(column2, _mm_set1_ps(factors[2])));
+			column = _mm_add_ps(column, _mm_mul_ps(column3, _mm_set1_ps(factors[3])));
+
+			_mm_storeu_ps(resultData + index * 4, column);
+		}
+#else
+		result = left * right;
+#endif
+	}
+	
+}
+
+LRTR::TransformGraph::~TransformGraph()
+{
+	unlink();
+}
+
+void LRTR::TransformGraph::update(const Scene& scene)
+{
+	if (mStorageVersion != scene.archetypes().version()) rebuild(scene);
+
+	propagate(*scene.threadPool());
+}
+
+auto LRTR::TransformGraph::size() const noexcept -> size_t
+{
+	return mTransforms.size();
+}
+
+auto LRTR::TransformGraph::depth() const noexcept -> size_t
+{
+	return mLevels.empty() ? 0 : mLevels.size() - 1;
+}
+
+void LRTR::TransformGraph::rebuild(const Scene& scene)
+{
+	struct Node {
+		std::shared_ptr<TransformWrap> Transform;
+
+		Identity Parent = 0;
+		size_t Depth = 0;
+	};
+
+	unlink();
+
+	mStorageVersion = scene.archetypes().version();
+
+	Group<Identity, Node> nodes;
+	Group<Identity, Shape*> parents;
+
+	scene.query<TransformHierarchy, TransformWrap>().each([&](const Archetype& archetype)
+		{
+			for (size_t row = 0; row < archetype.size(); row++) {
+				//the parent is removed if the handle is stale, so the node will be a root
+				const auto parent = scene.shape(archetype.get<TransformHierarchy>(row)->parent());
+
+				if (parent != nullptr) parents[parent->identity()] = parent;
+				
+				nodes[archetype.shapes()[row]->identity()] = {
+					archetype.shapes()[row]->component<TransformWrap>(),
+					parent != nullptr ? parent->identity() : 0
+				};
+			}
+		});
+
+	//the shapes without hierarchy are roots, we only add them if they are parents of other nodes
+	std::vector<Shape*> roots;
+
+	for (auto& node : nodes) {
+		if (node.second.Parent == 0 || nodes.find(node.second.Parent) != nodes.end()) continue;
+
+		const auto parent = parents.at(node.second.Parent);
+
+		if (!parent->hasComponent<TransformWrap>()) {
+			node.second.Parent = 0;
+
+			continue;
+		}
+
+		roots.push_back(parent);
+	}
+
+	for (const auto& root : roots)
+		nodes[root->identity()] = { root->component<TransformWrap>() };
+
+	std::vector<Identity> order;
+
+	for (auto& node : nodes) {
+		auto parent = node.second.Parent;
+
+		//the depth of node is the length of path to root, if the path is longer than
+		//the number of nodes, there is a cycle and we break it at this node
+		while (parent != 0 && node.second.Depth <= nodes.size()) {
+			parent = nodes.at(parent).Parent;
+			node.second.Depth++;
+		}
+
+		if (node.second.Depth > nodes.size()) {
+			LRTR_WARNING("The transform hierarchy has a cycle, the shape {0} is used as root.", node.first);
+
+			node.second.Parent = 0;
+			node.second.Depth = 0;
+		}
+
+		order.push_back(node.first);
+	}
+
+	//breaking a cycle changes the depth of other nodes in it, so we compute the depth again
+	for (auto& node : nodes) {
+		auto parent = node.second.Parent;
+
+		node.second.Depth = 0;
+
+		while (parent != 0) {
+			parent = nodes.at(parent).Parent;
+			node.second.Depth++;
+		}
+	}
+
+	std::sort(order.begin(), order.end(), [&](const Identity& left, const Identity& right)
+		{
+			const auto leftDepth = nodes.at(left).Depth;
+			const auto rightDepth = nodes.at(right).Depth;
+
+			return leftDepth != rightDepth ? leftDepth < rightDepth : left < right;
+		});
+
+	Group<Identity, size_t> indices;
+
+	mTransforms.clear();
+	mParents.clear();
+	mLevels.clear();
+
+	for (size_t index = 0; index < order.size(); index++) {
+		const auto& node = nodes.at(order[index]);
+
+		if (mLevels.size() <= node.Depth) mLevels.push_back(index);
+
+		mTransforms.push_back(node.Transform);
+		mParents.push_back(node.Parent != 0 ? indices.at(node.Parent) : InvalidNode);
+
+		//the world matrix of root is the matrix of its transform, so we only link the children
+		mTransforms.back()->mLinked = node.Parent != 0;
+
+		indices.insert({ order[index], index });
+	}
+
+	mLevels.push_back(order.size());
+
+	mVersions = std::vector<size_t>(order.size(), InvalidVersion);
+	mLocals = std::vector<Matrix4x4f>(order.size(), Matrix4x4f(1));
+	mWorlds = std::vector<Matrix4x4f>(order.size(), Matrix4x4f(1));
+	mDirty = std::vector<unsigned char>(order.size(), 0);
+}
+
+void LRTR::TransformGraph::propagate(ThreadPool& threadPool)
+{
+	const auto PropagateNodes = [&](const size_t begin, const size_t end)
+	{
+		for (size_t index = begin; index < end; index++) {
+			const auto& transform = mTransforms[index];
+			const auto parent = mParents[index];
+			const auto version = transform->version();
+
+			//the node is dirty if its local transform is changed or its parent is dirty
+			mDirty[index] = version != mVersions[index] || (parent != InvalidNode && mDirty[parent]);
+
+			if (!mDirty[index]) continue;
+
+			if (version != mVersions[index]) mLocals[index] = transform->transform().matrix();
+
+			if (parent == InvalidNode) {
+				mWorlds[index] = mLocals[index];
+				mVersions[index] = version;
+
+				continue;
+			}
+
+			multiplyMatrix(mWorlds[parent], mLocals[index], mWorlds[index]);
+
+			//set world matrix will change the version, so we record the version after it
+			transform->setWorld(mWorlds[index]);
+
+			mVersions[index] = transform->version();
+		}
+	};
+
+	//the nodes in same depth do not depend on each other, so we can propagate them in parallel
+	for (size_t level = 0; level + 1 < mLevels.size(); level++) {
+		const auto begin = mLevels[level];
+		const auto end = mLevels[level + 1];
+
+		if (end - begin < PropagateGrain * 2) { PropagateNodes(begin, end); continue; }
+
+		threadPool.parallelFor(end - begin, PropagateGrain, [&](size_t first, size_t last)
+			{
+				PropagateNodes(begin + first, begin + last);
+			});
+	}
+}
+
+void LRTR::TransformGraph::unlink()
+{
+	//the world matrix of unlinked transform is changed, so we need change the version
+	for (const auto& transform : mTransforms) {
+		if (!transform->mLinked) continue;
+
+		transform->mLinked = false;
+		transform->updateVersion();
+	}
+
+	mTransforms.clear();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../Shared/Parallel/ThreadPool.hpp"
+#include "../Shared/Math/Math.hpp"
+#include "../Core/Noncopyable.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace LRTR {
+
+	class TransformWrap;
+	class Scene;
+
+	//the transform graph is owned by scene, it links the shapes with TransformHierarchy to their parents
+	//the nodes are sorted by depth and stored in arrays, so the parent is always before its children
+	//we only propagate the world matrices of subtrees whose local transform is changed
+	class TransformGraph : public Noncopyable {
+	public:
+		TransformGraph() = default;
+
+		~TransformGraph();
+
+		//rebuild the graph if the shapes of scene are changed, then propagate the dirty subtrees
+		void update(const Scene& scene);
+
+		//the number of nodes in graph, include the roots
+		auto size() const noexcept -> size_t;
+
+		//the number of depths in graph
+		auto depth() const noexcept -> size_t;
+	private:
+		void rebuild(const Scene& scene);
+
+		void propagate(ThreadPool& threadPool);
+
+		void unlink();
+	private:
+		std::vector<std::shared_ptr<TransformWrap>> mTransforms;
+
+		//the index of parent node, the root node uses InvalidNode
+		std::vector<size_t> mParents;
+		//the version of transform when we computed the world matrix
+		std::vector<size_t> mVersions;
+
+		std::vector<Matrix4x4f> mLocals;
+		std::vector<Matrix4x4f> mWorlds;
+
+		//the dirty flags are written by different threads, so we do not use vector<bool>
+		std::vector<unsigned char> mDirty;
+
+		//the first node of each depth, the last one is the number of nodes
+		std::vector<size_t> mLevels;
+
+		//the version of archetype storage when we built the graph
+		size_t mStorageVersion = ~static_cast<size_t>(0);
+	};
+	
+}
@@ -0,0 +1,391 @@
+#include "BoundingVolumeHierarchy.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+#include <array>
+
+namespace LRTR {
+
+	constexpr size_t BinCount = 16;
+
+	//the node with fewer items may be a leaf if splitting it does not reduce the cost
+	constexpr unsigned MaxLeafItems = 4;
+
+	//the cost of visiting interior node, the cost of testing one item is 1
+	constexpr float TraversalCost = 1.0f;
+
+	//the planes of frustum that are still needed to test, each bit is one plane
+	constexpr unsigned AllPlanes = 0x3f;
+
+	inline auto intersectRay(
+		const Bound3f& bound, const Vector3f& origin, const Vector3f& inverseDirection,
+		const float distance, float& entry) -> bool
+	{
+		const auto lower = (bound.Min - origin) * inverseDirection;
+		const auto upper = (bound.Max - origin) * inverseDirection;
+
+		const auto minDistance = glm::min(lower, upper);
+		const auto maxDistance = glm::max(lower, upper);
+
+		entry = std::max(std::max(minDistance.x, minDistance.y), std::max(minDistance.z, 0.0f));
+
+		return entry <= std::min(std::min(maxDistance.x, maxDistance.y), std::min(maxDistance.z, distance));
+	}
+	
+}
+
+template <typename TTest>
+void LRTR::BoundingVolumeHierarchy::traverse(TTest&& test, const std::function<void(size_t)>& function) const
+{
+	if (mNodes.empty()) return;
+
+	std::vector<unsigned> stack = { 0 };
+
+	while (!stack.empty()) {
+		const auto index = stack.back();
+		const auto& node = mNodes[index];
+
+		stack.pop_back();
+
+		if (!test(node.Bound)) continue;
+
+		if (node.leaf()) {
+			for (auto item = node.Offset; item < node.Offset + node.Count; item++)
+				if (test(mBounds[mItems[item]])) function(mItems[item]);
+
+			continue;
+		}
+
+		stack.push_back(node.Offset);
+		stack.push_back(index + 1);
+	}
+}
+
+void LRTR::BoundingVolumeHierarchy::build(const std::vector<Bound3f>& bounds)
+{
+	mNodes.clear();
+	mBounds = bounds;
+	mItems = std::vector<unsigned>(bounds.size());
+
+	if (bounds.empty()) return;
+
+	std::iota(mItems.begin(), mItems.end(), 0);
+
+	std::vector<Vector3f> centers(bounds.size());
+
+	for (size_t index = 0; index < bounds.size(); index++) centers[index] = bounds[index].center();
+
+	//the binary tree with n leaves has 2n - 1 nodes
+	mNodes.reserve(bounds.size() * 2 - 1);
+
+	build(centers, 0, static_cast<unsigned>(bounds.size()));
+}
+
+void LRTR::BoundingVolumeHierarchy::refit(const std::vector<Bound3f>& bounds)
+{
+	assert(bounds.size() == mItems.size());
+
+	mBounds = bounds;
+
+	//the children are always after their parent, so we can refit the nodes in reverse order
+	for (auto index = mNodes.size(); index > 0; index--) {
+		auto& node = mNodes[index - 1];
+
+		node.Bound = Bound3f();
+
+		if (node.leaf()) {
+			for (auto item = node.Offset; item < node.Offset + node.Count; item++)
+				node.Bound.merge(mBounds[mItems[item]]);
+
+			continue;
+		}
+
+		node.Bound.merge(mNodes[index].Bound);
+		node.Bound.merge(mNodes[node.Offset].Bound);
+	}
+}
+
+void LRTR::BoundingVolumeHierarchy::clear()
+{
+	mNodes.clear();
+	mItems.clear();
+	mBounds.clear();
+}
+
+void LRTR::BoundingVolumeHierarchy::intersect(const FrustumF& frustum, const std::function<void(size_t)>& function) const
+{
+	if (mNodes.empty()) return;
+
+	std::vector<std::pair<unsigned, unsigned>> stack = { { 0, AllPlanes } };
+
+	//test the bound with planes in mask, the planes that the bound is inside are removed from mask
+	const auto TestPlanes = [&](const Bound3f& bound, unsigned& planes)
+	{
+		const auto center = bound.center();
+		const auto extent = bound.extent();
+
+		for (size_t plane = 0; plane < frustum.Planes.size(); plane++) {
+			if ((planes & (1u << plane)) == 0) continue;
+
+			const auto normal = Vector3f(frustum.Planes[plane]);
+			const auto distance = glm::dot(normal, center) + frustum.Planes[plane].w;
+			const auto radius = glm::dot(extent, glm::abs(normal));
+
+			if (distance + radius < 0) return false;
+			if (distance - radius >= 0) planes = planes & ~(1u << plane);
+		}
+
+		return true;
+	};
+	
+	while (!stack.empty()) {
+		const auto index = stack.back().first;
+		auto planes = stack.back().second;
+
+		stack.pop_back();
+
+		const auto& node = mNodes[index];
+
+		if (planes != 0 && !TestPlanes(node.Bound, planes)) continue;
+
+		if (node.leaf()) {
+			for (auto item = node.Offset; item < node.Offset + node.Count; item++) {
+				auto itemPlanes = planes;
+
+				if (itemPlanes == 0 || TestPlanes(mBounds[mItems[item]], itemPlanes)) function(mItems[item]);
+			}
+
+			continue;
+		}
+
+		stack.push_back({ node.Offset, planes });
+		stack.push_back({ index + 1, planes });
+	}
+}
+
+void LRTR::BoundingVolumeHierarchy::intersect(const Bound3f& bound, const std::function<void(size_t)>& function) const
+{
+	const auto Test = [&](const Bound3f& other) { return other.overlap(bound); };
+	
+	traverse(Test, function);
+}
+
+void LRTR::BoundingVolumeHierarchy::intersect(
+	const Vector3f& center, const float radius,
+	const std::function<void(size_t)>& function) const
+{
+	const auto Test = [&](const Bound3f& other) { return other.overlap(center, radius); };
+
+	traverse(Test, function);
+}
+
+void LRTR::BoundingVolumeHierarchy::intersect(
+	const RayF& ray, const float distance,
+	const std::function<float(size_t, float)>& function) const
+{
+	if (mNodes.empty()) return;
+
+	//the division by zero is infinity, so the slab test is still right for axis aligned rays
+	const auto inverseDirection = 1.0f / ray.Direction;
+
+	auto maxDistance = distance;
+	auto entry = 0.0f;
+
+	if (!intersectRay(mNodes[0].Bound, ray.Origin, inverseDirection, maxDistance, entry)) return;
+
+	std::vector<std::pair<unsigned, float>> stack = { { 0, entry } };
+
+	while (!stack.empty()) {
+		const auto index = stack.back().first;
+
+		//the node may be farther than the closest hit we found after it was pushed
+		if (stack.back().second > maxDistance) { stack.pop_back(); continue; }
+
+		stack.pop_back();
+
+		const auto& node = mNodes[index];
+
+		if (node.leaf()) {
+			for (auto item = node.Offset; item < node.Offset + node.Count; item++) {
+				if (!intersectRay(mBounds[mItems[item]], ray.Origin, inverseDirection, maxDistance, entry)) continue;
+
+				maxDistance = std::min(maxDistance, function(mItems[item], maxDistance));
+			}
+
+			continue;
+		}
+
+		auto leftEntry = 0.0f;
+		auto rightEntry = 0.0f;
+
+		const auto left = intersectRay(mNodes[index + 1].Bound, ray.Origin, inverseDirection, maxDistance, leftEntry);
+		const auto right = intersectRay(mNodes[node.Offset].Bound, ray.Origin, inverseDirection, maxDistance, rightEntry);
+
+		//push the farther child first, so the closer child is visited first
+		if (left && right) {
+			if (leftEntry <= rightEntry) {
+				stack.push_back({ node.Offset, rightEntry });
+				stack.push_back({ index + 1, leftEntry });
+			}
+			else {
+				stack.push_back({ index + 1, leftEntry });
+				stack.push_back({ node.Offset, rightEntry });
+			}
+		}
+		else if (left) stack.push_back({ index + 1, leftEntry });
+		else if (right) stack.push_back({ node.Offset, rightEntry });
+	}
+}
+
+auto LRTR::BoundingVolumeHierarchy::nodes() const noexcept -> const std::vector<BoundingVolumeNode>&
+{
+	return mNodes;
+}
+
+auto LRTR::BoundingVolumeHierarchy::items() const noexcept -> const std::vector<unsigned>&
+{
+	return mItems;
+}
+
+auto LRTR::BoundingVolumeHierarchy::bounds() const noexcept -> const std::vector<Bound3f>&
+{
+	return mBounds;
+}
+
+auto LRTR::BoundingVolumeHierarchy::bound() const noexcept -> Bound3f
+{
+	return mNodes.empty() ? Bound3f() : mNodes[0].Bound;
+}
+
+auto LRTR::BoundingVolumeHierarchy::cost() const noexcept -> float
+{
+	if (mNodes.empty()) return 0;
+
+	const auto area = mNodes[0].Bound.surfaceArea();
+
+	if (area <= 0) return 0;
+
+	auto cost = 0.0f;
+
+	//the probability of visiting node is the ratio of its area to the area of root
+	for (const auto& node : mNodes)
+		cost = cost + node.Bound.surfaceArea() * (node.leaf() ? static_cast<float>(node.Count) : TraversalCost);
+
+	return cost / area;
+}
+
+auto LRTR::BoundingVolumeHierarchy::size() const noexcept -> size_t
+{
+	return mItems.size();
+}
+
+auto LRTR::BoundingVolumeHierarchy::empty() const noexcept -> bool
+{
+	return mItems.empty();
+}
+
+auto LRTR::BoundingVolumeHierarchy::build(const std::vector<Vector3f>& centers, unsigned begin, unsigned end) -> unsigned
+{
+	struct Bin {
+		Bound3f Bound;
+		unsigned Count = 0;
+	};
+	
+	const auto index = static_cast<unsigned>(mNodes.size());
+	const auto count = end - begin;
+
+	Bound3f bound;
+	Bound3f centerBound;
+
+	for (auto item = begin; item < end; item++) {
+		bound.merge(mBounds[mItems[item]]);
+		centerBound.merge(centers[mItems[item]]);
+	}
+
+	mNodes.push_back({ bound, begin, count });
+
+	if (count == 1) return index;
+
+	//we split the items along the axis with the largest extent of centers
+	const auto size = centerBound.Max - centerBound.Min;
+	const auto axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+	const auto extent = size[axis];
+
+	auto middle = begin + count / 2;
+
+	if (extent > 0) {
+		std::array<Bin, BinCount> bins;
+
+		const auto BinIndex = [&](const unsigned item)
+		{
+			const auto offset = (centers[item][axis] - centerBound.Min[axis]) / extent;
+
+			return std::min(static_cast<size_t>(offset * BinCount), BinCount - 1);
+		};
+
+		for (auto item = begin; item < end; item++) {
+			auto& bin = bins[BinIndex(mItems[item])];
+
+			bin.Bound.merge(mBounds[mItems[item]]);
+			bin.Count++;
+		}
+
+		//the cost of the right part of each split, the split i puts bins [0, i] to left
+		std::array<float, BinCount - 1> rightCosts = {};
+
+		Bound3f rightBound;
+		unsigned rightCount = 0;
+
+		for (auto split = BinCount - 1; split > 0; split--) {
+			rightBound.merge(bins[split].Bound);
+			rightCount = rightCount + bins[split].Count;
+
+			rightCosts[split - 1] = rightBound.surfaceArea() * rightCount;
+		}
+
+		Bound3f leftBound;
+		unsigned leftCount = 0;
+
+		auto bestCost = std::numeric_limits<float>::max();
+		size_t bestSplit = 0;
+
+		for (size_t split = 0; split < BinCount - 1; split++) {
+			leftBound.merge(bins[split].Bound);
+			leftCount = leftCount + bins[split].Count;
+
+			const auto cost = leftBound.surfaceArea() * leftCount + rightCosts[split];
+
+			if (cost < bestCost) { bestCost = cost; bestSplit = split; }
+		}
+
+		const auto area = bound.surfaceArea();
+
+		bestCost = TraversalCost + (area > 0 ? bestCost / area : static_cast<float>(count));
+
+		//splitting the node is more expensive than testing all items
+		if (count <= MaxLeafItems && bestCost >= static_cast<float>(count)) return index;
+
+		middle = static_cast<unsigned>(std::partition(mItems.begin() + begin, mItems.begin() + end,
+			[&](const unsigned item) { return BinIndex(item) <= bestSplit; }) - mItems.begin());
+	}
+	else if (count <= MaxLeafItems) return index;
+
+	//all items are in one side, we split them at the median
+	if (middle == begin || middle == end) {
+		middle = begin + count / 2;
+
+		std::nth_element(mItems.begin() + begin, mItems.begin() + middle, mItems.begin() + end,
+			[&](const unsigned left, const unsigned right) { return centers[left][axis] < centers[right][axis]; });
+	}
+
+	//the left child is the next node, so we only need to record the right child
+	build(centers, begin, middle);
+
+	const auto right = build(centers, middle, end);
+
+	mNodes[index].Offset = right;
+	mNodes[index].Count = 0;
+
+	return index;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+#include "../Frustum.hpp"
+#include "../Bound.hpp"
+#include "../Ray.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace LRTR {
+
+	//the nodes are stored in depth first order, the left child of interior node is the next node
+	struct BoundingVolumeNode {
+		Bound3f Bound;
+
+		//the first item of leaf or the index of right child of interior node
+		unsigned Offset = 0;
+		//the number of items of leaf, interior node does not have items
+		unsigned Count = 0;
+
+		auto leaf() const noexcept -> bool { return Count != 0; }
+	};
+
+	//the bounding volume hierarchy over items with bounds, the item is the index of bound we built with
+	//we use binned surface area heuristic to build the hierarchy, when the items are moved we can refit
+	//the bounds of nodes without changing the topology, it is fast but the quality may be worse
+	class BoundingVolumeHierarchy : public Noncopyable {
+	public:
+		BoundingVolumeHierarchy() = default;
+
+		~BoundingVolumeHierarchy() = default;
+
+		void build(const std::vector<Bound3f>& bounds);
+
+		//the size of bounds must be the same as the size we built with
+		void refit(const std::vector<Bound3f>& bounds);
+
+		void clear();
+
+		//call the function for the items whose bound intersects the frustum
+		void intersect(const FrustumF& frustum, const std::function<void(size_t)>& function) const;
+
+		//call the function for the items whose bound overlaps the bound
+		void intersect(const Bound3f& bound, const std::function<void(size_t)>& function) const;
+
+		//call the function for the items whose bound overlaps the sphere
+		void intersect(const Vector3f& center, const float radius, const std::function<void(size_t)>& function) const;
+
+		//call the function for the items whose bound is hit by ray in [0, distance], the closer nodes are visited first
+		//the function returns the new max distance, so the closest hit query can stop visiting the farther nodes
+		void intersect(const RayF& ray, const float distance, const std::function<float(size_t, float)>& function) const;
+
+		auto nodes() const noexcept -> const std::vector<BoundingVolumeNode>&;
+
+		//the items in the order of leaves
+		auto items() const noexcept -> const std::vector<unsigned>&;
+
+		auto bounds() const noexcept -> const std::vector<Bound3f>&;
+
+		auto bound() const noexcept -> Bound3f;
+
+		//the surface area heuristic cost of hierarchy, the refit makes it larger when the items are moved
+		auto cost() const noexcept -> float;
+
+		auto size() const noexcept -> size_t;
+
+		auto empty() const noexcept -> bool;
+	private:
+		auto build(const std::vector<Vector3f>& centers, unsigned begin, unsigned end) -> unsigned;
+
+		//visit the nodes and items whose bound passes the test
+		template<typename TTest>
+		void traverse(TTest&& test, const std::function<void(size_t)>& function) const;
+	private:
+		std::vector<BoundingVolumeNode> mNodes;
+		std::vector<unsigned> mItems;
+
+		//the bounds of items, the leaves test them to skip the items that are not intersected
+		std::vector<Bound3f> mBounds;
+	};
+	
+}
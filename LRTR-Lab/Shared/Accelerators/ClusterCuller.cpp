@@ -0,0 +1,118 @@
+#include "ClusterCuller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LRTR {
+
+	//the tolerance of lengths and angles of axes, the matrices built from translation, rotation and scale are in it
+	constexpr float SimilarityTolerance = 1e-3f;
+
+	//the similarity transform keeps the angles, so the normal cone in local space is the cone in world space
+	//the non-uniform scale and shear change the angles between normals, so the cone of meshlet is not valid
+	inline auto isSimilarity(const Matrix4x4f& world) -> bool
+	{
+		if (world[0][3] != 0 || world[1][3] != 0 || world[2][3] != 0 || world[3][3] != 1) return false;
+
+		const Vector3f axes[3] = { Vector3f(world[0]), Vector3f(world[1]), Vector3f(world[2]) };
+
+		const auto scale = glm::dot(axes[0], axes[0]);
+
+		if (scale <= 0) return false;
+
+		for (auto axis = 0; axis < 3; axis++) {
+			const auto next = (axis + 1) % 3;
+
+			if (std::abs(glm::dot(axes[axis], axes[axis]) - scale) > SimilarityTolerance * scale) return false;
+			if (std::abs(glm::dot(axes[axis], axes[next])) > SimilarityTolerance * scale) return false;
+		}
+
+		return true;
+	}
+
+}
+
+void LRTR::ClusterCuller::begin(
+	const Matrix4x4f& viewProjection,
+	const Vector3f& viewer,
+	const bool coneCulled,
+	const OcclusionCuller* occlusionCuller)
+{
+	mOcclusionCuller = occlusionCuller;
+	mViewProjection = viewProjection;
+	mViewer = viewer;
+	mConeCulled = coneCulled;
+
+	mClusters = mFrustumCulled = mBackFacing = mOccluded = 0;
+}
+
+auto LRTR::ClusterCuller::cull(
+	const std::vector<Meshlet>& meshlets,
+	const Matrix4x4f& world,
+	std::vector<IndexRange>& ranges) -> size_t
+{
+	//the planes are extracted from the matrix with world, so they are in local space of mesh
+	//the viewer is transformed into local space, the side of triangle plane is not changed by transform
+	const auto frustum = FrustumF(mViewProjection * world);
+	const auto viewer = Vector3f(glm::inverse(world) * Vector4f(mViewer, 1.0f));
+	const auto coneCulled = mConeCulled && isSimilarity(world);
+
+	//the range we are merging into, it is not in ranges if its count is zero
+	auto range = IndexRange();
+	auto visible = static_cast<size_t>(0);
+
+	const auto flush = [&]()
+	{
+		if (range.Count != 0) ranges.push_back(range);
+
+		range = IndexRange();
+	};
+
+	for (const auto& meshlet : meshlets) {
+		mClusters++;
+
+		if (!frustum.intersect(meshlet.Center, meshlet.Radius)) { mFrustumCulled++; flush(); continue; }
+
+		if (coneCulled && MeshletBuilder::backFacing(meshlet, viewer)) { mBackFacing++; flush(); continue; }
+
+		//the occlusion culler tests bounds in world space, the box of sphere is conservative
+		if (mOcclusionCuller != nullptr && !mOcclusionCuller->test(Bound3f(
+			meshlet.Center - Vector3f(meshlet.Radius), meshlet.Center + Vector3f(meshlet.Radius)).transform(world))) {
+			mOccluded++; flush(); continue;
+		}
+
+		if (range.Count != 0 && range.Offset + range.Count == meshlet.IndexOffset)
+			range.Count = range.Count + meshlet.IndexCount;
+		else {
+			flush();
+
+			range = IndexRange(meshlet.IndexOffset, meshlet.IndexCount);
+		}
+
+		visible++;
+	}
+
+	flush();
+
+	return visible;
+}
+
+auto LRTR::ClusterCuller::clusters() const noexcept -> size_t
+{
+	return mClusters;
+}
+
+auto LRTR::ClusterCuller::frustumCulled() const noexcept -> size_t
+{
+	return mFrustumCulled;
+}
+
+auto LRTR::ClusterCuller::backFacing() const noexcept -> size_t
+{
+	return mBackFacing;
+}
+
+auto LRTR::ClusterCuller::occluded() const noexcept -> size_t
+{
+	return mOccluded;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+#include "../Meshes/MeshletBuilder.hpp"
+#include "../Frustum.hpp"
+
+#include "OcclusionCuller.hpp"
+
+#include <vector>
+
+namespace LRTR {
+
+	//the range of indices we draw, the offset is relative to the start index location of mesh
+	struct IndexRange {
+		unsigned Offset = 0;
+		unsigned Count = 0;
+
+		IndexRange() = default;
+
+		IndexRange(const unsigned offset, const unsigned count) : Offset(offset), Count(count) {}
+	};
+
+	//the cluster culler tests the meshlets of mesh with the frustum, the normal cone and the occlusion culler
+	//the visible meshlets are merged into index ranges, so the adjacent visible meshlets are one draw
+	//the tests are done in the local space of mesh, so we do not transform the meshlets
+	//the normal cone is only tested if the world matrix is a similarity transform (no non-uniform scale or shear)
+	class ClusterCuller : public Noncopyable {
+	public:
+		ClusterCuller() = default;
+
+		~ClusterCuller() = default;
+
+		//start a new view, the statistics are cleared, the viewer is the position of camera or light in world space
+		//the occlusion culler is rendered with the same view projection, it is not used if it is nullptr
+		void begin(
+			const Matrix4x4f& viewProjection,
+			const Vector3f& viewer,
+			const bool coneCulled = true,
+			const OcclusionCuller* occlusionCuller = nullptr);
+
+		//append the ranges of visible meshlets to ranges and return the number of visible meshlets
+		auto cull(
+			const std::vector<Meshlet>& meshlets,
+			const Matrix4x4f& world,
+			std::vector<IndexRange>& ranges) -> size_t;
+
+		//the meshlets we tested and culled since begin
+		auto clusters() const noexcept -> size_t;
+
+		auto frustumCulled() const noexcept -> size_t;
+
+		auto backFacing() const noexcept -> size_t;
+
+		auto occluded() const noexcept -> size_t;
+	private:
+		const OcclusionCuller* mOcclusionCuller = nullptr;
+
+		Matrix4x4f mViewProjection = Matrix4x4f(1);
+		Vector3f mViewer = Vector3f(0);
+
+		bool mConeCulled = true;
+
+		size_t mClusters = 0;
+		size_t mFrustumCulled = 0;
+		size_t mBackFacing = 0;
+		size_t mOccluded = 0;
+	};
+
+}
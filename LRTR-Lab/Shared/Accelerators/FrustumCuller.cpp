@@ -0,0 +1,238 @@
+#include "FrustumCuller.hpp"
+
+//the SSE is the baseline of x64, on Win32 it is enabled by /arch:SSE or /arch:SSE2
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define __LRTR_FRUSTUM_CULLER_SSE__
+#endif
+
+//the projects are not built with /arch:AVX, so the AVX version is compiled for its own
+//and we only call it if the CPU and OS support it
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#define __LRTR_FRUSTUM_CULLER_AVX__
+#define __LRTR_TARGET_AVX__
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define __LRTR_FRUSTUM_CULLER_AVX__
+#define __LRTR_TARGET_AVX__ __attribute__((target("avx")))
+#endif
+
+#include <cmath>
+
+namespace LRTR {
+
+	struct FrustumCullerBounds {
+		const float* CenterX;
+		const float* CenterY;
+		const float* CenterZ;
+		const float* ExtentX;
+		const float* ExtentY;
+		const float* ExtentZ;
+	};
+
+#ifdef __LRTR_FRUSTUM_CULLER_AVX__
+	//the AVX needs the support of OS to save the registers, so we check the OSXSAVE and XCR0 too
+	static auto FrustumCullerSupportAVX() noexcept -> bool
+	{
+#ifdef _MSC_VER
+		int info[4] = {};
+
+		__cpuid(info, 1);
+
+		const auto osxsave = (info[2] & (1 << 27)) != 0;
+		const auto avx = (info[2] & (1 << 28)) != 0;
+
+		return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+		__builtin_cpu_init();
+
+		return __builtin_cpu_supports("avx") != 0;
+#endif
+	}
+
+	__LRTR_TARGET_AVX__
+	static auto FrustumCullerCullAVX(
+		const FrustumCullerBounds& bounds, const FrustumF& frustum,
+		const size_t count, std::vector<unsigned char>& visible) -> size_t
+	{
+		size_t result = 0;
+		
+		for (size_t index = 0; index < count; index += 8) {
+			const auto cx = _mm256_loadu_ps(bounds.CenterX + index);
+			const auto cy = _mm256_loadu_ps(bounds.CenterY + index);
+			const auto cz = _mm256_loadu_ps(bounds.CenterZ + index);
+			const auto ex = _mm256_loadu_ps(bounds.ExtentX + index);
+			const auto ey = _mm256_loadu_ps(bounds.ExtentY + index);
+			const auto ez = _mm256_loadu_ps(bounds.ExtentZ + index);
+
+			auto outside = _mm256_setzero_ps();
+
+			for (const auto& plane : frustum.Planes) {
+				//the distance from center to plane and the projected radius of box on the normal
+				auto distance = _mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(plane.x)), _mm256_set1_ps(plane.w));
+
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(cy, _mm256_set1_ps(plane.y)));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(cz, _mm256_set1_ps(plane.z)));
+
+				auto radius = _mm256_mul_ps(ex, _mm256_set1_ps(std::abs(plane.x)));
+
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(ey, _mm256_set1_ps(std::abs(plane.y))));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(ez, _mm256_set1_ps(std::abs(plane.z))));
+
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+			}
+
+			const auto mask = _mm256_movemask_ps(outside);
+
+			for (size_t lane = 0; lane < 8; lane++) {
+				visible[index + lane] = (mask & (1 << lane)) == 0 ? 1 : 0;
+				result = result + visible[index + lane];
+			}
+		}
+
+		return result;
+	}
+#endif
+
+#ifdef __LRTR_FRUSTUM_CULLER_SSE__
+	static auto FrustumCullerCullSSE(
+		const FrustumCullerBounds& bounds, const FrustumF& frustum,
+		const size_t count, std::vector<unsigned char>& visible) -> size_t
+	{
+		size_t result = 0;
+
+		for (size_t index = 0; index < count; index += 4) {
+			const auto cx = _mm_loadu_ps(bounds.CenterX + index);
+			const auto cy = _mm_loadu_ps(bounds.CenterY + index);
+			const auto cz = _mm_loadu_ps(bounds.CenterZ + index);
+			const auto ex = _mm_loadu_ps(bounds.ExtentX + index);
+			const auto ey = _mm_loadu_ps(bounds.ExtentY + index);
+			const auto ez = _mm_loadu_ps(bounds.ExtentZ + index);
+
+			auto outside = _mm_setzero_ps();
+
+			for (const auto& plane : frustum.Planes) {
+				//the distance from center to plane and the projected radius of box on the normal
+				auto distance = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_set1_ps(plane.w));
+
+				distance = _mm_add_ps(distance, _mm_mul_ps(cy, _mm_set1_ps(plane.y)));
+				distance = _mm_add_ps(distance, _mm_mul_ps(cz, _mm_set1_ps(plane.z)));
+
+				auto radius = _mm_mul_ps(ex, _mm_set1_ps(std::abs(plane.x)));
+
+				radius = _mm_add_ps(radius, _mm_mul_ps(ey, _mm_set1_ps(std::abs(plane.y))));
+				radius = _mm_add_ps(radius, _mm_mul_ps(ez, _mm_set1_ps(std::abs(plane.z))));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+			}
+
+			const auto mask = _mm_movemask_ps(outside);
+
+			for (size_t lane = 0; lane < 4; lane++) {
+				visible[index + lane] = (mask & (1 << lane)) == 0 ? 1 : 0;
+				result = result + visible[index + lane];
+			}
+		}
+
+		return result;
+	}
+#endif
+
+}
+
+void LRTR::FrustumCuller::add(const Bound3f& bound)
+{
+	const auto center = bound.center();
+	const auto extent = bound.extent();
+
+	for (size_t axis = 0; axis < 3; axis++) {
+		mCenters[axis].push_back(center[static_cast<int>(axis)]);
+		mExtents[axis].push_back(extent[static_cast<int>(axis)]);
+	}
+}
+
+void LRTR::FrustumCuller::clear()
+{
+	for (size_t axis = 0; axis < 3; axis++) {
+		mCenters[axis].clear();
+		mExtents[axis].clear();
+	}
+}
+
+void LRTR::FrustumCuller::reserve(const size_t count)
+{
+	for (size_t axis = 0; axis < 3; axis++) {
+		mCenters[axis].reserve(count);
+		mExtents[axis].reserve(count);
+	}
+}
+
+auto LRTR::FrustumCuller::cull(const FrustumF& frustum, std::vector<unsigned char>& visible) const -> size_t
+{
+	const auto count = size();
+	const auto batchWidth = width();
+	const auto batches = count - count % batchWidth;
+
+	visible.resize(count);
+
+	size_t result = 0;
+
+	const auto bounds = FrustumCullerBounds{
+		mCenters[0].data(), mCenters[1].data(), mCenters[2].data(),
+		mExtents[0].data(), mExtents[1].data(), mExtents[2].data()
+	};
+
+#ifdef __LRTR_FRUSTUM_CULLER_AVX__
+	if (batchWidth == 8) result = FrustumCullerCullAVX(bounds, frustum, batches, visible);
+#endif
+#ifdef __LRTR_FRUSTUM_CULLER_SSE__
+	if (batchWidth == 4) result = FrustumCullerCullSSE(bounds, frustum, batches, visible);
+#endif
+
+	//the bounds that are not enough for one batch, we use the same order of operations as SIMD version
+	for (size_t index = batches; index < count; index++) {
+		auto outside = false;
+
+		for (const auto& plane : frustum.Planes) {
+			auto distance = bounds.CenterX[index] * plane.x + plane.w;
+
+			distance = distance + bounds.CenterY[index] * plane.y;
+			distance = distance + bounds.CenterZ[index] * plane.z;
+
+			auto radius = bounds.ExtentX[index] * std::abs(plane.x);
+
+			radius = radius + bounds.ExtentY[index] * std::abs(plane.y);
+			radius = radius + bounds.ExtentZ[index] * std::abs(plane.z);
+
+			outside = outside || distance + radius < 0;
+		}
+
+		visible[index] = outside ? 0 : 1;
+		result = result + visible[index];
+	}
+
+	return result;
+}
+
+auto LRTR::FrustumCuller::size() const noexcept -> size_t
+{
+	return mCenters[0].size();
+}
+
+auto LRTR::FrustumCuller::width() noexcept -> size_t
+{
+	//the CPU does not change when we are running, so we only check it once
+#ifdef __LRTR_FRUSTUM_CULLER_AVX__
+	static const auto supportAVX = FrustumCullerSupportAVX();
+
+	if (supportAVX) return 8;
+#endif
+
+#ifdef __LRTR_FRUSTUM_CULLER_SSE__
+	return 4;
+#else
+	return 1;
+#endif
+}
\ No newline at end of file
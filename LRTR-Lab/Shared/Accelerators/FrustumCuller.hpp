@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+#include "../Frustum.hpp"
+
+#include <vector>
+#include <array>
+
+namespace LRTR {
+
+	//the frustum culler stores the bounds as centers and extents in structure of arrays
+	//so we can test 4 (SSE) or 8 (AVX) bounds with one plane at a time, the AVX is used if the CPU supports it
+	//it does not depend on the device, so we can use it on any thread
+	class FrustumCuller : public Noncopyable {
+	public:
+		FrustumCuller() = default;
+
+		~FrustumCuller() = default;
+
+		void add(const Bound3f& bound);
+
+		void clear();
+
+		void reserve(const size_t count);
+
+		//the visible[index] is 1 if the bound intersects frustum, return the number of visible bounds
+		auto cull(const FrustumF& frustum, std::vector<unsigned char>& visible) const -> size_t;
+
+		auto size() const noexcept -> size_t;
+
+		//the number of bounds we test at a time, it depends on the CPU we are running on
+		static auto width() noexcept -> size_t;
+	private:
+		std::array<std::vector<float>, 3> mCenters;
+		std::array<std::vector<float>, 3> mExtents;
+	};
+	
+}
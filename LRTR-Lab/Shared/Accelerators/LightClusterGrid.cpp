@@ -0,0 +1,195 @@
+#include "LightClusterGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LRTR {
+
+	inline auto unproject(const Matrix4x4f& inverse, const float x, const float y, const float z) -> Vector3f
+	{
+		const auto point = inverse * Vector4f(x, y, z, 1.0f);
+
+		return Vector3f(point) / point.w;
+	}
+
+	//the point on the line (from, to) whose depth is the depth, the depth is -z in view space
+	inline auto pointAtDepth(const Vector3f& from, const Vector3f& to, const float depth) -> Vector3f
+	{
+		const auto t = (-depth - from.z) / (to.z - from.z);
+
+		return from + (to - from) * t;
+	}
+
+	inline auto clampIndex(const float value, const size_t count) -> size_t
+	{
+		if (!(value > 0)) return 0;
+
+		return std::min(static_cast<size_t>(value), count - 1);
+	}
+	
+}
+
+LRTR::LightClusterGrid::LightClusterGrid(const size_t width, const size_t height, const size_t depth) :
+	mWidth(width), mHeight(height), mDepth(depth),
+	mBounds(width * height * depth), mRowBounds(height * depth), mClusters(width * height * depth)
+{
+}
+
+void LRTR::LightClusterGrid::update(const Matrix4x4f& projection)
+{
+	if (projection == mProjection) return;
+
+	mProjection = projection;
+
+	const auto inverse = glm::inverse(projection);
+
+	mNear = -unproject(inverse, 0, 0, -1).z;
+	mFar = -unproject(inverse, 0, 0, +1).z;
+
+	//the corners of tiles are lines in view space, we find the points on them with the depth of slices
+	std::vector<std::pair<Vector3f, Vector3f>> lines((mWidth + 1) * (mHeight + 1));
+
+	for (size_t y = 0; y <= mHeight; y++) {
+		for (size_t x = 0; x <= mWidth; x++) {
+			const auto ndcX = -1.0f + 2.0f * x / mWidth;
+			const auto ndcY = +1.0f - 2.0f * y / mHeight;
+
+			lines[y * (mWidth + 1) + x] = {
+				unproject(inverse, ndcX, ndcY, -1),
+				unproject(inverse, ndcX, ndcY, +1)
+			};
+		}
+	}
+
+	for (size_t z = 0; z < mDepth; z++) {
+		const auto sliceNear = mNear * std::pow(mFar / mNear, static_cast<float>(z) / mDepth);
+		const auto sliceFar = mNear * std::pow(mFar / mNear, static_cast<float>(z + 1) / mDepth);
+
+		for (size_t y = 0; y < mHeight; y++) {
+			auto& rowBound = mRowBounds[z * mHeight + y];
+
+			rowBound = Bound3f();
+			
+			for (size_t x = 0; x < mWidth; x++) {
+				auto& bound = mBounds[index(x, y, z)];
+
+				bound = Bound3f();
+
+				for (size_t corner = 0; corner < 4; corner++) {
+					const auto& line = lines[(y + corner / 2) * (mWidth + 1) + x + corner % 2];
+
+					bound.merge(pointAtDepth(line.first, line.second, sliceNear));
+					bound.merge(pointAtDepth(line.first, line.second, sliceFar));
+				}
+
+				rowBound.merge(bound);
+			}
+		}
+	}
+}
+
+void LRTR::LightClusterGrid::build(const Matrix4x4f& view, const std::vector<Vector4f>& lights)
+{
+	mPairs.clear();
+
+	for (size_t light = 0; light < lights.size(); light++) {
+		const auto center = Vector3f(view * Vector4f(Vector3f(lights[light]), 1.0f));
+		const auto radius = lights[light].w;
+
+		const auto minDepth = -center.z - radius;
+		const auto maxDepth = -center.z + radius;
+
+		if (maxDepth < mNear || minDepth > mFar) continue;
+
+		//the range of slices is extended by one slice, so the lights touching the border of slices are still tested
+		const auto minZ = slice(minDepth) > 0 ? slice(minDepth) - 1 : 0;
+		const auto maxZ = std::min(slice(maxDepth) + 1, mDepth - 1);
+
+		for (auto z = minZ; z <= maxZ; z++) {
+			for (size_t y = 0; y < mHeight; y++) {
+				//the bound of row contains the bounds of all clusters in it, so we can skip the row
+				if (!mRowBounds[z * mHeight + y].overlap(center, radius)) continue;
+
+				for (size_t x = 0; x < mWidth; x++) {
+					const auto cluster = index(x, y, z);
+
+					if (mBounds[cluster].overlap(center, radius))
+						mPairs.push_back({ static_cast<unsigned>(cluster), static_cast<unsigned>(light) });
+				}
+			}
+		}
+	}
+
+	//counting sort the pairs by clusters, the lights of one cluster are still in the order of lights
+	for (auto& cluster : mClusters) cluster = LightCluster();
+
+	for (const auto& pair : mPairs) mClusters[pair.first].Count++;
+
+	unsigned offset = 0;
+
+	for (auto& cluster : mClusters) {
+		cluster.Offset = offset;
+		offset = offset + cluster.Count;
+		cluster.Count = 0;
+	}
+
+	mIndices.resize(mPairs.size());
+
+	for (const auto& pair : mPairs) {
+		auto& cluster = mClusters[pair.first];
+
+		mIndices[cluster.Offset + cluster.Count++] = pair.second;
+	}
+}
+
+auto LRTR::LightClusterGrid::clusters() const noexcept -> const std::vector<LightCluster>&
+{
+	return mClusters;
+}
+
+auto LRTR::LightClusterGrid::indices() const noexcept -> const std::vector<unsigned>&
+{
+	return mIndices;
+}
+
+auto LRTR::LightClusterGrid::bound(const size_t index) const -> const Bound3f&
+{
+	return mBounds[index];
+}
+
+auto LRTR::LightClusterGrid::index(const size_t x, const size_t y, const size_t z) const noexcept -> size_t
+{
+	return (z * mHeight + y) * mWidth + x;
+}
+
+auto LRTR::LightClusterGrid::slice(const float depth) const noexcept -> size_t
+{
+	if (depth <= mNear) return 0;
+
+	return clampIndex(std::log(depth / mNear) / std::log(mFar / mNear) * mDepth, mDepth);
+}
+
+auto LRTR::LightClusterGrid::width() const noexcept -> size_t
+{
+	return mWidth;
+}
+
+auto LRTR::LightClusterGrid::height() const noexcept -> size_t
+{
+	return mHeight;
+}
+
+auto LRTR::LightClusterGrid::depth() const noexcept -> size_t
+{
+	return mDepth;
+}
+
+auto LRTR::LightClusterGrid::zNear() const noexcept -> float
+{
+	return mNear;
+}
+
+auto LRTR::LightClusterGrid::zFar() const noexcept -> float
+{
+	return mFar;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+#include "../Bound.hpp"
+
+#include <vector>
+
+namespace LRTR {
+
+	//the lights of cluster are indices[Offset, Offset + Count)
+	struct LightCluster {
+		unsigned Offset = 0;
+		unsigned Count = 0;
+	};
+
+	//the light cluster grid splits the view frustum into tiles on screen and slices in depth
+	//the depth of slices grows exponentially from near plane to far plane, so the clusters have similar shape
+	//the lights are binned by testing their spheres with the view space bounds of clusters
+	//the tile (0, 0) is the top left of screen, the same as the texture coordinate of screen
+	class LightClusterGrid : public Noncopyable {
+	public:
+		explicit LightClusterGrid(
+			const size_t width = 16,
+			const size_t height = 9,
+			const size_t depth = 24);
+
+		~LightClusterGrid() = default;
+
+		//update the bounds of clusters if the projection is changed
+		//the projection is camera to screen and the depth range of screen is [-1, 1]
+		void update(const Matrix4x4f& projection);
+
+		//the lights are spheres in world space, xyz is the center and w is the radius
+		void build(const Matrix4x4f& view, const std::vector<Vector4f>& lights);
+
+		auto clusters() const noexcept -> const std::vector<LightCluster>&;
+
+		auto indices() const noexcept -> const std::vector<unsigned>&;
+
+		//the bound of cluster in view space
+		auto bound(const size_t index) const -> const Bound3f&;
+
+		auto index(const size_t x, const size_t y, const size_t z) const noexcept -> size_t;
+
+		//the slice of depth in view space, the depth is the distance to camera along the view direction
+		auto slice(const float depth) const noexcept -> size_t;
+
+		auto width() const noexcept -> size_t;
+
+		auto height() const noexcept -> size_t;
+
+		auto depth() const noexcept -> size_t;
+
+		auto zNear() const noexcept -> float;
+
+		auto zFar() const noexcept -> float;
+	private:
+		size_t mWidth;
+		size_t mHeight;
+		size_t mDepth;
+
+		float mNear = 0;
+		float mFar = 0;
+
+		Matrix4x4f mProjection = Matrix4x4f(0);
+
+		std::vector<Bound3f> mBounds;
+		//the bounds of rows of clusters, we use them to skip the rows that the light does not intersect
+		std::vector<Bound3f> mRowBounds;
+		std::vector<LightCluster> mClusters;
+		std::vector<unsigned> mIndices;
+
+		//the clusters and lights that intersect, they are sorted into clusters and indices
+		std::vector<std::pair<unsigned, unsigned>> mPairs;
+	};
+	
+}
@@ -0,0 +1,613 @@
+#include "OcclusionCuller.hpp"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define __LRTR_OCCLUSION_CULLER_SSE__
+#endif
+
+#include <unordered_map>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <cmath>
+
+namespace LRTR {
+
+	//the triangles whose area is less than it do not cover any pixel
+	constexpr float MinTriangleArea = 1e-8f;
+
+	//the max depth of depth buffer, it is the depth of far plane
+	constexpr float FarDepth = 1.0f;
+
+	//the texel that is not covered by the occluder we are rasterizing
+	constexpr float UncoveredDepth = std::numeric_limits<float>::lowest();
+
+	//the texels the edge touches are found with this tolerance, so the rounding error does not miss a texel
+	constexpr float EdgeTolerance = 1e-3f;
+
+	//the positions are the same only if their bits are the same, so the hash and equal are consistent for -0 and nan
+	struct OccluderPositionHash {
+		auto operator()(const Vector3f& position) const -> size_t
+		{
+			unsigned bits[3];
+
+			std::memcpy(bits, &position.x, sizeof(bits));
+
+			return (static_cast<size_t>(bits[0]) * 73856093u) ^ (static_cast<size_t>(bits[1]) * 19349663u) ^ (static_cast<size_t>(bits[2]) * 83492791u);
+		}
+
+		auto operator()(const Vector3f& first, const Vector3f& second) const -> bool
+		{
+			return std::memcmp(&first.x, &second.x, sizeof(float) * 3) == 0;
+		}
+	};
+
+	inline auto edgeKey(const unsigned first, const unsigned second) -> unsigned long long
+	{
+		return (static_cast<unsigned long long>(std::min(first, second)) << 32) | std::max(first, second);
+	}
+
+	//the sign of result is the side of point in screen, the z of them is ignored
+	inline auto edgeSide(const Vector3f& from, const Vector3f& to, const Vector3f& point) -> float
+	{
+		return (to.x - from.x) * (point.y - from.y) - (to.y - from.y) * (point.x - from.x);
+	}
+
+	//clip the polygon with near plane (z + w >= 0), return the count of vertices of result
+	inline auto clipNearPlane(const Vector4f input[3], Vector4f output[4]) -> size_t
+	{
+		size_t count = 0;
+
+		for (size_t index = 0; index < 3; index++) {
+			const auto& current = input[index];
+			const auto& next = input[(index + 1) % 3];
+
+			const auto currentDistance = current.z + current.w;
+			const auto nextDistance = next.z + next.w;
+
+			if (currentDistance >= 0) output[count++] = current;
+
+			//the edge crosses the near plane, so we add the intersection
+			if ((currentDistance >= 0) != (nextDistance >= 0))
+				output[count++] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+		}
+
+		return count;
+	}
+
+}
+
+LRTR::OcclusionCuller::OcclusionCuller(const size_t width, const size_t height) :
+	mTilesX(width / TileWidth), mTilesY(height / TileHeight)
+{
+	assert(width % TileWidth == 0 && height % TileHeight == 0);
+
+	//the last level has only one texel
+	auto levelWidth = width;
+	auto levelHeight = height;
+
+	while (true) {
+		mSizes.push_back({ levelWidth, levelHeight });
+		mDepths.push_back(std::vector<float>(levelWidth * levelHeight, FarDepth));
+
+		if (levelWidth == 1 && levelHeight == 1) break;
+
+		levelWidth = std::max(static_cast<size_t>(1), (levelWidth + 1) / 2);
+		levelHeight = std::max(static_cast<size_t>(1), (levelHeight + 1) / 2);
+	}
+
+	mBins.resize(mTilesX * mTilesY);
+	mEdgeBins.resize(mTilesX * mTilesY);
+}
+
+void LRTR::OcclusionCuller::clear(const Matrix4x4f& viewProjection)
+{
+	mViewProjection = viewProjection;
+	mOccluders.clear();
+	mTriangles.clear();
+	mEdges.clear();
+
+	for (auto& depth : mDepths) std::fill(depth.begin(), depth.end(), FarDepth);
+}
+
+void LRTR::OcclusionCuller::add(
+	const std::vector<Vector3f>& positions,
+	const std::vector<unsigned>& indices,
+	const Matrix4x4f& world)
+{
+	mOccluders.push_back({ &positions, &indices, mViewProjection * world });
+}
+
+void LRTR::OcclusionCuller::render(ThreadPool* threadPool)
+{
+	const auto parallelFor = [&](const size_t count, const std::function<void(size_t)>& function)
+	{
+		if (threadPool == nullptr) {
+			for (size_t index = 0; index < count; index++) function(index);
+
+			return;
+		}
+
+		threadPool->parallelFor(count, 1, [&](const size_t begin, const size_t end)
+			{
+				for (size_t index = begin; index < end; index++) function(index);
+			});
+	};
+
+	mOccluderTriangles.resize(mOccluders.size());
+	mOccluderEdges.resize(mOccluders.size());
+
+	parallelFor(mOccluders.size(), [&](const size_t index)
+		{
+			mOccluderTriangles[index].clear();
+			mOccluderEdges[index].clear();
+
+			setup(index, mOccluderTriangles[index], mOccluderEdges[index]);
+		});
+
+	mTriangles.clear();
+	mEdges.clear();
+
+	for (size_t index = 0; index < mOccluders.size(); index++) {
+		mTriangles.insert(mTriangles.end(), mOccluderTriangles[index].begin(), mOccluderTriangles[index].end());
+		mEdges.insert(mEdges.end(), mOccluderEdges[index].begin(), mOccluderEdges[index].end());
+	}
+
+	//bin the triangles and edges into tiles, so each tile can be rasterized without locks
+	//they are added in the order of occluders, so the bins are sorted by occluders too
+	for (auto& bin : mBins) bin.clear();
+	for (auto& bin : mEdgeBins) bin.clear();
+
+	for (size_t index = 0; index < mTriangles.size(); index++) {
+		const auto& triangle = mTriangles[index];
+
+		const auto minTileX = static_cast<size_t>(triangle.MinX) / TileWidth;
+		const auto minTileY = static_cast<size_t>(triangle.MinY) / TileHeight;
+		const auto maxTileX = static_cast<size_t>(triangle.MaxX - 1) / TileWidth;
+		const auto maxTileY = static_cast<size_t>(triangle.MaxY - 1) / TileHeight;
+
+		for (auto y = minTileY; y <= maxTileY; y++)
+			for (auto x = minTileX; x <= maxTileX; x++)
+				mBins[y * mTilesX + x].push_back(static_cast<unsigned>(index));
+	}
+
+	const auto screenWidth = static_cast<int>(mSizes[0].first);
+	const auto screenHeight = static_cast<int>(mSizes[0].second);
+
+	for (size_t index = 0; index < mEdges.size(); index++) {
+		const auto& edge = mEdges[index];
+
+		const auto minX = std::max(0, static_cast<int>(std::floor(std::min(edge.X0, edge.X1) - EdgeTolerance)));
+		const auto minY = std::max(0, static_cast<int>(std::floor(std::min(edge.Y0, edge.Y1) - EdgeTolerance)));
+		const auto maxX = std::min(screenWidth - 1, static_cast<int>(std::floor(std::max(edge.X0, edge.X1) + EdgeTolerance)));
+		const auto maxY = std::min(screenHeight - 1, static_cast<int>(std::floor(std::max(edge.Y0, edge.Y1) + EdgeTolerance)));
+
+		if (minX > maxX || minY > maxY) continue;
+
+		for (auto y = static_cast<size_t>(minY) / TileHeight; y <= static_cast<size_t>(maxY) / TileHeight; y++)
+			for (auto x = static_cast<size_t>(minX) / TileWidth; x <= static_cast<size_t>(maxX) / TileWidth; x++)
+				mEdgeBins[y * mTilesX + x].push_back(static_cast<unsigned>(index));
+	}
+
+	parallelFor(mBins.size(), [&](const size_t tile) { rasterize(tile); });
+
+	buildLevels();
+}
+
+auto LRTR::OcclusionCuller::test(const Bound3f& bound) const -> bool
+{
+	if (bound.empty()) return true;
+
+	auto minX = std::numeric_limits<float>::max(), maxX = std::numeric_limits<float>::lowest();
+	auto minY = std::numeric_limits<float>::max(), maxY = std::numeric_limits<float>::lowest();
+	auto minDepth = std::numeric_limits<float>::max();
+
+	for (size_t corner = 0; corner < 8; corner++) {
+		const auto point = mViewProjection * Vector4f(
+			(corner & 1) ? bound.Max.x : bound.Min.x,
+			(corner & 2) ? bound.Max.y : bound.Min.y,
+			(corner & 4) ? bound.Max.z : bound.Min.z, 1.0f);
+
+		//the bound crosses the near plane, it is too close to be occluded
+		if (point.z + point.w <= 0 || point.w <= 0) return true;
+
+		const auto x = point.x / point.w;
+		const auto y = point.y / point.w;
+
+		minX = std::min(minX, x); maxX = std::max(maxX, x);
+		minY = std::min(minY, y); maxY = std::max(maxY, y);
+		minDepth = std::min(minDepth, point.z / point.w * 0.5f + 0.5f);
+	}
+
+	const auto screenWidth = static_cast<float>(mSizes[0].first);
+	const auto screenHeight = static_cast<float>(mSizes[0].second);
+
+	//the v of screen is 0 at the top, so the max y of ndc is the min y of screen
+	const auto left = std::max(0.0f, std::floor((minX * 0.5f + 0.5f) * screenWidth));
+	const auto right = std::min(screenWidth, std::ceil((maxX * 0.5f + 0.5f) * screenWidth));
+	const auto top = std::max(0.0f, std::floor((0.5f - maxY * 0.5f) * screenHeight));
+	const auto bottom = std::min(screenHeight, std::ceil((0.5f - minY * 0.5f) * screenHeight));
+
+	//the bound is outside the screen, the frustum culling should cull it
+	if (left >= right || top >= bottom) return true;
+
+	//find the level that the bound covers at most 2 x 2 texels, so we only read a few texels
+	const auto extent = static_cast<size_t>(std::max(right - left, bottom - top));
+
+	size_t level = 0;
+
+	while (level + 1 < levels() && (extent >> level) > 2) level++;
+
+	const auto& depth = mDepths[level];
+	const auto levelWidth = mSizes[level].first;
+
+	const auto beginX = static_cast<size_t>(left) >> level, endX = (static_cast<size_t>(right) - 1) >> level;
+	const auto beginY = static_cast<size_t>(top) >> level, endY = (static_cast<size_t>(bottom) - 1) >> level;
+
+	for (auto y = beginY; y <= endY; y++) {
+		for (auto x = beginX; x <= endX; x++)
+			if (minDepth <= depth[y * levelWidth + x]) return true;
+	}
+
+	return false;
+}
+
+auto LRTR::OcclusionCuller::depth(const size_t level) const noexcept -> const std::vector<float>&
+{
+	return mDepths[level];
+}
+
+auto LRTR::OcclusionCuller::width(const size_t level) const noexcept -> size_t
+{
+	return mSizes[level].first;
+}
+
+auto LRTR::OcclusionCuller::height(const size_t level) const noexcept -> size_t
+{
+	return mSizes[level].second;
+}
+
+auto LRTR::OcclusionCuller::levels() const noexcept -> size_t
+{
+	return mDepths.size();
+}
+
+auto LRTR::OcclusionCuller::occluders() const noexcept -> size_t
+{
+	return mOccluders.size();
+}
+
+auto LRTR::OcclusionCuller::triangles() const noexcept -> size_t
+{
+	return mTriangles.size();
+}
+
+void LRTR::OcclusionCuller::setup(const size_t index, std::vector<OccluderTriangle>& triangles, std::vector<OccluderEdge>& edges) const
+{
+	const auto& occluder = mOccluders[index];
+	const auto& positions = *occluder.Positions;
+	const auto& indices = *occluder.Indices;
+
+	const auto screenWidth = static_cast<float>(mSizes[0].first);
+	const auto screenHeight = static_cast<float>(mSizes[0].second);
+
+	const auto toScreen = [&](const Vector4f& point)
+	{
+		return Vector3f(
+			(point.x / point.w * 0.5f + 0.5f) * screenWidth,
+			(0.5f - point.y / point.w * 0.5f) * screenHeight,
+			point.z / point.w * 0.5f + 0.5f);
+	};
+
+	std::vector<Vector4f> clipPositions(positions.size());
+	std::vector<Vector3f> screenPositions(positions.size());
+
+	for (size_t vertex = 0; vertex < positions.size(); vertex++) {
+		clipPositions[vertex] = occluder.Transform * Vector4f(positions[vertex], 1.0f);
+		screenPositions[vertex] = toScreen(clipPositions[vertex]);
+	}
+
+	//the vertices at the same position are split by the normals or texcoords
+	//we use the first one of them to find the shared edges, otherwise there are outlines on the seams
+	std::vector<unsigned> welded(positions.size());
+	std::unordered_map<Vector3f, unsigned, OccluderPositionHash, OccluderPositionHash> firstVertices;
+
+	firstVertices.reserve(positions.size());
+
+	for (size_t vertex = 0; vertex < positions.size(); vertex++)
+		welded[vertex] = firstVertices.insert({ positions[vertex], static_cast<unsigned>(vertex) }).first->second;
+
+	//the edges of triangles that are not clipped, the value is the vertex that is not on the edge
+	std::vector<std::pair<unsigned long long, unsigned>> sharedEdges;
+
+	const auto emit = [&](float x[3], float y[3], float z[3]) -> bool
+	{
+		auto area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+
+		if (std::abs(area) < MinTriangleArea) return false;
+
+		//the occluders are rasterized in both sides, so we make the area positive
+		if (area < 0) {
+			std::swap(x[1], x[2]);
+			std::swap(y[1], y[2]);
+			std::swap(z[1], z[2]);
+
+			area = -area;
+		}
+
+		OccluderTriangle triangle;
+
+		triangle.MinX = std::max(0, static_cast<int>(std::floor(std::min({ x[0], x[1], x[2] }))));
+		triangle.MinY = std::max(0, static_cast<int>(std::floor(std::min({ y[0], y[1], y[2] }))));
+		triangle.MaxX = std::min(static_cast<int>(screenWidth), static_cast<int>(std::ceil(std::max({ x[0], x[1], x[2] }))));
+		triangle.MaxY = std::min(static_cast<int>(screenHeight), static_cast<int>(std::ceil(std::max({ y[0], y[1], y[2] }))));
+		triangle.Occluder = static_cast<unsigned>(index);
+
+		//the triangle is out of screen, but it still shares the edges with other triangles
+		if (triangle.MinX >= triangle.MaxX || triangle.MinY >= triangle.MaxY) return true;
+
+		//the edge (a, b) is positive on the left side of it, the inside of triangle
+		for (size_t edge = 0; edge < 3; edge++) {
+			const auto a = edge, b = (edge + 1) % 3;
+
+			triangle.EdgeA[edge] = -(y[b] - y[a]);
+			triangle.EdgeB[edge] = x[b] - x[a];
+			triangle.EdgeC[edge] = (y[b] - y[a]) * x[a] - (x[b] - x[a]) * y[a];
+		}
+
+		//the barycentric of vertex 1 is the edge (2, 0) and the barycentric of vertex 2 is the edge (0, 1)
+		const auto dz1 = (z[1] - z[0]) / area;
+		const auto dz2 = (z[2] - z[0]) / area;
+
+		triangle.Depth[0] = triangle.EdgeA[2] * dz1 + triangle.EdgeA[0] * dz2;
+		triangle.Depth[1] = triangle.EdgeB[2] * dz1 + triangle.EdgeB[0] * dz2;
+		triangle.Depth[2] = triangle.EdgeC[2] * dz1 + triangle.EdgeC[0] * dz2 + z[0];
+
+		//we test the center of texel, the edges are moved outside by half texel so we find all texels the triangle overlaps
+		//and the depth is moved to the max depth of plane in the texel
+		for (size_t edge = 0; edge < 3; edge++)
+			triangle.EdgeC[edge] = triangle.EdgeC[edge] + 0.5f * (std::abs(triangle.EdgeA[edge]) + std::abs(triangle.EdgeB[edge]));
+
+		triangle.Depth[2] = triangle.Depth[2] + 0.5f * (std::abs(triangle.Depth[0]) + std::abs(triangle.Depth[1]));
+
+		triangles.push_back(triangle);
+
+		return true;
+	};
+
+	const auto outline = [&](const Vector3f& from, const Vector3f& to)
+	{
+		edges.push_back({ from.x, from.y, to.x, to.y, static_cast<unsigned>(index) });
+	};
+
+	for (size_t triangle = 0; triangle + 2 < indices.size(); triangle += 3) {
+		const unsigned vertices[3] = { indices[triangle + 0], indices[triangle + 1], indices[triangle + 2] };
+
+		const Vector4f input[3] = {
+			clipPositions[vertices[0]],
+			clipPositions[vertices[1]],
+			clipPositions[vertices[2]]
+		};
+
+		//the triangle is in front of near plane, the edges of it may be shared with other triangles
+		if (input[0].z + input[0].w >= 0 && input[1].z + input[1].w >= 0 && input[2].z + input[2].w >= 0) {
+			float x[3], y[3], z[3];
+
+			for (size_t vertex = 0; vertex < 3; vertex++) {
+				x[vertex] = screenPositions[vertices[vertex]].x;
+				y[vertex] = screenPositions[vertices[vertex]].y;
+				z[vertex] = screenPositions[vertices[vertex]].z;
+			}
+
+			if (!emit(x, y, z)) continue;
+
+			for (size_t edge = 0; edge < 3; edge++) {
+				sharedEdges.push_back({
+					edgeKey(welded[vertices[edge]], welded[vertices[(edge + 1) % 3]]),
+					welded[vertices[(edge + 2) % 3]] });
+			}
+
+			continue;
+		}
+
+		Vector4f polygon[4];
+
+		const auto count = clipNearPlane(input, polygon);
+
+		Vector3f screen[4];
+
+		for (size_t vertex = 0; vertex < count; vertex++) screen[vertex] = toScreen(polygon[vertex]);
+
+		//the polygon is a triangle or a quad, we split it as a fan
+		//the diagonals of fan are inside the polygon, so only the edges of polygon are outline
+		auto emitted = false;
+
+		for (size_t fan = 1; fan + 1 < count; fan++) {
+			float x[3] = { screen[0].x, screen[fan].x, screen[fan + 1].x };
+			float y[3] = { screen[0].y, screen[fan].y, screen[fan + 1].y };
+			float z[3] = { screen[0].z, screen[fan].z, screen[fan + 1].z };
+
+			emitted = emit(x, y, z) || emitted;
+		}
+
+		if (!emitted) continue;
+
+		for (size_t vertex = 0; vertex < count; vertex++) outline(screen[vertex], screen[(vertex + 1) % count]);
+	}
+
+	std::sort(sharedEdges.begin(), sharedEdges.end());
+
+	//the edge is inside the occluder if it is shared by two triangles on different sides of it in screen
+	//the other edges (boundary of mesh, silhouette and non-manifold edges) are outline
+	for (size_t begin = 0, end = 0; begin < sharedEdges.size(); begin = end) {
+		while (end < sharedEdges.size() && sharedEdges[end].first == sharedEdges[begin].first) end++;
+
+		const auto& from = screenPositions[sharedEdges[begin].first >> 32];
+		const auto& to = screenPositions[sharedEdges[begin].first & 0xffffffffull];
+
+		if (end - begin == 2) {
+			const auto first = edgeSide(from, to, screenPositions[sharedEdges[begin].second]);
+			const auto second = edgeSide(from, to, screenPositions[sharedEdges[begin + 1].second]);
+
+			if ((first > 0 && second < 0) || (first < 0 && second > 0)) continue;
+		}
+
+		outline(from, to);
+	}
+}
+
+void LRTR::OcclusionCuller::rasterize(const size_t tile)
+{
+	const auto tileX = static_cast<int>((tile % mTilesX) * TileWidth);
+	const auto tileY = static_cast<int>((tile / mTilesX) * TileHeight);
+	const auto screenWidth = mSizes[0].first;
+
+	const auto depth = mDepths[0].data();
+
+	const auto& triangleBin = mBins[tile];
+	const auto& edgeBin = mEdgeBins[tile];
+
+	//the depth of occluder we are rasterizing, it is merged to depth buffer when the occluder is finished
+	float occluderDepth[TileWidth * TileHeight];
+
+	size_t edgeCursor = 0;
+
+	for (size_t triangleCursor = 0; triangleCursor < triangleBin.size();) {
+		const auto occluder = mTriangles[triangleBin[triangleCursor]].Occluder;
+
+		std::fill(occluderDepth, occluderDepth + TileWidth * TileHeight, UncoveredDepth);
+
+		//the texels the triangles overlap, the depth is the max depth of triangles in texel
+		for (; triangleCursor < triangleBin.size() && mTriangles[triangleBin[triangleCursor]].Occluder == occluder; triangleCursor++) {
+			const auto& triangle = mTriangles[triangleBin[triangleCursor]];
+
+			//the begin of x is aligned to 4, so the 4 pixels we process are in the same tile
+			const auto beginX = std::max(triangle.MinX, tileX) & ~3;
+			const auto endX = std::min(triangle.MaxX, tileX + static_cast<int>(TileWidth));
+			const auto beginY = std::max(triangle.MinY, tileY);
+			const auto endY = std::min(triangle.MaxY, tileY + static_cast<int>(TileHeight));
+
+			for (auto y = beginY; y < endY; y++) {
+				const auto pixelY = static_cast<float>(y) + 0.5f;
+				const auto row = occluderDepth + (y - tileY) * TileWidth - tileX;
+
+				float rowEdge[3];
+
+				for (size_t edge = 0; edge < 3; edge++)
+					rowEdge[edge] = triangle.EdgeB[edge] * pixelY + triangle.EdgeC[edge];
+
+				const auto rowDepth = triangle.Depth[1] * pixelY + triangle.Depth[2];
+
+#ifdef __LRTR_OCCLUSION_CULLER_SSE__
+				const auto offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+				//the edges are moved outside, so the texels out of the bound of triangle may pass the edges
+				//we also need test the bound, then the texel overlaps triangle if it passes all of them
+				const auto minX = _mm_set1_ps(static_cast<float>(triangle.MinX));
+				const auto maxX = _mm_set1_ps(static_cast<float>(triangle.MaxX));
+
+				for (auto x = beginX; x < endX; x += 4) {
+					const auto pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+					const auto edge0 = _mm_add_ps(_mm_mul_ps(pixelX, _mm_set1_ps(triangle.EdgeA[0])), _mm_set1_ps(rowEdge[0]));
+					const auto edge1 = _mm_add_ps(_mm_mul_ps(pixelX, _mm_set1_ps(triangle.EdgeA[1])), _mm_set1_ps(rowEdge[1]));
+					const auto edge2 = _mm_add_ps(_mm_mul_ps(pixelX, _mm_set1_ps(triangle.EdgeA[2])), _mm_set1_ps(rowEdge[2]));
+
+					const auto inside = _mm_and_ps(
+						_mm_and_ps(_mm_cmpgt_ps(pixelX, minX), _mm_cmplt_ps(pixelX, maxX)),
+						_mm_and_ps(_mm_cmpge_ps(edge0, _mm_setzero_ps()),
+							_mm_and_ps(_mm_cmpge_ps(edge1, _mm_setzero_ps()), _mm_cmpge_ps(edge2, _mm_setzero_ps()))));
+
+					if (_mm_movemask_ps(inside) == 0) continue;
+
+					const auto current = _mm_loadu_ps(row + x);
+					const auto pixelDepth = _mm_max_ps(current,
+						_mm_add_ps(_mm_mul_ps(pixelX, _mm_set1_ps(triangle.Depth[0])), _mm_set1_ps(rowDepth)));
+
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, pixelDepth), _mm_andnot_ps(inside, current)));
+				}
+#else
+				for (auto x = std::max(beginX, triangle.MinX); x < endX; x++) {
+					const auto pixelX = static_cast<float>(x) + 0.5f;
+
+					if (triangle.EdgeA[0] * pixelX + rowEdge[0] < 0 ||
+						triangle.EdgeA[1] * pixelX + rowEdge[1] < 0 ||
+						triangle.EdgeA[2] * pixelX + rowEdge[2] < 0) continue;
+
+					row[x] = std::max(row[x], triangle.Depth[0] * pixelX + rowDepth);
+				}
+#endif
+			}
+		}
+
+		//the edges of occluders that have no triangles in this tile do not change anything
+		while (edgeCursor < edgeBin.size() && mEdges[edgeBin[edgeCursor]].Occluder < occluder) edgeCursor++;
+
+		//the texels the outline touches are not inside the occluder, we find them row by row
+		for (; edgeCursor < edgeBin.size() && mEdges[edgeBin[edgeCursor]].Occluder == occluder; edgeCursor++) {
+			const auto& edge = mEdges[edgeBin[edgeCursor]];
+
+			const auto minY = std::min(edge.Y0, edge.Y1), maxY = std::max(edge.Y0, edge.Y1);
+
+			const auto beginY = std::max(tileY, static_cast<int>(std::floor(minY - EdgeTolerance)));
+			const auto endY = std::min(tileY + static_cast<int>(TileHeight) - 1, static_cast<int>(std::floor(maxY + EdgeTolerance)));
+
+			for (auto y = beginY; y <= endY; y++) {
+				//the part of edge in the row [y, y + 1]
+				auto fromX = edge.X0, toX = edge.X1;
+
+				if (maxY - minY > EdgeTolerance) {
+					const auto slope = (edge.X1 - edge.X0) / (edge.Y1 - edge.Y0);
+					const auto top = std::clamp(static_cast<float>(y), minY, maxY);
+					const auto bottom = std::clamp(static_cast<float>(y + 1), minY, maxY);
+
+					fromX = edge.X0 + (top - edge.Y0) * slope;
+					toX = edge.X0 + (bottom - edge.Y0) * slope;
+				}
+
+				const auto beginX = std::max(tileX, static_cast<int>(std::floor(std::min(fromX, toX) - EdgeTolerance)));
+				const auto endX = std::min(tileX + static_cast<int>(TileWidth) - 1, static_cast<int>(std::floor(std::max(fromX, toX) + EdgeTolerance)));
+
+				for (auto x = beginX; x <= endX; x++)
+					occluderDepth[(y - tileY) * TileWidth + (x - tileX)] = UncoveredDepth;
+			}
+		}
+
+		for (size_t y = 0; y < TileHeight; y++) {
+			const auto row = depth + (tileY + y) * screenWidth + tileX;
+
+			for (size_t x = 0; x < TileWidth; x++) {
+				const auto value = occluderDepth[y * TileWidth + x];
+
+				if (value != UncoveredDepth) row[x] = std::min(row[x], value);
+			}
+		}
+	}
+}
+
+void LRTR::OcclusionCuller::buildLevels()
+{
+	//the texel of next level is the max depth of 2 x 2 texels, the texels out of level are ignored
+	for (size_t level = 1; level < mDepths.size(); level++) {
+		const auto& source = mDepths[level - 1];
+		const auto sourceWidth = mSizes[level - 1].first;
+		const auto sourceHeight = mSizes[level - 1].second;
+
+		auto& target = mDepths[level];
+		const auto targetWidth = mSizes[level].first;
+		const auto targetHeight = mSizes[level].second;
+
+		for (size_t y = 0; y < targetHeight; y++) {
+			const auto y0 = y * 2, y1 = std::min(y * 2 + 1, sourceHeight - 1);
+
+			for (size_t x = 0; x < targetWidth; x++) {
+				const auto x0 = x * 2, x1 = std::min(x * 2 + 1, sourceWidth - 1);
+
+				target[y * targetWidth + x] = std::max(
+					std::max(source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1]),
+					std::max(source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]));
+			}
+		}
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+
+#include "../Parallel/ThreadPool.hpp"
+#include "../Math/Math.hpp"
+#include "../Bound.hpp"
+
+#include <vector>
+
+namespace LRTR {
+
+	//the triangle of occluder in screen space, the edges are (A, B, C) of A * x + B * y + C
+	//the edges are moved outside by half texel, so the texel overlaps the triangle if all edges are not negative at its center
+	//the depth is the plane (A, B, C) of the max depth of triangle in the texel
+	struct OccluderTriangle {
+		float EdgeA[3];
+		float EdgeB[3];
+		float EdgeC[3];
+		float Depth[3];
+
+		//the pixels the triangle may cover, [min, max)
+		int MinX, MinY, MaxX, MaxY;
+
+		unsigned Occluder;
+	};
+
+	//the edge on the outline of occluder in screen space, the texels it touches are not covered by the occluder
+	struct OccluderEdge {
+		float X0, Y0;
+		float X1, Y1;
+
+		unsigned Occluder;
+	};
+
+	//the occlusion culler rasterizes a few large occluders into a small depth buffer on CPU
+	//then we build the hierarchical depth buffer (the max depth of texels) and test the bounds with it
+	//the bound is occluded if its nearest depth is farther than all depths of texels it covers
+	//the depth is the depth of ndc in [0, 1], so the projection matrix is the same as rendering
+	//the rasterization is conservative, the texel is covered by occluder only if the whole texel is inside it
+	//so we find the texels that overlap the triangles and remove the texels that the outline of occluder touches
+	//the edges shared by two triangles on different sides are not outline, so there is no crack between triangles
+	class OcclusionCuller : public Noncopyable {
+	public:
+		//the width must be a multiple of tile width and the height must be a multiple of tile height
+		explicit OcclusionCuller(const size_t width = 256, const size_t height = 128);
+
+		~OcclusionCuller() = default;
+
+		//start a new frame, the depth buffer is cleared and occluders are removed
+		void clear(const Matrix4x4f& viewProjection);
+
+		//the positions and indices are not copied, so they must be alive until render is finished
+		void add(
+			const std::vector<Vector3f>& positions,
+			const std::vector<unsigned>& indices,
+			const Matrix4x4f& world);
+
+		//rasterize the occluders and build the hierarchical depth buffer
+		//the occluders and tiles are processed in parallel if the thread pool is not nullptr
+		void render(ThreadPool* threadPool = nullptr);
+
+		//return false if the bound is occluded, the bound is in world space
+		auto test(const Bound3f& bound) const -> bool;
+
+		//the depth buffer of level, level 0 is the depth buffer we rasterized
+		auto depth(const size_t level) const noexcept -> const std::vector<float>&;
+
+		auto width(const size_t level = 0) const noexcept -> size_t;
+
+		auto height(const size_t level = 0) const noexcept -> size_t;
+
+		auto levels() const noexcept -> size_t;
+
+		auto occluders() const noexcept -> size_t;
+
+		//the triangles rasterized in last render, the triangles clipped by near plane may be split
+		auto triangles() const noexcept -> size_t;
+
+		static constexpr size_t TileWidth = 32;
+		static constexpr size_t TileHeight = 16;
+	private:
+		struct Occluder {
+			const std::vector<Vector3f>* Positions;
+			const std::vector<unsigned>* Indices;
+
+			Matrix4x4f Transform;
+		};
+
+		//transform the triangles of occluder to screen space and clip them with near plane
+		//and find the edges on the outline of occluder in screen space
+		void setup(const size_t index, std::vector<OccluderTriangle>& triangles, std::vector<OccluderEdge>& edges) const;
+
+		void rasterize(const size_t tile);
+
+		void buildLevels();
+	private:
+		std::vector<Occluder> mOccluders;
+
+		//the triangles and edges of each occluder, we merge them after we setup them in parallel
+		std::vector<std::vector<OccluderTriangle>> mOccluderTriangles;
+		std::vector<std::vector<OccluderEdge>> mOccluderEdges;
+		std::vector<OccluderTriangle> mTriangles;
+		std::vector<OccluderEdge> mEdges;
+
+		//the indices of triangles and edges that overlap the tile, they are sorted by occluders
+		std::vector<std::vector<unsigned>> mBins;
+		std::vector<std::vector<unsigned>> mEdgeBins;
+
+		std::vector<std::vector<float>> mDepths;
+		std::vector<std::pair<size_t, size_t>> mSizes;
+
+		Matrix4x4f mViewProjection = Matrix4x4f(1);
+
+		size_t mTilesX = 0;
+		size_t mTilesY = 0;
+	};
+
+}
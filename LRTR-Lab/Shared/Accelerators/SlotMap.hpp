@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace LRTR {
+
+	//the handle of value in slot map, it is the index of slot and the generation of slot
+	//the generation is changed when the value is erased, so the old handles are invalid
+	struct SlotHandle {
+		static constexpr unsigned InvalidIndex = ~0u;
+		
+		unsigned Index = InvalidIndex;
+		unsigned Generation = 0;
+
+		SlotHandle() = default;
+
+		SlotHandle(const unsigned index, const unsigned generation) :
+			Index(index), Generation(generation) {}
+
+		//the handle is not null, it does not mean the value is still alive
+		auto valid() const noexcept -> bool { return Index != InvalidIndex; }
+
+		auto operator==(const SlotHandle& other) const noexcept -> bool
+		{
+			return Index == other.Index && Generation == other.Generation;
+		}
+
+		auto operator!=(const SlotHandle& other) const noexcept -> bool { return !(*this == other); }
+	};
+
+	//the values are packed in an array, the slots map handles to the values
+	//so we can iterate the values linearly and check the handles in O(1)
+	template<typename T>
+	class SlotMap {
+	public:
+		SlotMap() = default;
+
+		~SlotMap() = default;
+
+		auto insert(const T& value) -> SlotHandle;
+
+		//return false if the handle is stale
+		auto erase(const SlotHandle& handle) -> bool;
+
+		auto contains(const SlotHandle& handle) const noexcept -> bool;
+
+		//return nullptr if the handle is stale
+		auto get(const SlotHandle& handle) const noexcept -> const T*;
+
+		auto get(const SlotHandle& handle) noexcept -> T*;
+
+		auto at(const SlotHandle& handle) const -> const T&;
+		
+		auto values() const noexcept -> const std::vector<T>&;
+
+		//the handles of values, handles()[index] is the handle of values()[index]
+		auto handles() const noexcept -> const std::vector<SlotHandle>&;
+		
+		auto size() const noexcept -> size_t;
+
+		auto empty() const noexcept -> bool;
+	private:
+		struct Slot {
+			unsigned Generation = 0;
+			
+			//the index of value if the slot is used, otherwise the next free slot
+			unsigned Index = SlotHandle::InvalidIndex;
+		};
+
+		std::vector<Slot> mSlots;
+		
+		std::vector<T> mValues;
+		std::vector<SlotHandle> mHandles;
+
+		unsigned mFreeSlot = SlotHandle::InvalidIndex;
+	};
+
+	template <typename T>
+	auto SlotMap<T>::insert(const T& value) -> SlotHandle
+	{
+		auto index = mFreeSlot;
+
+		if (index == SlotHandle::InvalidIndex) {
+			index = static_cast<unsigned>(mSlots.size());
+			
+			mSlots.push_back(Slot());
+		}
+		else mFreeSlot = mSlots[index].Index;
+
+		mSlots[index].Index = static_cast<unsigned>(mValues.size());
+
+		mValues.push_back(value);
+		mHandles.push_back(SlotHandle(index, mSlots[index].Generation));
+
+		return mHandles.back();
+	}
+
+	template <typename T>
+	auto SlotMap<T>::erase(const SlotHandle& handle) -> bool
+	{
+		if (!contains(handle)) return false;
+
+		auto& slot = mSlots[handle.Index];
+		const auto last = mValues.size() - 1;
+
+		//move the last value to the position we erased, so the values are still packed
+		if (slot.Index != last) {
+			mValues[slot.Index] = std::move(mValues[last]);
+			mHandles[slot.Index] = mHandles[last];
+			mSlots[mHandles[slot.Index].Index].Index = slot.Index;
+		}
+
+		mValues.pop_back();
+		mHandles.pop_back();
+
+		slot.Generation++;
+		slot.Index = mFreeSlot;
+
+		mFreeSlot = handle.Index;
+
+		return true;
+	}
+
+	template <typename T>
+	auto SlotMap<T>::contains(const SlotHandle& handle) const noexcept -> bool
+	{
+		return handle.Index < mSlots.size() && mSlots[handle.Index].Generation == handle.Generation;
+	}
+
+	template <typename T>
+	auto SlotMap<T>::get(const SlotHandle& handle) const noexcept -> const T*
+	{
+		return contains(handle) ? &mValues[mSlots[handle.Index].Index] : nullptr;
+	}
+
+	template <typename T>
+	auto SlotMap<T>::get(const SlotHandle& handle) noexcept -> T*
+	{
+		return contains(handle) ? &mValues[mSlots[handle.Index].Index] : nullptr;
+	}
+
+	template <typename T>
+	auto SlotMap<T>::at(const SlotHandle& handle) const -> const T&
+	{
+		assert(contains(handle));
+
+		return mValues[mSlots[handle.Index].Index];
+	}
+
+	template <typename T>
+	auto SlotMap<T>::values() const noexcept -> const std::vector<T>&
+	{
+		return mValues;
+	}
+
+	template <typename T>
+	auto SlotMap<T>::handles() const noexcept -> const std::vector<SlotHandle>&
+	{
+		return mHandles;
+	}
+
+	template <typename T>
+	auto SlotMap<T>::size() const noexcept -> size_t
+	{
+		return mValues.size();
+	}
+
+	template <typename T>
+	auto SlotMap<T>::empty() const noexcept -> bool
+	{
+		return mValues.empty();
+	}
+}
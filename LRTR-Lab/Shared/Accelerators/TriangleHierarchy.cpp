@@ -0,0 +1,667 @@
+#include "TriangleHierarchy.hpp"
+
+#if defined(_M_X64) || defined(__SSE__)
+#include <xmmintrin.h>
+#define __LRTR_TRIANGLE_HIERARCHY_SSE__
+#endif
+
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <cmath>
+
+namespace LRTR {
+
+	constexpr size_t BinCount = 16;
+
+	//the leaf is one block, so it has at most four triangles
+	constexpr unsigned MaxLeafTriangles = 4;
+
+	//the cost of visiting interior node, the cost of testing one triangle is 1
+	constexpr float TraversalCost = 1.0f;
+
+	//the subtrees with more triangles are built in parallel
+	constexpr unsigned ParallelBuildCount = 16384;
+
+	//the triangles in one task when we compute the bounds in parallel
+	constexpr size_t BoundGrain = 4096;
+
+	//the rays of packet in structure of arrays
+	struct RayPacketData {
+		float Origin[3][4];
+		float InverseDirection[3][4];
+	};
+
+	inline auto packRays(const std::array<RayF, 4>& rays) -> RayPacketData
+	{
+		RayPacketData packet;
+
+		for (size_t lane = 0; lane < 4; lane++) {
+			for (int axis = 0; axis < 3; axis++) {
+				packet.Origin[axis][lane] = rays[lane].Origin[axis];
+				packet.InverseDirection[axis][lane] = 1.0f / rays[lane].Direction[axis];
+			}
+		}
+
+		return packet;
+	}
+
+	inline auto intersectBound(
+		const Bound3f& bound, const Vector3f& origin, const Vector3f& inverseDirection,
+		const float distance, float& entry) -> bool
+	{
+		const auto lower = (bound.Min - origin) * inverseDirection;
+		const auto upper = (bound.Max - origin) * inverseDirection;
+
+		const auto minDistance = glm::min(lower, upper);
+		const auto maxDistance = glm::max(lower, upper);
+
+		entry = std::max(std::max(minDistance.x, minDistance.y), std::max(minDistance.z, 0.0f));
+
+		return entry <= std::min(std::min(maxDistance.x, maxDistance.y), std::min(maxDistance.z, distance));
+	}
+
+	//return the mask of rays that hit the bound in [0, distances[i]], the inactive rays are never hit
+	inline auto intersectBound(const Bound3f& bound, const RayPacketData& packet, const float distances[4]) -> unsigned
+	{
+#ifdef __LRTR_TRIANGLE_HIERARCHY_SSE__
+		const auto zero = _mm_setzero_ps();
+		const auto maxDistance = _mm_loadu_ps(distances);
+
+		auto entry = zero;
+		auto exit = maxDistance;
+
+		for (int axis = 0; axis < 3; axis++) {
+			const auto origin = _mm_loadu_ps(packet.Origin[axis]);
+			const auto inverse = _mm_loadu_ps(packet.InverseDirection[axis]);
+
+			const auto lower = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bound.Min[axis]), origin), inverse);
+			const auto upper = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bound.Max[axis]), origin), inverse);
+
+			entry = _mm_max_ps(entry, _mm_min_ps(lower, upper));
+			exit = _mm_min_ps(exit, _mm_max_ps(lower, upper));
+		}
+
+		const auto hit = _mm_and_ps(_mm_cmple_ps(entry, exit), _mm_cmpgt_ps(maxDistance, zero));
+
+		return static_cast<unsigned>(_mm_movemask_ps(hit));
+#else
+		unsigned mask = 0;
+
+		for (size_t lane = 0; lane < 4; lane++) {
+			if (distances[lane] <= 0) continue;
+
+			auto entry = 0.0f;
+
+			const auto origin = Vector3f(packet.Origin[0][lane], packet.Origin[1][lane], packet.Origin[2][lane]);
+			const auto inverseDirection = Vector3f(
+				packet.InverseDirection[0][lane], packet.InverseDirection[1][lane], packet.InverseDirection[2][lane]);
+
+			if (intersectBound(bound, origin, inverseDirection, distances[lane], entry)) mask = mask | (1u << lane);
+		}
+
+		return mask;
+#endif
+	}
+
+	//test the ray with four triangles of block (Moller-Trumbore), return the mask of triangles hit in (0, distance]
+	inline auto intersectBlock(
+		const TriangleBlock& block, const RayF& ray, const float distance,
+		float distances[4], float us[4], float vs[4]) -> unsigned
+	{
+#ifdef __LRTR_TRIANGLE_HIERARCHY_SSE__
+		const auto zero = _mm_setzero_ps();
+		const auto one = _mm_set1_ps(1.0f);
+
+		const auto dx = _mm_set1_ps(ray.Direction.x);
+		const auto dy = _mm_set1_ps(ray.Direction.y);
+		const auto dz = _mm_set1_ps(ray.Direction.z);
+
+		const auto e1x = _mm_load_ps(block.Edge1[0]);
+		const auto e1y = _mm_load_ps(block.Edge1[1]);
+		const auto e1z = _mm_load_ps(block.Edge1[2]);
+
+		const auto e2x = _mm_load_ps(block.Edge2[0]);
+		const auto e2y = _mm_load_ps(block.Edge2[1]);
+		const auto e2z = _mm_load_ps(block.Edge2[2]);
+
+		//p = direction x edge2
+		const auto px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+		const auto py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+		const auto pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+		const auto determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+		const auto inverse = _mm_div_ps(one, determinant);
+
+		const auto tx = _mm_sub_ps(_mm_set1_ps(ray.Origin.x), _mm_load_ps(block.Vertex[0]));
+		const auto ty = _mm_sub_ps(_mm_set1_ps(ray.Origin.y), _mm_load_ps(block.Vertex[1]));
+		const auto tz = _mm_sub_ps(_mm_set1_ps(ray.Origin.z), _mm_load_ps(block.Vertex[2]));
+
+		const auto u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), inverse);
+
+		//q = t x edge1
+		const auto qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+		const auto qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+		const auto qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+
+		const auto v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverse);
+		const auto t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverse);
+
+		//the comparisons with NaN are false, so the triangles parallel to ray and the unused lanes are not hit
+		auto hit = _mm_cmpneq_ps(determinant, zero);
+
+		hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+		hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+		hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+		hit = _mm_and_ps(hit, _mm_cmpgt_ps(t, zero));
+		hit = _mm_and_ps(hit, _mm_cmple_ps(t, _mm_set1_ps(distance)));
+
+		_mm_storeu_ps(distances, t);
+		_mm_storeu_ps(us, u);
+		_mm_storeu_ps(vs, v);
+
+		return static_cast<unsigned>(_mm_movemask_ps(hit));
+#else
+		unsigned mask = 0;
+
+		for (size_t lane = 0; lane < 4; lane++) {
+			const auto edge1 = Vector3f(block.Edge1[0][lane], block.Edge1[1][lane], block.Edge1[2][lane]);
+			const auto edge2 = Vector3f(block.Edge2[0][lane], block.Edge2[1][lane], block.Edge2[2][lane]);
+			const auto vertex = Vector3f(block.Vertex[0][lane], block.Vertex[1][lane], block.Vertex[2][lane]);
+
+			const auto p = glm::cross(ray.Direction, edge2);
+			const auto determinant = glm::dot(edge1, p);
+
+			if (determinant == 0) continue;
+
+			const auto inverse = 1.0f / determinant;
+			const auto t = ray.Origin - vertex;
+			const auto q = glm::cross(t, edge1);
+
+			us[lane] = glm::dot(t, p) * inverse;
+			vs[lane] = glm::dot(ray.Direction, q) * inverse;
+			distances[lane] = glm::dot(edge2, q) * inverse;
+
+			if (us[lane] >= 0 && vs[lane] >= 0 && us[lane] + vs[lane] <= 1 &&
+				distances[lane] > 0 && distances[lane] <= distance) mask = mask | (1u << lane);
+		}
+
+		return mask;
+#endif
+	}
+
+	inline auto anyActive(const std::array<float, 4>& distances) -> bool
+	{
+		return distances[0] > 0 || distances[1] > 0 || distances[2] > 0 || distances[3] > 0;
+	}
+
+}
+
+struct LRTR::TriangleHierarchy::BuildContext {
+	std::vector<Bound3f> Bounds;
+	std::vector<Vector3f> Centers;
+
+	//the tasks partition the disjoint ranges of items, so they do not need lock
+	std::vector<unsigned> Items;
+};
+
+template <typename TLeaf>
+void LRTR::TriangleHierarchy::traverse(const RayF& ray, float& distance, TLeaf&& leaf) const
+{
+	if (mNodes.empty() || distance <= 0) return;
+
+	//the division by zero is infinity, so the slab test is still right for axis aligned rays
+	const auto inverseDirection = 1.0f / ray.Direction;
+
+	auto entry = 0.0f;
+
+	if (!intersectBound(mNodes[0].Bound, ray.Origin, inverseDirection, distance, entry)) return;
+
+	std::vector<std::pair<unsigned, float>> stack;
+
+	stack.reserve(64);
+	stack.push_back({ 0, entry });
+
+	while (!stack.empty()) {
+		const auto index = stack.back().first;
+
+		//the node may be farther than the closest hit we found after it was pushed
+		if (stack.back().second > distance) { stack.pop_back(); continue; }
+
+		stack.pop_back();
+
+		const auto& node = mNodes[index];
+
+		if (node.leaf()) {
+			leaf(mBlocks[node.Offset], distance);
+
+			if (distance <= 0) return;
+
+			continue;
+		}
+
+		auto leftEntry = 0.0f;
+		auto rightEntry = 0.0f;
+
+		const auto left = intersectBound(mNodes[index + 1].Bound, ray.Origin, inverseDirection, distance, leftEntry);
+		const auto right = intersectBound(mNodes[node.Offset].Bound, ray.Origin, inverseDirection, distance, rightEntry);
+
+		//push the farther child first, so the closer child is visited first
+		if (left && right) {
+			if (leftEntry <= rightEntry) {
+				stack.push_back({ node.Offset, rightEntry });
+				stack.push_back({ index + 1, leftEntry });
+			}
+			else {
+				stack.push_back({ index + 1, leftEntry });
+				stack.push_back({ node.Offset, rightEntry });
+			}
+		}
+		else if (left) stack.push_back({ index + 1, leftEntry });
+		else if (right) stack.push_back({ node.Offset, rightEntry });
+	}
+}
+
+template <typename TLeaf>
+void LRTR::TriangleHierarchy::traverse(const std::array<RayF, 4>& rays, std::array<float, 4>& distances, TLeaf&& leaf) const
+{
+	if (mNodes.empty() || !anyActive(distances)) return;
+
+	const auto packet = packRays(rays);
+
+	std::vector<unsigned> stack;
+
+	stack.reserve(64);
+	stack.push_back(0);
+
+	while (!stack.empty()) {
+		const auto index = stack.back();
+		const auto& node = mNodes[index];
+
+		stack.pop_back();
+
+		const auto mask = intersectBound(node.Bound, packet, distances.data());
+
+		if (mask == 0) continue;
+
+		if (node.leaf()) {
+			leaf(mBlocks[node.Offset], mask, distances);
+
+			if (!anyActive(distances)) return;
+
+			continue;
+		}
+
+		//the rays are coherent, so we order the children by the direction of first active ray
+		//along the axis that separates the centers of children most
+		const auto offset = mNodes[node.Offset].Bound.center() - mNodes[index + 1].Bound.center();
+		const auto magnitude = glm::abs(offset);
+		const auto axis = magnitude.x > magnitude.y ? (magnitude.x > magnitude.z ? 0 : 2) : (magnitude.y > magnitude.z ? 1 : 2);
+
+		size_t lane = 0;
+
+		while ((mask & (1u << lane)) == 0) lane++;
+
+		//the left child is closer if the ray goes from left to right
+		if (rays[lane].Direction[axis] * offset[axis] >= 0) {
+			stack.push_back(node.Offset);
+			stack.push_back(index + 1);
+		}
+		else {
+			stack.push_back(index + 1);
+			stack.push_back(node.Offset);
+		}
+	}
+}
+
+void LRTR::TriangleHierarchy::build(
+	const std::vector<Vector3f>& positions,
+	const std::vector<unsigned>& indices,
+	ThreadPool* threadPool)
+{
+	clear();
+
+	mTriangles = indices.size() / 3;
+
+	if (mTriangles == 0) return;
+
+	BuildContext context;
+
+	context.Bounds = std::vector<Bound3f>(mTriangles);
+	context.Centers = std::vector<Vector3f>(mTriangles);
+	context.Items = std::vector<unsigned>(mTriangles);
+
+	std::iota(context.Items.begin(), context.Items.end(), 0);
+
+	const auto ComputeBounds = [&](const size_t begin, const size_t end)
+	{
+		for (auto triangle = begin; triangle < end; triangle++) {
+			Bound3f bound;
+
+			bound.merge(positions[indices[triangle * 3 + 0]]);
+			bound.merge(positions[indices[triangle * 3 + 1]]);
+			bound.merge(positions[indices[triangle * 3 + 2]]);
+
+			context.Bounds[triangle] = bound;
+			context.Centers[triangle] = bound.center();
+		}
+	};
+
+	if (threadPool == nullptr || mTriangles < ParallelBuildCount) ComputeBounds(0, mTriangles);
+	else threadPool->parallelFor(mTriangles, BoundGrain, ComputeBounds);
+
+	//the binary tree with n triangles has at most 2n - 1 nodes
+	mNodes.reserve(mTriangles * 2 - 1);
+
+	build(context, mNodes, 0, static_cast<unsigned>(mTriangles), threadPool);
+
+	//the leaves are converted to blocks, the offset of leaf is the index of block instead of first item
+	for (auto& node : mNodes) {
+		if (!node.leaf()) continue;
+
+		TriangleBlock block = {};
+
+		for (unsigned lane = 0; lane < 4; lane++) {
+			if (lane >= node.Count) { block.Triangles[lane] = TriangleHit::InvalidTriangle; continue; }
+
+			const auto triangle = context.Items[node.Offset + lane];
+
+			const auto& v0 = positions[indices[triangle * 3 + 0]];
+			const auto& v1 = positions[indices[triangle * 3 + 1]];
+			const auto& v2 = positions[indices[triangle * 3 + 2]];
+
+			for (int axis = 0; axis < 3; axis++) {
+				block.Vertex[axis][lane] = v0[axis];
+				block.Edge1[axis][lane] = v1[axis] - v0[axis];
+				block.Edge2[axis][lane] = v2[axis] - v0[axis];
+			}
+
+			block.Triangles[lane] = triangle;
+		}
+
+		node.Offset = static_cast<unsigned>(mBlocks.size());
+
+		mBlocks.push_back(block);
+	}
+}
+
+void LRTR::TriangleHierarchy::clear()
+{
+	mNodes.clear();
+	mBlocks.clear();
+
+	mTriangles = 0;
+}
+
+auto LRTR::TriangleHierarchy::intersect(const RayF& ray, TriangleHit& hit) const -> bool
+{
+	auto distance = hit.Distance;
+	auto found = false;
+
+	traverse(ray, distance, [&](const TriangleBlock& block, float& maxDistance)
+		{
+			float distances[4], us[4], vs[4];
+
+			const auto mask = intersectBlock(block, ray, maxDistance, distances, us, vs);
+
+			for (size_t lane = 0; lane < 4; lane++) {
+				if ((mask & (1u << lane)) == 0 || distances[lane] > maxDistance) continue;
+
+				maxDistance = distances[lane];
+
+				hit.Distance = distances[lane];
+				hit.U = us[lane];
+				hit.V = vs[lane];
+				hit.Triangle = block.Triangles[lane];
+
+				found = true;
+			}
+		});
+
+	return found;
+}
+
+auto LRTR::TriangleHierarchy::intersect(const std::array<RayF, 4>& rays, std::array<TriangleHit, 4>& hits) const -> unsigned
+{
+	std::array<float, 4> distances = {
+		hits[0].Distance, hits[1].Distance, hits[2].Distance, hits[3].Distance
+	};
+
+	unsigned result = 0;
+
+	traverse(rays, distances, [&](const TriangleBlock& block, const unsigned mask, std::array<float, 4>& maxDistances)
+		{
+			for (size_t ray = 0; ray < 4; ray++) {
+				if ((mask & (1u << ray)) == 0) continue;
+
+				float blockDistances[4], us[4], vs[4];
+
+				const auto hitMask = intersectBlock(block, rays[ray], maxDistances[ray], blockDistances, us, vs);
+
+				for (size_t lane = 0; lane < 4; lane++) {
+					if ((hitMask & (1u << lane)) == 0 || blockDistances[lane] > maxDistances[ray]) continue;
+
+					maxDistances[ray] = blockDistances[lane];
+
+					hits[ray].Distance = blockDistances[lane];
+					hits[ray].U = us[lane];
+					hits[ray].V = vs[lane];
+					hits[ray].Triangle = block.Triangles[lane];
+
+					result = result | (1u << ray);
+				}
+			}
+		});
+
+	return result;
+}
+
+auto LRTR::TriangleHierarchy::occluded(const RayF& ray, const float distance) const -> bool
+{
+	auto maxDistance = distance;
+	auto found = false;
+
+	traverse(ray, maxDistance, [&](const TriangleBlock& block, float& currentDistance)
+		{
+			float distances[4], us[4], vs[4];
+
+			if (intersectBlock(block, ray, currentDistance, distances, us, vs) == 0) return;
+
+			//stop the traversal at the first hit
+			currentDistance = 0;
+			found = true;
+		});
+
+	return found;
+}
+
+auto LRTR::TriangleHierarchy::occluded(const std::array<RayF, 4>& rays, const std::array<float, 4>& distances) const -> unsigned
+{
+	auto maxDistances = distances;
+
+	unsigned result = 0;
+
+	traverse(rays, maxDistances, [&](const TriangleBlock& block, const unsigned mask, std::array<float, 4>& currentDistances)
+		{
+			for (size_t ray = 0; ray < 4; ray++) {
+				if ((mask & (1u << ray)) == 0) continue;
+
+				float blockDistances[4], us[4], vs[4];
+
+				if (intersectBlock(block, rays[ray], currentDistances[ray], blockDistances, us, vs) == 0) continue;
+
+				//the ray is inactive after its first hit
+				currentDistances[ray] = 0;
+				result = result | (1u << ray);
+			}
+		});
+
+	return result;
+}
+
+auto LRTR::TriangleHierarchy::nodes() const noexcept -> const std::vector<BoundingVolumeNode>&
+{
+	return mNodes;
+}
+
+auto LRTR::TriangleHierarchy::blocks() const noexcept -> const std::vector<TriangleBlock>&
+{
+	return mBlocks;
+}
+
+auto LRTR::TriangleHierarchy::bound() const noexcept -> Bound3f
+{
+	return mNodes.empty() ? Bound3f() : mNodes[0].Bound;
+}
+
+auto LRTR::TriangleHierarchy::size() const noexcept -> size_t
+{
+	return mTriangles;
+}
+
+auto LRTR::TriangleHierarchy::empty() const noexcept -> bool
+{
+	return mTriangles == 0;
+}
+
+void LRTR::TriangleHierarchy::build(
+	BuildContext& context,
+	std::vector<BoundingVolumeNode>& nodes,
+	unsigned begin, unsigned end,
+	ThreadPool* threadPool)
+{
+	struct Bin {
+		Bound3f Bound;
+		unsigned Count = 0;
+	};
+
+	const auto index = static_cast<unsigned>(nodes.size());
+	const auto count = end - begin;
+
+	auto& items = context.Items;
+
+	Bound3f bound;
+	Bound3f centerBound;
+
+	for (auto item = begin; item < end; item++) {
+		bound.merge(context.Bounds[items[item]]);
+		centerBound.merge(context.Centers[items[item]]);
+	}
+
+	nodes.push_back({ bound, begin, count });
+
+	if (count == 1) return;
+
+	//we split the triangles along the axis with the largest extent of centers
+	const auto size = centerBound.Max - centerBound.Min;
+	const auto axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+	const auto extent = size[axis];
+
+	auto middle = begin + count / 2;
+
+	if (extent > 0) {
+		std::array<Bin, BinCount> bins;
+
+		const auto BinIndex = [&](const unsigned item)
+		{
+			const auto offset = (context.Centers[item][axis] - centerBound.Min[axis]) / extent;
+
+			return std::min(static_cast<size_t>(offset * BinCount), BinCount - 1);
+		};
+
+		for (auto item = begin; item < end; item++) {
+			auto& bin = bins[BinIndex(items[item])];
+
+			bin.Bound.merge(context.Bounds[items[item]]);
+			bin.Count++;
+		}
+
+		//the cost of the right part of each split, the split i puts bins [0, i] to left
+		std::array<float, BinCount - 1> rightCosts = {};
+
+		Bound3f rightBound;
+		unsigned rightCount = 0;
+
+		for (auto split = BinCount - 1; split > 0; split--) {
+			rightBound.merge(bins[split].Bound);
+			rightCount = rightCount + bins[split].Count;
+
+			rightCosts[split - 1] = rightBound.surfaceArea() * rightCount;
+		}
+
+		Bound3f leftBound;
+		unsigned leftCount = 0;
+
+		auto bestCost = std::numeric_limits<float>::max();
+		size_t bestSplit = 0;
+
+		for (size_t split = 0; split < BinCount - 1; split++) {
+			leftBound.merge(bins[split].Bound);
+			leftCount = leftCount + bins[split].Count;
+
+			const auto cost = leftBound.surfaceArea() * leftCount + rightCosts[split];
+
+			if (cost < bestCost) { bestCost = cost; bestSplit = split; }
+		}
+
+		const auto area = bound.surfaceArea();
+
+		bestCost = TraversalCost + (area > 0 ? bestCost / area : static_cast<float>(count));
+
+		//splitting the node is more expensive than testing all triangles in one block
+		if (count <= MaxLeafTriangles && bestCost >= static_cast<float>(count)) return;
+
+		middle = static_cast<unsigned>(std::partition(items.begin() + begin, items.begin() + end,
+			[&](const unsigned item) { return BinIndex(item) <= bestSplit; }) - items.begin());
+	}
+	else if (count <= MaxLeafTriangles) return;
+
+	//all triangles are in one side, we split them at the median
+	if (middle == begin || middle == end) {
+		middle = begin + count / 2;
+
+		std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end,
+			[&](const unsigned left, const unsigned right) { return context.Centers[left][axis] < context.Centers[right][axis]; });
+	}
+
+	if (threadPool != nullptr && count >= ParallelBuildCount) {
+		//the right subtree is built in another task with its own nodes, then we append them after the left subtree
+		std::vector<BoundingVolumeNode> rightNodes;
+		std::atomic<bool> finished = false;
+
+		threadPool->submit([&]()
+			{
+				build(context, rightNodes, middle, end, threadPool);
+
+				finished = true;
+			});
+
+		build(context, nodes, begin, middle, threadPool);
+
+		//the caller runs other tasks while waiting, so the nested builds do not block workers
+		threadPool->wait([&]() { return finished.load(); });
+
+		const auto right = static_cast<unsigned>(nodes.size());
+
+		for (auto node : rightNodes) {
+			if (!node.leaf()) node.Offset = node.Offset + right;
+
+			nodes.push_back(node);
+		}
+
+		nodes[index].Offset = right;
+		nodes[index].Count = 0;
+
+		return;
+	}
+
+	//the left child is the next node, so we only need to record the right child
+	build(context, nodes, begin, middle, threadPool);
+
+	const auto right = static_cast<unsigned>(nodes.size());
+
+	build(context, nodes, middle, end, threadPool);
+
+	nodes[index].Offset = right;
+	nodes[index].Count = 0;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+
+#include "BoundingVolumeHierarchy.hpp"
+
+#include "../Parallel/ThreadPool.hpp"
+#include "../Bound.hpp"
+#include "../Ray.hpp"
+
+#include <limits>
+#include <vector>
+#include <array>
+
+namespace LRTR {
+
+	//the hit of ray and triangle, the triangle is the index of triangle in mesh (the first index is Triangle * 3)
+	//the (U, V) is the barycentric coordinate of vertex 1 and 2, the point is (1 - U - V) * v0 + U * v1 + V * v2
+	struct TriangleHit {
+		float Distance = std::numeric_limits<float>::max();
+		float U = 0;
+		float V = 0;
+
+		unsigned Triangle = InvalidTriangle;
+
+		auto valid() const noexcept -> bool { return Triangle != InvalidTriangle; }
+
+		static constexpr unsigned InvalidTriangle = ~0u;
+	};
+
+	//four triangles of leaf in structure of arrays, so we can test them with one ray at a time
+	//the unused lanes have zero edges, they are never hit
+	struct alignas(16) TriangleBlock {
+		float Vertex[3][4];
+		float Edge1[3][4];
+		float Edge2[3][4];
+
+		unsigned Triangles[4];
+	};
+
+	//the bounding volume hierarchy over the triangles of a mesh, it is built with binned surface area heuristic
+	//the leaf has at most four triangles and they are stored in one block, so the leaf is tested with SSE
+	//the rays of packet are traversed together, they should be coherent (e.g. the rays of neighbouring pixels)
+	class TriangleHierarchy : public Noncopyable {
+	public:
+		TriangleHierarchy() = default;
+
+		~TriangleHierarchy() = default;
+
+		//the subtrees of large mesh are built in parallel if the thread pool is not nullptr
+		void build(
+			const std::vector<Vector3f>& positions,
+			const std::vector<unsigned>& indices,
+			ThreadPool* threadPool = nullptr);
+
+		void clear();
+
+		//find the closest hit in (0, hit.Distance], the hit is updated if we find a closer one
+		auto intersect(const RayF& ray, TriangleHit& hit) const -> bool;
+
+		//the closest hits of four rays, the rays whose hit distance is not positive are ignored
+		//return the mask of rays that hit a triangle, the bit i is the ray i
+		auto intersect(const std::array<RayF, 4>& rays, std::array<TriangleHit, 4>& hits) const -> unsigned;
+
+		//return true if there is any hit in (0, distance], it stops at the first hit
+		auto occluded(const RayF& ray, const float distance) const -> bool;
+
+		//return the mask of rays that have any hit in (0, distances[i]]
+		auto occluded(const std::array<RayF, 4>& rays, const std::array<float, 4>& distances) const -> unsigned;
+
+		auto nodes() const noexcept -> const std::vector<BoundingVolumeNode>&;
+
+		auto blocks() const noexcept -> const std::vector<TriangleBlock>&;
+
+		auto bound() const noexcept -> Bound3f;
+
+		//the number of triangles we built with
+		auto size() const noexcept -> size_t;
+
+		auto empty() const noexcept -> bool;
+	private:
+		struct BuildContext;
+
+		//build the subtree of items [begin, end) into nodes, the offsets of leaves are the first items
+		void build(
+			BuildContext& context,
+			std::vector<BoundingVolumeNode>& nodes,
+			unsigned begin, unsigned end,
+			ThreadPool* threadPool);
+
+		//visit the leaves hit by the ray in (0, distance], the leaf function can reduce the distance
+		//the traversal stops when the distance is not positive, so the any hit query can stop at first hit
+		template<typename TLeaf>
+		void traverse(const RayF& ray, float& distance, TLeaf&& leaf) const;
+
+		//visit the leaves hit by any ray of packet, the rays whose distance is not positive are inactive
+		template<typename TLeaf>
+		void traverse(const std::array<RayF, 4>& rays, std::array<float, 4>& distances, TLeaf&& leaf) const;
+	private:
+		std::vector<BoundingVolumeNode> mNodes;
+		std::vector<TriangleBlock> mBlocks;
+
+		size_t mTriangles = 0;
+	};
+
+}
@@ -0,0 +1,56 @@
+#include "BlockAllocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+LRTR::BlockAllocator::BlockAllocator(
+	const size_t size,
+	const size_t alignment,
+	const size_t blockElements) :
+	mAlignment(std::max(alignment, static_cast<size_t>(1))), mBlockElements(std::max(blockElements, static_cast<size_t>(1)))
+{
+	mStride = (std::max(size, static_cast<size_t>(1)) + mAlignment - 1) / mAlignment * mAlignment;
+	mBlockUsed = mBlockElements;
+}
+
+auto LRTR::BlockAllocator::allocate() -> void*
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	mSize++;
+	
+	if (!mFreeElements.empty()) {
+		const auto element = mFreeElements.back();
+
+		mFreeElements.pop_back();
+
+		return element;
+	}
+
+	if (mBlockUsed == mBlockElements) {
+		//the block has extra space, so we can align the first element of it
+		mBlocks.push_back(std::make_unique<unsigned char[]>(mStride * mBlockElements + mAlignment));
+
+		const auto address = reinterpret_cast<std::uintptr_t>(mBlocks.back().get());
+		
+		mBlockStart = reinterpret_cast<unsigned char*>((address + mAlignment - 1) / mAlignment * mAlignment);
+		mBlockUsed = 0;
+	}
+
+	return mBlockStart + mStride * mBlockUsed++;
+}
+
+void LRTR::BlockAllocator::deallocate(void* element)
+{
+	if (element == nullptr) return;
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	mFreeElements.push_back(element);
+	mSize--;
+}
+
+auto LRTR::BlockAllocator::size() const noexcept -> size_t
+{
+	return mSize;
+}
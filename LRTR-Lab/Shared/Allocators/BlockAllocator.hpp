@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+
+#include <memory>
+#include <vector>
+#include <mutex>
+
+namespace LRTR {
+
+	//the block allocator assigns elements with same size from contiguous blocks
+	//the elements allocated one after another are next to each other, so scanning them is prefetch friendly
+	//the blocks are never moved or released, so the pointers of elements are always valid until they are deallocated
+	class BlockAllocator : public Noncopyable {
+	public:
+		explicit BlockAllocator(
+			const size_t size,
+			const size_t alignment,
+			const size_t blockElements = 256);
+
+		~BlockAllocator() = default;
+
+		auto allocate() -> void*;
+
+		//the element is reused by the next allocation, so the holes are filled first
+		void deallocate(void* element);
+
+		//the number of elements allocated and not deallocated
+		auto size() const noexcept -> size_t;
+
+		//the allocator of type, it is never destroyed because the static objects may deallocate after main
+		template<typename T>
+		static auto of() -> BlockAllocator&;
+	private:
+		std::vector<std::unique_ptr<unsigned char[]>> mBlocks;
+		std::vector<void*> mFreeElements;
+
+		unsigned char* mBlockStart = nullptr;
+
+		size_t mAlignment = 0;
+		size_t mStride = 0;
+		size_t mBlockElements = 0;
+		size_t mBlockUsed = 0;
+		size_t mSize = 0;
+
+		std::mutex mMutex;
+	};
+
+	//the allocator of standard library, the single element is from the block allocator of its type
+	//it is used by std::allocate_shared, so the object and its control block are in one element
+	template<typename T>
+	class BlockAllocatorAdapter {
+	public:
+		using value_type = T;
+
+		BlockAllocatorAdapter() = default;
+
+		template<typename U>
+		BlockAllocatorAdapter(const BlockAllocatorAdapter<U>&) noexcept {}
+
+		auto allocate(const size_t count) -> T*
+		{
+			if (count != 1) return std::allocator<T>().allocate(count);
+
+			return static_cast<T*>(BlockAllocator::of<T>().allocate());
+		}
+
+		void deallocate(T* element, const size_t count)
+		{
+			if (count != 1) std::allocator<T>().deallocate(element, count);
+			else BlockAllocator::of<T>().deallocate(element);
+		}
+
+		template<typename U>
+		auto operator==(const BlockAllocatorAdapter<U>&) const noexcept -> bool { return true; }
+
+		template<typename U>
+		auto operator!=(const BlockAllocatorAdapter<U>&) const noexcept -> bool { return false; }
+	};
+
+	template <typename T>
+	auto BlockAllocator::of() -> BlockAllocator&
+	{
+		static const auto allocator = new BlockAllocator(sizeof(T), alignof(T));
+
+		return *allocator;
+	}
+
+}
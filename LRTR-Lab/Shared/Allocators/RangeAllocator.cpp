@@ -0,0 +1,374 @@
+#include "RangeAllocator.hpp"
+
+#include <algorithm>
+
+namespace LRTR {
+
+	constexpr unsigned InvalidRangeBlock = ~0u;
+
+	inline auto lowestBit(const unsigned long long value) -> size_t
+	{
+		size_t bit = 0;
+
+		while ((value & (1ull << bit)) == 0) bit++;
+
+		return bit;
+	}
+
+	inline auto highestBit(const unsigned long long value) -> size_t
+	{
+		size_t bit = 63;
+
+		while ((value & (1ull << bit)) == 0) bit--;
+
+		return bit;
+	}
+
+}
+
+LRTR::RangeAllocator::RangeAllocator(const size_t capacity) :
+	mCapacity(capacity)
+{
+	clear();
+}
+
+auto LRTR::RangeAllocator::allocate(const size_t count, const Identity& owner) -> size_t
+{
+	const auto wanted = std::max(count, static_cast<size_t>(1));
+	const auto freeBlock = findFreeBlock(wanted);
+
+	if (freeBlock != InvalidRangeBlock) {
+		removeFreeBlock(freeBlock);
+		useBlock(freeBlock, wanted, owner);
+
+		return mBlocks[freeBlock].Offset;
+	}
+
+	//there is no free range large enough, so we append it to the end of pool
+	if (wanted > mCapacity - mEnd) return InvalidOffset;
+
+	const auto block = createBlock();
+
+	mBlocks[block].Offset = mEnd;
+	mBlocks[block].Count = wanted;
+	mBlocks[block].Owner = owner;
+	mBlocks[block].Previous = mLastBlock;
+	mBlocks[block].Next = InvalidRangeBlock;
+	mBlocks[block].IsFree = false;
+
+	if (mLastBlock != InvalidRangeBlock) mBlocks[mLastBlock].Next = block;
+
+	mLastBlock = block;
+	mEnd = mEnd + wanted;
+	mUsed = mUsed + wanted;
+
+	mUsedBlocks[mBlocks[block].Offset] = block;
+
+	return mBlocks[block].Offset;
+}
+
+void LRTR::RangeAllocator::release(const size_t offset)
+{
+	const auto it = mUsedBlocks.find(offset);
+
+	if (it == mUsedBlocks.end()) return;
+
+	auto block = it->second;
+
+	mUsedBlocks.erase(it);
+
+	mUsed = mUsed - mBlocks[block].Count;
+
+	mBlocks[block].IsFree = true;
+	mBlocks[block].IsKept = false;
+	mBlocks[block].Owner = 0;
+
+	//merge the free blocks next to it, the merged block uses the offset of previous one
+	if (const auto previous = mBlocks[block].Previous; previous != InvalidRangeBlock && mBlocks[previous].IsFree) {
+		removeFreeBlock(previous);
+
+		mBlocks[previous].Count = mBlocks[previous].Count + mBlocks[block].Count;
+		mBlocks[previous].Next = mBlocks[block].Next;
+
+		if (mBlocks[block].Next != InvalidRangeBlock) mBlocks[mBlocks[block].Next].Previous = previous;
+		if (mLastBlock == block) mLastBlock = previous;
+
+		destroyBlock(block);
+
+		block = previous;
+	}
+
+	if (const auto next = mBlocks[block].Next; next != InvalidRangeBlock && mBlocks[next].IsFree) {
+		removeFreeBlock(next);
+
+		mBlocks[block].Count = mBlocks[block].Count + mBlocks[next].Count;
+		mBlocks[block].Next = mBlocks[next].Next;
+
+		if (mBlocks[next].Next != InvalidRangeBlock) mBlocks[mBlocks[next].Next].Previous = block;
+		if (mLastBlock == next) mLastBlock = block;
+
+		destroyBlock(next);
+	}
+
+	//the free block at the end is trimmed, so the last block is always used
+	if (mLastBlock == block) {
+		mEnd = mBlocks[block].Offset;
+		mLastBlock = mBlocks[block].Previous;
+
+		if (mLastBlock != InvalidRangeBlock) mBlocks[mLastBlock].Next = InvalidRangeBlock;
+
+		destroyBlock(block);
+
+		return;
+	}
+
+	insertFreeBlock(block);
+}
+
+auto LRTR::RangeAllocator::relocateLast(RangeRelocation& relocation, const bool keepSource) -> bool
+{
+	//the kept ranges are waiting for release, so we move the last range that is not kept
+	auto lastBlock = mLastBlock;
+
+	while (lastBlock != InvalidRangeBlock && (mBlocks[lastBlock].IsFree || mBlocks[lastBlock].IsKept))
+		lastBlock = mBlocks[lastBlock].Previous;
+
+	if (lastBlock == InvalidRangeBlock) return false;
+
+	const auto last = mBlocks[lastBlock];
+	const auto freeBlock = findFreeBlock(last.Count);
+
+	//the free blocks may be after the last range if there are kept ranges, we only move the range towards the start
+	if (freeBlock == InvalidRangeBlock || mBlocks[freeBlock].Offset > last.Offset) return false;
+
+	removeFreeBlock(freeBlock);
+	useBlock(freeBlock, last.Count, last.Owner);
+
+	relocation.Owner = last.Owner;
+	relocation.From = last.Offset;
+	relocation.To = mBlocks[freeBlock].Offset;
+	relocation.Count = last.Count;
+
+	if (!keepSource) { release(last.Offset); return true; }
+
+	mBlocks[lastBlock].IsKept = true;
+	mBlocks[lastBlock].Owner = 0;
+
+	return true;
+}
+
+void LRTR::RangeAllocator::keep(const size_t offset)
+{
+	const auto it = mUsedBlocks.find(offset);
+
+	if (it == mUsedBlocks.end()) return;
+
+	mBlocks[it->second].IsKept = true;
+	mBlocks[it->second].Owner = 0;
+}
+
+void LRTR::RangeAllocator::clear()
+{
+	mBlocks.clear();
+	mUnusedBlocks.clear();
+	mUsedBlocks.clear();
+
+	for (auto& freeLists : mFreeLists) freeLists.fill(InvalidRangeBlock);
+
+	mSecondLevelBitmaps.fill(0);
+	mFirstLevelBitmap = 0;
+
+	mLastBlock = InvalidRangeBlock;
+
+	mEnd = 0;
+	mUsed = 0;
+	mFreeRanges = 0;
+}
+
+auto LRTR::RangeAllocator::end() const noexcept -> size_t
+{
+	return mEnd;
+}
+
+auto LRTR::RangeAllocator::capacity() const noexcept -> size_t
+{
+	return mCapacity;
+}
+
+auto LRTR::RangeAllocator::used() const noexcept -> size_t
+{
+	return mUsed;
+}
+
+auto LRTR::RangeAllocator::unused() const noexcept -> size_t
+{
+	return mEnd - mUsed;
+}
+
+auto LRTR::RangeAllocator::freeRanges() const noexcept -> size_t
+{
+	return mFreeRanges;
+}
+
+auto LRTR::RangeAllocator::largestFreeRange() const noexcept -> size_t
+{
+	if (mFirstLevelBitmap == 0) return 0;
+
+	//the largest block is in the highest size class, but the blocks in one class have different sizes
+	const auto firstLevel = highestBit(mFirstLevelBitmap);
+	const auto secondLevel = highestBit(mSecondLevelBitmaps[firstLevel]);
+
+	size_t largest = 0;
+
+	for (auto block = mFreeLists[firstLevel][secondLevel]; block != InvalidRangeBlock; block = mBlocks[block].NextFree)
+		largest = std::max(largest, mBlocks[block].Count);
+
+	return largest;
+}
+
+auto LRTR::RangeAllocator::fragmentation() const noexcept -> float
+{
+	if (unused() == 0) return 0;
+
+	return 1.0f - static_cast<float>(largestFreeRange()) / static_cast<float>(unused());
+}
+
+void LRTR::RangeAllocator::mapping(const size_t count, size_t& firstLevel, size_t& secondLevel)
+{
+	//the small counts are in the first level 0 linearly, the others are divided into second levels in each power of two
+	if (count < SecondLevels) {
+		firstLevel = 0;
+		secondLevel = count;
+
+		return;
+	}
+
+	const auto bit = highestBit(count);
+
+	firstLevel = bit - SecondLevelBits + 1;
+	secondLevel = (count >> (bit - SecondLevelBits)) - SecondLevels;
+}
+
+auto LRTR::RangeAllocator::createBlock() -> unsigned
+{
+	if (!mUnusedBlocks.empty()) {
+		const auto block = mUnusedBlocks.back();
+
+		mUnusedBlocks.pop_back();
+
+		return block;
+	}
+
+	mBlocks.push_back(Block());
+
+	return static_cast<unsigned>(mBlocks.size() - 1);
+}
+
+void LRTR::RangeAllocator::destroyBlock(const unsigned block)
+{
+	mBlocks[block] = Block();
+
+	mUnusedBlocks.push_back(block);
+}
+
+void LRTR::RangeAllocator::insertFreeBlock(const unsigned block)
+{
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+
+	mapping(mBlocks[block].Count, firstLevel, secondLevel);
+
+	auto& head = mFreeLists[firstLevel][secondLevel];
+
+	mBlocks[block].IsFree = true;
+	mBlocks[block].PreviousFree = InvalidRangeBlock;
+	mBlocks[block].NextFree = head;
+
+	if (head != InvalidRangeBlock) mBlocks[head].PreviousFree = block;
+
+	head = block;
+
+	mSecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+	mFirstLevelBitmap |= 1ull << firstLevel;
+	mFreeRanges++;
+}
+
+void LRTR::RangeAllocator::removeFreeBlock(const unsigned block)
+{
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+
+	mapping(mBlocks[block].Count, firstLevel, secondLevel);
+
+	const auto previous = mBlocks[block].PreviousFree;
+	const auto next = mBlocks[block].NextFree;
+
+	if (previous != InvalidRangeBlock) mBlocks[previous].NextFree = next;
+	if (next != InvalidRangeBlock) mBlocks[next].PreviousFree = previous;
+
+	if (mFreeLists[firstLevel][secondLevel] == block) {
+		mFreeLists[firstLevel][secondLevel] = next;
+
+		if (next == InvalidRangeBlock) {
+			mSecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+
+			if (mSecondLevelBitmaps[firstLevel] == 0) mFirstLevelBitmap &= ~(1ull << firstLevel);
+		}
+	}
+
+	mBlocks[block].PreviousFree = InvalidRangeBlock;
+	mBlocks[block].NextFree = InvalidRangeBlock;
+	mFreeRanges--;
+}
+
+auto LRTR::RangeAllocator::findFreeBlock(const size_t count) const -> unsigned
+{
+	auto rounded = count;
+
+	if (count >= SecondLevels) rounded = count + (static_cast<size_t>(1) << (highestBit(count) - SecondLevelBits)) - 1;
+
+	size_t firstLevel = 0;
+	size_t secondLevel = 0;
+
+	mapping(rounded, firstLevel, secondLevel);
+
+	//find the non-empty class in this first level that is not smaller than the class of count
+	auto secondLevelBitmap = mSecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+
+	if (secondLevelBitmap == 0) {
+		const auto firstLevelBitmap = firstLevel + 1 < 64 ? mFirstLevelBitmap & (~0ull << (firstLevel + 1)) : 0;
+
+		if (firstLevelBitmap == 0) return InvalidRangeBlock;
+
+		firstLevel = lowestBit(firstLevelBitmap);
+		secondLevelBitmap = mSecondLevelBitmaps[firstLevel];
+	}
+
+	return mFreeLists[firstLevel][lowestBit(secondLevelBitmap)];
+}
+
+void LRTR::RangeAllocator::useBlock(const unsigned block, const size_t count, const Identity& owner)
+{
+	//the block found is never the last one, because the free block at the end is trimmed
+	if (mBlocks[block].Count > count) {
+		const auto remain = createBlock();
+
+		mBlocks[remain].Offset = mBlocks[block].Offset + count;
+		mBlocks[remain].Count = mBlocks[block].Count - count;
+		mBlocks[remain].Previous = block;
+		mBlocks[remain].Next = mBlocks[block].Next;
+
+		if (mBlocks[block].Next != InvalidRangeBlock) mBlocks[mBlocks[block].Next].Previous = remain;
+
+		mBlocks[block].Next = remain;
+		mBlocks[block].Count = count;
+
+		insertFreeBlock(remain);
+	}
+
+	mBlocks[block].IsFree = false;
+	mBlocks[block].Owner = owner;
+
+	mUsed = mUsed + count;
+	mUsedBlocks[mBlocks[block].Offset] = block;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+#include "../../Core/TypeInfo.hpp"
+
+#include <unordered_map>
+#include <vector>
+#include <limits>
+#include <array>
+
+namespace LRTR {
+
+	//the range moved by relocation, the elements in [From, From + Count) should be copied to [To, To + Count)
+	struct RangeRelocation {
+		Identity Owner = 0;
+
+		size_t From = 0;
+		size_t To = 0;
+		size_t Count = 0;
+	};
+
+	//the range allocator assigns ranges of elements in a linear pool (vertices or indices in a buffer)
+	//the free ranges are kept in two level segregated lists (TLSF), so allocate and release are O(1)
+	//if there is not a free range large enough the range is appended to the end, until the end reaches the capacity
+	//the free ranges at the end are trimmed, so end() is the number of elements the buffer needs
+	class RangeAllocator : public Noncopyable {
+	public:
+		static constexpr size_t InvalidOffset = std::numeric_limits<size_t>::max();
+
+		explicit RangeAllocator(const size_t capacity = InvalidOffset);
+
+		~RangeAllocator() = default;
+
+		//allocate a range with count elements (at least one), the owner is used when the range is relocated
+		//return InvalidOffset if there is not enough space in capacity
+		auto allocate(const size_t count, const Identity& owner = 0) -> size_t;
+
+		//release the range starting at offset, it is merged with the free ranges next to it
+		void release(const size_t offset);
+
+		//move the last range to a free range before it, return false if there is no free range large enough
+		//the allocator does not touch the elements, the caller copies them and updates the owner of range
+		//if keep source is true the old range stays allocated until the caller releases it at relocation.From
+		//so the elements still read from it are not overwritten, the kept ranges are skipped by next relocations
+		auto relocateLast(RangeRelocation& relocation, const bool keepSource = false) -> bool;
+
+		//keep the range starting at offset until the caller releases it, the kept range loses its owner
+		//and is never relocated, it is used for the ranges waiting for release
+		void keep(const size_t offset);
+
+		void clear();
+
+		//the end of last allocated range, the buffer should have at least end() elements
+		auto end() const noexcept -> size_t;
+
+		auto capacity() const noexcept -> size_t;
+
+		//the elements allocated by ranges
+		auto used() const noexcept -> size_t;
+
+		//the elements in free ranges before end()
+		auto unused() const noexcept -> size_t;
+
+		auto freeRanges() const noexcept -> size_t;
+
+		auto largestFreeRange() const noexcept -> size_t;
+
+		//1 - largest free range / unused elements, it is 0 if all free elements are in one range
+		auto fragmentation() const noexcept -> float;
+	private:
+		struct Block {
+			size_t Offset = 0;
+			size_t Count = 0;
+
+			Identity Owner = 0;
+
+			//the blocks next to it in the pool and in the free list of its size class
+			unsigned Previous = 0;
+			unsigned Next = 0;
+			unsigned PreviousFree = 0;
+			unsigned NextFree = 0;
+
+			bool IsFree = false;
+			bool IsKept = false;
+		};
+
+		static constexpr size_t SecondLevelBits = 4;
+		static constexpr size_t SecondLevels = 1 << SecondLevelBits;
+		static constexpr size_t FirstLevels = 64 - SecondLevelBits + 1;
+
+		static void mapping(const size_t count, size_t& firstLevel, size_t& secondLevel);
+
+		auto createBlock() -> unsigned;
+
+		void destroyBlock(const unsigned block);
+
+		void insertFreeBlock(const unsigned block);
+
+		void removeFreeBlock(const unsigned block);
+
+		//find a free block that has at least count elements, the count is rounded up to the next size class
+		//so any block in the class found is large enough
+		auto findFreeBlock(const size_t count) const -> unsigned;
+
+		//mark the free block used, the elements after count are split into a new free block
+		void useBlock(const unsigned block, const size_t count, const Identity& owner);
+	private:
+		std::vector<Block> mBlocks;
+		std::vector<unsigned> mUnusedBlocks;
+
+		std::array<std::array<unsigned, SecondLevels>, FirstLevels> mFreeLists;
+		std::array<unsigned, FirstLevels> mSecondLevelBitmaps;
+		unsigned long long mFirstLevelBitmap = 0;
+
+		//the used blocks indexed by their offsets, so we can release them with offset
+		std::unordered_map<size_t, unsigned> mUsedBlocks;
+
+		unsigned mLastBlock = 0;
+
+		size_t mCapacity = 0;
+		size_t mEnd = 0;
+		size_t mUsed = 0;
+		size_t mFreeRanges = 0;
+	};
+
+}
@@ -0,0 +1,313 @@
+#include "ShadowAtlasAllocator.hpp"
+
+#include <algorithm>
+
+namespace LRTR {
+
+	//the max extent of texture 2d in DirectX12
+	constexpr size_t MaxAtlasExtent = 16384;
+
+	inline auto tileKey(const ShadowAtlasTile& tile) -> unsigned long long
+	{
+		return (static_cast<unsigned long long>(tile.X) << 32) | tile.Y;
+	}
+
+	inline auto keyTile(const unsigned long long key) -> ShadowAtlasTile
+	{
+		return ShadowAtlasTile(static_cast<unsigned>(key >> 32), static_cast<unsigned>(key & 0xffffffffull));
+	}
+
+	inline auto roundUpPowerOfTwo(const size_t value) -> size_t
+	{
+		size_t result = 1;
+
+		while (result < value) result = result << 1;
+
+		return result;
+	}
+
+}
+
+LRTR::ShadowAtlasAllocator::ShadowAtlasAllocator(
+	const size_t budget, const size_t texelSize,
+	const size_t minResolution, const size_t maxResolution) :
+	mBudget(budget)
+{
+	mExtent = 1;
+
+	while (mExtent < MaxAtlasExtent && (mExtent * 2) * (mExtent * 2) * texelSize <= budget) mExtent = mExtent * 2;
+
+	//the atlas can hold at least one light with max resolution, it has 16 tiles with 1/4 extent
+	mMaxResolution = std::max(std::min(roundUpPowerOfTwo(maxResolution), mExtent / 4), static_cast<size_t>(1));
+	mMinResolution = std::min(roundUpPowerOfTwo(std::max(minResolution, static_cast<size_t>(1))), mMaxResolution);
+
+	clear();
+}
+
+void LRTR::ShadowAtlasAllocator::beginFrame()
+{
+	mFrame++;
+	mEvictions = 0;
+}
+
+auto LRTR::ShadowAtlasAllocator::allocate(const std::vector<ShadowAtlasRequest>& requests) -> std::vector<const ShadowAtlasSlot*>
+{
+	//mark the slots of all requests first, so allocating one light never evicts a light we need in this frame
+	for (const auto& request : requests) {
+		const auto it = mSlots.find(request.Owner);
+
+		if (it != mSlots.end()) it->second.LastUsed = mFrame;
+	}
+
+	std::vector<const ShadowAtlasSlot*> slots;
+
+	slots.reserve(requests.size());
+
+	for (const auto& request : requests) slots.push_back(allocate(request.Owner, request.Resolution));
+
+	return slots;
+}
+
+void LRTR::ShadowAtlasAllocator::release(const Identity& owner)
+{
+	const auto it = mSlots.find(owner);
+
+	if (it == mSlots.end()) return;
+
+	freeSlot(it->second);
+	mSlots.erase(it);
+}
+
+void LRTR::ShadowAtlasAllocator::clear()
+{
+	mSlots.clear();
+	mFreeTiles.clear();
+	mFreeTiles.resize(level(mMinResolution) + 1);
+	mFreeTiles[0].insert(tileKey(ShadowAtlasTile(0, 0)));
+
+	mUsedTexels = 0;
+}
+
+auto LRTR::ShadowAtlasAllocator::resolution(const float screenSize) const noexcept -> size_t
+{
+	const auto wanted = static_cast<size_t>(std::max(screenSize * 0.5f, 0.0f));
+
+	return std::clamp(roundUpPowerOfTwo(wanted), mMinResolution, mMaxResolution);
+}
+
+auto LRTR::ShadowAtlasAllocator::find(const Identity& owner) const noexcept -> const ShadowAtlasSlot*
+{
+	const auto it = mSlots.find(owner);
+
+	return it != mSlots.end() ? &it->second : nullptr;
+}
+
+auto LRTR::ShadowAtlasAllocator::extent() const noexcept -> size_t
+{
+	return mExtent;
+}
+
+auto LRTR::ShadowAtlasAllocator::budget() const noexcept -> size_t
+{
+	return mBudget;
+}
+
+auto LRTR::ShadowAtlasAllocator::minResolution() const noexcept -> size_t
+{
+	return mMinResolution;
+}
+
+auto LRTR::ShadowAtlasAllocator::maxResolution() const noexcept -> size_t
+{
+	return mMaxResolution;
+}
+
+auto LRTR::ShadowAtlasAllocator::usedTexels() const noexcept -> size_t
+{
+	return mUsedTexels;
+}
+
+auto LRTR::ShadowAtlasAllocator::size() const noexcept -> size_t
+{
+	return mSlots.size();
+}
+
+auto LRTR::ShadowAtlasAllocator::evictions() const noexcept -> size_t
+{
+	return mEvictions;
+}
+
+auto LRTR::ShadowAtlasAllocator::level(const size_t resolution) const noexcept -> size_t
+{
+	size_t result = 0;
+
+	while ((mExtent >> result) > resolution) result++;
+
+	return result;
+}
+
+auto LRTR::ShadowAtlasAllocator::allocate(const Identity& owner, const size_t resolution) -> const ShadowAtlasSlot*
+{
+	const auto wanted = std::clamp(roundUpPowerOfTwo(resolution), mMinResolution, mMaxResolution);
+
+	const auto it = mSlots.find(owner);
+
+	if (it != mSlots.end()) {
+		auto& current = it->second;
+
+		current.LastUsed = mFrame;
+
+		//we do not shrink the slot by one level, so the slot is not reallocated when the light moves a little
+		if (current.Resolution == wanted || current.Resolution == wanted * 2) return &current;
+
+		//the slot was reduced when the atlas was full, we try to find a larger one for it
+		//if there is no space, we keep the slot, so the content of it is still valid
+		if (current.Resolution < wanted) {
+			ShadowAtlasSlot slot;
+
+			for (auto larger = wanted; larger > current.Resolution; larger = larger / 2) {
+				if (!allocateSlotOrEvict(slot, larger)) continue;
+
+				freeSlot(current);
+
+				slot.Identifier = ++mIdentifier;
+				slot.LastUsed = mFrame;
+
+				return &(current = slot);
+			}
+
+			return &current;
+		}
+
+		freeSlot(current);
+		mSlots.erase(it);
+	}
+
+	ShadowAtlasSlot slot;
+
+	for (auto current = wanted; current >= mMinResolution; current = current / 2) {
+		//the slots not used in this frame are evicted before we reduce the resolution
+		if (!allocateSlotOrEvict(slot, current)) continue;
+
+		slot.Identifier = ++mIdentifier;
+		slot.LastUsed = mFrame;
+
+		return &(mSlots[owner] = slot);
+	}
+
+	return nullptr;
+}
+
+auto LRTR::ShadowAtlasAllocator::allocateTile(const size_t level, ShadowAtlasTile& tile) -> bool
+{
+	//find the smallest free tile that is not smaller than the tile we need
+	auto current = static_cast<int>(level);
+
+	while (current >= 0 && mFreeTiles[current].empty()) current--;
+
+	if (current < 0) return false;
+
+	tile = keyTile(*mFreeTiles[current].begin());
+
+	mFreeTiles[current].erase(mFreeTiles[current].begin());
+
+	//split the tile until it is the level we need, the top-left child is used and others are free
+	for (; current < static_cast<int>(level); current++) {
+		const auto half = static_cast<unsigned>(mExtent >> (current + 1));
+
+		mFreeTiles[current + 1].insert(tileKey(ShadowAtlasTile(tile.X + half, tile.Y)));
+		mFreeTiles[current + 1].insert(tileKey(ShadowAtlasTile(tile.X, tile.Y + half)));
+		mFreeTiles[current + 1].insert(tileKey(ShadowAtlasTile(tile.X + half, tile.Y + half)));
+	}
+
+	return true;
+}
+
+void LRTR::ShadowAtlasAllocator::freeTile(size_t level, ShadowAtlasTile tile)
+{
+	//merge the tile with its buddies if all of them are free
+	while (level > 0) {
+		const auto size = static_cast<unsigned>(mExtent >> level);
+		const auto parent = ShadowAtlasTile(tile.X & ~(size * 2 - 1), tile.Y & ~(size * 2 - 1));
+
+		const std::array<ShadowAtlasTile, 4> children = {
+			ShadowAtlasTile(parent.X, parent.Y),
+			ShadowAtlasTile(parent.X + size, parent.Y),
+			ShadowAtlasTile(parent.X, parent.Y + size),
+			ShadowAtlasTile(parent.X + size, parent.Y + size)
+		};
+
+		auto& freeTiles = mFreeTiles[level];
+
+		const auto merged = std::all_of(children.begin(), children.end(), [&](const ShadowAtlasTile& child)
+			{
+				return (child.X == tile.X && child.Y == tile.Y) || freeTiles.find(tileKey(child)) != freeTiles.end();
+			});
+
+		if (!merged) break;
+
+		for (const auto& child : children) freeTiles.erase(tileKey(child));
+
+		tile = parent;
+		level--;
+	}
+
+	mFreeTiles[level].insert(tileKey(tile));
+}
+
+auto LRTR::ShadowAtlasAllocator::allocateSlot(ShadowAtlasSlot& slot, const size_t resolution) -> bool
+{
+	const auto tileLevel = level(resolution);
+
+	for (size_t face = 0; face < slot.Tiles.size(); face++) {
+		if (allocateTile(tileLevel, slot.Tiles[face])) continue;
+
+		//we can not allocate all faces, so we free the faces we allocated
+		for (size_t index = 0; index < face; index++) freeTile(tileLevel, slot.Tiles[index]);
+
+		return false;
+	}
+
+	slot.Resolution = resolution;
+
+	mUsedTexels = mUsedTexels + resolution * resolution * slot.Tiles.size();
+
+	return true;
+}
+
+void LRTR::ShadowAtlasAllocator::freeSlot(const ShadowAtlasSlot& slot)
+{
+	const auto tileLevel = level(slot.Resolution);
+
+	for (const auto& tile : slot.Tiles) freeTile(tileLevel, tile);
+
+	mUsedTexels = mUsedTexels - slot.Resolution * slot.Resolution * slot.Tiles.size();
+}
+
+auto LRTR::ShadowAtlasAllocator::allocateSlotOrEvict(ShadowAtlasSlot& slot, const size_t resolution) -> bool
+{
+	auto allocated = allocateSlot(slot, resolution);
+
+	while (!allocated && evict()) allocated = allocateSlot(slot, resolution);
+
+	return allocated;
+}
+
+auto LRTR::ShadowAtlasAllocator::evict() -> bool
+{
+	auto victim = mSlots.end();
+
+	for (auto it = mSlots.begin(); it != mSlots.end(); ++it) {
+		if (it->second.LastUsed >= mFrame) continue;
+
+		if (victim == mSlots.end() || it->second.LastUsed < victim->second.LastUsed) victim = it;
+	}
+
+	if (victim == mSlots.end()) return false;
+
+	freeSlot(victim->second);
+	mSlots.erase(victim);
+	mEvictions++;
+
+	return true;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+#include "../../Core/TypeInfo.hpp"
+
+#include <unordered_map>
+#include <vector>
+#include <array>
+#include <set>
+
+namespace LRTR {
+
+	//the tile is a square region of atlas, the position is the top-left texel of it
+	struct ShadowAtlasTile {
+		unsigned X = 0;
+		unsigned Y = 0;
+
+		ShadowAtlasTile() = default;
+
+		ShadowAtlasTile(const unsigned x, const unsigned y) : X(x), Y(y) {}
+	};
+
+	//the slot of a point light, it has six tiles with same resolution for the faces of cube
+	//the identifier is unique for each allocation, if it is changed the content of tiles is invalid
+	struct ShadowAtlasSlot {
+		std::array<ShadowAtlasTile, 6> Tiles;
+
+		size_t Resolution = 0;
+		size_t Identifier = 0;
+		size_t LastUsed = 0;
+	};
+
+	//the light that needs a slot in this frame, the resolution is the one it wants before clamping
+	struct ShadowAtlasRequest {
+		Identity Owner = 0;
+		size_t Resolution = 0;
+
+		ShadowAtlasRequest() = default;
+
+		ShadowAtlasRequest(const Identity& owner, const size_t resolution) : Owner(owner), Resolution(resolution) {}
+	};
+
+	//the shadow atlas allocator assigns the tiles of a square atlas to the point lights
+	//the atlas is divided as a quadtree (2D buddy allocator), so the tiles of power of two are packed without fragments
+	//the slots are kept across frames and evicted by LRU order only when there is not enough space
+	class ShadowAtlasAllocator : public Noncopyable {
+	public:
+		//the extent of atlas is the largest power of two that the memory of atlas is not greater than budget
+		explicit ShadowAtlasAllocator(
+			const size_t budget = 64 * 1024 * 1024,
+			const size_t texelSize = 4,
+			const size_t minResolution = 64,
+			const size_t maxResolution = 1024);
+
+		~ShadowAtlasAllocator() = default;
+
+		//start a new frame, the slots used in this frame can not be evicted
+		void beginFrame();
+
+		//allocate or reuse the slots of all lights in this frame, the requests are allocated in order
+		//so the lights with larger resolution should be first
+		//the resolution will be rounded up to power of two and clamped, if there is not enough space
+		//we evict the slots not requested in this frame and reduce the resolution
+		//the slot is nullptr if we can not allocate it even with min resolution
+		auto allocate(const std::vector<ShadowAtlasRequest>& requests) -> std::vector<const ShadowAtlasSlot*>;
+
+		void release(const Identity& owner);
+
+		void clear();
+
+		//the resolution for a light that covers screenSize pixels on the screen
+		//the face of cube covers 90 degrees, so it needs about half of pixels of the light
+		auto resolution(const float screenSize) const noexcept -> size_t;
+
+		auto find(const Identity& owner) const noexcept -> const ShadowAtlasSlot*;
+
+		auto extent() const noexcept -> size_t;
+
+		auto budget() const noexcept -> size_t;
+
+		auto minResolution() const noexcept -> size_t;
+
+		auto maxResolution() const noexcept -> size_t;
+
+		//the texels of tiles allocated by slots
+		auto usedTexels() const noexcept -> size_t;
+
+		auto size() const noexcept -> size_t;
+
+		//the number of slots evicted since the frame began
+		auto evictions() const noexcept -> size_t;
+	private:
+		auto level(const size_t resolution) const noexcept -> size_t;
+
+		auto allocate(const Identity& owner, const size_t resolution) -> const ShadowAtlasSlot*;
+
+		auto allocateTile(const size_t level, ShadowAtlasTile& tile) -> bool;
+
+		void freeTile(size_t level, ShadowAtlasTile tile);
+
+		auto allocateSlot(ShadowAtlasSlot& slot, const size_t resolution) -> bool;
+
+		void freeSlot(const ShadowAtlasSlot& slot);
+
+		//allocate the slot, evict the slots not used in this frame if there is not enough space
+		auto allocateSlotOrEvict(ShadowAtlasSlot& slot, const size_t resolution) -> bool;
+
+		//evict the least recently used slot that is not used in this frame, return false if there is no one
+		auto evict() -> bool;
+	private:
+		//the free tiles of each level, level 0 is the whole atlas
+		//the key is (x << 32) | y, so we can find the buddies of tile when we free it
+		std::vector<std::set<unsigned long long>> mFreeTiles;
+
+		std::unordered_map<Identity, ShadowAtlasSlot> mSlots;
+
+		size_t mExtent = 0;
+		size_t mBudget = 0;
+		size_t mMinResolution = 0;
+		size_t mMaxResolution = 0;
+		size_t mUsedTexels = 0;
+
+		size_t mFrame = 0;
+		size_t mIdentifier = 0;
+		size_t mEvictions = 0;
+	};
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Math/Math.hpp"
+
+#include <limits>
+
+namespace LRTR {
+
+	//the axis aligned bounding box, the default bound is empty (min > max)
+	template<typename T>
+	struct Bound3 {
+		Vector3<T> Min = Vector3<T>(std::numeric_limits<T>::max());
+		Vector3<T> Max = Vector3<T>(std::numeric_limits<T>::lowest());
+
+		Bound3() = default;
+
+		Bound3(
+			const Vector3<T>& min,
+			const Vector3<T>& max) :
+			Min(min), Max(max) {}
+
+		bool empty() const noexcept {
+			return Min.x > Max.x || Min.y > Max.y || Min.z > Max.z;
+		}
+
+		auto center() const noexcept -> Vector3<T> {
+			return (Min + Max) * static_cast<T>(0.5);
+		}
+
+		//the half size of bound
+		auto extent() const noexcept -> Vector3<T> {
+			return (Max - Min) * static_cast<T>(0.5);
+		}
+
+		auto surfaceArea() const noexcept -> T {
+			if (empty()) return static_cast<T>(0);
+
+			const auto size = Max - Min;
+
+			return static_cast<T>(2) * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		void merge(const Vector3<T>& point) noexcept {
+			Min = glm::min(Min, point);
+			Max = glm::max(Max, point);
+		}
+
+		void merge(const Bound3<T>& bound) noexcept {
+			Min = glm::min(Min, bound.Min);
+			Max = glm::max(Max, bound.Max);
+		}
+
+		bool contain(const Vector3<T>& point) const noexcept {
+			return
+				point.x >= Min.x && point.x <= Max.x &&
+				point.y >= Min.y && point.y <= Max.y &&
+				point.z >= Min.z && point.z <= Max.z;
+		}
+
+		bool overlap(const Bound3<T>& bound) const noexcept {
+			return
+				Min.x <= bound.Max.x && Max.x >= bound.Min.x &&
+				Min.y <= bound.Max.y && Max.y >= bound.Min.y &&
+				Min.z <= bound.Max.z && Max.z >= bound.Min.z;
+		}
+
+		bool overlap(const Vector3<T>& center, const T radius) const noexcept {
+			//the distance from center to the closest point in bound
+			const auto offset = center - glm::clamp(center, Min, Max);
+
+			return glm::dot(offset, offset) <= radius * radius;
+		}
+
+		//transform the center and extent instead of eight corners, the result is the
+		//bound of transformed box, matrix is column major and the last row is (0, 0, 0, 1)
+		auto transform(const Matrix4x4<T>& matrix) const noexcept -> Bound3<T> {
+			if (empty()) return Bound3<T>();
+
+			const auto center = Vector3<T>(matrix * Vector4<T>(this->center(), static_cast<T>(1)));
+			const auto extent = this->extent();
+
+			const auto transformed =
+				glm::abs(Vector3<T>(matrix[0])) * extent.x +
+				glm::abs(Vector3<T>(matrix[1])) * extent.y +
+				glm::abs(Vector3<T>(matrix[2])) * extent.z;
+
+			return Bound3<T>(center - transformed, center + transformed);
+		}
+	};
+
+	using Bound3f = Bound3<float>;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Bound.hpp"
+
+#include <array>
+
+namespace LRTR {
+
+	//the frustum is stored as six planes (left, right, bottom, top, near, far)
+	//the plane is (normal, distance) and the normal points to the inside of frustum
+	template<typename T>
+	struct Frustum {
+		std::array<Vector4<T>, 6> Planes;
+
+		Frustum() = default;
+
+		//extract the planes from projection * view matrix, the matrix is column major
+		//we use [-1, 1] as the depth range of near plane, it is conservative for [0, 1]
+		explicit Frustum(const Matrix4x4<T>& matrix) {
+			const auto row = [&](const int index)
+			{
+				return Vector4<T>(matrix[0][index], matrix[1][index], matrix[2][index], matrix[3][index]);
+			};
+
+			const auto row0 = row(0);
+			const auto row1 = row(1);
+			const auto row2 = row(2);
+			const auto row3 = row(3);
+
+			Planes[0] = row3 + row0;
+			Planes[1] = row3 - row0;
+			Planes[2] = row3 + row1;
+			Planes[3] = row3 - row1;
+			Planes[4] = row3 + row2;
+			Planes[5] = row3 - row2;
+
+			for (auto& plane : Planes) {
+				const auto length = glm::length(Vector3<T>(plane));
+
+				if (length > static_cast<T>(0)) plane = plane / length;
+			}
+		}
+
+		//the bound is outside if it is on the negative side of any plane
+		bool intersect(const Bound3<T>& bound) const noexcept {
+			const auto center = bound.center();
+			const auto extent = bound.extent();
+
+			for (const auto& plane : Planes) {
+				const auto normal = Vector3<T>(plane);
+				const auto radius = glm::dot(extent, glm::abs(normal));
+
+				if (glm::dot(normal, center) + plane.w + radius < static_cast<T>(0)) return false;
+			}
+
+			return true;
+		}
+
+		bool intersect(const Vector3<T>& center, const T radius) const noexcept {
+			for (const auto& plane : Planes)
+				if (glm::dot(Vector3<T>(plane), center) + plane.w + radius < static_cast<T>(0)) return false;
+
+			return true;
+		}
+	};
+
+	using FrustumF = Frustum<float>;
+}
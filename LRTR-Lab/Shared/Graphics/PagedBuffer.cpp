@@ -0,0 +1,139 @@
+#include "PagedBuffer.hpp"
+
+#include "ResourceHelper.hpp"
+
+#include <algorithm>
+
+LRTR::PagedBuffer::PagedBuffer(
+	const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
+	const std::vector<size_t>& strides,
+	const bool indexBuffer,
+	const size_t pageSize) :
+	mDevice(device), mStrides(strides), mIndexBuffer(indexBuffer), mPageSize(pageSize)
+{
+}
+
+auto LRTR::PagedBuffer::allocate(const size_t count, const Identity& owner) -> PagedRange
+{
+	//the ranges are allocated in the first page that has space, so the older pages are filled first
+	for (size_t index = 0; index < mPages.size(); index++) {
+		auto& page = mPages[index];
+
+		if (page.Allocator == nullptr || page.Allocator->capacity() != mPageSize) continue;
+
+		const auto offset = page.Allocator->allocate(count, owner);
+
+		if (offset != RangeAllocator::InvalidOffset) return PagedRange(index, offset);
+	}
+
+	//the released page is reused for the new page, so the number of pages does not grow in long sessions
+	auto index = static_cast<size_t>(0);
+
+	while (index < mPages.size() && mPages[index].Allocator != nullptr) index++;
+
+	if (index == mPages.size()) mPages.push_back(Page());
+
+	createPage(mPages[index], std::max(count, mPageSize));
+
+	return PagedRange(index, mPages[index].Allocator->allocate(count, owner));
+}
+
+void LRTR::PagedBuffer::release(const PagedRange& range)
+{
+	auto& page = mPages[range.Page];
+
+	if (page.Allocator == nullptr) return;
+
+	page.Allocator->release(range.Offset);
+}
+
+void LRTR::PagedBuffer::keep(const PagedRange& range)
+{
+	if (mPages[range.Page].Allocator == nullptr) return;
+
+	mPages[range.Page].Allocator->keep(range.Offset);
+}
+
+void LRTR::PagedBuffer::destroyPage(const size_t page)
+{
+	if (!empty(page)) return;
+
+	mPages[page].Allocator.reset();
+	mPages[page].Buffers.clear();
+}
+
+auto LRTR::PagedBuffer::empty(const size_t page) const noexcept -> bool
+{
+	return mPages[page].Allocator != nullptr && mPages[page].Allocator->used() == 0;
+}
+
+void LRTR::PagedBuffer::upload(const size_t stream, const PagedRange& range, const void* data, const size_t count)
+{
+	CodeRed::ResourceHelper::updateBuffer(mPages[range.Page].Buffers[stream], data,
+		mStrides[stream] * range.Offset,
+		mStrides[stream] * count);
+}
+
+auto LRTR::PagedBuffer::relocateLast(const size_t page, RangeRelocation& relocation, const bool keepSource) -> bool
+{
+	if (mPages[page].Allocator == nullptr) return false;
+
+	return mPages[page].Allocator->relocateLast(relocation, keepSource);
+}
+
+auto LRTR::PagedBuffer::buffers(const size_t page) const -> const std::vector<std::shared_ptr<CodeRed::GpuBuffer>>&
+{
+	return mPages[page].Buffers;
+}
+
+auto LRTR::PagedBuffer::buffer(const size_t page, const size_t stream) const -> std::shared_ptr<CodeRed::GpuBuffer>
+{
+	return page < mPages.size() && !mPages[page].Buffers.empty() ? mPages[page].Buffers[stream] : nullptr;
+}
+
+auto LRTR::PagedBuffer::pages() const noexcept -> size_t
+{
+	return mPages.size();
+}
+
+auto LRTR::PagedBuffer::used() const noexcept -> size_t
+{
+	size_t used = 0;
+
+	for (const auto& page : mPages) if (page.Allocator != nullptr) used = used + page.Allocator->used();
+
+	return used;
+}
+
+auto LRTR::PagedBuffer::unused() const noexcept -> size_t
+{
+	size_t unused = 0;
+
+	for (const auto& page : mPages) if (page.Allocator != nullptr) unused = unused + page.Allocator->unused();
+
+	return unused;
+}
+
+auto LRTR::PagedBuffer::fragmentation() const noexcept -> float
+{
+	auto fragmentation = 0.0f;
+
+	for (const auto& page : mPages)
+		if (page.Allocator != nullptr) fragmentation = std::max(fragmentation, page.Allocator->fragmentation());
+
+	return fragmentation;
+}
+
+void LRTR::PagedBuffer::createPage(Page& page, const size_t count)
+{
+	page.Allocator = std::make_unique<RangeAllocator>(count);
+	page.Buffers.clear();
+
+	for (const auto& stride : mStrides) {
+		page.Buffers.push_back(mDevice->createBuffer(
+			mIndexBuffer ?
+			CodeRed::ResourceInfo::IndexBuffer(stride, count, CodeRed::MemoryHeap::Upload) :
+			CodeRed::ResourceInfo::VertexBuffer(stride, count, CodeRed::MemoryHeap::Upload)
+		));
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../Allocators/RangeAllocator.hpp"
+
+#include <CodeRed/Core/CodeRedGraphics.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace LRTR {
+
+	//the range in paged buffer, the offset is the location of first element in its page
+	struct PagedRange {
+		size_t Page = 0;
+		size_t Offset = 0;
+
+		PagedRange() = default;
+
+		PagedRange(const size_t page, const size_t offset) : Page(page), Offset(offset) {}
+	};
+
+	//the paged buffer is a group of streams (e.g. the properties of vertices) that have the same element count
+	//the elements are in pages with fixed count and each page has one buffer for each stream
+	//the ranges are allocated in one page and never straddle pages, so a draw only binds the buffers of one page
+	//the buffer grows by adding pages, so the elements in old pages are never copied
+	class PagedBuffer : public Noncopyable {
+	public:
+		explicit PagedBuffer(
+			const std::shared_ptr<CodeRed::GpuLogicalDevice>& device,
+			const std::vector<size_t>& strides,
+			const bool indexBuffer,
+			const size_t pageSize);
+
+		~PagedBuffer() = default;
+
+		//the range that is larger than page size has its own page with the same size of it
+		auto allocate(const size_t count, const Identity& owner = 0) -> PagedRange;
+
+		//release the range, the page is kept even if it is empty, so the buffers bound by frames in flight are valid
+		void release(const PagedRange& range);
+
+		//keep the range until it is released, the kept range is never relocated, see RangeAllocator::keep
+		void keep(const PagedRange& range);
+
+		//destroy the buffers of page if it is empty, the caller should make sure no frame in flight uses them
+		//the page keeps its index, so the ranges in other pages are not changed
+		void destroyPage(const size_t page);
+
+		auto empty(const size_t page) const noexcept -> bool;
+
+		//write count elements of stream into the range, the buffers are in upload heap so we write them directly
+		void upload(const size_t stream, const PagedRange& range, const void* data, const size_t count);
+
+		//move the last range of page into a free range before it, see RangeAllocator::relocateLast
+		//the buffers of page are not changed, the caller copies the elements
+		auto relocateLast(const size_t page, RangeRelocation& relocation, const bool keepSource = false) -> bool;
+
+		auto buffers(const size_t page) const -> const std::vector<std::shared_ptr<CodeRed::GpuBuffer>>&;
+
+		auto buffer(const size_t page, const size_t stream) const -> std::shared_ptr<CodeRed::GpuBuffer>;
+
+		//the number of pages, include the pages destroyed
+		auto pages() const noexcept -> size_t;
+
+		//the elements allocated and the unused elements in free ranges of all pages
+		auto used() const noexcept -> size_t;
+
+		auto unused() const noexcept -> size_t;
+
+		//the largest fragmentation of pages
+		auto fragmentation() const noexcept -> float;
+	private:
+		struct Page {
+			std::unique_ptr<RangeAllocator> Allocator;
+			std::vector<std::shared_ptr<CodeRed::GpuBuffer>> Buffers;
+		};
+
+		void createPage(Page& page, const size_t count);
+	private:
+		std::shared_ptr<CodeRed::GpuLogicalDevice> mDevice;
+
+		std::vector<size_t> mStrides;
+		std::vector<Page> mPages;
+
+		bool mIndexBuffer = false;
+
+		size_t mPageSize = 0;
+	};
+
+}
@@ -2,62 +2,6 @@
 
 #include <stb_image.h>
 
-void CodeRed::ResourceHelper::updateBuffer(
-	const std::shared_ptr<GpuLogicalDevice>& device,
-	const std::shared_ptr<GpuCommandAllocator>& allocator,
-	const std::shared_ptr<GpuBuffer>& buffer, 
-	const void* data)
-{
-	updateBuffer(
-		device,
-		allocator,
-		device->createCommandQueue(),
-		buffer,
-		data);
-}
-
-void CodeRed::ResourceHelper::updateBuffer(
-	const std::shared_ptr<GpuLogicalDevice>& device,
-	const std::shared_ptr<GpuCommandAllocator>& allocator, 
-	const std::shared_ptr<GpuCommandQueue>& queue,
-	const std::shared_ptr<GpuBuffer>& buffer, 
-	const void* data)
-{
-	//first, we create the command list and command queue for copy resource
-	auto commandList = device->createGraphicsCommandList(allocator);
-	auto commandQueue = queue;
-
-	//create the upload buffer
-	const auto uploadBuffer = device->createBuffer(
-		ResourceInfo::UploadBuffer(buffer->stride(), buffer->count())
-	);
-
-	const auto memory = uploadBuffer->mapMemory();
-	std::memcpy(memory, data, uploadBuffer->size());
-	uploadBuffer->unmapMemory();
-
-	const auto oldLayout = buffer->layout();
-
-	//start recoding the copy commands
-	commandList->beginRecording();
-
-	//we need translate the buffer layout to copy-destination
-	commandList->layoutTransition(buffer, ResourceLayout::CopyDestination);
-
-	//copy upload buffer to buffer
-	//because the size of constant buffer may not equal stride * count(256bytes limit)
-	//so we use buffer size
-	commandList->copyBuffer(uploadBuffer, buffer, buffer->size());
-
-	//translate back the layout of buffer
-	commandList->layoutTransition(buffer, oldLayout);
-
-	//end recoding, execute and wait finish
-	commandList->endRecording();
-	commandQueue->execute({ commandList });
-	commandQueue->waitIdle();
-}
-
 void CodeRed::ResourceHelper::updateBuffer(
 	const std::shared_ptr<GpuBuffer>& buffer, 
 	const void* data, 
@@ -65,11 +9,7 @@ void CodeRed::ResourceHelper::updateBuffer(
 {
 	if (size == 0) return;
 	
-	const auto memory = buffer->mapMemory();
-
-	std::memcpy(memory, data, size);
-
-	buffer->unmapMemory();
+	std::memcpy(mappedMemory(buffer), data, size);
 }
 
 void CodeRed::ResourceHelper::updateBuffer(
@@ -82,11 +22,31 @@ void CodeRed::ResourceHelper::updateBuffer(
 	
 	const auto memory = 
 		reinterpret_cast<void*>(
-		reinterpret_cast<size_t>(buffer->mapMemory()) + offset);
+		reinterpret_cast<size_t>(mappedMemory(buffer)) + offset);
 	
 	std::memcpy(memory, data, size);
+}
+
+auto CodeRed::ResourceHelper::mappedMemory(const std::shared_ptr<GpuBuffer>& buffer) -> void*
+{
+	std::lock_guard<std::mutex> lock(mMappedMutex);
 
-	buffer->unmapMemory();
+	const auto it = mMappedMemories.find(buffer.get());
+
+	//the buffer at the same address may be a new one if the old one is released, so we check the reference
+	if (it != mMappedMemories.end() && !it->second.Buffer.expired()) return it->second.Memory;
+
+	//the released buffers are only removed when we map a new one, the buffers are unmapped when they are destroyed
+	for (auto mapped = mMappedMemories.begin(); mapped != mMappedMemories.end();) {
+		if (mapped->second.Buffer.expired()) mapped = mMappedMemories.erase(mapped);
+		else ++mapped;
+	}
+
+	const auto memory = buffer->mapMemory();
+
+	mMappedMemories[buffer.get()] = { buffer, memory };
+
+	return memory;
 }
 
 void CodeRed::ResourceHelper::copyBuffer(
@@ -96,13 +56,10 @@ void CodeRed::ResourceHelper::copyBuffer(
 {
 	const auto dstMemory =
 		reinterpret_cast<void*>(
-			reinterpret_cast<size_t>(destination->mapMemory()) + offset);
-	const auto srcMemory = source->mapMemory();
+			reinterpret_cast<size_t>(mappedMemory(destination)) + offset);
+	const auto srcMemory = mappedMemory(source);
 
 	std::memcpy(dstMemory, srcMemory, source->size());
-
-	destination->unmapMemory();
-	source->unmapMemory();
 }
 
 auto CodeRed::ResourceHelper::expandBuffer(
@@ -2,25 +2,14 @@
 
 #include <CodeRed/Core/CodeRedGraphics.hpp>
 
+#include <unordered_map>
+#include <mutex>
+
 namespace CodeRed {
 
 	class ResourceHelper {
 	public:
-		static void updateBuffer(
-			const std::shared_ptr<GpuLogicalDevice>& device,
-			const std::shared_ptr<GpuCommandAllocator> &allocator,
-			const std::shared_ptr<GpuBuffer>& buffer,
-			const void* data
-		);
-
-		static void updateBuffer(
-			const std::shared_ptr<GpuLogicalDevice>& device,
-			const std::shared_ptr<GpuCommandAllocator>& allocator,
-			const std::shared_ptr<GpuCommandQueue>& queue,
-			const std::shared_ptr<GpuBuffer>& buffer,
-			const void* data
-		);
-
+		//the buffers are in upload heap and kept mapped, so the update copies the data into the mapped memory
 		static void updateBuffer(
 			const std::shared_ptr<GpuBuffer>& buffer,
 			const void* data,
@@ -32,6 +21,11 @@ namespace CodeRed {
 			const size_t offset,
 			const size_t size);
 
+		//the memory of upload buffer, the buffer is mapped when it is first used and kept mapped until it is released
+		//so the buffers updated every frame do not map and unmap memory for each update
+		//do not call mapMemory or unmapMemory of the buffer after using it
+		static auto mappedMemory(const std::shared_ptr<GpuBuffer>& buffer) -> void*;
+
 		static void copyBuffer(
 			const std::shared_ptr<GpuBuffer>& destination,
 			const std::shared_ptr<GpuBuffer>& source,
@@ -79,6 +73,16 @@ namespace CodeRed {
 		) -> std::shared_ptr<GpuTexture>;
 	private:
 		static auto formatMapped(int channel) -> PixelFormat;
+	private:
+		struct MappedMemory {
+			std::weak_ptr<GpuBuffer> Buffer;
+
+			void* Memory = nullptr;
+		};
+
+		//the systems update their buffers in parallel, so the mapped memories are guarded by mutex
+		static inline std::unordered_map<GpuBuffer*, MappedMemory> mMappedMemories;
+		static inline std::mutex mMappedMutex;
 	};
 	
 }
\ No newline at end of file
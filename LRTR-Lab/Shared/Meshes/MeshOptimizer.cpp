@@ -0,0 +1,330 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace LRTR {
+
+	constexpr unsigned InvalidOptimizeVertex = ~0u;
+
+	//the FIFO cache with timestamps, the vertex is in cache if it was inserted in last size insertions
+	class VertexCacheSimulator {
+	public:
+		VertexCacheSimulator(const size_t vertexCount, const size_t cacheSize) :
+			mTimestamps(vertexCount, 0), mTime(cacheSize + 1), mCacheSize(cacheSize) {}
+
+		//return true if the vertex is not in cache (we need to transform it)
+		auto access(const unsigned vertex) -> bool
+		{
+			if (mTime - mTimestamps[vertex] <= mCacheSize) return false;
+
+			mTimestamps[vertex] = mTime++;
+
+			return true;
+		}
+
+		//the age of vertex in cache, it is larger than cache size if the vertex is not in cache
+		auto age(const unsigned vertex) const noexcept -> size_t { return mTime - mTimestamps[vertex]; }
+
+		//make all vertices not in cache
+		void flush() noexcept { mTime = mTime + mCacheSize + 1; }
+	private:
+		std::vector<size_t> mTimestamps;
+
+		size_t mTime;
+		size_t mCacheSize;
+	};
+
+}
+
+auto LRTR::MeshOptimizer::analyzeVertexCache(
+	const std::vector<unsigned>& indices,
+	const size_t vertexCount,
+	const size_t cacheSize) -> VertexCacheStatistics
+{
+	VertexCacheStatistics statistics;
+
+	if (indices.empty() || vertexCount == 0) return statistics;
+
+	VertexCacheSimulator cache(vertexCount, cacheSize);
+
+	std::vector<unsigned char> used(vertexCount, 0);
+
+	size_t usedCount = 0;
+
+	for (const auto& vertex : indices) {
+		if (cache.access(vertex)) statistics.Transformed++;
+
+		if (!used[vertex]) { used[vertex] = 1; usedCount++; }
+	}
+
+	statistics.ACMR = static_cast<float>(statistics.Transformed) / static_cast<float>(indices.size() / 3);
+	statistics.ATVR = static_cast<float>(statistics.Transformed) / static_cast<float>(usedCount);
+
+	return statistics;
+}
+
+auto LRTR::MeshOptimizer::optimizeVertexCache(
+	const std::vector<unsigned>& indices,
+	const size_t vertexCount,
+	std::vector<unsigned>* clusters,
+	const size_t cacheSize) -> std::vector<unsigned>
+{
+	const auto triangleCount = indices.size() / 3;
+
+	if (clusters != nullptr) clusters->clear();
+
+	if (triangleCount == 0 || vertexCount == 0) return indices;
+
+	//the live count of vertex is the number of triangles that use it and are not emitted
+	std::vector<unsigned> liveCounts(vertexCount, 0);
+	std::vector<unsigned> adjacencyOffsets(vertexCount + 1, 0);
+	std::vector<unsigned> adjacency(triangleCount * 3);
+
+	for (size_t index = 0; index < triangleCount * 3; index++) liveCounts[indices[index]]++;
+
+	for (size_t vertex = 0; vertex < vertexCount; vertex++)
+		adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveCounts[vertex];
+
+	{
+		auto offsets = adjacencyOffsets;
+
+		for (size_t index = 0; index < triangleCount * 3; index++)
+			adjacency[offsets[indices[index]]++] = static_cast<unsigned>(index / 3);
+	}
+
+	VertexCacheSimulator cache(vertexCount, cacheSize);
+
+	std::vector<unsigned char> emitted(triangleCount, 0);
+	std::vector<unsigned> deadEnds;
+	std::vector<unsigned> candidates;
+	std::vector<unsigned> result;
+
+	result.reserve(triangleCount * 3);
+
+	size_t cursor = 0;
+
+	//the dead end is the vertex we emitted recently, if there is no one we find the next vertex in input order
+	const auto skipDeadEnd = [&]()
+	{
+		while (!deadEnds.empty()) {
+			const auto vertex = deadEnds.back();
+
+			deadEnds.pop_back();
+
+			if (liveCounts[vertex] > 0) return vertex;
+		}
+
+		while (cursor < vertexCount) {
+			if (liveCounts[cursor] > 0) return static_cast<unsigned>(cursor);
+
+			cursor++;
+		}
+
+		return InvalidOptimizeVertex;
+	};
+
+	auto fanning = skipDeadEnd();
+
+	if (clusters != nullptr) clusters->push_back(0);
+
+	while (fanning != InvalidOptimizeVertex) {
+		candidates.clear();
+
+		//emit all triangles around the fanning vertex
+		for (auto offset = adjacencyOffsets[fanning]; offset < adjacencyOffsets[fanning + 1]; offset++) {
+			const auto triangle = adjacency[offset];
+
+			if (emitted[triangle]) continue;
+
+			for (size_t corner = 0; corner < 3; corner++) {
+				const auto vertex = indices[triangle * 3 + corner];
+
+				result.push_back(vertex);
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+
+				liveCounts[vertex]--;
+
+				cache.access(vertex);
+			}
+
+			emitted[triangle] = 1;
+		}
+
+		//the next fanning vertex is the oldest candidate that is still in cache after we emit its triangles
+		auto next = InvalidOptimizeVertex;
+		auto bestPriority = -1;
+
+		for (const auto& vertex : candidates) {
+			if (liveCounts[vertex] == 0) continue;
+
+			auto priority = 0;
+
+			if (cache.age(vertex) + 2 * liveCounts[vertex] <= cacheSize)
+				priority = static_cast<int>(cache.age(vertex));
+
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				next = vertex;
+			}
+		}
+
+		if (next == InvalidOptimizeVertex) {
+			next = skipDeadEnd();
+
+			if (next != InvalidOptimizeVertex && clusters != nullptr)
+				clusters->push_back(static_cast<unsigned>(result.size() / 3));
+		}
+
+		fanning = next;
+	}
+
+	return result;
+}
+
+auto LRTR::MeshOptimizer::optimizeOverdraw(
+	const std::vector<unsigned>& indices,
+	const std::vector<Vector3f>& positions,
+	const std::vector<unsigned>& clusters,
+	const float threshold,
+	const size_t cacheSize) -> std::vector<unsigned>
+{
+	const auto triangleCount = indices.size() / 3;
+
+	if (triangleCount == 0 || clusters.empty()) return indices;
+
+	//split the clusters, the cache is cold at the beginning of each cluster
+	//so we only split when the cluster is long enough to have a good ACMR
+	std::vector<unsigned> splitClusters;
+
+	{
+		VertexCacheSimulator cache(positions.size(), cacheSize);
+
+		for (size_t cluster = 0; cluster < clusters.size(); cluster++) {
+			const auto begin = static_cast<size_t>(clusters[cluster]);
+			const auto end = cluster + 1 < clusters.size() ? static_cast<size_t>(clusters[cluster + 1]) : triangleCount;
+
+			//the clusters are drawn in any order, so the ACMR of cluster with cold cache is what we need to keep
+			size_t clusterMisses = 0;
+
+			cache.flush();
+
+			for (auto index = begin * 3; index < end * 3; index++)
+				if (cache.access(indices[index])) clusterMisses++;
+
+			const auto targetACMR = static_cast<float>(clusterMisses) / static_cast<float>(end - begin) * threshold;
+
+			size_t start = begin;
+			size_t misses = 0;
+
+			cache.flush();
+
+			splitClusters.push_back(static_cast<unsigned>(begin));
+
+			for (auto triangle = begin; triangle < end; triangle++) {
+				for (size_t corner = 0; corner < 3; corner++)
+					if (cache.access(indices[triangle * 3 + corner])) misses++;
+
+				const auto count = triangle + 1 - start;
+
+				if (triangle + 1 < end && static_cast<float>(misses) <= targetACMR * static_cast<float>(count)) {
+					splitClusters.push_back(static_cast<unsigned>(triangle + 1));
+
+					start = triangle + 1;
+					misses = 0;
+
+					cache.flush();
+				}
+			}
+
+			//the tail after the last split is not checked, we merge it into the previous cluster if its ACMR is too large
+			if (start != begin && static_cast<float>(misses) > targetACMR * static_cast<float>(end - start))
+				splitClusters.pop_back();
+		}
+	}
+
+	//the centroid and the sum of area weighted normals of clusters
+	std::vector<Vector3f> centroids(splitClusters.size(), Vector3f(0));
+	std::vector<Vector3f> normals(splitClusters.size(), Vector3f(0));
+
+	auto meshCentroid = Vector3f(0);
+	auto meshArea = 0.0f;
+
+	for (size_t cluster = 0; cluster < splitClusters.size(); cluster++) {
+		const auto begin = static_cast<size_t>(splitClusters[cluster]);
+		const auto end = cluster + 1 < splitClusters.size() ? static_cast<size_t>(splitClusters[cluster + 1]) : triangleCount;
+
+		auto area = 0.0f;
+
+		for (auto triangle = begin; triangle < end; triangle++) {
+			const auto& v0 = positions[indices[triangle * 3 + 0]];
+			const auto& v1 = positions[indices[triangle * 3 + 1]];
+			const auto& v2 = positions[indices[triangle * 3 + 2]];
+
+			const auto normal = glm::cross(v1 - v0, v2 - v0);
+			const auto triangleArea = glm::length(normal) * 0.5f;
+
+			centroids[cluster] = centroids[cluster] + (v0 + v1 + v2) * (triangleArea / 3.0f);
+			normals[cluster] = normals[cluster] + normal;
+
+			area = area + triangleArea;
+		}
+
+		meshCentroid = meshCentroid + centroids[cluster];
+		meshArea = meshArea + area;
+
+		if (area > 0) centroids[cluster] = centroids[cluster] / area;
+	}
+
+	if (meshArea > 0) meshCentroid = meshCentroid / meshArea;
+
+	//the cluster facing away from the center of mesh is more likely to occlude others, so we draw it first
+	std::vector<float> sortKeys(splitClusters.size());
+	std::vector<unsigned> order(splitClusters.size());
+
+	for (size_t cluster = 0; cluster < splitClusters.size(); cluster++) {
+		const auto length = glm::length(normals[cluster]);
+
+		sortKeys[cluster] = length > 0 ? glm::dot(centroids[cluster] - meshCentroid, normals[cluster] / length) : 0.0f;
+		order[cluster] = static_cast<unsigned>(cluster);
+	}
+
+	std::stable_sort(order.begin(), order.end(),
+		[&](const unsigned left, const unsigned right) { return sortKeys[left] > sortKeys[right]; });
+
+	std::vector<unsigned> result;
+
+	result.reserve(indices.size());
+
+	for (const auto& cluster : order) {
+		const auto begin = static_cast<size_t>(splitClusters[cluster]);
+		const auto end = cluster + 1 < splitClusters.size() ? static_cast<size_t>(splitClusters[cluster + 1]) : triangleCount;
+
+		result.insert(result.end(), indices.begin() + begin * 3, indices.begin() + end * 3);
+	}
+
+	return result;
+}
+
+auto LRTR::MeshOptimizer::optimizeVertexFetch(
+	const std::vector<unsigned>& indices,
+	const size_t vertexCount) -> std::vector<unsigned>
+{
+	std::vector<unsigned> remap(vertexCount, InvalidOptimizeVertex);
+
+	unsigned next = 0;
+
+	for (const auto& vertex : indices)
+		if (remap[vertex] == InvalidOptimizeVertex) remap[vertex] = next++;
+
+	for (auto& vertex : remap)
+		if (vertex == InvalidOptimizeVertex) vertex = next++;
+
+	return remap;
+}
+
+void LRTR::MeshOptimizer::remapIndices(std::vector<unsigned>& indices, const std::vector<unsigned>& remap)
+{
+	for (auto& vertex : indices) vertex = remap[vertex];
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../Math/Math.hpp"
+
+#include <vector>
+
+namespace LRTR {
+
+	//the result of simulating the post-transform vertex cache with FIFO replacement
+	//ACMR is the transformed vertices per triangle, ATVR is the transformed vertices per used vertex
+	struct VertexCacheStatistics {
+		size_t Transformed = 0;
+
+		float ACMR = 0;
+		float ATVR = 0;
+	};
+
+	namespace MeshOptimizer {
+
+		//the size of FIFO cache we simulate and optimize for
+		constexpr size_t VertexCacheSize = 16;
+
+		auto analyzeVertexCache(
+			const std::vector<unsigned>& indices,
+			const size_t vertexCount,
+			const size_t cacheSize = VertexCacheSize) -> VertexCacheStatistics;
+
+		//reorder the triangles with tipsify, the triangles are emitted by fanning around the vertices in cache
+		//the clusters are the first triangles of sequences that start from a dead end (the cache is cold)
+		auto optimizeVertexCache(
+			const std::vector<unsigned>& indices,
+			const size_t vertexCount,
+			std::vector<unsigned>* clusters = nullptr,
+			const size_t cacheSize = VertexCacheSize) -> std::vector<unsigned>;
+
+		//reorder the clusters of triangles by the direction they face, so the outer clusters are drawn first
+		//the clusters are split into smaller clusters while their ACMR is not larger than threshold * ACMR of the cluster
+		auto optimizeOverdraw(
+			const std::vector<unsigned>& indices,
+			const std::vector<Vector3f>& positions,
+			const std::vector<unsigned>& clusters,
+			const float threshold = 1.05f,
+			const size_t cacheSize = VertexCacheSize) -> std::vector<unsigned>;
+
+		//the remap of vertices in the order they are first used, remap[old] = new
+		//the vertices that are not used are put after the used vertices
+		auto optimizeVertexFetch(
+			const std::vector<unsigned>& indices,
+			const size_t vertexCount) -> std::vector<unsigned>;
+
+		template<typename T>
+		void remapVertices(std::vector<T>& vertices, const std::vector<unsigned>& remap);
+
+		void remapIndices(std::vector<unsigned>& indices, const std::vector<unsigned>& remap);
+	}
+
+	template <typename T>
+	void MeshOptimizer::remapVertices(std::vector<T>& vertices, const std::vector<unsigned>& remap)
+	{
+		//the property that is not enough for all vertices is not used by mesh, we do not remap it
+		if (vertices.size() < remap.size()) return;
+
+		auto result = std::vector<T>(vertices.size());
+
+		for (size_t index = 0; index < remap.size(); index++) result[remap[index]] = vertices[index];
+		for (size_t index = remap.size(); index < vertices.size(); index++) result[index] = vertices[index];
+
+		vertices = std::move(result);
+	}
+
+}
@@ -0,0 +1,322 @@
+#include "MeshSimplifier.hpp"
+
+#include "../Bound.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+
+namespace LRTR {
+
+	//the level is dropped if it has more triangles than the ratio of previous level
+	constexpr float MinLevelReduction = 0.85f;
+
+	//the collapse is rejected if the normal of an adjacent triangle rotates more than about 75 degrees
+	constexpr float MinFlipCosine = 0.25f;
+
+	//the symmetric matrix of quadric error (A, B, C), the error of point p is p * A * p + 2 * B * p + C
+	//the planes are weighted by the area of triangles, so the error divided by weight is the mean square distance
+	struct Quadric {
+		float A00 = 0, A11 = 0, A22 = 0;
+		float A01 = 0, A02 = 0, A12 = 0;
+		float B0 = 0, B1 = 0, B2 = 0;
+		float C = 0;
+
+		float Weight = 0;
+
+		Quadric() = default;
+
+		Quadric(const Vector3f& normal, const float distance, const float weight) :
+			A00(normal.x * normal.x * weight), A11(normal.y * normal.y * weight), A22(normal.z * normal.z * weight),
+			A01(normal.x * normal.y * weight), A02(normal.x * normal.z * weight), A12(normal.y * normal.z * weight),
+			B0(normal.x * distance * weight), B1(normal.y * distance * weight), B2(normal.z * distance * weight),
+			C(distance * distance * weight), Weight(weight) {}
+
+		void merge(const Quadric& other) noexcept
+		{
+			A00 = A00 + other.A00; A11 = A11 + other.A11; A22 = A22 + other.A22;
+			A01 = A01 + other.A01; A02 = A02 + other.A02; A12 = A12 + other.A12;
+			B0 = B0 + other.B0; B1 = B1 + other.B1; B2 = B2 + other.B2;
+			C = C + other.C;
+
+			Weight = Weight + other.Weight;
+		}
+
+		auto error(const Vector3f& point) const noexcept -> float
+		{
+			const auto x = point.x;
+			const auto y = point.y;
+			const auto z = point.z;
+
+			const auto result =
+				x * x * A00 + y * y * A11 + z * z * A22 +
+				2 * (x * y * A01 + x * z * A02 + y * z * A12) +
+				2 * (x * B0 + y * B1 + z * B2) + C;
+
+			return Weight > 0 ? std::max(result / Weight, 0.0f) : 0.0f;
+		}
+	};
+
+	struct Collapse {
+		unsigned From;
+		unsigned To;
+
+		float Error;
+	};
+
+	inline auto triangleNormal(const Vector3f& v0, const Vector3f& v1, const Vector3f& v2) -> Vector3f
+	{
+		return glm::cross(v1 - v0, v2 - v0);
+	}
+
+}
+
+auto LRTR::MeshSimplifier::simplify(
+	const std::vector<Vector3f>& positions,
+	const std::vector<unsigned>& indices,
+	const size_t targetIndexCount,
+	const float maxError,
+	float* resultError) -> std::vector<unsigned>
+{
+	auto result = indices;
+	auto error = 0.0f;
+
+	if (resultError != nullptr) *resultError = 0;
+
+	if (positions.empty() || indices.size() <= targetIndexCount) return result;
+
+	Bound3f bound;
+
+	for (const auto& position : positions) bound.merge(position);
+
+	const auto scale = glm::length(bound.Max - bound.Min);
+
+	if (scale <= 0) return result;
+
+	const auto vertexCount = positions.size();
+	const auto maxSquareError = (maxError * scale) * (maxError * scale);
+
+	//the edge is on border if there is no edge with reverse direction, we lock the vertices of it
+	std::vector<unsigned char> locked(vertexCount, 0);
+
+	{
+		std::vector<std::pair<unsigned, unsigned>> edges;
+
+		edges.reserve(result.size());
+
+		for (size_t index = 0; index < result.size(); index = index + 3) {
+			for (size_t corner = 0; corner < 3; corner++)
+				edges.push_back({ result[index + corner], result[index + (corner + 1) % 3] });
+		}
+
+		std::sort(edges.begin(), edges.end());
+
+		for (const auto& edge : edges) {
+			if (std::binary_search(edges.begin(), edges.end(), std::make_pair(edge.second, edge.first))) continue;
+
+			locked[edge.first] = 1;
+			locked[edge.second] = 1;
+		}
+	}
+
+	std::vector<Quadric> quadrics(vertexCount);
+
+	for (size_t index = 0; index < result.size(); index = index + 3) {
+		const auto& v0 = positions[result[index + 0]];
+		const auto& v1 = positions[result[index + 1]];
+		const auto& v2 = positions[result[index + 2]];
+
+		const auto normal = triangleNormal(v0, v1, v2);
+		const auto length = glm::length(normal);
+
+		//the degenerate triangle does not have plane
+		if (length <= 0) continue;
+
+		const auto unit = normal / length;
+		const auto quadric = Quadric(unit, -glm::dot(unit, v0), length * 0.5f);
+
+		quadrics[result[index + 0]].merge(quadric);
+		quadrics[result[index + 1]].merge(quadric);
+		quadrics[result[index + 2]].merge(quadric);
+	}
+
+	std::vector<unsigned> remap(vertexCount);
+	std::vector<unsigned char> touched(vertexCount);
+
+	std::vector<unsigned> adjacencyOffsets(vertexCount + 1);
+	std::vector<unsigned> adjacency;
+
+	std::vector<std::pair<unsigned, unsigned>> edges;
+	std::vector<Collapse> collapses;
+
+	std::iota(remap.begin(), remap.end(), 0);
+
+	//each pass collapses the cheapest edges whose vertices are not changed in this pass
+	//so the costs and adjacency computed at the beginning of pass are still valid
+	while (result.size() > targetIndexCount) {
+		const auto triangleCount = result.size() / 3;
+
+		//the triangles adjacent to vertex v are adjacency[adjacencyOffsets[v], adjacencyOffsets[v + 1])
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+
+		for (const auto& vertex : result) adjacencyOffsets[vertex + 1]++;
+
+		for (size_t vertex = 0; vertex < vertexCount; vertex++) adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+
+		adjacency.resize(result.size());
+
+		{
+			auto offsets = adjacencyOffsets;
+
+			for (size_t index = 0; index < result.size(); index++)
+				adjacency[offsets[result[index]]++] = static_cast<unsigned>(index / 3);
+		}
+
+		edges.clear();
+		collapses.clear();
+
+		for (size_t index = 0; index < result.size(); index = index + 3) {
+			for (size_t corner = 0; corner < 3; corner++) {
+				const auto v0 = result[index + corner];
+				const auto v1 = result[index + (corner + 1) % 3];
+
+				edges.push_back({ std::min(v0, v1), std::max(v0, v1) });
+			}
+		}
+
+		std::sort(edges.begin(), edges.end());
+
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		for (const auto& edge : edges) {
+			if (locked[edge.first] && locked[edge.second]) continue;
+
+			auto quadric = quadrics[edge.first];
+
+			quadric.merge(quadrics[edge.second]);
+
+			//the locked vertex can not be moved, so it can only be the target of collapse
+			const auto firstError = locked[edge.first] ? std::numeric_limits<float>::max() : quadric.error(positions[edge.second]);
+			const auto secondError = locked[edge.second] ? std::numeric_limits<float>::max() : quadric.error(positions[edge.first]);
+
+			if (firstError <= secondError) collapses.push_back({ edge.first, edge.second, firstError });
+			else collapses.push_back({ edge.second, edge.first, secondError });
+		}
+
+		std::sort(collapses.begin(), collapses.end(),
+			[](const Collapse& left, const Collapse& right) { return left.Error < right.Error; });
+
+		std::fill(touched.begin(), touched.end(), 0);
+
+		const auto removeCount = (result.size() - targetIndexCount + 2) / 3;
+
+		size_t removed = 0;
+		size_t collapsed = 0;
+
+		for (const auto& collapse : collapses) {
+			if (collapse.Error > maxSquareError || removed >= removeCount) break;
+
+			if (touched[collapse.From] || touched[collapse.To]) continue;
+
+			//the triangles around the vertex we move must not be flipped, the triangles with both vertices
+			//of edge are removed, the vertices of triangles may be collapsed in this pass so we remap them
+			auto flipped = false;
+			size_t degenerated = 0;
+
+			for (auto offset = adjacencyOffsets[collapse.From]; offset < adjacencyOffsets[collapse.From + 1] && !flipped; offset++) {
+				const auto triangle = adjacency[offset];
+
+				const unsigned corners[3] = {
+					remap[result[triangle * 3 + 0]],
+					remap[result[triangle * 3 + 1]],
+					remap[result[triangle * 3 + 2]]
+				};
+
+				if (corners[0] == collapse.To || corners[1] == collapse.To || corners[2] == collapse.To) { degenerated++; continue; }
+
+				if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0]) continue;
+
+				Vector3f moved[3] = { positions[corners[0]], positions[corners[1]], positions[corners[2]] };
+
+				const auto before = triangleNormal(moved[0], moved[1], moved[2]);
+
+				for (size_t corner = 0; corner < 3; corner++)
+					if (corners[corner] == collapse.From) moved[corner] = positions[collapse.To];
+
+				const auto after = triangleNormal(moved[0], moved[1], moved[2]);
+
+				flipped = glm::dot(before, after) <= MinFlipCosine * glm::length(before) * glm::length(after);
+			}
+
+			if (flipped) continue;
+
+			remap[collapse.From] = collapse.To;
+			touched[collapse.From] = 1;
+			touched[collapse.To] = 1;
+
+			quadrics[collapse.To].merge(quadrics[collapse.From]);
+
+			error = std::max(error, collapse.Error);
+			removed = removed + degenerated;
+			collapsed++;
+		}
+
+		if (collapsed == 0) break;
+
+		//apply the collapses and remove the degenerate triangles
+		size_t write = 0;
+
+		for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+			const auto v0 = remap[result[triangle * 3 + 0]];
+			const auto v1 = remap[result[triangle * 3 + 1]];
+			const auto v2 = remap[result[triangle * 3 + 2]];
+
+			if (v0 == v1 || v1 == v2 || v2 == v0) continue;
+
+			result[write++] = v0;
+			result[write++] = v1;
+			result[write++] = v2;
+		}
+
+		result.resize(write);
+
+		//the collapsed vertices are not used by any triangle, so we can reset the remap
+		std::iota(remap.begin(), remap.end(), 0);
+	}
+
+	if (resultError != nullptr) *resultError = std::sqrt(error) / scale;
+
+	return result;
+}
+
+auto LRTR::MeshSimplifier::simplifyLevels(
+	const std::vector<Vector3f>& positions,
+	const std::vector<unsigned>& indices,
+	const size_t maxLevels,
+	const float ratio,
+	const float maxError) -> std::vector<MeshLevelOfDetail>
+{
+	std::vector<MeshLevelOfDetail> levels;
+
+	//the level is simplified from the previous one, so the error of level is the sum of errors
+	auto current = indices;
+	auto accumulatedError = 0.0f;
+
+	for (size_t level = 0; level < maxLevels; level++) {
+		const auto target = static_cast<size_t>(static_cast<float>(current.size() / 3) * ratio) * 3;
+
+		auto error = 0.0f;
+		auto next = simplify(positions, current, target, maxError, &error);
+
+		if (static_cast<float>(next.size()) > static_cast<float>(current.size()) * MinLevelReduction) break;
+
+		accumulatedError = accumulatedError + error;
+
+		levels.push_back(MeshLevelOfDetail(next, accumulatedError));
+
+		current = std::move(next);
+	}
+
+	return levels;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../Math/Math.hpp"
+
+#include <vector>
+
+namespace LRTR {
+
+	//the level of detail of mesh, the indices reference the vertices of original mesh
+	//the error is the distance between the level and original mesh relative to the diagonal of bound
+	struct MeshLevelOfDetail {
+		std::vector<unsigned> Indices;
+
+		float Error = 0;
+
+		MeshLevelOfDetail() = default;
+
+		MeshLevelOfDetail(const std::vector<unsigned>& indices, const float error) :
+			Indices(indices), Error(error) {}
+	};
+
+	namespace MeshSimplifier {
+
+		//collapse the edges with the smallest quadric error until the indices are not more than target
+		//or the error of next collapse is larger than max error (relative to the diagonal of bound)
+		//the vertex is collapsed into its neighbour instead of a new position, so the result uses the same vertices
+		//the vertices on borders of index space are locked, the seams of texture coordinates are borders too
+		auto simplify(
+			const std::vector<Vector3f>& positions,
+			const std::vector<unsigned>& indices,
+			const size_t targetIndexCount,
+			const float maxError,
+			float* resultError = nullptr) -> std::vector<unsigned>;
+
+		//build the chain of levels, each level has about ratio of the triangles of previous one
+		//we stop when the level can not reduce enough triangles, the level 0 (original mesh) is not in result
+		auto simplifyLevels(
+			const std::vector<Vector3f>& positions,
+			const std::vector<unsigned>& indices,
+			const size_t maxLevels = 4,
+			const float ratio = 0.5f,
+			const float maxError = 0.02f) -> std::vector<MeshLevelOfDetail>;
+
+	}
+
+}
@@ -0,0 +1,222 @@
+#include "MeshletBuilder.hpp"
+
+#include "../Bound.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <cmath>
+
+namespace LRTR {
+
+	constexpr unsigned InvalidMeshletTriangle = ~0u;
+
+	//the cone is not used if the normals are almost perpendicular to axis (about 84 degrees)
+	constexpr float MinConeCosine = 0.1f;
+
+}
+
+auto LRTR::MeshletBuilder::build(
+	const std::vector<Vector3f>& positions,
+	std::vector<unsigned>& indices,
+	const size_t maxVertices,
+	const size_t maxTriangles) -> std::vector<Meshlet>
+{
+	std::vector<Meshlet> meshlets;
+
+	const auto triangleCount = indices.size() / 3;
+	const auto vertexCount = positions.size();
+
+	if (triangleCount == 0 || vertexCount == 0) return meshlets;
+
+	//the triangles adjacent to vertex v are adjacency[adjacencyOffsets[v], adjacencyOffsets[v + 1])
+	std::vector<unsigned> adjacencyOffsets(vertexCount + 1, 0);
+	std::vector<unsigned> adjacency(triangleCount * 3);
+
+	for (size_t index = 0; index < triangleCount * 3; index++) adjacencyOffsets[indices[index] + 1]++;
+
+	for (size_t vertex = 0; vertex < vertexCount; vertex++) adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+
+	{
+		auto offsets = adjacencyOffsets;
+
+		for (size_t index = 0; index < triangleCount * 3; index++)
+			adjacency[offsets[indices[index]]++] = static_cast<unsigned>(index / 3);
+	}
+
+	//the owner[v] is the meshlet that uses vertex v, the shared[t] is the number of vertices of triangle t in meshlet
+	//the stamp[t] is the meshlet we count the shared vertices for, so we do not need to reset them for each meshlet
+	std::vector<unsigned> owners(vertexCount, InvalidMeshletTriangle);
+	std::vector<unsigned> stamps(triangleCount, InvalidMeshletTriangle);
+	std::vector<unsigned char> shared(triangleCount, 0);
+	std::vector<unsigned char> emitted(triangleCount, 0);
+	std::vector<unsigned> result;
+
+	//the candidates[n - 1] are the triangles that have n vertices in meshlet, the entries may be out of date
+	//so we check them when we pop them, the earlier one is used first so the meshlet grows around its first
+	//triangle in rings (it has more triangles than growing in strips), the heads are the first entries not popped
+	std::array<std::vector<unsigned>, 3> candidates;
+	std::array<size_t, 3> heads = { 0, 0, 0 };
+
+	result.reserve(triangleCount * 3);
+
+	size_t cursor = 0;
+
+	const auto current = [&]() { return static_cast<unsigned>(meshlets.size() - 1); };
+
+	const auto addVertex = [&](const unsigned vertex)
+	{
+		owners[vertex] = current();
+		meshlets.back().VertexCount++;
+
+		for (auto offset = adjacencyOffsets[vertex]; offset < adjacencyOffsets[vertex + 1]; offset++) {
+			const auto triangle = adjacency[offset];
+
+			if (emitted[triangle]) continue;
+
+			if (stamps[triangle] != current()) {
+				stamps[triangle] = current();
+				shared[triangle] = 0;
+			}
+
+			shared[triangle]++;
+
+			candidates[shared[triangle] - 1].push_back(triangle);
+		}
+	};
+
+	//the best candidate is the one uses fewest new vertices
+	const auto findCandidate = [&]()
+	{
+		for (auto level = 3; level > 0; level--) {
+			auto& bucket = candidates[level - 1];
+
+			auto& head = heads[level - 1];
+
+			while (head < bucket.size()) {
+				const auto triangle = bucket[head];
+
+				if (!emitted[triangle] && stamps[triangle] == current() && shared[triangle] == level) return triangle;
+
+				head++;
+			}
+		}
+
+		return InvalidMeshletTriangle;
+	};
+
+	const auto beginMeshlet = [&]()
+	{
+		Meshlet meshlet;
+
+		meshlet.IndexOffset = static_cast<unsigned>(result.size());
+
+		meshlets.push_back(meshlet);
+
+		for (auto& bucket : candidates) bucket.clear();
+		for (auto& head : heads) head = 0;
+	};
+
+	beginMeshlet();
+
+	for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+		//if there is no triangle adjacent to meshlet, we use the first triangle that is not emitted in input order
+		auto triangle = findCandidate();
+
+		if (triangle == InvalidMeshletTriangle) {
+			while (emitted[cursor]) cursor++;
+
+			triangle = static_cast<unsigned>(cursor);
+		}
+
+		const auto newVertices = 3 - (stamps[triangle] == current() ? shared[triangle] : 0);
+
+		if (meshlets.back().VertexCount + newVertices > maxVertices || meshlets.back().IndexCount / 3 + 1 > maxTriangles)
+			beginMeshlet();
+
+		emitted[triangle] = 1;
+
+		for (size_t corner = 0; corner < 3; corner++) {
+			const auto vertex = indices[triangle * 3 + corner];
+
+			if (owners[vertex] != current()) addVertex(vertex);
+
+			result.push_back(vertex);
+		}
+
+		meshlets.back().IndexCount = meshlets.back().IndexCount + 3;
+	}
+
+	indices = std::move(result);
+
+	for (auto& meshlet : meshlets) computeBound(positions, indices, meshlet);
+
+	return meshlets;
+}
+
+void LRTR::MeshletBuilder::computeBound(
+	const std::vector<Vector3f>& positions,
+	const std::vector<unsigned>& indices,
+	Meshlet& meshlet)
+{
+	const auto begin = static_cast<size_t>(meshlet.IndexOffset);
+	const auto end = begin + meshlet.IndexCount;
+
+	Bound3f bound;
+
+	for (auto index = begin; index < end; index++) bound.merge(positions[indices[index]]);
+
+	meshlet.Center = bound.empty() ? Vector3f(0) : bound.center();
+	meshlet.Radius = 0;
+
+	for (auto index = begin; index < end; index++)
+		meshlet.Radius = std::max(meshlet.Radius, glm::length(positions[indices[index]] - meshlet.Center));
+
+	//the normals of triangles, the degenerate triangles do not have normal so they do not limit the cone
+	std::vector<Vector3f> normals;
+
+	auto axis = Vector3f(0);
+
+	for (auto index = begin; index < end; index = index + 3) {
+		const auto& v0 = positions[indices[index + 0]];
+		const auto& v1 = positions[indices[index + 1]];
+		const auto& v2 = positions[indices[index + 2]];
+
+		const auto normal = glm::cross(v1 - v0, v2 - v0);
+		const auto length = glm::length(normal);
+
+		if (length <= 0) continue;
+
+		normals.push_back(normal / length);
+
+		axis = axis + normals.back();
+	}
+
+	meshlet.ConeAxis = Vector3f(0, 0, 1);
+	meshlet.ConeCutoff = 1;
+
+	const auto axisLength = glm::length(axis);
+
+	if (normals.empty() || axisLength <= 0) return;
+
+	axis = axis / axisLength;
+
+	auto minCosine = 1.0f;
+
+	for (const auto& normal : normals) minCosine = std::min(minCosine, glm::dot(axis, normal));
+
+	if (minCosine <= MinConeCosine) return;
+
+	//the normal cone has half angle a (cos(a) = minCosine), the triangles are back facing if the view direction
+	//is in the cone with half angle 90 - a around the axis, so the cutoff is cos(90 - a) = sin(a)
+	meshlet.ConeAxis = axis;
+	meshlet.ConeCutoff = std::sqrt(1.0f - minCosine * minCosine);
+}
+
+auto LRTR::MeshletBuilder::backFacing(const Meshlet& meshlet, const Vector3f& viewer) -> bool
+{
+	//the sphere makes the test conservative for all points of triangles, not only the center
+	const auto direction = meshlet.Center - viewer;
+
+	return glm::dot(direction, meshlet.ConeAxis) >= meshlet.ConeCutoff * glm::length(direction) + meshlet.Radius;
+}
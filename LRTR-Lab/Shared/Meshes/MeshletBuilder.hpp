@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../Math/Math.hpp"
+
+#include <vector>
+
+namespace LRTR {
+
+	//the meshlet is a range of triangles in the indices of mesh, the triangles use a few vertices
+	//the sphere and cone are in the local space of mesh, the triangles are in the sphere
+	//the cone is the directions the triangles face, the meshlet is back facing if the viewer is out of the cone
+	struct Meshlet {
+		unsigned IndexOffset = 0;
+		unsigned IndexCount = 0;
+		unsigned VertexCount = 0;
+
+		Vector3f Center = Vector3f(0);
+		float Radius = 0;
+
+		//the cutoff is the sine of the max angle between axis and normals of triangles
+		//it is 1 if the triangles face too different directions, so the meshlet is never back facing
+		Vector3f ConeAxis = Vector3f(0, 0, 1);
+		float ConeCutoff = 1;
+	};
+
+	namespace MeshletBuilder {
+
+		constexpr size_t MaxVertices = 64;
+		constexpr size_t MaxTriangles = 124;
+
+		//reorder the triangles into meshlets and return them, the indices are reordered in place
+		//the next triangle of meshlet is the one adjacent to meshlet and uses fewest new vertices
+		auto build(
+			const std::vector<Vector3f>& positions,
+			std::vector<unsigned>& indices,
+			const size_t maxVertices = MaxVertices,
+			const size_t maxTriangles = MaxTriangles) -> std::vector<Meshlet>;
+
+		//compute the sphere and cone of triangles in [offset, offset + count) of indices
+		void computeBound(
+			const std::vector<Vector3f>& positions,
+			const std::vector<unsigned>& indices,
+			Meshlet& meshlet);
+
+		//the meshlet is back facing if the viewer can not see any triangle of it, the viewer is in the local space
+		//the cone is only valid if the local space is a similarity transform of the space the viewer is from
+		auto backFacing(const Meshlet& meshlet, const Vector3f& viewer) -> bool;
+	}
+
+}
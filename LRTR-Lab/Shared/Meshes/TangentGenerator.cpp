@@ -0,0 +1,258 @@
+#include "TangentGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace LRTR {
+
+	//the number of triangles or vertices in one chunk of parallel for
+	constexpr size_t TangentGrain = 4096;
+
+	//the vertex is not split
+	constexpr unsigned InvalidSplitVertex = ~0u;
+
+	inline void tangentParallelFor(
+		ThreadPool* threadPool, const size_t count,
+		const std::function<void(size_t, size_t)>& function)
+	{
+		if (threadPool == nullptr || count <= TangentGrain) { if (count != 0) function(0, count); return; }
+
+		threadPool->parallelFor(count, TangentGrain, function);
+	}
+
+	//the angle between two edges, the zero edge has zero angle so it does not have weight
+	inline auto cornerAngle(const Vector3f& edge0, const Vector3f& edge1) -> float
+	{
+		const auto length0 = glm::length(edge0);
+		const auto length1 = glm::length(edge1);
+
+		if (length0 <= 0 || length1 <= 0) return 0;
+
+		return std::acos(std::min(std::max(glm::dot(edge0, edge1) / (length0 * length1), -1.0f), 1.0f));
+	}
+
+	//the vertex v is used by the corners corners[offsets[v], offsets[v + 1]), the corners are in the order of indices
+	void buildCornerAdjacency(
+		const std::vector<unsigned>& indices,
+		const size_t vertexCount,
+		std::vector<unsigned>& offsets,
+		std::vector<unsigned>& corners)
+	{
+		offsets.assign(vertexCount + 1, 0);
+		corners.resize(indices.size() - indices.size() % 3);
+
+		for (size_t corner = 0; corner < corners.size(); corner++) offsets[indices[corner] + 1]++;
+
+		for (size_t vertex = 0; vertex < vertexCount; vertex++) offsets[vertex + 1] += offsets[vertex];
+
+		auto next = offsets;
+
+		for (size_t corner = 0; corner < corners.size(); corner++)
+			corners[next[indices[corner]]++] = static_cast<unsigned>(corner);
+	}
+
+	//any unit vector perpendicular to the normal, it is used when the vertex does not have tangent
+	inline auto perpendicular(const Vector3f& normal) -> Vector3f
+	{
+		const auto axis = std::abs(normal.x) > 0.9f ? Vector3f(0, 1, 0) : Vector3f(1, 0, 0);
+		const auto tangent = glm::cross(normal, axis);
+		const auto length = glm::length(tangent);
+
+		return length > 0 ? tangent / length : Vector3f(1, 0, 0);
+	}
+
+}
+
+auto LRTR::TangentGenerator::computeNormals(
+	const std::vector<Vector3f>& positions,
+	const std::vector<unsigned>& indices,
+	ThreadPool* threadPool) -> std::vector<Vector3f>
+{
+	const auto triangleCount = indices.size() / 3;
+
+	//the weighted normal of each corner, the triangles write their own corners so the chunks do not share data
+	std::vector<Vector3f> cornerNormals(triangleCount * 3, Vector3f(0));
+
+	tangentParallelFor(threadPool, triangleCount, [&](const size_t begin, const size_t end)
+		{
+			for (auto triangle = begin; triangle < end; triangle++) {
+				const auto& p0 = positions[indices[triangle * 3 + 0]];
+				const auto& p1 = positions[indices[triangle * 3 + 1]];
+				const auto& p2 = positions[indices[triangle * 3 + 2]];
+
+				const auto normal = glm::cross(p1 - p0, p2 - p0);
+				const auto length = glm::length(normal);
+
+				if (length <= 0) continue;
+
+				cornerNormals[triangle * 3 + 0] = normal / length * cornerAngle(p1 - p0, p2 - p0);
+				cornerNormals[triangle * 3 + 1] = normal / length * cornerAngle(p2 - p1, p0 - p1);
+				cornerNormals[triangle * 3 + 2] = normal / length * cornerAngle(p0 - p2, p1 - p2);
+			}
+		});
+
+	std::vector<unsigned> offsets;
+	std::vector<unsigned> corners;
+
+	buildCornerAdjacency(indices, positions.size(), offsets, corners);
+
+	std::vector<Vector3f> normals(positions.size());
+
+	tangentParallelFor(threadPool, positions.size(), [&](const size_t begin, const size_t end)
+		{
+			for (auto vertex = begin; vertex < end; vertex++) {
+				auto normal = Vector3f(0);
+
+				for (auto offset = offsets[vertex]; offset < offsets[vertex + 1]; offset++)
+					normal = normal + cornerNormals[corners[offset]];
+
+				const auto length = glm::length(normal);
+
+				normals[vertex] = length > 0 ? normal / length : Vector3f(0, 0, 1);
+			}
+		});
+
+	return normals;
+}
+
+auto LRTR::TangentGenerator::computeTangents(
+	const std::vector<Vector3f>& positions,
+	const std::vector<Vector3f>& texCoords,
+	const std::vector<Vector3f>& normals,
+	const std::vector<unsigned>& indices,
+	ThreadPool* threadPool) -> TangentFrames
+{
+	const auto triangleCount = indices.size() / 3;
+
+	//the direction of texture coordinate u on triangle and whether the triangle preserves the orientation
+	//the direction is zero if the texture coordinates or the positions of triangle are degenerate
+	std::vector<Vector3f> triangleTangents(triangleCount, Vector3f(0));
+	std::vector<unsigned char> orientations(triangleCount, 1);
+
+	//the mesh without texture coordinates does not have tangent space, all vertices use the fallback tangents
+	const auto hasTexCoords = texCoords.size() >= positions.size();
+
+	tangentParallelFor(threadPool, hasTexCoords ? triangleCount : 0, [&](const size_t begin, const size_t end)
+		{
+			for (auto triangle = begin; triangle < end; triangle++) {
+				const auto v0 = indices[triangle * 3 + 0];
+				const auto v1 = indices[triangle * 3 + 1];
+				const auto v2 = indices[triangle * 3 + 2];
+
+				const auto d1 = positions[v1] - positions[v0];
+				const auto d2 = positions[v2] - positions[v0];
+				const auto t21 = texCoords[v1] - texCoords[v0];
+				const auto t31 = texCoords[v2] - texCoords[v0];
+
+				//the signed area of triangle in texture space, the tangent is scaled by it so we flip it back
+				const auto area = t21.x * t31.y - t21.y * t31.x;
+				const auto tangent = t31.y * d1 - t21.y * d2;
+				const auto length = glm::length(tangent);
+
+				orientations[triangle] = area > 0 ? 1 : 0;
+
+				if (area == 0 || length <= 0) continue;
+
+				triangleTangents[triangle] = tangent / length * (area > 0 ? 1.0f : -1.0f);
+			}
+		});
+
+	std::vector<unsigned> offsets;
+	std::vector<unsigned> corners;
+
+	buildCornerAdjacency(indices, positions.size(), offsets, corners);
+
+	TangentFrames frames;
+
+	frames.Tangents.resize(positions.size());
+	frames.Signs.resize(positions.size());
+
+	//the tangent of the side with smaller weight, it is used by the new vertex if the vertex is split
+	std::vector<Vector3f> splitTangents(positions.size(), Vector3f(0));
+
+	tangentParallelFor(threadPool, positions.size(), [&](const size_t begin, const size_t end)
+		{
+			for (auto vertex = begin; vertex < end; vertex++) {
+				const auto& normal = normals[vertex];
+
+				//the sums of corners that preserve and flip the orientation, MikkTSpace splits them into two vertices
+				Vector3f tangents[2] = { Vector3f(0), Vector3f(0) };
+				float weights[2] = { 0, 0 };
+
+				for (auto offset = offsets[vertex]; offset < offsets[vertex + 1]; offset++) {
+					const auto corner = corners[offset];
+					const auto triangle = corner / 3;
+					const auto& tangent = triangleTangents[triangle];
+
+					if (tangent == Vector3f(0)) continue;
+
+					//the tangent and edges are projected onto the plane of vertex normal like MikkTSpace
+					const auto project = [&](const Vector3f& value) { return value - normal * glm::dot(normal, value); };
+
+					const auto& position = positions[indices[corner]];
+					const auto& next = positions[indices[triangle * 3 + (corner % 3 + 1) % 3]];
+					const auto& previous = positions[indices[triangle * 3 + (corner % 3 + 2) % 3]];
+
+					const auto projected = project(tangent);
+					const auto length = glm::length(projected);
+
+					if (length <= 0) continue;
+
+					const auto weight = cornerAngle(project(next - position), project(previous - position));
+					const auto side = orientations[triangle];
+
+					tangents[side] = tangents[side] + projected / length * weight;
+					weights[side] = weights[side] + weight;
+				}
+
+				const auto side = weights[1] >= weights[0] ? 1 : 0;
+				const auto length = glm::length(tangents[side]);
+
+				frames.Tangents[vertex] = length > 0 ? tangents[side] / length : perpendicular(normal);
+				frames.Signs[vertex] = side == 1 ? 1.0f : -1.0f;
+
+				//the vertex is split only if both sides have weight, the zero vector means it is not split
+				if (weights[1 - side] <= 0) continue;
+
+				const auto splitLength = glm::length(tangents[1 - side]);
+
+				splitTangents[vertex] = splitLength > 0 ? tangents[1 - side] / splitLength : perpendicular(normal);
+			}
+		});
+
+	//the new vertices are added in the order of input vertices, so the result does not depend on threads
+	std::vector<unsigned> splitVertices(positions.size(), InvalidSplitVertex);
+
+	for (size_t vertex = 0; vertex < positions.size(); vertex++) {
+		if (splitTangents[vertex] == Vector3f(0)) continue;
+
+		splitVertices[vertex] = static_cast<unsigned>(positions.size() + frames.Splits.size());
+
+		frames.Splits.push_back(static_cast<unsigned>(vertex));
+		frames.Tangents.push_back(splitTangents[vertex]);
+		frames.Signs.push_back(-frames.Signs[vertex]);
+	}
+
+	frames.Indices = indices;
+
+	if (frames.Splits.empty()) return frames;
+
+	//the corners on the side with smaller weight use the new vertex, the degenerate triangles keep the input vertex
+	tangentParallelFor(threadPool, triangleCount, [&](const size_t begin, const size_t end)
+		{
+			for (auto triangle = begin; triangle < end; triangle++) {
+				if (triangleTangents[triangle] == Vector3f(0)) continue;
+
+				const auto sign = orientations[triangle] == 1 ? 1.0f : -1.0f;
+
+				for (auto corner = triangle * 3; corner < triangle * 3 + 3; corner++) {
+					const auto vertex = indices[corner];
+
+					if (splitVertices[vertex] != InvalidSplitVertex && frames.Signs[vertex] != sign)
+						frames.Indices[corner] = splitVertices[vertex];
+				}
+			}
+		});
+
+	return frames;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../Parallel/ThreadPool.hpp"
+#include "../Math/Math.hpp"
+
+#include <vector>
+
+namespace LRTR {
+
+	//the tangent frames of vertices, the bitangent is cross(normal, tangent) * sign
+	//the vertices used by triangles with different signs are split, the new vertices are after the input vertices
+	//the splits[i] is the input vertex that the vertex (input count + i) copies, the indices use the new vertices
+	struct TangentFrames {
+		std::vector<Vector3f> Tangents;
+		std::vector<float> Signs;
+
+		std::vector<unsigned> Splits;
+		std::vector<unsigned> Indices;
+	};
+
+	namespace TangentGenerator {
+
+		//the normal of vertex is the sum of normals of triangles around it weighted by the angle of corner
+		//the triangles are processed in chunks in parallel if the thread pool is not nullptr
+		//the vertices sum the triangles in the order of indices, so the result does not depend on threads
+		auto computeNormals(
+			const std::vector<Vector3f>& positions,
+			const std::vector<unsigned>& indices,
+			ThreadPool* threadPool = nullptr) -> std::vector<Vector3f>;
+
+		//the tangent space of each corner is from the texture coordinates of triangle like MikkTSpace
+		//it is projected onto the plane of vertex normal and weighted by the angle of corner
+		//the sign is negative if the texture coordinates of vertex are mirrored
+		//the vertex on the mirrored seam is split like MikkTSpace, the input vertex keeps the sign with larger weight
+		//and the corners with the other sign use the new vertex
+		auto computeTangents(
+			const std::vector<Vector3f>& positions,
+			const std::vector<Vector3f>& texCoords,
+			const std::vector<Vector3f>& normals,
+			const std::vector<unsigned>& indices,
+			ThreadPool* threadPool = nullptr) -> TangentFrames;
+	}
+
+}
@@ -0,0 +1,186 @@
+#include "VertexCompression.hpp"
+
+#include "../Bound.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace LRTR {
+
+	constexpr float MaxQuantizedPosition = 65535.0f;
+	constexpr float MaxQuantizedDirection = 32767.0f;
+
+	inline auto signNotZero(const float value) -> float
+	{
+		return value >= 0 ? 1.0f : -1.0f;
+	}
+
+	inline auto quantizeSnorm(const float value) -> short
+	{
+		return static_cast<short>(std::round(std::min(std::max(value, -1.0f), 1.0f) * MaxQuantizedDirection));
+	}
+
+}
+
+auto LRTR::VertexCompression::encodeHalf(const float value) -> unsigned short
+{
+	unsigned bits;
+
+	std::memcpy(&bits, &value, sizeof(float));
+
+	const auto sign = static_cast<unsigned short>((bits >> 16) & 0x8000u);
+	const auto exponent = static_cast<int>((bits >> 23) & 0xffu);
+
+	auto mantissa = bits & 0x7fffffu;
+
+	//the nan keeps a quiet bit, so it is still nan after we drop the low bits of mantissa
+	if (exponent == 255) return static_cast<unsigned short>(sign | 0x7c00u | (mantissa != 0 ? 0x200u : 0u));
+
+	const auto halfExponent = exponent - 127 + 15;
+
+	if (halfExponent >= 31) return static_cast<unsigned short>(sign | 0x7c00u);
+
+	//the value is subnormal in half, we shift the mantissa with implicit one and round to nearest even
+	if (halfExponent <= 0) {
+		if (halfExponent < -10) return sign;
+
+		mantissa = mantissa | 0x800000u;
+
+		const auto shift = static_cast<unsigned>(14 - halfExponent);
+		const auto remainder = mantissa & ((1u << shift) - 1);
+		const auto halfway = 1u << (shift - 1);
+
+		auto half = mantissa >> shift;
+
+		if (remainder > halfway || (remainder == halfway && (half & 1u))) half++;
+
+		return static_cast<unsigned short>(sign | half);
+	}
+
+	//the carry of rounding goes into exponent, so the largest value is rounded to infinity
+	auto half = (static_cast<unsigned>(halfExponent) << 10) | (mantissa >> 13);
+
+	const auto remainder = mantissa & 0x1fffu;
+
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) half++;
+
+	return static_cast<unsigned short>(sign | half);
+}
+
+auto LRTR::VertexCompression::decodeHalf(const unsigned short value) -> float
+{
+	const auto sign = static_cast<unsigned>(value & 0x8000u) << 16;
+	const auto exponent = static_cast<unsigned>(value >> 10) & 0x1fu;
+	const auto mantissa = static_cast<unsigned>(value) & 0x3ffu;
+
+	unsigned bits;
+
+	if (exponent == 31) bits = sign | 0x7f800000u | (mantissa << 13);
+	else if (exponent != 0) bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	else {
+		//the subnormal half is normal in float
+		const auto result = std::ldexp(static_cast<float>(mantissa), -24);
+
+		return sign != 0 ? -result : result;
+	}
+
+	float result;
+
+	std::memcpy(&result, &bits, sizeof(float));
+
+	return result;
+}
+
+auto LRTR::VertexCompression::quantization(const std::vector<Vector3f>& positions) -> PositionQuantization
+{
+	PositionQuantization result;
+
+	if (positions.empty()) return result;
+
+	Bound3f bound;
+
+	for (const auto& position : positions) bound.merge(position);
+
+	result.Offset = bound.Min;
+
+	for (auto axis = 0; axis < 3; axis++) {
+		const auto extent = bound.Max[axis] - bound.Min[axis];
+
+		result.Scale[axis] = extent > 0 ? extent : 1.0f;
+	}
+
+	return result;
+}
+
+auto LRTR::VertexCompression::encodePosition(
+	const Vector3f& position,
+	const PositionQuantization& quantization,
+	const float sign) -> PackedPosition
+{
+	const auto normalized = glm::clamp((position - quantization.Offset) / quantization.Scale, Vector3f(0), Vector3f(1));
+
+	return {
+		static_cast<unsigned short>(std::round(normalized.x * MaxQuantizedPosition)),
+		static_cast<unsigned short>(std::round(normalized.y * MaxQuantizedPosition)),
+		static_cast<unsigned short>(std::round(normalized.z * MaxQuantizedPosition)),
+		static_cast<unsigned short>(sign < 0 ? 0 : 65535)
+	};
+}
+
+auto LRTR::VertexCompression::decodePosition(
+	const PackedPosition& position,
+	const PositionQuantization& quantization) -> Vector3f
+{
+	return quantization.Offset + Vector3f(position.X, position.Y, position.Z) / MaxQuantizedPosition * quantization.Scale;
+}
+
+auto LRTR::VertexCompression::decodeSign(const PackedPosition& position) -> float
+{
+	return position.W >= 32768 ? 1.0f : -1.0f;
+}
+
+auto LRTR::VertexCompression::encodeTexCoord(const Vector3f& texCoord) -> PackedTexCoord
+{
+	return { encodeHalf(texCoord.x), encodeHalf(texCoord.y) };
+}
+
+auto LRTR::VertexCompression::decodeTexCoord(const PackedTexCoord& texCoord) -> Vector3f
+{
+	return Vector3f(decodeHalf(texCoord.U), decodeHalf(texCoord.V), 0.0f);
+}
+
+auto LRTR::VertexCompression::encodeDirection(const Vector3f& direction) -> PackedDirection
+{
+	const auto length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+
+	if (length <= 0) return { 0, 0 };
+
+	//project the direction onto the octahedron and fold the lower half onto the upper half
+	auto x = direction.x / length;
+	auto y = direction.y / length;
+
+	if (direction.z < 0) {
+		const auto foldedX = (1.0f - std::abs(y)) * signNotZero(x);
+		const auto foldedY = (1.0f - std::abs(x)) * signNotZero(y);
+
+		x = foldedX;
+		y = foldedY;
+	}
+
+	return { quantizeSnorm(x), quantizeSnorm(y) };
+}
+
+auto LRTR::VertexCompression::decodeDirection(const PackedDirection& direction) -> Vector3f
+{
+	auto x = std::max(static_cast<float>(direction.X) / MaxQuantizedDirection, -1.0f);
+	auto y = std::max(static_cast<float>(direction.Y) / MaxQuantizedDirection, -1.0f);
+
+	const auto z = 1.0f - std::abs(x) - std::abs(y);
+	const auto fold = std::max(-z, 0.0f);
+
+	x = x + (x >= 0 ? -fold : fold);
+	y = y + (y >= 0 ? -fold : fold);
+
+	return glm::normalize(Vector3f(x, y, z));
+}
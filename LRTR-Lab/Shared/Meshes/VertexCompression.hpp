@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../Math/Math.hpp"
+
+#include <vector>
+
+namespace LRTR {
+
+	//the position is quantized into 16 bits per axis in the bound of mesh
+	//the w is the sign of bitangent, 0 means negative and 65535 means positive
+	struct PackedPosition {
+		unsigned short X = 0;
+		unsigned short Y = 0;
+		unsigned short Z = 0;
+		unsigned short W = 0;
+	};
+
+	//the texture coordinate in half float, the z of texture coordinate is dropped
+	struct PackedTexCoord {
+		unsigned short U = 0;
+		unsigned short V = 0;
+	};
+
+	//the unit vector in octahedral encoding, the x and y are snorm in 16 bits
+	struct PackedDirection {
+		short X = 0;
+		short Y = 0;
+	};
+
+	//the range of positions we quantize into, position = offset + quantized * scale
+	struct PositionQuantization {
+		Vector3f Offset = Vector3f(0);
+		Vector3f Scale = Vector3f(1);
+	};
+
+	namespace VertexCompression {
+
+		auto encodeHalf(const float value) -> unsigned short;
+
+		auto decodeHalf(const unsigned short value) -> float;
+
+		//the quantization of positions, the axis with zero extent uses scale 1 so it is still decodable
+		auto quantization(const std::vector<Vector3f>& positions) -> PositionQuantization;
+
+		auto encodePosition(const Vector3f& position, const PositionQuantization& quantization, const float sign = 1.0f) -> PackedPosition;
+
+		auto decodePosition(const PackedPosition& position, const PositionQuantization& quantization) -> Vector3f;
+
+		auto decodeSign(const PackedPosition& position) -> float;
+
+		auto encodeTexCoord(const Vector3f& texCoord) -> PackedTexCoord;
+
+		auto decodeTexCoord(const PackedTexCoord& texCoord) -> Vector3f;
+
+		//the direction does not need to be normalized, the zero direction is encoded as (0, 0, 1)
+		auto encodeDirection(const Vector3f& direction) -> PackedDirection;
+
+		auto decodeDirection(const PackedDirection& direction) -> Vector3f;
+	}
+
+}
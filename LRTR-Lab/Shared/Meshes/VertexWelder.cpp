@@ -0,0 +1,318 @@
+#include "VertexWelder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <atomic>
+#include <array>
+#include <cmath>
+
+namespace LRTR {
+
+	//the number of vertices we process in one task
+	constexpr size_t WeldGrain = 16384;
+
+	//the size of cell in epsilon, the vertex only searches the cells next to it if it is in epsilon of their borders
+	//so the larger cell has less cells to search but more vertices in each cell
+	constexpr float WeldCellSize = 4.0f;
+
+	constexpr unsigned InvalidWeldVertex = ~0u;
+
+	using WeldCell = std::array<int, 3>;
+
+	//the slot of hash table, the key is the first vertex inserted into the slot (we compare with its values)
+	//the value is the first vertex of slot or the head of list of vertices in slot (the list is linked by next)
+	struct WeldSlot {
+		std::atomic<unsigned> Key;
+		std::atomic<unsigned> Value;
+	};
+
+	inline auto mixHash(const unsigned long long hash, const unsigned value) -> unsigned long long
+	{
+		const auto result = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+
+		return result ^ (result >> 29);
+	}
+
+	//the negative zero is the same as zero
+	inline auto floatBits(const float value) -> unsigned
+	{
+		const auto normalized = value == 0 ? 0.0f : value;
+
+		unsigned bits;
+
+		std::memcpy(&bits, &normalized, sizeof(float));
+
+		return bits;
+	}
+
+	inline auto cellHash(const WeldCell& cell) -> size_t
+	{
+		return static_cast<size_t>(mixHash(mixHash(mixHash(0,
+			static_cast<unsigned>(cell[0])),
+			static_cast<unsigned>(cell[1])),
+			static_cast<unsigned>(cell[2])));
+	}
+
+	inline auto gridCoordinate(const float value) -> int
+	{
+		const auto limit = static_cast<float>(std::numeric_limits<int>::max() / 2);
+
+		return static_cast<int>(std::floor(std::min(std::max(value, -limit), limit)));
+	}
+
+	inline void weldParallelFor(
+		ThreadPool* threadPool, const size_t count,
+		const std::function<void(size_t, size_t)>& function)
+	{
+		if (threadPool == nullptr || count <= WeldGrain) { if (count != 0) function(0, count); return; }
+
+		threadPool->parallelFor(count, WeldGrain, function);
+	}
+
+	//the hash table with linear probing, the slots are claimed by threads with compare and swap
+	//the size of table is at least 1.5 times of keys, so the probing is short
+	class WeldTable {
+	public:
+		WeldTable(const size_t count, ThreadPool* threadPool)
+		{
+			size_t slotCount = 1;
+
+			while (slotCount < count + count / 2) slotCount = slotCount << 1;
+
+			mSlots = std::vector<WeldSlot>(slotCount);
+			mMask = slotCount - 1;
+
+			weldParallelFor(threadPool, slotCount, [&](const size_t begin, const size_t end)
+				{
+					for (auto slot = begin; slot < end; slot++) {
+						mSlots[slot].Key.store(InvalidWeldVertex, std::memory_order_relaxed);
+						mSlots[slot].Value.store(InvalidWeldVertex, std::memory_order_relaxed);
+					}
+				});
+		}
+
+		//find or claim the slot whose key is equal to vertex
+		template<typename Equal>
+		auto insert(const unsigned vertex, const size_t hash, Equal&& equal) -> size_t
+		{
+			auto slot = hash & mMask;
+
+			while (true) {
+				auto key = mSlots[slot].Key.load(std::memory_order_acquire);
+
+				if (key == InvalidWeldVertex && mSlots[slot].Key.compare_exchange_strong(key, vertex, std::memory_order_acq_rel)) return slot;
+
+				if (equal(key)) return slot;
+
+				slot = (slot + 1) & mMask;
+			}
+		}
+
+		//find the slot whose key is equal, return invalid slot if there is no such slot
+		template<typename Equal>
+		auto find(const size_t hash, Equal&& equal) const -> size_t
+		{
+			auto slot = hash & mMask;
+
+			while (true) {
+				const auto key = mSlots[slot].Key.load(std::memory_order_relaxed);
+
+				if (key == InvalidWeldVertex) return InvalidSlot;
+				if (equal(key)) return slot;
+
+				slot = (slot + 1) & mMask;
+			}
+		}
+
+		auto value(const size_t slot) noexcept -> std::atomic<unsigned>& { return mSlots[slot].Value; }
+
+		static constexpr size_t InvalidSlot = std::numeric_limits<size_t>::max();
+	private:
+		std::vector<WeldSlot> mSlots;
+
+		size_t mMask = 0;
+	};
+
+	//the leader of vertex is the first vertex whose position and attributes have the same bits
+	void weldSameVertices(
+		const std::vector<const Vector3f*>& streams,
+		const size_t count,
+		ThreadPool* threadPool,
+		std::vector<unsigned>& leaders)
+	{
+		WeldTable table(count, threadPool);
+
+		std::vector<unsigned> vertexSlots(count);
+
+		weldParallelFor(threadPool, count, [&](const size_t begin, const size_t end)
+			{
+				for (auto index = begin; index < end; index++) {
+					unsigned long long hash = 0;
+
+					for (const auto& stream : streams) {
+						hash = mixHash(hash, floatBits(stream[index].x));
+						hash = mixHash(hash, floatBits(stream[index].y));
+						hash = mixHash(hash, floatBits(stream[index].z));
+					}
+
+					const auto slot = table.insert(static_cast<unsigned>(index), static_cast<size_t>(hash),
+						[&](const unsigned key)
+						{
+							for (const auto& stream : streams) {
+								if (floatBits(stream[key].x) != floatBits(stream[index].x) ||
+									floatBits(stream[key].y) != floatBits(stream[index].y) ||
+									floatBits(stream[key].z) != floatBits(stream[index].z)) return false;
+							}
+
+							return true;
+						});
+
+					auto& first = table.value(slot);
+					auto current = first.load(std::memory_order_relaxed);
+
+					while (index < current && !first.compare_exchange_weak(current, static_cast<unsigned>(index), std::memory_order_relaxed)) {}
+
+					vertexSlots[index] = static_cast<unsigned>(slot);
+				}
+			});
+
+		weldParallelFor(threadPool, count, [&](const size_t begin, const size_t end)
+			{
+				for (auto index = begin; index < end; index++)
+					leaders[index] = table.value(vertexSlots[index]).load(std::memory_order_relaxed);
+			});
+	}
+
+	//the leader of vertex is the first vertex whose position and attributes are in epsilon
+	//only the vertices that are leaders of themselves are welded, so the same vertices are only searched once
+	void weldNearVertices(
+		const std::vector<const Vector3f*>& streams,
+		const size_t count,
+		const float epsilon,
+		ThreadPool* threadPool,
+		std::vector<unsigned>& leaders)
+	{
+		const auto& positions = streams.front();
+		const auto cellScale = 1.0f / (epsilon * WeldCellSize);
+
+		WeldTable table(count, threadPool);
+
+		std::vector<WeldCell> cells(count);
+		std::vector<unsigned> cellSlots(count);
+		std::vector<unsigned> next(count);
+
+		weldParallelFor(threadPool, count, [&](const size_t begin, const size_t end)
+			{
+				for (auto index = begin; index < end; index++) {
+					if (leaders[index] != index) continue;
+
+					cells[index] = {
+						gridCoordinate(positions[index].x * cellScale),
+						gridCoordinate(positions[index].y * cellScale),
+						gridCoordinate(positions[index].z * cellScale)
+					};
+
+					const auto slot = table.insert(static_cast<unsigned>(index), cellHash(cells[index]),
+						[&](const unsigned key) { return cells[key] == cells[index]; });
+
+					next[index] = table.value(slot).exchange(static_cast<unsigned>(index), std::memory_order_relaxed);
+					cellSlots[index] = static_cast<unsigned>(slot);
+				}
+			});
+
+		const auto matched = [&](const size_t left, const size_t right)
+		{
+			for (const auto& stream : streams) {
+				const auto difference = glm::abs(stream[left] - stream[right]);
+
+				if (difference.x > epsilon || difference.y > epsilon || difference.z > epsilon) return false;
+			}
+
+			return true;
+		};
+
+		weldParallelFor(threadPool, count, [&](const size_t begin, const size_t end)
+			{
+				for (auto index = begin; index < end; index++) {
+					if (leaders[index] != index) continue;
+
+					const auto& cell = cells[index];
+
+					auto leader = static_cast<unsigned>(index);
+
+					WeldCell neighbour = cell;
+					WeldCell direction = { 0, 0, 0 };
+
+					//the direction of border that is in epsilon of vertex, zero means there is no border in epsilon
+					for (size_t axis = 0; axis < 3; axis++) {
+						const auto scaled = positions[index][static_cast<int>(axis)] * cellScale;
+						const auto fraction = scaled - std::floor(scaled);
+
+						if (fraction * WeldCellSize <= 1.0f) direction[axis] = -1;
+						if ((1.0f - fraction) * WeldCellSize <= 1.0f) direction[axis] = 1;
+					}
+
+					for (auto corner = 0; corner < 8; corner++) {
+						//skip the corners that use the axes without border in epsilon
+						if (((corner & 1) && direction[0] == 0) ||
+							((corner & 2) && direction[1] == 0) ||
+							((corner & 4) && direction[2] == 0)) continue;
+
+						for (size_t axis = 0; axis < 3; axis++)
+							neighbour[axis] = cell[axis] + ((corner >> axis) & 1) * direction[axis];
+
+						const auto slot = corner == 0 ? cellSlots[index] : table.find(cellHash(neighbour),
+							[&](const unsigned key) { return cells[key] == neighbour; });
+
+						if (slot == WeldTable::InvalidSlot) continue;
+
+						for (auto other = table.value(slot).load(std::memory_order_relaxed); other != InvalidWeldVertex; other = next[other])
+							if (other < leader && matched(index, other)) leader = other;
+					}
+
+					leaders[index] = leader;
+				}
+			});
+	}
+
+}
+
+auto LRTR::VertexWelder::weld(
+	const std::vector<Vector3f>& positions,
+	const std::vector<const std::vector<Vector3f>*>& attributes,
+	const float epsilon,
+	ThreadPool* threadPool) -> VertexWeldResult
+{
+	VertexWeldResult result;
+
+	const auto count = positions.size();
+
+	if (count == 0) return result;
+
+	//the attributes that are empty or not enough for all vertices are not used to weld
+	std::vector<const Vector3f*> streams = { positions.data() };
+
+	for (const auto& attribute : attributes)
+		if (attribute != nullptr && attribute->size() >= count) streams.push_back(attribute->data());
+
+	//the leader of vertex is the first vertex that can be welded with it, it is not larger than the vertex
+	//most vertices of triangle soup are the same as others, so we weld them first and only search the rest in grid
+	std::vector<unsigned> leaders(count);
+
+	weldSameVertices(streams, count, threadPool, leaders);
+
+	if (epsilon > 0) weldNearVertices(streams, count, epsilon, threadPool, leaders);
+
+	result.Remap = std::vector<unsigned>(count);
+
+	for (size_t index = 0; index < count; index++) {
+		if (leaders[index] == index) {
+			result.Remap[index] = static_cast<unsigned>(result.Vertices.size());
+			result.Vertices.push_back(static_cast<unsigned>(index));
+		}
+		else result.Remap[index] = result.Remap[leaders[index]];
+	}
+
+	return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../Parallel/ThreadPool.hpp"
+#include "../Math/Math.hpp"
+
+#include <vector>
+
+namespace LRTR {
+
+	//the remap[i] is the welded vertex of input vertex i, the vertices[v] is the input vertex we keep for welded vertex v
+	//the welded vertices are ordered by the first input vertex they have
+	struct VertexWeldResult {
+		std::vector<unsigned> Remap;
+		std::vector<unsigned> Vertices;
+	};
+
+	namespace VertexWelder {
+
+		//weld the vertices whose positions are in epsilon of each other (per axis), if epsilon is zero, only the same positions are welded
+		//the attributes are optional, if they are not empty the vertices are welded only when all attributes are in epsilon too
+		//the vertices are put into a hash grid and the vertices are matched in parallel if the thread pool is not nullptr
+		//the vertex is welded to the first vertex around it, so the vertices in a chain shorter than epsilon are welded together
+		auto weld(
+			const std::vector<Vector3f>& positions,
+			const std::vector<const std::vector<Vector3f>*>& attributes,
+			const float epsilon = 0,
+			ThreadPool* threadPool = nullptr) -> VertexWeldResult;
+
+	}
+
+}
@@ -0,0 +1,158 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+LRTR::ThreadPool::ThreadPool(const size_t count)
+{
+	//the thread that waits the tasks will also execute the tasks
+	//so we only need count - 1 workers
+	const auto threads = count != 0 ? count : 
+		static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+	for (size_t index = 0; index <= threads; index++)
+		mQueues.push_back(std::make_unique<TaskQueue>());
+
+	for (size_t index = 0; index < threads; index++)
+		mThreads.push_back(std::thread([this, index]() { execute(index); }));
+}
+
+LRTR::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		mExisted = false;
+	}
+
+	mCondition.notify_all();
+
+	for (auto& thread : mThreads) thread.join();
+}
+
+void LRTR::ThreadPool::submit(const std::function<void()>& task)
+{
+	//the worker pushes the task to its queue, other threads push the task to queues one by one
+	const auto index = currentIndex() != mThreads.size() ? currentIndex() : mNext++ % mQueues.size();
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		++mPending;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mQueues[index]->Mutex);
+
+		mQueues[index]->Tasks.push_back(task);
+	}
+	
+	mCondition.notify_one();
+}
+
+void LRTR::ThreadPool::wait(const std::function<bool()>& finished)
+{
+	const auto index = currentIndex();
+	
+	auto task = std::function<void()>();
+
+	while (!finished()) {
+		if (pop(index, task)) task();
+		else std::this_thread::yield();
+	}
+}
+
+void LRTR::ThreadPool::parallelFor(
+	const size_t count, 
+	const size_t grain,
+	const std::function<void(size_t, size_t)>& function)
+{
+	const auto chunkSize = std::max(grain, static_cast<size_t>(1));
+	const auto chunks = (count + chunkSize - 1) / chunkSize;
+
+	if (chunks <= 1) { if (count != 0) function(0, count); return; }
+
+	std::atomic<size_t> remaining = chunks;
+
+	//the first chunk is executed by the caller
+	for (size_t chunk = 1; chunk < chunks; chunk++) {
+		submit([&function, &remaining, chunk, chunkSize, count]()
+			{
+				function(chunk * chunkSize, std::min((chunk + 1) * chunkSize, count));
+
+				--remaining;
+			});
+	}
+
+	function(0, chunkSize);
+
+	--remaining;
+	
+	wait([&]() { return remaining == 0; });
+}
+
+auto LRTR::ThreadPool::size() const noexcept -> size_t
+{
+	return mThreads.size() + 1;
+}
+
+auto LRTR::ThreadPool::pop(const size_t index, std::function<void()>& task) -> bool
+{
+	if (mPending == 0) return false;
+	
+	//pop the last task we pushed, it is the most likely to be in cache
+	{
+		std::lock_guard<std::mutex> lock(mQueues[index]->Mutex);
+
+		if (!mQueues[index]->Tasks.empty()) {
+			task = std::move(mQueues[index]->Tasks.back());
+
+			mQueues[index]->Tasks.pop_back();
+
+			--mPending;
+			
+			return true;
+		}
+	}
+
+	//steal the oldest task from other queues
+	for (size_t offset = 1; offset < mQueues.size(); offset++) {
+		const auto& queue = mQueues[(index + offset) % mQueues.size()];
+		
+		std::lock_guard<std::mutex> lock(queue->Mutex);
+
+		if (queue->Tasks.empty()) continue;
+
+		task = std::move(queue->Tasks.front());
+
+		queue->Tasks.pop_front();
+
+		--mPending;
+
+		return true;
+	}
+
+	return false;
+}
+
+auto LRTR::ThreadPool::currentIndex() const noexcept -> size_t
+{
+	return mCurrentPool == this ? mCurrentIndex : mThreads.size();
+}
+
+void LRTR::ThreadPool::execute(const size_t index)
+{
+	mCurrentPool = this;
+	mCurrentIndex = index;
+
+	auto task = std::function<void()>();
+	
+	while (true) {
+		if (pop(index, task)) { task(); continue; }
+
+		std::unique_lock<std::mutex> lock(mMutex);
+
+		mCondition.wait(lock, [this]() { return !mExisted || mPending != 0; });
+
+		if (!mExisted) return;
+	}
+}
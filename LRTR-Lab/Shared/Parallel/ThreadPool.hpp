@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../../Core/Noncopyable.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <deque>
+#include <mutex>
+
+namespace LRTR {
+
+	//the thread pool uses one queue for each worker, the worker pops the task from the back of its queue
+	//and steals the task from the front of other queues when its queue is empty
+	class ThreadPool : public Noncopyable {
+	public:
+		//if the count is zero, we will use the number of hardware threads
+		explicit ThreadPool(const size_t count = 0);
+
+		~ThreadPool();
+
+		void submit(const std::function<void()>& task);
+
+		//the caller executes the tasks in pool until the finished returns true
+		//so we can wait in the task without blocking a worker
+		void wait(const std::function<bool()>& finished);
+
+		//split [0, count) into chunks with grain size and run the function in parallel
+		//the function will be called with [begin, end) of chunk
+		void parallelFor(
+			const size_t count, 
+			const size_t grain,
+			const std::function<void(size_t, size_t)>& function);
+
+		auto size() const noexcept -> size_t;
+	private:
+		struct TaskQueue {
+			std::deque<std::function<void()>> Tasks;
+			std::mutex Mutex;
+		};
+
+		auto pop(const size_t index, std::function<void()>& task) -> bool;
+
+		auto currentIndex() const noexcept -> size_t;
+
+		void execute(const size_t index);
+	private:
+		//the last queue is used by the threads that are not worker
+		std::vector<std::unique_ptr<TaskQueue>> mQueues;
+		std::vector<std::thread> mThreads;
+
+		std::condition_variable mCondition;
+		std::mutex mMutex;
+
+		std::atomic<size_t> mPending = 0;
+		std::atomic<size_t> mNext = 0;
+		
+		bool mExisted = true;
+
+		static inline thread_local const ThreadPool* mCurrentPool = nullptr;
+		static inline thread_local size_t mCurrentIndex = 0;
+	};
+	
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Math/Math.hpp"
+
+namespace LRTR {
+
+	template<typename T>
+	struct Ray {
+		Vector3<T> Origin = Vector3<T>(0);
+		Vector3<T> Direction = Vector3<T>(0, 0, 1);
+
+		Ray() = default;
+
+		Ray(
+			const Vector3<T>& origin,
+			const Vector3<T>& direction) :
+			Origin(origin), Direction(direction) {}
+
+		auto at(const T& distance) const noexcept -> Vector3<T> {
+			return Origin + Direction * distance;
+		}
+	};
+
+	using RayF = Ray<float>;
+}
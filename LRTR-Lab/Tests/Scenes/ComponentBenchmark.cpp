@@ -0,0 +1,97 @@
+#include "../Testing.hpp"
+
+#include "../../Scenes/Components/CollectionLabel.hpp"
+#include "../../Scenes/Components/TransformWrap.hpp"
+#include "../../Scenes/Archetype.hpp"
+#include "../../Scenes/Shape.hpp"
+
+#include <typeindex>
+
+namespace LRTR {
+
+	//the shapes in the benchmarks, it is about the number of primitives in our large glTF scenes
+	constexpr size_t ComponentBenchmarkShapes = 50000;
+
+	//the component access before dense ids, the components are keyed by type index and casted by dynamic cast
+	class TypeIndexComponents {
+	public:
+		template<typename TComponent>
+		void addComponent(const std::shared_ptr<TComponent>& component)
+		{
+			mComponents.insert({ typeid(TComponent), component });
+		}
+
+		template<typename TComponent>
+		auto component() const -> std::shared_ptr<TComponent>
+		{
+			return std::dynamic_pointer_cast<TComponent>(mComponents.at(typeid(TComponent)));
+		}
+
+		template<typename TComponent>
+		auto hasComponent() const -> bool
+		{
+			return mComponents.find(typeid(TComponent)) != mComponents.end();
+		}
+	private:
+		Group<std::type_index, std::shared_ptr<Component>> mComponents;
+	};
+
+}
+
+LRTR_BENCHMARK(ComponentAccess)
+{
+	using namespace LRTR;
+
+	std::vector<std::shared_ptr<Shape>> shapes;
+	std::vector<TypeIndexComponents> typeIndexShapes(ComponentBenchmarkShapes);
+	
+	ArchetypeStorage storage;
+
+	for (size_t index = 0; index < ComponentBenchmarkShapes; index++) {
+		const auto transform = makeComponent<TransformWrap>(
+			Vector3f(static_cast<float>(index), 0, 0), Vector4f(0, 0, 0, 1), Vector3f(1));
+
+		shapes.push_back(std::make_shared<Shape>());
+		shapes.back()->addComponent(transform);
+
+		typeIndexShapes[index].addComponent(std::make_shared<CollectionLabel>());
+		typeIndexShapes[index].addComponent(transform);
+
+		storage.add(shapes.back().get());
+	}
+
+	//the sums are checked, so the compiler can not remove the loops
+	auto typeIndexSum = 0.0f;
+	auto denseSum = 0.0f;
+	auto columnSum = 0.0f;
+	
+	Testing::measure("type index and dynamic cast", 20, [&]()
+		{
+			typeIndexSum = 0;
+
+			for (const auto& shape : typeIndexShapes)
+				if (shape.hasComponent<TransformWrap>()) typeIndexSum += shape.component<TransformWrap>()->translation().x;
+		});
+
+	Testing::measure("dense id and static cast", 20, [&]()
+		{
+			denseSum = 0;
+
+			for (const auto& shape : shapes)
+				if (shape->hasComponent<TransformWrap>()) denseSum += shape->component<TransformWrap>()->translation().x;
+		});
+
+	Testing::measure("archetype column", 20, [&]()
+		{
+			columnSum = 0;
+
+			storage.each<TransformWrap>([&](const Archetype& archetype)
+				{
+					for (size_t row = 0; row < archetype.size(); row++)
+						columnSum += archetype.get<TransformWrap>(row)->translation().x;
+				});
+		});
+
+	LRTR_CHECK(typeIndexSum == denseSum);
+	LRTR_CHECK(denseSum == columnSum);
+}
@@ -0,0 +1,209 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Accelerators/BoundingVolumeHierarchy.hpp"
+
+#include <algorithm>
+#include <random>
+
+namespace LRTR {
+
+	static auto BoundingVolumeTestBounds(const size_t count, const unsigned seed) -> std::vector<Bound3f>
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> centers(-50.0f, 50.0f);
+		std::uniform_real_distribution<float> extents(0.0f, 3.0f);
+
+		std::vector<Bound3f> bounds;
+
+		for (size_t index = 0; index < count; index++) {
+			const auto center = Vector3f(centers(random), centers(random), centers(random));
+			const auto extent = Vector3f(extents(random), extents(random), extents(random));
+
+			bounds.push_back(Bound3f(center - extent, center + extent));
+		}
+
+		return bounds;
+	}
+
+	//the box [-20, 20] with two tilted planes, so the bounds are partially inside of some planes
+	static auto BoundingVolumeTestFrustum() -> FrustumF
+	{
+		FrustumF frustum;
+
+		frustum.Planes[0] = Vector4f(1, 0, 0, 20);
+		frustum.Planes[1] = Vector4f(-1, 0, 0, 20);
+		frustum.Planes[2] = Vector4f(0, 0.8f, 0.6f, 20);
+		frustum.Planes[3] = Vector4f(0, -0.8f, 0.6f, 20);
+		frustum.Planes[4] = Vector4f(0, 0, 1, 20);
+		frustum.Planes[5] = Vector4f(0, 0, -1, 20);
+
+		return frustum;
+	}
+
+	//the slab test of ray and bound in [0, distance], the entry is the distance the ray enters the bound
+	static auto BoundingVolumeTestRay(const Bound3f& bound, const RayF& ray, const float distance, float& entry) -> bool
+	{
+		const auto inverseDirection = 1.0f / ray.Direction;
+		const auto lower = (bound.Min - ray.Origin) * inverseDirection;
+		const auto upper = (bound.Max - ray.Origin) * inverseDirection;
+
+		const auto minDistance = glm::min(lower, upper);
+		const auto maxDistance = glm::max(lower, upper);
+
+		entry = std::max(std::max(minDistance.x, minDistance.y), std::max(minDistance.z, 0.0f));
+
+		return entry <= std::min(std::min(maxDistance.x, maxDistance.y), std::min(maxDistance.z, distance));
+	}
+
+	//the items found by hierarchy should be the items found by testing every bound
+	static auto BoundingVolumeTestQueries(const BoundingVolumeHierarchy& hierarchy, const std::vector<Bound3f>& bounds) -> size_t
+	{
+		size_t mismatches = 0;
+
+		const auto compare = [&](std::vector<size_t> found, std::vector<size_t> expected)
+		{
+			std::sort(found.begin(), found.end());
+
+			if (found != expected) mismatches++;
+		};
+
+		const auto frustum = BoundingVolumeTestFrustum();
+
+		std::vector<size_t> found;
+		std::vector<size_t> expected;
+
+		hierarchy.intersect(frustum, [&](const size_t item) { found.push_back(item); });
+
+		for (size_t index = 0; index < bounds.size(); index++) if (frustum.intersect(bounds[index])) expected.push_back(index);
+
+		compare(found, expected);
+
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> points(-50.0f, 50.0f);
+		std::uniform_real_distribution<float> sizes(0.5f, 15.0f);
+
+		for (size_t query = 0; query < 64; query++) {
+			const auto center = Vector3f(points(random), points(random), points(random));
+			const auto size = sizes(random);
+			const auto bound = Bound3f(center - Vector3f(size), center + Vector3f(size * 0.5f));
+
+			found.clear();
+			expected.clear();
+
+			hierarchy.intersect(bound, [&](const size_t item) { found.push_back(item); });
+
+			for (size_t index = 0; index < bounds.size(); index++) if (bounds[index].overlap(bound)) expected.push_back(index);
+
+			compare(found, expected);
+
+			found.clear();
+			expected.clear();
+
+			hierarchy.intersect(center, size, [&](const size_t item) { found.push_back(item); });
+
+			for (size_t index = 0; index < bounds.size(); index++) if (bounds[index].overlap(center, size)) expected.push_back(index);
+
+			compare(found, expected);
+
+			//the ray from center to a random point, we find the closest bound it enters
+			const auto direction = glm::normalize(Vector3f(points(random), points(random), points(random)) - center);
+			const auto ray = RayF(center, direction);
+
+			auto closest = 100.0f;
+			auto expectedClosest = 100.0f;
+			auto entry = 0.0f;
+
+			hierarchy.intersect(ray, 100.0f, [&](const size_t item, const float distance)
+				{
+					if (BoundingVolumeTestRay(bounds[item], ray, distance, entry)) closest = std::min(closest, entry);
+
+					return closest;
+				});
+
+			for (const auto& other : bounds)
+				if (BoundingVolumeTestRay(other, ray, expectedClosest, entry)) expectedClosest = std::min(expectedClosest, entry);
+
+			if (closest != expectedClosest) mismatches++;
+		}
+
+		return mismatches;
+	}
+
+}
+
+LRTR_TEST(BoundingVolumeHierarchyQueries)
+{
+	using namespace LRTR;
+
+	const auto bounds = BoundingVolumeTestBounds(2000, 3);
+
+	BoundingVolumeHierarchy hierarchy;
+
+	hierarchy.build(bounds);
+
+	LRTR_CHECK(hierarchy.size() == bounds.size());
+
+	//every item is in exactly one leaf
+	auto items = hierarchy.items();
+
+	std::sort(items.begin(), items.end());
+
+	for (size_t index = 0; index < items.size(); index++) LRTR_CHECK(items[index] == index);
+
+	LRTR_CHECK(BoundingVolumeTestQueries(hierarchy, bounds) == 0);
+}
+
+LRTR_TEST(BoundingVolumeHierarchyRefit)
+{
+	using namespace LRTR;
+
+	auto bounds = BoundingVolumeTestBounds(2000, 5);
+
+	BoundingVolumeHierarchy hierarchy;
+
+	hierarchy.build(bounds);
+
+	const auto cost = hierarchy.cost();
+
+	//the items are moved randomly, so the topology is worse but the queries are still right after refit
+	std::mt19937 random(9);
+	std::uniform_real_distribution<float> offsets(-10.0f, 10.0f);
+
+	for (auto& bound : bounds) {
+		const auto offset = Vector3f(offsets(random), offsets(random), offsets(random));
+
+		bound = Bound3f(bound.Min + offset, bound.Max + offset);
+	}
+
+	hierarchy.refit(bounds);
+
+	LRTR_CHECK(hierarchy.cost() >= cost);
+	LRTR_CHECK(BoundingVolumeTestQueries(hierarchy, bounds) == 0);
+
+	//the node bounds contain the bounds of their children
+	const auto& nodes = hierarchy.nodes();
+
+	size_t uncontained = 0;
+
+	for (size_t index = 0; index < nodes.size(); index++) {
+		const auto& node = nodes[index];
+
+		//the bound contains the child if merging the child does not change it
+		const auto contains = [&](const Bound3f& child)
+		{
+			auto merged = node.Bound;
+
+			merged.merge(child);
+
+			return merged.Min == node.Bound.Min && merged.Max == node.Bound.Max;
+		};
+
+		if (node.leaf()) {
+			for (auto item = node.Offset; item < node.Offset + node.Count; item++)
+				if (!contains(bounds[hierarchy.items()[item]])) uncontained++;
+		}
+		else if (!contains(nodes[index + 1].Bound) || !contains(nodes[node.Offset].Bound)) uncontained++;
+	}
+
+	LRTR_CHECK(uncontained == 0);
+}
@@ -0,0 +1,64 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Accelerators/ClusterCuller.hpp"
+
+namespace LRTR {
+
+	//the meshlet is a flat patch at the origin facing +z, so it is back facing for the viewers below it
+	static auto ClusterCullerTestMeshlet() -> Meshlet
+	{
+		Meshlet meshlet;
+
+		meshlet.IndexOffset = 0;
+		meshlet.IndexCount = 3;
+		meshlet.Center = Vector3f(0);
+		meshlet.Radius = 0.1f;
+		meshlet.ConeAxis = Vector3f(0, 0, 1);
+		meshlet.ConeCutoff = 0.2f;
+
+		return meshlet;
+	}
+
+	static auto ClusterCullerTestCull(const Matrix4x4f& world, const Vector3f& viewer) -> size_t
+	{
+		ClusterCuller culler;
+
+		std::vector<IndexRange> ranges;
+
+		//the view projection is identity, so the frustum is the box [-1, 1] and the meshlet is in it
+		culler.begin(Matrix4x4f(1), viewer);
+
+		return culler.cull({ ClusterCullerTestMeshlet() }, world, ranges);
+	}
+
+}
+
+LRTR_TEST(ClusterCullerBackFacing)
+{
+	using namespace LRTR;
+
+	auto scaled = Matrix4x4f(1);
+
+	scaled[0][0] = 0.5f;
+	scaled[1][1] = 0.5f;
+	scaled[2][2] = 0.5f;
+
+	LRTR_CHECK(ClusterCullerTestCull(Matrix4x4f(1), Vector3f(0, 0, 10)) == 1);
+	LRTR_CHECK(ClusterCullerTestCull(Matrix4x4f(1), Vector3f(0, 0, -10)) == 0);
+	LRTR_CHECK(ClusterCullerTestCull(scaled, Vector3f(0, 0, -10)) == 0);
+}
+
+LRTR_TEST(ClusterCullerNonUniformScale)
+{
+	using namespace LRTR;
+
+	//the non-uniform scale and shear change the angles of normals, so the cone is not tested
+	auto scaled = Matrix4x4f(1);
+	auto sheared = Matrix4x4f(1);
+
+	scaled[2][2] = 0.1f;
+	sheared[2][0] = 0.8f;
+
+	LRTR_CHECK(ClusterCullerTestCull(scaled, Vector3f(0, 0, -10)) == 1);
+	LRTR_CHECK(ClusterCullerTestCull(sheared, Vector3f(0, 0, -10)) == 1);
+}
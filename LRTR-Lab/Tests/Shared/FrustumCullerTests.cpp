@@ -0,0 +1,109 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Accelerators/FrustumCuller.hpp"
+
+#include <random>
+#include <cstdio>
+
+namespace LRTR {
+
+	//a frustum like box [-10, 10] with two tilted planes, so every lane of the planes is used
+	static auto FrustumCullerTestFrustum() -> FrustumF
+	{
+		FrustumF frustum;
+
+		frustum.Planes[0] = Vector4f(1, 0, 0, 10);
+		frustum.Planes[1] = Vector4f(-1, 0, 0, 10);
+		frustum.Planes[2] = Vector4f(0, 0.8f, 0.6f, 10);
+		frustum.Planes[3] = Vector4f(0, -0.8f, 0.6f, 10);
+		frustum.Planes[4] = Vector4f(0, 0, 1, 10);
+		frustum.Planes[5] = Vector4f(0, 0, -1, 10);
+
+		return frustum;
+	}
+
+}
+
+LRTR_TEST(FrustumCullerWidth)
+{
+	using namespace LRTR;
+
+	const auto width = FrustumCuller::width();
+
+	LRTR_CHECK(width == 1 || width == 4 || width == 8);
+
+	std::printf("    the frustum culler tests %zu bounds at a time\n", width);
+}
+
+LRTR_TEST(FrustumCullerMatchesScalar)
+{
+	using namespace LRTR;
+
+	const auto frustum = FrustumCullerTestFrustum();
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> centers(-20.0f, 20.0f);
+	std::uniform_real_distribution<float> extents(0.0f, 4.0f);
+
+	//the count is not a multiple of width, so the tail of SIMD version is tested too
+	FrustumCuller culler;
+
+	std::vector<Bound3f> bounds;
+
+	for (size_t index = 0; index < 1027; index++) {
+		const auto center = Vector3f(centers(random), centers(random), centers(random));
+		const auto extent = Vector3f(extents(random), extents(random), extents(random));
+
+		bounds.push_back(Bound3f(center - extent, center + extent));
+		culler.add(bounds.back());
+	}
+
+	std::vector<unsigned char> visible;
+
+	const auto count = culler.cull(frustum, visible);
+
+	LRTR_CHECK(visible.size() == bounds.size());
+
+	//one bound is less than a batch, so it is tested by the scalar version
+	size_t scalarCount = 0;
+	size_t mismatches = 0;
+
+	for (size_t index = 0; index < bounds.size(); index++) {
+		FrustumCuller single;
+		std::vector<unsigned char> singleVisible;
+
+		single.add(bounds[index]);
+		scalarCount = scalarCount + single.cull(frustum, singleVisible);
+
+		if (singleVisible[0] != visible[index]) mismatches++;
+	}
+
+	LRTR_CHECK(mismatches == 0);
+	LRTR_CHECK(count == scalarCount);
+
+	//the random bounds are both inside and outside, so both results are tested
+	LRTR_CHECK(count != 0 && count != bounds.size());
+}
+
+LRTR_TEST(FrustumCullerObviousBounds)
+{
+	using namespace LRTR;
+
+	const auto frustum = FrustumCullerTestFrustum();
+
+	FrustumCuller culler;
+
+	for (size_t index = 0; index < 16; index++) {
+		//the even bounds are at the origin and the odd ones are far away on x axis
+		const auto center = Vector3f(index % 2 == 0 ? 0.0f : 100.0f, 0, 0);
+
+		culler.add(Bound3f(center - Vector3f(1), center + Vector3f(1)));
+	}
+
+	std::vector<unsigned char> visible;
+
+	LRTR_CHECK(culler.cull(frustum, visible) == 8);
+
+	for (size_t index = 0; index < 16; index++)
+		LRTR_CHECK(visible[index] == (index % 2 == 0 ? 1 : 0));
+}
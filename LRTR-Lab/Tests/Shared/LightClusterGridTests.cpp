@@ -0,0 +1,174 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Accelerators/LightClusterGrid.hpp"
+
+#include <random>
+#include <cmath>
+
+namespace LRTR {
+
+	//the right handed perspective projection with depth range [-1, 1], it is the projection the grid expects
+	static auto LightClusterTestProjection(const float fovY, const float aspect, const float zNear, const float zFar) -> Matrix4x4f
+	{
+		const auto focal = 1.0f / std::tan(fovY * 0.5f);
+
+		auto projection = Matrix4x4f(0);
+
+		projection[0][0] = focal / aspect;
+		projection[1][1] = focal;
+		projection[2][2] = -(zFar + zNear) / (zFar - zNear);
+		projection[2][3] = -1.0f;
+		projection[3][2] = -(2.0f * zFar * zNear) / (zFar - zNear);
+
+		return projection;
+	}
+
+	//the view moves the world by (1, -2, -3), so the lights are not centered on the camera
+	static auto LightClusterTestView() -> Matrix4x4f
+	{
+		auto view = Matrix4x4f(1);
+
+		view[3] = Vector4f(1, -2, -3, 1);
+
+		return view;
+	}
+
+	static auto LightClusterTestLights(const size_t count, const unsigned seed) -> std::vector<Vector4f>
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> xy(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> z(-120.0f, 10.0f);
+		std::uniform_real_distribution<float> radius(0.1f, 8.0f);
+
+		std::vector<Vector4f> lights;
+
+		for (size_t index = 0; index < count; index++)
+			lights.push_back(Vector4f(xy(random), xy(random), z(random), radius(random)));
+
+		return lights;
+	}
+
+	//test every light with every cluster, the grid should find the same lights for each cluster
+	static auto LightClusterBruteForce(
+		const LightClusterGrid& grid,
+		const Matrix4x4f& view,
+		const std::vector<Vector4f>& lights)
+		-> std::vector<std::vector<unsigned>>
+	{
+		std::vector<std::vector<unsigned>> result(grid.width() * grid.height() * grid.depth());
+
+		for (size_t cluster = 0; cluster < result.size(); cluster++) {
+			for (size_t light = 0; light < lights.size(); light++) {
+				const auto center = Vector3f(view * Vector4f(Vector3f(lights[light]), 1.0f));
+
+				if (grid.bound(cluster).overlap(center, lights[light].w))
+					result[cluster].push_back(static_cast<unsigned>(light));
+			}
+		}
+
+		return result;
+	}
+
+}
+
+LRTR_TEST(LightClusterGridSlices)
+{
+	using namespace LRTR;
+
+	LightClusterGrid grid(16, 9, 24);
+
+	grid.update(LightClusterTestProjection(1.0f, 16.0f / 9.0f, 0.1f, 100.0f));
+
+	LRTR_CHECK(std::abs(grid.zNear() - 0.1f) < 1e-3f);
+	LRTR_CHECK(std::abs(grid.zFar() - 100.0f) < 1e-1f);
+
+	LRTR_CHECK(grid.slice(0.0f) == 0);
+	LRTR_CHECK(grid.slice(1000.0f) == grid.depth() - 1);
+
+	//the slices grow with depth and the bound of cluster contains the depth of its slice
+	for (size_t step = 1; step < 200; step++) {
+		const auto depth = 0.1f + step * 0.5f;
+
+		LRTR_CHECK(grid.slice(depth) >= grid.slice(depth - 0.5f));
+
+		const auto& bound = grid.bound(grid.index(8, 4, grid.slice(depth)));
+
+		LRTR_CHECK(-bound.Max.z <= depth + 1e-3f && -bound.Min.z >= depth - 1e-3f);
+	}
+}
+
+LRTR_TEST(LightClusterGridMatchesBruteForce)
+{
+	using namespace LRTR;
+
+	LightClusterGrid grid(16, 9, 24);
+
+	const auto view = LightClusterTestView();
+	const auto lights = LightClusterTestLights(300, 11);
+
+	grid.update(LightClusterTestProjection(1.0f, 16.0f / 9.0f, 0.1f, 100.0f));
+	grid.build(view, lights);
+
+	const auto expected = LightClusterBruteForce(grid, view, lights);
+
+	size_t mismatches = 0;
+	size_t pairs = 0;
+
+	for (size_t cluster = 0; cluster < expected.size(); cluster++) {
+		const auto& range = grid.clusters()[cluster];
+		const auto begin = grid.indices().begin() + range.Offset;
+
+		//the lights of one cluster are in the order of lights, so we can compare them directly
+		if (std::vector<unsigned>(begin, begin + range.Count) != expected[cluster]) mismatches++;
+
+		pairs = pairs + expected[cluster].size();
+	}
+
+	LRTR_CHECK(mismatches == 0);
+	LRTR_CHECK(pairs == grid.indices().size());
+	LRTR_CHECK(pairs != 0);
+}
+
+LRTR_TEST(LightClusterGridRebuild)
+{
+	using namespace LRTR;
+
+	LightClusterGrid grid(8, 8, 8);
+
+	const auto view = LightClusterTestView();
+
+	grid.update(LightClusterTestProjection(1.2f, 1.0f, 0.5f, 50.0f));
+	grid.build(view, LightClusterTestLights(100, 3));
+
+	//the grid is reused every frame, so the results of the last build must not be kept
+	grid.build(view, {});
+
+	LRTR_CHECK(grid.indices().empty());
+
+	for (const auto& cluster : grid.clusters()) LRTR_CHECK(cluster.Count == 0);
+}
+
+LRTR_BENCHMARK(LightClusterGridBinning)
+{
+	using namespace LRTR;
+
+	LightClusterGrid grid(16, 9, 24);
+
+	const auto view = LightClusterTestView();
+	const auto lights = LightClusterTestLights(1024, 5);
+
+	grid.update(LightClusterTestProjection(1.0f, 16.0f / 9.0f, 0.1f, 100.0f));
+
+	size_t bruteForcePairs = 0;
+
+	Testing::measure("cluster grid, 1024 lights", 20, [&]() { grid.build(view, lights); });
+	Testing::measure("brute force, 1024 lights", 3, [&]()
+		{
+			bruteForcePairs = 0;
+
+			for (const auto& cluster : LightClusterBruteForce(grid, view, lights))
+				bruteForcePairs = bruteForcePairs + cluster.size();
+		});
+
+	LRTR_CHECK(bruteForcePairs == grid.indices().size());
+}
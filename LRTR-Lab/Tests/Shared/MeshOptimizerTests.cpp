@@ -0,0 +1,212 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Meshes/MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <random>
+#include <deque>
+#include <array>
+#include <cmath>
+
+namespace LRTR {
+
+	//the sphere with shuffled triangles, so the vertex cache and vertex fetch are bad before we optimize them
+	//the last vertices are not used by any triangle
+	struct MeshOptimizerTestMesh {
+		std::vector<Vector3f> Positions;
+		std::vector<unsigned> Indices;
+
+		MeshOptimizerTestMesh(const size_t slices, const size_t stacks, const unsigned seed)
+		{
+			for (size_t stack = 0; stack <= stacks; stack++) {
+				for (size_t slice = 0; slice <= slices; slice++) {
+					const auto theta = static_cast<float>(stack) / static_cast<float>(stacks) * 3.1415926f;
+					const auto phi = static_cast<float>(slice) / static_cast<float>(slices) * 6.2831853f;
+
+					Positions.push_back(Vector3f(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+				}
+			}
+
+			std::vector<std::array<unsigned, 3>> triangles;
+
+			for (size_t stack = 0; stack < stacks; stack++) {
+				for (size_t slice = 0; slice < slices; slice++) {
+					const auto v0 = static_cast<unsigned>(stack * (slices + 1) + slice);
+					const auto v1 = v0 + 1;
+					const auto v2 = v0 + static_cast<unsigned>(slices + 1);
+					const auto v3 = v2 + 1;
+
+					triangles.push_back({ v0, v1, v3 });
+					triangles.push_back({ v0, v3, v2 });
+				}
+			}
+
+			std::mt19937 random(seed);
+
+			std::shuffle(triangles.begin(), triangles.end(), random);
+
+			for (const auto& triangle : triangles) Indices.insert(Indices.end(), triangle.begin(), triangle.end());
+
+			for (size_t index = 0; index < 5; index++) Positions.push_back(Vector3f(2.0f, 0, static_cast<float>(index)));
+		}
+	};
+
+	//the triangles rotated so the smallest index is the first (the winding is kept), then sorted
+	//the reordered mesh has the same triangles if it has the same canonical triangles
+	static auto MeshOptimizerTestTriangles(const std::vector<unsigned>& indices) -> std::vector<std::array<unsigned, 3>>
+	{
+		std::vector<std::array<unsigned, 3>> triangles;
+
+		for (size_t triangle = 0; triangle < indices.size() / 3; triangle++) {
+			std::array<unsigned, 3> vertices = { indices[triangle * 3 + 0], indices[triangle * 3 + 1], indices[triangle * 3 + 2] };
+
+			std::rotate(vertices.begin(), std::min_element(vertices.begin(), vertices.end()), vertices.end());
+
+			triangles.push_back(vertices);
+		}
+
+		std::sort(triangles.begin(), triangles.end());
+
+		return triangles;
+	}
+
+	//simulate the FIFO cache with a queue, return the number of transformed vertices
+	static auto MeshOptimizerTestTransformed(const std::vector<unsigned>& indices, const size_t cacheSize) -> size_t
+	{
+		std::deque<unsigned> cache;
+
+		size_t transformed = 0;
+
+		for (const auto index : indices) {
+			if (std::find(cache.begin(), cache.end(), index) != cache.end()) continue;
+
+			cache.push_back(index);
+			transformed++;
+
+			if (cache.size() > cacheSize) cache.pop_front();
+		}
+
+		return transformed;
+	}
+
+}
+
+LRTR_TEST(MeshOptimizerAnalyzeVertexCache)
+{
+	using namespace LRTR;
+
+	const MeshOptimizerTestMesh mesh(32, 24, 3);
+
+	for (const size_t cacheSize : { 4, 16, 32 }) {
+		const auto statistics = MeshOptimizer::analyzeVertexCache(mesh.Indices, mesh.Positions.size(), cacheSize);
+		const auto transformed = MeshOptimizerTestTransformed(mesh.Indices, cacheSize);
+
+		LRTR_CHECK(statistics.Transformed == transformed);
+		LRTR_CHECK(statistics.ACMR == static_cast<float>(transformed) / static_cast<float>(mesh.Indices.size() / 3));
+	}
+}
+
+LRTR_TEST(MeshOptimizerVertexCache)
+{
+	using namespace LRTR;
+
+	const MeshOptimizerTestMesh mesh(32, 24, 5);
+
+	std::vector<unsigned> clusters;
+
+	const auto optimized = MeshOptimizer::optimizeVertexCache(mesh.Indices, mesh.Positions.size(), &clusters);
+
+	LRTR_CHECK(MeshOptimizerTestTriangles(optimized) == MeshOptimizerTestTriangles(mesh.Indices));
+
+	const auto before = MeshOptimizer::analyzeVertexCache(mesh.Indices, mesh.Positions.size());
+	const auto after = MeshOptimizer::analyzeVertexCache(optimized, mesh.Positions.size());
+
+	LRTR_CHECK(after.ACMR < before.ACMR);
+	LRTR_CHECK(after.ACMR < 1.0f);
+
+	//the clusters start from the first triangle and are sorted
+	LRTR_CHECK(!clusters.empty() && clusters[0] == 0);
+	LRTR_CHECK(std::is_sorted(clusters.begin(), clusters.end()));
+	LRTR_CHECK(clusters.back() < optimized.size() / 3);
+}
+
+LRTR_TEST(MeshOptimizerOverdraw)
+{
+	using namespace LRTR;
+
+	const auto threshold = 1.05f;
+
+	for (const unsigned seed : { 7, 11, 13 }) {
+		const MeshOptimizerTestMesh mesh(32, 24, seed);
+
+		std::vector<unsigned> clusters;
+
+		const auto optimized = MeshOptimizer::optimizeVertexCache(mesh.Indices, mesh.Positions.size(), &clusters);
+		const auto sorted = MeshOptimizer::optimizeOverdraw(optimized, mesh.Positions, clusters, threshold);
+
+		LRTR_CHECK(MeshOptimizerTestTriangles(sorted) == MeshOptimizerTestTriangles(mesh.Indices));
+
+		//the clusters are drawn in any order, so the cache may be cold at the beginning of each cluster
+		//the split clusters should not be much worse than the clusters with cold cache
+		size_t transformed = 0;
+
+		for (size_t cluster = 0; cluster < clusters.size(); cluster++) {
+			const auto begin = static_cast<size_t>(clusters[cluster]);
+			const auto end = cluster + 1 < clusters.size() ? static_cast<size_t>(clusters[cluster + 1]) : optimized.size() / 3;
+
+			transformed = transformed + MeshOptimizerTestTransformed(
+				std::vector<unsigned>(optimized.begin() + begin * 3, optimized.begin() + end * 3), MeshOptimizer::VertexCacheSize);
+		}
+
+		const auto coldACMR = static_cast<float>(transformed) / static_cast<float>(optimized.size() / 3);
+		const auto after = MeshOptimizer::analyzeVertexCache(sorted, mesh.Positions.size());
+
+		LRTR_CHECK(after.ACMR <= coldACMR * threshold);
+	}
+}
+
+LRTR_TEST(MeshOptimizerVertexFetch)
+{
+	using namespace LRTR;
+
+	const MeshOptimizerTestMesh mesh(32, 24, 9);
+
+	const auto indices = MeshOptimizer::optimizeVertexCache(mesh.Indices, mesh.Positions.size());
+	const auto remap = MeshOptimizer::optimizeVertexFetch(indices, mesh.Positions.size());
+
+	//the remap is a permutation of vertices
+	LRTR_CHECK(remap.size() == mesh.Positions.size());
+
+	auto sortedRemap = remap;
+
+	std::sort(sortedRemap.begin(), sortedRemap.end());
+
+	for (size_t index = 0; index < sortedRemap.size(); index++) LRTR_CHECK(sortedRemap[index] == index);
+
+	auto positions = mesh.Positions;
+	auto remappedIndices = indices;
+
+	MeshOptimizer::remapVertices(positions, remap);
+	MeshOptimizer::remapIndices(remappedIndices, remap);
+
+	//the vertices are in the order they are first used, so every index is not larger than the next new vertex
+	unsigned next = 0;
+	size_t unordered = 0;
+	size_t mismatches = 0;
+
+	for (size_t index = 0; index < remappedIndices.size(); index++) {
+		if (remappedIndices[index] > next) unordered++;
+		if (remappedIndices[index] == next) next++;
+
+		if (positions[remappedIndices[index]] != mesh.Positions[indices[index]]) mismatches++;
+	}
+
+	LRTR_CHECK(unordered == 0);
+	LRTR_CHECK(mismatches == 0);
+
+	//the unused vertices are after the used vertices
+	LRTR_CHECK(next == mesh.Positions.size() - 5);
+
+	for (size_t index = mesh.Positions.size() - 5; index < mesh.Positions.size(); index++)
+		LRTR_CHECK(remap[index] >= next);
+}
@@ -0,0 +1,166 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Meshes/MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+namespace LRTR {
+
+	//the height field in [0, size - 1] x [0, size - 1], the triangles are counter-clockwise seen from +z
+	struct MeshSimplifierTestMesh {
+		std::vector<Vector3f> Positions;
+		std::vector<unsigned> Indices;
+
+		MeshSimplifierTestMesh(const size_t size, const float noise, const unsigned seed)
+		{
+			std::mt19937 random(seed);
+			std::uniform_real_distribution<float> offsets(-noise, noise);
+
+			for (size_t y = 0; y < size; y++) {
+				for (size_t x = 0; x < size; x++) {
+					const auto height = std::sin(static_cast<float>(x) * 0.2f) * std::cos(static_cast<float>(y) * 0.15f) * 2.0f;
+
+					Positions.push_back(Vector3f(static_cast<float>(x), static_cast<float>(y), height + offsets(random)));
+				}
+			}
+
+			for (size_t y = 0; y + 1 < size; y++) {
+				for (size_t x = 0; x + 1 < size; x++) {
+					const auto v0 = static_cast<unsigned>(y * size + x);
+					const auto v1 = v0 + 1;
+					const auto v2 = v0 + static_cast<unsigned>(size);
+					const auto v3 = v2 + 1;
+
+					Indices.insert(Indices.end(), { v0, v1, v3, v0, v3, v2 });
+				}
+			}
+		}
+	};
+
+	//the result is valid if the triangles use the vertices of mesh, are not degenerate and are not flipped
+	//the height field is seen from +z, so the flipped triangle has a normal pointing to -z
+	//the triangle on a grid line has zero area seen from +z, it is steep but not flipped
+	//the triangles without flips and overlaps cover the grid once, so the areas seen from +z sum to the area of grid
+	static auto MeshSimplifierTestInvalid(const MeshSimplifierTestMesh& mesh, const std::vector<unsigned>& indices) -> size_t
+	{
+		if (indices.size() % 3 != 0) return 1;
+
+		const auto extent = mesh.Positions.back().x;
+
+		size_t invalid = 0;
+
+		auto area = 0.0;
+
+		for (size_t triangle = 0; triangle < indices.size() / 3; triangle++) {
+			const auto v0 = indices[triangle * 3 + 0];
+			const auto v1 = indices[triangle * 3 + 1];
+			const auto v2 = indices[triangle * 3 + 2];
+
+			if (v0 >= mesh.Positions.size() || v1 >= mesh.Positions.size() || v2 >= mesh.Positions.size()) { invalid++; continue; }
+			if (v0 == v1 || v1 == v2 || v2 == v0) { invalid++; continue; }
+
+			const auto normal = glm::cross(mesh.Positions[v1] - mesh.Positions[v0], mesh.Positions[v2] - mesh.Positions[v0]);
+
+			if (normal.z < 0) invalid++;
+
+			area = area + std::abs(normal.z) * 0.5;
+		}
+
+		if (std::abs(area - extent * extent) > 1e-3 * extent * extent) invalid++;
+
+		return invalid;
+	}
+
+	//the vertices on the border of grid are locked, so the result still uses all of them
+	static auto MeshSimplifierTestMissingBorder(const size_t size, const std::vector<unsigned>& indices) -> size_t
+	{
+		std::vector<unsigned char> used(size * size, 0);
+
+		for (const auto index : indices) used[index] = 1;
+
+		size_t missing = 0;
+
+		for (size_t y = 0; y < size; y++) {
+			for (size_t x = 0; x < size; x++) {
+				const auto border = x == 0 || y == 0 || x + 1 == size || y + 1 == size;
+
+				if (border && !used[y * size + x]) missing++;
+			}
+		}
+
+		return missing;
+	}
+
+}
+
+LRTR_TEST(MeshSimplifierSimplify)
+{
+	using namespace LRTR;
+
+	const MeshSimplifierTestMesh mesh(40, 0.05f, 3);
+
+	const auto target = mesh.Indices.size() / 4;
+
+	auto error = 0.0f;
+
+	const auto result = MeshSimplifier::simplify(mesh.Positions, mesh.Indices, target, 1.0f, &error);
+
+	LRTR_CHECK(result.size() <= target);
+	LRTR_CHECK(!result.empty());
+	LRTR_CHECK(error > 0 && error <= 1.0f);
+	LRTR_CHECK(MeshSimplifierTestInvalid(mesh, result) == 0);
+	LRTR_CHECK(MeshSimplifierTestMissingBorder(40, result) == 0);
+}
+
+LRTR_TEST(MeshSimplifierMaxError)
+{
+	using namespace LRTR;
+
+	const MeshSimplifierTestMesh mesh(40, 0.3f, 5);
+
+	auto looseError = 0.0f;
+	auto tightError = 0.0f;
+
+	//the target can not be reached, so the simplification stops at the max error
+	const auto loose = MeshSimplifier::simplify(mesh.Positions, mesh.Indices, 0, 0.02f, &looseError);
+	const auto tight = MeshSimplifier::simplify(mesh.Positions, mesh.Indices, 0, 0.002f, &tightError);
+
+	LRTR_CHECK(looseError <= 0.02f);
+	LRTR_CHECK(tightError <= 0.002f);
+	LRTR_CHECK(tight.size() > loose.size());
+	LRTR_CHECK(tight.size() < mesh.Indices.size());
+	LRTR_CHECK(MeshSimplifierTestInvalid(mesh, loose) == 0);
+	LRTR_CHECK(MeshSimplifierTestInvalid(mesh, tight) == 0);
+
+	//the zero error keeps the mesh with noise as it is, the target is not more than the indices
+	const auto original = MeshSimplifier::simplify(mesh.Positions, mesh.Indices, mesh.Indices.size(), 0.0f);
+
+	LRTR_CHECK(original == mesh.Indices);
+}
+
+LRTR_TEST(MeshSimplifierLevels)
+{
+	using namespace LRTR;
+
+	const MeshSimplifierTestMesh mesh(40, 0.05f, 7);
+
+	const auto levels = MeshSimplifier::simplifyLevels(mesh.Positions, mesh.Indices, 4, 0.5f, 0.1f);
+
+	LRTR_CHECK(!levels.empty());
+
+	//every level has fewer triangles than the previous one, and the error is accumulated
+	auto previousSize = mesh.Indices.size();
+	auto previousError = 0.0f;
+
+	for (const auto& level : levels) {
+		LRTR_CHECK(level.Indices.size() < previousSize);
+		LRTR_CHECK(level.Error >= previousError);
+		LRTR_CHECK(MeshSimplifierTestInvalid(mesh, level.Indices) == 0);
+		LRTR_CHECK(MeshSimplifierTestMissingBorder(40, level.Indices) == 0);
+
+		previousSize = level.Indices.size();
+		previousError = level.Error;
+	}
+}
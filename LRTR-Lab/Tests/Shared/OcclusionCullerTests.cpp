@@ -0,0 +1,265 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Accelerators/OcclusionCuller.hpp"
+
+#include <random>
+#include <cstdio>
+#include <cmath>
+
+namespace LRTR {
+
+	//the view projection of tests is identity, so the world space is the ndc and the screen x is (x + 1) / 2 * width
+	static auto OcclusionTestNdcX(const float pixel, const size_t width) -> float
+	{
+		return pixel / static_cast<float>(width) * 2.0f - 1.0f;
+	}
+
+	static auto OcclusionTestNdcY(const float pixel, const size_t height) -> float
+	{
+		return 1.0f - pixel / static_cast<float>(height) * 2.0f;
+	}
+
+	//the quad is [minX, maxX] x [minY, maxY] in ndc, its z is z0 + slope * x
+	struct OcclusionTestQuad {
+		std::vector<Vector3f> Positions;
+		std::vector<unsigned> Indices = { 0, 1, 2, 0, 2, 3 };
+
+		OcclusionTestQuad(const float minX, const float maxX, const float minY, const float maxY, const float z0, const float slope = 0)
+		{
+			Positions = {
+				Vector3f(minX, minY, z0 + slope * minX),
+				Vector3f(maxX, minY, z0 + slope * maxX),
+				Vector3f(maxX, maxY, z0 + slope * maxX),
+				Vector3f(minX, maxY, z0 + slope * minX)
+			};
+		}
+	};
+
+	//the box has 12 triangles, it is the occluder we use in the benchmark
+	struct OcclusionTestBox {
+		std::vector<Vector3f> Positions;
+		std::vector<unsigned> Indices = {
+			0, 1, 2, 0, 2, 3, 4, 6, 5, 4, 7, 6,
+			0, 4, 5, 0, 5, 1, 3, 2, 6, 3, 6, 7,
+			0, 3, 7, 0, 7, 4, 1, 5, 6, 1, 6, 2
+		};
+
+		explicit OcclusionTestBox(const Bound3f& bound)
+		{
+			for (size_t corner = 0; corner < 8; corner++) {
+				const auto x = (corner == 1 || corner == 2 || corner == 5 || corner == 6) ? bound.Max.x : bound.Min.x;
+				const auto y = (corner == 2 || corner == 3 || corner == 6 || corner == 7) ? bound.Max.y : bound.Min.y;
+				const auto z = corner >= 4 ? bound.Max.z : bound.Min.z;
+
+				Positions.push_back(Vector3f(x, y, z));
+			}
+		}
+	};
+
+}
+
+LRTR_TEST(OcclusionCullerOccludesBehind)
+{
+	using namespace LRTR;
+
+	OcclusionCuller culler(256, 128);
+
+	//the quad is [62.72, 193.28] x [31.36, 96.64] in screen, the edges are not on the borders of texels
+	const auto quad = OcclusionTestQuad(-0.51f, 0.51f, -0.51f, 0.51f, 0.0f);
+
+	culler.clear(Matrix4x4f(1));
+	culler.add(quad.Positions, quad.Indices, Matrix4x4f(1));
+	culler.render();
+
+	//the depth of quad is 0.5, the bound behind it is occluded and the bound in front of it is not
+	LRTR_CHECK(!culler.test(Bound3f(Vector3f(-0.2f, -0.2f, 0.2f), Vector3f(0.2f, 0.2f, 0.4f))));
+	LRTR_CHECK(culler.test(Bound3f(Vector3f(-0.2f, -0.2f, -0.4f), Vector3f(0.2f, 0.2f, -0.2f))));
+
+	//the bound is larger than the quad, so a part of it is visible
+	LRTR_CHECK(culler.test(Bound3f(Vector3f(-0.7f, -0.2f, 0.2f), Vector3f(0.2f, 0.2f, 0.4f))));
+
+	//the texels inside the quad are covered even on the shared diagonal and the partial texels are not
+	size_t cracks = 0;
+
+	for (size_t y = 32; y < 96; y++)
+		for (size_t x = 63; x < 193; x++)
+			if (std::abs(culler.depth(0)[y * 256 + x] - 0.5f) > 1e-5f) cracks++;
+
+	LRTR_CHECK(cracks == 0);
+	LRTR_CHECK(culler.depth(0)[64 * 256 + 62] == 1.0f);
+	LRTR_CHECK(culler.depth(0)[64 * 256 + 193] == 1.0f);
+	LRTR_CHECK(culler.depth(0)[31 * 256 + 128] == 1.0f);
+	LRTR_CHECK(culler.depth(0)[96 * 256 + 128] == 1.0f);
+}
+
+LRTR_TEST(OcclusionCullerRotatedBox)
+{
+	using namespace LRTR;
+
+	constexpr size_t width = 256, height = 128;
+
+	OcclusionCuller culler(width, height);
+
+	//the box is rotated around z, so the outline is not aligned to the texels
+	auto box = OcclusionTestBox(Bound3f(Vector3f(-0.4f, -0.4f, -0.1f), Vector3f(0.4f, 0.4f, 0.1f)));
+
+	const auto angle = 0.5f;
+
+	for (auto& position : box.Positions) {
+		position = Vector3f(
+			position.x * std::cos(angle) - position.y * std::sin(angle),
+			position.x * std::sin(angle) + position.y * std::cos(angle), position.z);
+	}
+
+	culler.clear(Matrix4x4f(1));
+	culler.add(box.Positions, box.Indices, Matrix4x4f(1));
+	culler.render();
+
+	//the texels that are written must be inside the box, we test the four corners of them
+	size_t outside = 0;
+	size_t covered = 0;
+
+	for (size_t y = 0; y < height; y++) {
+		for (size_t x = 0; x < width; x++) {
+			if (culler.depth(0)[y * width + x] == 1.0f) continue;
+
+			for (size_t corner = 0; corner < 4; corner++) {
+				const auto ndcX = OcclusionTestNdcX(static_cast<float>(x + (corner & 1)), width);
+				const auto ndcY = OcclusionTestNdcY(static_cast<float>(y + (corner >> 1)), height);
+
+				//rotate back to the space of box
+				const auto localX = ndcX * std::cos(angle) + ndcY * std::sin(angle);
+				const auto localY = -ndcX * std::sin(angle) + ndcY * std::cos(angle);
+
+				if (std::abs(localX) > 0.4f + 1e-4f || std::abs(localY) > 0.4f + 1e-4f) outside++;
+			}
+
+			covered++;
+		}
+	}
+
+	LRTR_CHECK(outside == 0);
+	LRTR_CHECK(covered > 2000);
+
+	//the depth of box is the depth of its back face, 0.55
+	LRTR_CHECK(std::abs(culler.depth(0)[64 * width + 128] - 0.55f) < 1e-5f);
+}
+
+LRTR_TEST(OcclusionCullerPartialTexels)
+{
+	using namespace LRTR;
+
+	constexpr size_t width = 256, height = 128;
+
+	OcclusionCuller culler(width, height);
+
+	//the right edge of occluder is at 100.6, so it covers the center of texel 100 but not the whole texel
+	//the texel 100 is not covered, so it keeps the far depth
+	const auto quad = OcclusionTestQuad(-1.0f, OcclusionTestNdcX(100.6f, width), -1.0f, 1.0f, 0.0f);
+
+	culler.clear(Matrix4x4f(1));
+	culler.add(quad.Positions, quad.Indices, Matrix4x4f(1));
+	culler.render();
+
+	LRTR_CHECK(std::abs(culler.depth(0)[64 * width + 99] - 0.5f) < 1e-5f);
+	LRTR_CHECK(culler.depth(0)[64 * width + 100] == 1.0f);
+
+	//the bound behind the occluder is in [100.7, 101] of screen, it is visible in the texel 100
+	const auto bound = Bound3f(
+		Vector3f(OcclusionTestNdcX(100.7f, width), OcclusionTestNdcY(64.9f, height), 0.2f),
+		Vector3f(OcclusionTestNdcX(101.0f, width), OcclusionTestNdcY(64.1f, height), 0.4f));
+
+	LRTR_CHECK(culler.test(bound));
+}
+
+LRTR_TEST(OcclusionCullerMaxDepth)
+{
+	using namespace LRTR;
+
+	constexpr size_t width = 256, height = 128;
+	constexpr float slope = 0.4f;
+
+	OcclusionCuller culler(width, height);
+
+	//the depth of quad changes along x, the texels must store the max depth of the quad in them
+	const auto quad = OcclusionTestQuad(-0.8f, 0.8f, -0.8f, 0.8f, 0.0f, slope);
+
+	culler.clear(Matrix4x4f(1));
+	culler.add(quad.Positions, quad.Indices, Matrix4x4f(1));
+	culler.render();
+
+	size_t covered = 0;
+	size_t nearer = 0;
+
+	for (size_t y = 0; y < height; y++) {
+		for (size_t x = 0; x < width; x++) {
+			const auto depth = culler.depth(0)[y * width + x];
+
+			if (depth == 1.0f) continue;
+
+			//the max depth is at the right side of texel, the depth of ndc is z * 0.5 + 0.5
+			const auto maxDepth = slope * OcclusionTestNdcX(static_cast<float>(x + 1), width) * 0.5f + 0.5f;
+
+			if (depth < maxDepth - 1e-5f) nearer++;
+
+			covered++;
+		}
+	}
+
+	LRTR_CHECK(covered != 0);
+	LRTR_CHECK(nearer == 0);
+}
+
+LRTR_BENCHMARK(OcclusionCullerRenderAndTest)
+{
+	using namespace LRTR;
+
+	std::mt19937 random(17);
+	std::uniform_real_distribution<float> position(-0.9f, 0.9f);
+	std::uniform_real_distribution<float> size(0.05f, 0.3f);
+	std::uniform_real_distribution<float> depth(-0.5f, 0.9f);
+
+	std::vector<OcclusionTestBox> occluders;
+	std::vector<Bound3f> bounds;
+
+	for (size_t index = 0; index < 256; index++) {
+		const auto center = Vector3f(position(random), position(random), depth(random));
+		const auto extent = Vector3f(size(random), size(random), 0.05f);
+
+		occluders.push_back(OcclusionTestBox(Bound3f(center - extent, center + extent)));
+	}
+
+	for (size_t index = 0; index < 100000; index++) {
+		const auto center = Vector3f(position(random), position(random), depth(random));
+		const auto extent = Vector3f(size(random) * 0.1f);
+
+		bounds.push_back(Bound3f(center - extent, center + extent));
+	}
+
+	OcclusionCuller culler(256, 128);
+	ThreadPool threadPool;
+
+	const auto render = [&](ThreadPool* pool)
+	{
+		culler.clear(Matrix4x4f(1));
+
+		for (const auto& occluder : occluders) culler.add(occluder.Positions, occluder.Indices, Matrix4x4f(1));
+
+		culler.render(pool);
+	};
+
+	size_t visible = 0;
+
+	Testing::measure("render 256 boxes, one thread", 50, [&]() { render(nullptr); });
+	Testing::measure("render 256 boxes, thread pool", 50, [&]() { render(&threadPool); });
+	Testing::measure("test 100000 bounds", 10, [&]()
+		{
+			visible = 0;
+
+			for (const auto& bound : bounds) visible = visible + (culler.test(bound) ? 1 : 0);
+		});
+
+	std::printf("    %zu of %zu bounds are visible\n", visible, bounds.size());
+
+	LRTR_CHECK(visible != 0 && visible != bounds.size());
+}
@@ -0,0 +1,99 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Allocators/RangeAllocator.hpp"
+
+namespace LRTR {
+
+	//four ranges with 16 elements, the second and third are released so there is a hole of 32 elements
+	static void RangeAllocatorTestHole(RangeAllocator& allocator)
+	{
+		allocator.allocate(16, 1);
+		allocator.allocate(16, 2);
+		allocator.allocate(16, 3);
+		allocator.allocate(16, 4);
+
+		allocator.release(16);
+		allocator.release(32);
+	}
+
+}
+
+LRTR_TEST(RangeAllocatorRelocate)
+{
+	using namespace LRTR;
+
+	RangeAllocator allocator;
+	RangeRelocation relocation;
+
+	RangeAllocatorTestHole(allocator);
+
+	LRTR_CHECK(allocator.relocateLast(relocation));
+	LRTR_CHECK(relocation.Owner == 4 && relocation.From == 48 && relocation.To == 16 && relocation.Count == 16);
+
+	//the old range is released at once, so the end is trimmed
+	LRTR_CHECK(allocator.end() == 32);
+	LRTR_CHECK(allocator.used() == 32);
+	LRTR_CHECK(!allocator.relocateLast(relocation));
+}
+
+LRTR_TEST(RangeAllocatorRelocateKeepSource)
+{
+	using namespace LRTR;
+
+	RangeAllocator allocator;
+	RangeRelocation relocation;
+
+	RangeAllocatorTestHole(allocator);
+
+	LRTR_CHECK(allocator.relocateLast(relocation, true));
+	LRTR_CHECK(relocation.Owner == 4 && relocation.From == 48 && relocation.To == 16);
+
+	//the kept range is still allocated, so the new range does not overwrite it
+	LRTR_CHECK(allocator.end() == 64);
+	LRTR_CHECK(allocator.used() == 48);
+	LRTR_CHECK(allocator.allocate(16, 5) == 32);
+	LRTR_CHECK(allocator.allocate(16, 6) == 64);
+
+	allocator.release(32);
+
+	//the last range is moved before the kept range, the kept range itself is never moved
+	LRTR_CHECK(allocator.relocateLast(relocation, true));
+	LRTR_CHECK(relocation.Owner == 6 && relocation.From == 64 && relocation.To == 32);
+	LRTR_CHECK(!allocator.relocateLast(relocation, true));
+
+	//the kept ranges are trimmed when the caller releases them
+	allocator.release(64);
+	allocator.release(48);
+
+	LRTR_CHECK(allocator.end() == 48);
+	LRTR_CHECK(allocator.used() == 48);
+	LRTR_CHECK(allocator.unused() == 0);
+}
+
+LRTR_TEST(RangeAllocatorKeepReleased)
+{
+	using namespace LRTR;
+
+	//the mesh 4 is released and waiting for retire, then the defragmentation runs before the retire
+	RangeAllocator allocator;
+	RangeRelocation relocation;
+
+	RangeAllocatorTestHole(allocator);
+
+	allocator.keep(48);
+
+	//the kept range is not moved, and the range before it has no free range before it
+	LRTR_CHECK(!allocator.relocateLast(relocation, true));
+	LRTR_CHECK(allocator.used() == 32);
+
+	//the new mesh uses the hole, the kept range is still allocated
+	LRTR_CHECK(allocator.allocate(32, 5) == 16);
+	LRTR_CHECK(allocator.allocate(16, 6) == 64);
+
+	//the retire releases the kept range once, the ranges of new meshes are not changed
+	allocator.release(48);
+
+	LRTR_CHECK(allocator.used() == 64);
+	LRTR_CHECK(allocator.allocate(16, 7) == 48);
+	LRTR_CHECK(allocator.end() == 80);
+}
@@ -0,0 +1,168 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Allocators/ShadowAtlasAllocator.hpp"
+
+namespace LRTR {
+
+	//the atlas is 1024 x 1024 and the max resolution is 256, so it can hold two slots with max resolution
+	//and the third one is reduced to 128
+	static auto ShadowAtlasTestAllocator() -> ShadowAtlasAllocator
+	{
+		return ShadowAtlasAllocator(1024 * 1024 * 4, 4, 64, 1024);
+	}
+
+	//the tiles of slots must be in the atlas and must not overlap each other
+	static auto ShadowAtlasTestValid(const ShadowAtlasAllocator& allocator, const std::vector<const ShadowAtlasSlot*>& slots) -> bool
+	{
+		std::vector<unsigned char> texels(allocator.extent() * allocator.extent(), 0);
+
+		for (const auto& slot : slots) {
+			if (slot == nullptr) continue;
+
+			for (const auto& tile : slot->Tiles) {
+				if (tile.X + slot->Resolution > allocator.extent() || tile.Y + slot->Resolution > allocator.extent())
+					return false;
+
+				for (size_t y = tile.Y; y < tile.Y + slot->Resolution; y++) {
+					for (size_t x = tile.X; x < tile.X + slot->Resolution; x++) {
+						if (texels[y * allocator.extent() + x] != 0) return false;
+
+						texels[y * allocator.extent() + x] = 1;
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	static auto ShadowAtlasTestIdentifiers(const std::vector<const ShadowAtlasSlot*>& slots) -> std::vector<size_t>
+	{
+		std::vector<size_t> identifiers;
+
+		for (const auto& slot : slots) identifiers.push_back(slot != nullptr ? slot->Identifier : 0);
+
+		return identifiers;
+	}
+
+}
+
+LRTR_TEST(ShadowAtlasAllocatorLimits)
+{
+	using namespace LRTR;
+
+	auto allocator = ShadowAtlasTestAllocator();
+
+	LRTR_CHECK(allocator.extent() == 1024);
+	LRTR_CHECK(allocator.maxResolution() == 256);
+	LRTR_CHECK(allocator.minResolution() == 64);
+
+	allocator.beginFrame();
+
+	const auto slots = allocator.allocate({ { 1, 1000 }, { 2, 100 }, { 3, 1 } });
+
+	//the resolutions are rounded up to power of two and clamped
+	LRTR_CHECK(slots[0] != nullptr && slots[0]->Resolution == 256);
+	LRTR_CHECK(slots[1] != nullptr && slots[1]->Resolution == 128);
+	LRTR_CHECK(slots[2] != nullptr && slots[2]->Resolution == 64);
+	LRTR_CHECK(ShadowAtlasTestValid(allocator, slots));
+	LRTR_CHECK(allocator.usedTexels() == 6 * (256 * 256 + 128 * 128 + 64 * 64));
+
+	allocator.release(1);
+	allocator.release(2);
+	allocator.release(3);
+
+	LRTR_CHECK(allocator.size() == 0 && allocator.usedTexels() == 0);
+}
+
+LRTR_TEST(ShadowAtlasAllocatorKeepsRequestedSlots)
+{
+	using namespace LRTR;
+
+	auto allocator = ShadowAtlasTestAllocator();
+
+	allocator.beginFrame();
+
+	const auto first = allocator.allocate({ { 1, 256 }, { 2, 256 }, { 3, 256 } });
+
+	LRTR_CHECK(first[2] != nullptr && first[2]->Resolution == 128);
+
+	const auto identifiers = ShadowAtlasTestIdentifiers(first);
+
+	//the new light is allocated first, but it can not evict the lights requested in the same frame
+	allocator.beginFrame();
+
+	const auto second = allocator.allocate({ { 4, 256 }, { 1, 256 }, { 2, 256 }, { 3, 256 } });
+
+	LRTR_CHECK(allocator.evictions() == 0);
+	LRTR_CHECK(second[0] != nullptr && second[0]->Resolution == 128);
+	LRTR_CHECK(ShadowAtlasTestValid(allocator, second));
+
+	for (size_t index = 0; index < identifiers.size(); index++)
+		LRTR_CHECK(second[index + 1] != nullptr && second[index + 1]->Identifier == identifiers[index]);
+}
+
+LRTR_TEST(ShadowAtlasAllocatorReducedSlotsAreStable)
+{
+	using namespace LRTR;
+
+	auto allocator = ShadowAtlasTestAllocator();
+
+	const std::vector<ShadowAtlasRequest> requests = { { 1, 256 }, { 2, 256 }, { 3, 256 }, { 4, 256 } };
+
+	allocator.beginFrame();
+
+	const auto identifiers = ShadowAtlasTestIdentifiers(allocator.allocate(requests));
+
+	//the reduced slots still want a larger resolution, but the atlas is full
+	//so they are kept and the tiles cached with the identifiers are still valid
+	for (size_t frame = 0; frame < 4; frame++) {
+		allocator.beginFrame();
+
+		const auto slots = allocator.allocate(requests);
+
+		LRTR_CHECK(ShadowAtlasTestIdentifiers(slots) == identifiers);
+		LRTR_CHECK(ShadowAtlasTestValid(allocator, slots));
+		LRTR_CHECK(allocator.evictions() == 0);
+	}
+}
+
+LRTR_TEST(ShadowAtlasAllocatorGrowsAndShrinks)
+{
+	using namespace LRTR;
+
+	auto allocator = ShadowAtlasTestAllocator();
+
+	allocator.beginFrame();
+
+	const auto reduced = allocator.allocate({ { 1, 256 }, { 2, 256 }, { 3, 256 } })[2];
+
+	LRTR_CHECK(reduced != nullptr && reduced->Resolution == 128);
+
+	const auto reducedIdentifier = reduced->Identifier;
+
+	//the other lights are not requested, so they can be evicted and the reduced slot grows
+	allocator.beginFrame();
+
+	const auto grown = allocator.allocate({ { 3, 256 } })[0];
+
+	LRTR_CHECK(grown != nullptr && grown->Resolution == 256);
+	LRTR_CHECK(grown->Identifier != reducedIdentifier);
+	LRTR_CHECK(allocator.evictions() != 0);
+
+	//the slot is not shrunk by one level, so a light moves a little does not reallocate the slot
+	const auto grownIdentifier = grown->Identifier;
+
+	allocator.beginFrame();
+
+	const auto kept = allocator.allocate({ { 3, 128 } })[0];
+
+	LRTR_CHECK(kept != nullptr && kept->Resolution == 256 && kept->Identifier == grownIdentifier);
+
+	allocator.beginFrame();
+
+	const auto shrunk = allocator.allocate({ { 3, 64 } })[0];
+
+	LRTR_CHECK(shrunk != nullptr && shrunk->Resolution == 64 && shrunk->Identifier != grownIdentifier);
+	LRTR_CHECK(allocator.find(3) == shrunk);
+}
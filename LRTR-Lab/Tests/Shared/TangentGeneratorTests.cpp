@@ -0,0 +1,91 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Meshes/TangentGenerator.hpp"
+
+#include <cmath>
+
+namespace LRTR {
+
+	//two quads in the plane z = 0 share the edge x = 0, the texture of right quad is the mirror of left quad
+	//so the u grows with x on the right and grows with -x on the left
+	struct TangentTestMirroredQuads {
+		std::vector<Vector3f> Positions = {
+			Vector3f(-1, 0, 0), Vector3f(0, 0, 0), Vector3f(1, 0, 0),
+			Vector3f(-1, 1, 0), Vector3f(0, 1, 0), Vector3f(1, 1, 0)
+		};
+
+		std::vector<Vector3f> TexCoords = {
+			Vector3f(1, 0, 0), Vector3f(0, 0, 0), Vector3f(1, 0, 0),
+			Vector3f(1, 1, 0), Vector3f(0, 1, 0), Vector3f(1, 1, 0)
+		};
+
+		std::vector<unsigned> Indices = {
+			0, 1, 4, 0, 4, 3,
+			1, 2, 5, 1, 5, 4
+		};
+	};
+
+	static auto TangentTestNear(const Vector3f& first, const Vector3f& second) -> bool
+	{
+		return glm::length(first - second) < 1e-4f;
+	}
+
+}
+
+LRTR_TEST(TangentGeneratorMirroredSeam)
+{
+	using namespace LRTR;
+
+	const TangentTestMirroredQuads mesh;
+
+	const auto normals = TangentGenerator::computeNormals(mesh.Positions, mesh.Indices);
+	const auto frames = TangentGenerator::computeTangents(mesh.Positions, mesh.TexCoords, normals, mesh.Indices);
+
+	//the two vertices on the seam are used by both sides, so they are split
+	LRTR_CHECK(frames.Splits.size() == 2);
+	LRTR_CHECK(frames.Tangents.size() == mesh.Positions.size() + frames.Splits.size());
+	LRTR_CHECK(frames.Signs.size() == frames.Tangents.size());
+	LRTR_CHECK(frames.Indices.size() == mesh.Indices.size());
+
+	for (const auto& split : frames.Splits) LRTR_CHECK(split == 1 || split == 4);
+
+	//each corner uses a vertex whose sign and tangent are the ones of its triangle
+	size_t mismatches = 0;
+
+	for (size_t corner = 0; corner < frames.Indices.size(); corner++) {
+		const auto vertex = frames.Indices[corner];
+		const auto source = vertex < mesh.Positions.size() ? vertex : frames.Splits[vertex - mesh.Positions.size()];
+		const auto left = corner < 6;
+
+		if (source != mesh.Indices[corner]) mismatches++;
+		if (frames.Signs[vertex] != (left ? -1.0f : 1.0f)) mismatches++;
+		if (!TangentTestNear(frames.Tangents[vertex], left ? Vector3f(-1, 0, 0) : Vector3f(1, 0, 0))) mismatches++;
+	}
+
+	LRTR_CHECK(mismatches == 0);
+}
+
+LRTR_TEST(TangentGeneratorNoSeam)
+{
+	using namespace LRTR;
+
+	//the texture of right quad is not mirrored, so no vertex is split and the indices are not changed
+	TangentTestMirroredQuads mesh;
+
+	mesh.TexCoords = {
+		Vector3f(0, 0, 0), Vector3f(1, 0, 0), Vector3f(2, 0, 0),
+		Vector3f(0, 1, 0), Vector3f(1, 1, 0), Vector3f(2, 1, 0)
+	};
+
+	const auto normals = TangentGenerator::computeNormals(mesh.Positions, mesh.Indices);
+	const auto frames = TangentGenerator::computeTangents(mesh.Positions, mesh.TexCoords, normals, mesh.Indices);
+
+	LRTR_CHECK(frames.Splits.empty());
+	LRTR_CHECK(frames.Indices == mesh.Indices);
+	LRTR_CHECK(frames.Tangents.size() == mesh.Positions.size());
+
+	for (size_t vertex = 0; vertex < mesh.Positions.size(); vertex++) {
+		LRTR_CHECK(frames.Signs[vertex] == 1.0f);
+		LRTR_CHECK(TangentTestNear(frames.Tangents[vertex], Vector3f(1, 0, 0)));
+	}
+}
@@ -0,0 +1,216 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Accelerators/TriangleHierarchy.hpp"
+
+#include <random>
+#include <cmath>
+
+namespace LRTR {
+
+	//the soup of small triangles in [-10, 10], the triangles do not share vertices
+	struct TriangleHierarchyTestMesh {
+		std::vector<Vector3f> Positions;
+		std::vector<unsigned> Indices;
+
+		TriangleHierarchyTestMesh(const size_t count, const unsigned seed)
+		{
+			std::mt19937 random(seed);
+			std::uniform_real_distribution<float> centers(-10.0f, 10.0f);
+			std::uniform_real_distribution<float> offsets(-0.8f, 0.8f);
+
+			for (size_t triangle = 0; triangle < count; triangle++) {
+				const auto center = Vector3f(centers(random), centers(random), centers(random));
+
+				for (size_t vertex = 0; vertex < 3; vertex++) {
+					Indices.push_back(static_cast<unsigned>(Positions.size()));
+					Positions.push_back(center + Vector3f(offsets(random), offsets(random), offsets(random)));
+				}
+			}
+		}
+	};
+
+	//the rays from random points outside the mesh to random points in it, so most of them hit something
+	static auto TriangleHierarchyTestRays(const size_t count, const unsigned seed) -> std::vector<RayF>
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> origins(-14.0f, 14.0f);
+		std::uniform_real_distribution<float> targets(-8.0f, 8.0f);
+
+		std::vector<RayF> rays;
+
+		for (size_t index = 0; index < count; index++) {
+			const auto origin = Vector3f(origins(random), origins(random), 14.0f);
+			const auto target = Vector3f(targets(random), targets(random), targets(random));
+
+			rays.push_back(RayF(origin, glm::normalize(target - origin)));
+		}
+
+		return rays;
+	}
+
+	//test the ray with every triangle (Moller-Trumbore), the hit is the closest one in (0, hit.Distance]
+	static void TriangleHierarchyTestBruteForce(const TriangleHierarchyTestMesh& mesh, const RayF& ray, TriangleHit& hit)
+	{
+		for (size_t triangle = 0; triangle < mesh.Indices.size() / 3; triangle++) {
+			const auto& v0 = mesh.Positions[mesh.Indices[triangle * 3 + 0]];
+			const auto edge1 = mesh.Positions[mesh.Indices[triangle * 3 + 1]] - v0;
+			const auto edge2 = mesh.Positions[mesh.Indices[triangle * 3 + 2]] - v0;
+
+			const auto p = glm::cross(ray.Direction, edge2);
+			const auto determinant = glm::dot(edge1, p);
+
+			if (determinant == 0) continue;
+
+			const auto inverse = 1.0f / determinant;
+			const auto t = ray.Origin - v0;
+			const auto q = glm::cross(t, edge1);
+
+			const auto u = glm::dot(t, p) * inverse;
+			const auto v = glm::dot(ray.Direction, q) * inverse;
+			const auto distance = glm::dot(edge2, q) * inverse;
+
+			if (u < 0 || v < 0 || u + v > 1 || distance <= 0 || distance > hit.Distance) continue;
+
+			hit.Distance = distance;
+			hit.U = u;
+			hit.V = v;
+			hit.Triangle = static_cast<unsigned>(triangle);
+		}
+	}
+
+	//the hits are the same if they hit the same triangle at the same distance, or both miss
+	static auto TriangleHierarchyTestSame(const TriangleHit& first, const TriangleHit& second) -> bool
+	{
+		if (first.valid() != second.valid()) return false;
+		if (!first.valid()) return true;
+
+		//the hits at the same distance may be different triangles, any of them is the closest hit
+		return std::abs(first.Distance - second.Distance) <= 1e-4f * std::max(first.Distance, 1.0f);
+	}
+
+}
+
+LRTR_TEST(TriangleHierarchySingleRay)
+{
+	using namespace LRTR;
+
+	const TriangleHierarchyTestMesh mesh(3000, 13);
+
+	TriangleHierarchy hierarchy;
+
+	hierarchy.build(mesh.Positions, mesh.Indices);
+
+	LRTR_CHECK(hierarchy.size() == mesh.Indices.size() / 3);
+
+	size_t hits = 0;
+	size_t mismatches = 0;
+	size_t occlusionMismatches = 0;
+
+	for (const auto& ray : TriangleHierarchyTestRays(2000, 17)) {
+		TriangleHit hit;
+		TriangleHit expected;
+
+		const auto found = hierarchy.intersect(ray, hit);
+
+		TriangleHierarchyTestBruteForce(mesh, ray, expected);
+
+		if (found != expected.valid() || !TriangleHierarchyTestSame(hit, expected)) mismatches++;
+		if (found) hits++;
+
+		//the any hit query in a shorter distance, the occluder must be closer than it
+		const auto distance = expected.valid() ? expected.Distance * 1.5f : 30.0f;
+
+		if (hierarchy.occluded(ray, distance) != expected.valid()) occlusionMismatches++;
+		if (expected.valid() && hierarchy.occluded(ray, expected.Distance * 0.5f)) {
+			TriangleHit closer;
+
+			closer.Distance = expected.Distance * 0.5f;
+
+			TriangleHierarchyTestBruteForce(mesh, ray, closer);
+
+			if (!closer.valid()) occlusionMismatches++;
+		}
+	}
+
+	//the rays should test both the hits and the misses
+	LRTR_CHECK(hits > 200 && hits < 1800);
+	LRTR_CHECK(mismatches == 0);
+	LRTR_CHECK(occlusionMismatches == 0);
+}
+
+LRTR_TEST(TriangleHierarchyPacket)
+{
+	using namespace LRTR;
+
+	const TriangleHierarchyTestMesh mesh(3000, 19);
+
+	TriangleHierarchy hierarchy;
+
+	hierarchy.build(mesh.Positions, mesh.Indices);
+
+	const auto rays = TriangleHierarchyTestRays(2000, 23);
+
+	size_t mismatches = 0;
+	size_t occlusionMismatches = 0;
+
+	for (size_t index = 0; index + 4 <= rays.size(); index = index + 4) {
+		//the first ray of packet is inactive, so the packet should ignore it
+		const std::array<RayF, 4> packet = { rays[index], rays[index + 1], rays[index + 2], rays[index + 3] };
+
+		std::array<TriangleHit, 4> hits;
+		std::array<float, 4> distances = { 0.0f, 30.0f, 5.0f, 30.0f };
+
+		hits[0].Distance = 0;
+
+		const auto mask = hierarchy.intersect(packet, hits);
+		const auto occluded = hierarchy.occluded(packet, distances);
+
+		if ((mask & 1u) != 0 || (occluded & 1u) != 0) mismatches++;
+
+		for (size_t lane = 1; lane < 4; lane++) {
+			TriangleHit expected;
+
+			const auto found = hierarchy.intersect(packet[lane], expected);
+
+			if (((mask >> lane) & 1u) != (found ? 1u : 0u) || !TriangleHierarchyTestSame(hits[lane], expected)) mismatches++;
+
+			const auto expectedOccluded = expected.valid() && expected.Distance <= distances[lane];
+
+			if (((occluded >> lane) & 1u) != (expectedOccluded ? 1u : 0u)) occlusionMismatches++;
+		}
+	}
+
+	LRTR_CHECK(mismatches == 0);
+	LRTR_CHECK(occlusionMismatches == 0);
+}
+
+LRTR_TEST(TriangleHierarchyThreadPool)
+{
+	using namespace LRTR;
+
+	//the subtrees are built in parallel, so the hierarchy should find the same hits as the serial one
+	const TriangleHierarchyTestMesh mesh(40000, 29);
+
+	ThreadPool threadPool;
+	TriangleHierarchy serial;
+	TriangleHierarchy parallel;
+
+	serial.build(mesh.Positions, mesh.Indices);
+	parallel.build(mesh.Positions, mesh.Indices, &threadPool);
+
+	LRTR_CHECK(parallel.size() == serial.size());
+
+	size_t mismatches = 0;
+
+	for (const auto& ray : TriangleHierarchyTestRays(1000, 31)) {
+		TriangleHit first;
+		TriangleHit second;
+
+		serial.intersect(ray, first);
+		parallel.intersect(ray, second);
+
+		if (!TriangleHierarchyTestSame(first, second)) mismatches++;
+	}
+
+	LRTR_CHECK(mismatches == 0);
+}
@@ -0,0 +1,140 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Meshes/VertexCompression.hpp"
+
+#include <random>
+#include <limits>
+#include <cmath>
+
+namespace LRTR {
+
+	//the angle between two directions in radians, the acos of dot is not precise for small angles
+	static auto VertexCompressionTestAngle(const Vector3f& first, const Vector3f& second) -> float
+	{
+		return std::atan2(glm::length(glm::cross(first, second)), glm::dot(first, second));
+	}
+
+}
+
+LRTR_TEST(VertexCompressionHalfRoundTrip)
+{
+	using namespace LRTR;
+
+	//every half that is not nan must be the same after decode and encode
+	size_t mismatches = 0;
+
+	for (unsigned value = 0; value < 65536; value++) {
+		const auto half = static_cast<unsigned short>(value);
+
+		if ((half & 0x7c00u) == 0x7c00u && (half & 0x3ffu) != 0) {
+			if (!std::isnan(VertexCompression::decodeHalf(half))) mismatches++;
+
+			continue;
+		}
+
+		if (VertexCompression::encodeHalf(VertexCompression::decodeHalf(half)) != half) mismatches++;
+	}
+
+	LRTR_CHECK(mismatches == 0);
+}
+
+LRTR_TEST(VertexCompressionHalfRounding)
+{
+	using namespace LRTR;
+
+	LRTR_CHECK(VertexCompression::encodeHalf(0.0f) == 0x0000u);
+	LRTR_CHECK(VertexCompression::encodeHalf(-0.0f) == 0x8000u);
+	LRTR_CHECK(VertexCompression::encodeHalf(1.0f) == 0x3c00u);
+	LRTR_CHECK(VertexCompression::encodeHalf(-2.0f) == 0xc000u);
+	LRTR_CHECK(VertexCompression::encodeHalf(65504.0f) == 0x7bffu);
+
+	//the values larger than the max half are infinity, the values less than the min subnormal are zero
+	LRTR_CHECK(VertexCompression::encodeHalf(65520.0f) == 0x7c00u);
+	LRTR_CHECK(VertexCompression::encodeHalf(std::numeric_limits<float>::infinity()) == 0x7c00u);
+	LRTR_CHECK(VertexCompression::encodeHalf(1e-10f) == 0x0000u);
+	LRTR_CHECK(std::isnan(VertexCompression::decodeHalf(VertexCompression::encodeHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+	//the texture coordinates in [-16, 16] have at least 11 bits of precision
+	std::mt19937 random(19);
+	std::uniform_real_distribution<float> values(-16.0f, 16.0f);
+
+	size_t errors = 0;
+
+	for (size_t index = 0; index < 100000; index++) {
+		const auto value = values(random);
+		const auto decoded = VertexCompression::decodeHalf(VertexCompression::encodeHalf(value));
+
+		if (std::abs(decoded - value) > std::max(std::abs(value) * std::ldexp(1.0f, -11), std::ldexp(1.0f, -25))) errors++;
+	}
+
+	LRTR_CHECK(errors == 0);
+}
+
+LRTR_TEST(VertexCompressionPositionRoundTrip)
+{
+	using namespace LRTR;
+
+	std::mt19937 random(23);
+	std::uniform_real_distribution<float> x(-120.0f, 80.0f);
+	std::uniform_real_distribution<float> y(3.0f, 5.0f);
+
+	//the z of all positions is the same, so its extent is zero
+	std::vector<Vector3f> positions;
+
+	for (size_t index = 0; index < 10000; index++) positions.push_back(Vector3f(x(random), y(random), 7.0f));
+
+	const auto quantization = VertexCompression::quantization(positions);
+
+	LRTR_CHECK(quantization.Scale.z == 1.0f);
+
+	//the error of each axis is at most half step of quantization
+	const auto tolerance = quantization.Scale * (0.5f / 65535.0f) + Vector3f(1e-5f);
+
+	size_t errors = 0;
+
+	for (size_t index = 0; index < positions.size(); index++) {
+		const auto sign = index % 2 == 0 ? 1.0f : -1.0f;
+		const auto packed = VertexCompression::encodePosition(positions[index], quantization, sign);
+		const auto difference = glm::abs(VertexCompression::decodePosition(packed, quantization) - positions[index]);
+
+		if (difference.x > tolerance.x || difference.y > tolerance.y || difference.z > tolerance.z) errors++;
+		if (VertexCompression::decodeSign(packed) != sign) errors++;
+	}
+
+	LRTR_CHECK(errors == 0);
+}
+
+LRTR_TEST(VertexCompressionDirectionRoundTrip)
+{
+	using namespace LRTR;
+
+	std::mt19937 random(29);
+	std::normal_distribution<float> normal(0.0f, 1.0f);
+
+	auto maxAngle = 0.0f;
+
+	for (size_t index = 0; index < 100000; index++) {
+		const auto direction = glm::normalize(Vector3f(normal(random), normal(random), normal(random)));
+		const auto decoded = VertexCompression::decodeDirection(VertexCompression::encodeDirection(direction));
+
+		maxAngle = std::max(maxAngle, VertexCompressionTestAngle(direction, decoded));
+	}
+
+	//16 bits octahedral encoding is better than 0.01 degrees
+	LRTR_CHECK(maxAngle < 0.01f * 3.14159265f / 180.0f);
+
+	//the axes and the directions on the fold of octahedron are exact
+	const Vector3f axes[] = {
+		Vector3f(1, 0, 0), Vector3f(-1, 0, 0),
+		Vector3f(0, 1, 0), Vector3f(0, -1, 0),
+		Vector3f(0, 0, 1), Vector3f(0, 0, -1)
+	};
+
+	for (const auto& axis : axes)
+		LRTR_CHECK(VertexCompressionTestAngle(axis, VertexCompression::decodeDirection(VertexCompression::encodeDirection(axis))) < 1e-3f);
+
+	//the direction does not need to be normalized and the zero direction is (0, 0, 1)
+	LRTR_CHECK(VertexCompressionTestAngle(Vector3f(0, 3, -4),
+		VertexCompression::decodeDirection(VertexCompression::encodeDirection(Vector3f(0, 3, -4)))) < 1e-3f);
+	LRTR_CHECK(VertexCompression::decodeDirection(VertexCompression::encodeDirection(Vector3f(0))) == Vector3f(0, 0, 1));
+}
@@ -0,0 +1,191 @@
+#include "../Testing.hpp"
+
+#include "../../Shared/Meshes/VertexWelder.hpp"
+
+#include <algorithm>
+#include <random>
+#include <cstdio>
+#include <thread>
+#include <tuple>
+
+namespace LRTR {
+
+	//the triangle soup of a grid with size x size quads, every quad has its own 6 vertices
+	//the positions are moved by jitter, so the same vertices of grid are not the same bits
+	static auto VertexWelderTestSoup(const size_t size, const float jitter, const unsigned seed) -> std::vector<Vector3f>
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> offset(-jitter, jitter);
+
+		std::vector<Vector3f> positions;
+
+		positions.reserve(size * size * 6);
+
+		const auto vertex = [&](const size_t x, const size_t y)
+		{
+			positions.push_back(Vector3f(
+				static_cast<float>(x) + offset(random),
+				static_cast<float>(y) + offset(random),
+				static_cast<float>((x * 7 + y * 13) % 5) + offset(random)));
+		};
+
+		for (size_t y = 0; y < size; y++) {
+			for (size_t x = 0; x < size; x++) {
+				vertex(x, y); vertex(x + 1, y); vertex(x + 1, y + 1);
+				vertex(x, y); vertex(x + 1, y + 1); vertex(x, y + 1);
+			}
+		}
+
+		return positions;
+	}
+
+	//the old way of triangle soup, sort the positions and weld the same ones
+	static auto VertexWelderTestSortWeld(const std::vector<Vector3f>& positions) -> size_t
+	{
+		std::vector<std::pair<std::tuple<float, float, float>, unsigned>> sorted(positions.size());
+
+		for (size_t index = 0; index < positions.size(); index++)
+			sorted[index] = { std::make_tuple(positions[index].x, positions[index].y, positions[index].z), static_cast<unsigned>(index) };
+
+		std::sort(sorted.begin(), sorted.end());
+
+		size_t count = 0;
+
+		for (size_t index = 0; index < sorted.size(); index++)
+			if (index == 0 || sorted[index].first != sorted[index - 1].first) count++;
+
+		return count;
+	}
+
+	//the remap must point to a kept vertex that is in epsilon of the input vertex
+	static auto VertexWelderTestValid(const std::vector<Vector3f>& positions, const VertexWeldResult& result, const float epsilon) -> bool
+	{
+		if (result.Remap.size() != positions.size()) return false;
+
+		for (size_t index = 0; index < positions.size(); index++) {
+			if (result.Remap[index] >= result.Vertices.size()) return false;
+
+			const auto difference = glm::abs(positions[index] - positions[result.Vertices[result.Remap[index]]]);
+
+			if (difference.x > epsilon || difference.y > epsilon || difference.z > epsilon) return false;
+		}
+
+		return true;
+	}
+
+}
+
+LRTR_TEST(VertexWelderSamePositions)
+{
+	using namespace LRTR;
+
+	const auto positions = VertexWelderTestSoup(32, 0.0f, 1);
+	const auto result = VertexWelder::weld(positions, {});
+
+	LRTR_CHECK(result.Vertices.size() == 33 * 33);
+	LRTR_CHECK(VertexWelderTestValid(positions, result, 0.0f));
+
+	//the welded vertices are ordered by the first input vertex they have
+	LRTR_CHECK(std::is_sorted(result.Vertices.begin(), result.Vertices.end()));
+	LRTR_CHECK(result.Remap[0] == 0 && result.Remap[3] == 0);
+}
+
+LRTR_TEST(VertexWelderEpsilon)
+{
+	using namespace LRTR;
+
+	const auto positions = VertexWelderTestSoup(32, 1e-4f, 2);
+
+	//the jitter is less than epsilon, so the vertices of grid are welded, but they are not the same bits
+	const auto exact = VertexWelder::weld(positions, {});
+	const auto welded = VertexWelder::weld(positions, {}, 1e-3f);
+
+	LRTR_CHECK(exact.Vertices.size() == positions.size());
+	LRTR_CHECK(welded.Vertices.size() == 33 * 33);
+	LRTR_CHECK(VertexWelderTestValid(positions, welded, 1e-3f));
+}
+
+LRTR_TEST(VertexWelderAttributes)
+{
+	using namespace LRTR;
+
+	const auto positions = VertexWelderTestSoup(16, 0.0f, 3);
+
+	//every triangle has its own normal, so only the vertices of the same triangle side can be welded
+	std::vector<Vector3f> normals(positions.size());
+
+	for (size_t index = 0; index < normals.size(); index++)
+		normals[index] = (index / 3) % 2 == 0 ? Vector3f(0, 0, 1) : Vector3f(0, 1, 0);
+
+	const auto withoutNormals = VertexWelder::weld(positions, {});
+	const auto withNormals = VertexWelder::weld(positions, { &normals });
+
+	LRTR_CHECK(withoutNormals.Vertices.size() == 17 * 17);
+	LRTR_CHECK(withNormals.Vertices.size() > withoutNormals.Vertices.size());
+
+	size_t mismatches = 0;
+
+	for (size_t index = 0; index < positions.size(); index++)
+		if (normals[withNormals.Vertices[withNormals.Remap[index]]] != normals[index]) mismatches++;
+
+	LRTR_CHECK(mismatches == 0);
+	LRTR_CHECK(VertexWelderTestValid(positions, withNormals, 0.0f));
+}
+
+LRTR_TEST(VertexWelderThreadPool)
+{
+	using namespace LRTR;
+
+	//the soup is larger than one task, so the tasks claim the slots of hash table at the same time
+	const auto positions = VertexWelderTestSoup(128, 1e-4f, 4);
+
+	ThreadPool threadPool;
+
+	const auto serial = VertexWelder::weld(positions, {}, 1e-3f);
+	const auto parallel = VertexWelder::weld(positions, {}, 1e-3f, &threadPool);
+
+	LRTR_CHECK(serial.Remap == parallel.Remap);
+	LRTR_CHECK(serial.Vertices == parallel.Vertices);
+	LRTR_CHECK(parallel.Vertices.size() == 129 * 129);
+}
+
+LRTR_BENCHMARK(VertexWelderSoup)
+{
+	using namespace LRTR;
+
+	//1024 x 1024 quads, it is about two million triangles and six million vertices
+	const auto exactPositions = VertexWelderTestSoup(1024, 0.0f, 5);
+	const auto jitterPositions = VertexWelderTestSoup(1024, 1e-4f, 6);
+
+	ThreadPool threadPool;
+
+	std::printf("    %zu triangles, %zu vertices, %u hardware threads\n",
+		exactPositions.size() / 3, exactPositions.size(), std::thread::hardware_concurrency());
+
+	size_t sortCount = 0;
+	size_t serialCount = 0;
+	size_t parallelCount = 0;
+	size_t epsilonCount = 0;
+
+	Testing::measure("sort positions, one thread", 3, [&]() { sortCount = VertexWelderTestSortWeld(exactPositions); });
+	Testing::measure("hash same positions, one thread", 3, [&]()
+		{
+			serialCount = VertexWelder::weld(exactPositions, {}).Vertices.size();
+		});
+	Testing::measure("hash same positions, thread pool", 3, [&]()
+		{
+			parallelCount = VertexWelder::weld(exactPositions, {}, 0, &threadPool).Vertices.size();
+		});
+	Testing::measure("hash grid with epsilon, one thread", 3, [&]()
+		{
+			VertexWelder::weld(jitterPositions, {}, 1e-3f);
+		});
+	Testing::measure("hash grid with epsilon, thread pool", 3, [&]()
+		{
+			epsilonCount = VertexWelder::weld(jitterPositions, {}, 1e-3f, &threadPool).Vertices.size();
+		});
+
+	LRTR_CHECK(sortCount == 1025 * 1025);
+	LRTR_CHECK(serialCount == sortCount && parallelCount == sortCount);
+	LRTR_CHECK(epsilonCount == 1025 * 1025);
+}
@@ -0,0 +1,59 @@
+#include "Testing.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace LRTR {
+
+	namespace Testing {
+
+		//the number of failed checks of all cases
+		static size_t failureCount = 0;
+
+	}
+
+}
+
+auto LRTR::Testing::cases() -> std::vector<Case>&
+{
+	//the cases are added by static objects of test files, so the vector is created when we first use it
+	static std::vector<Case> instance;
+
+	return instance;
+}
+
+auto LRTR::Testing::add(const std::string& name, const std::function<void()>& function, const CaseType type) -> bool
+{
+	cases().push_back({ name, function, type });
+
+	return true;
+}
+
+void LRTR::Testing::fail(const char* file, const int line, const char* expression)
+{
+	std::printf("    failed: %s (%s:%d)\n", expression, file, line);
+
+	failureCount++;
+}
+
+auto LRTR::Testing::failures() -> size_t
+{
+	return failureCount;
+}
+
+auto LRTR::Testing::measure(const std::string& name, const size_t iterations, const std::function<void()>& function) -> double
+{
+	//the first run warms the caches and the allocators, so it is not measured
+	function();
+
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	for (size_t index = 0; index < iterations; index++) function();
+
+	const auto end = std::chrono::high_resolution_clock::now();
+	const auto milliseconds = std::chrono::duration<double, std::milli>(end - start).count() / static_cast<double>(iterations);
+
+	std::printf("    %-48s %12.4f ms\n", name.c_str(), milliseconds);
+
+	return milliseconds;
+}
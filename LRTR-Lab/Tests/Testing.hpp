@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace LRTR {
+
+	namespace Testing {
+
+		//the benchmarks are only run when we ask for them, because they take seconds
+		enum class CaseType : unsigned {
+			Test = 0,
+			Benchmark = 1
+		};
+
+		struct Case {
+			std::string Name;
+			std::function<void()> Function;
+
+			CaseType Type = CaseType::Test;
+		};
+
+		auto cases() -> std::vector<Case>&;
+
+		auto add(const std::string& name, const std::function<void()>& function, const CaseType type) -> bool;
+
+		//record a failed check of current case, the case keeps running so we can see all failed checks
+		void fail(const char* file, const int line, const char* expression);
+
+		auto failures() -> size_t;
+
+		//run the function and return the average milliseconds of iterations, the result is printed with name
+		auto measure(const std::string& name, const size_t iterations, const std::function<void()>& function) -> double;
+	}
+
+}
+
+#define LRTR_TEST(name) \
+	static void name(); \
+	static const auto name##Registered = LRTR::Testing::add(#name, name, LRTR::Testing::CaseType::Test); \
+	static void name()
+
+#define LRTR_BENCHMARK(name) \
+	static void name(); \
+	static const auto name##Registered = LRTR::Testing::add(#name, name, LRTR::Testing::CaseType::Benchmark); \
+	static void name()
+
+#define LRTR_CHECK(expression) \
+	do { if (!(expression)) LRTR::Testing::fail(__FILE__, __LINE__, #expression); } while (false)
@@ -0,0 +1,37 @@
+#include "Testing.hpp"
+
+#include <cstring>
+#include <cstdio>
+
+//usage: Tests [--benchmark] [filter]
+//the tests are run by default, the cases are filtered by the substring of their names
+int main(int argc, char** argv) {
+
+	auto type = LRTR::Testing::CaseType::Test;
+	auto filter = std::string();
+
+	for (auto index = 1; index < argc; index++) {
+		if (std::strcmp(argv[index], "--benchmark") == 0) type = LRTR::Testing::CaseType::Benchmark;
+		else filter = argv[index];
+	}
+
+	size_t count = 0;
+	
+	for (const auto& testCase : LRTR::Testing::cases()) {
+		if (testCase.Type != type || testCase.Name.find(filter) == std::string::npos) continue;
+
+		const auto failures = LRTR::Testing::failures();
+
+		std::printf("[ run  ] %s\n", testCase.Name.c_str());
+
+		testCase.Function();
+
+		std::printf("[ %s ] %s\n", LRTR::Testing::failures() == failures ? " ok " : "fail", testCase.Name.c_str());
+
+		count++;
+	}
+
+	std::printf("%zu cases, %zu failed checks\n", count, LRTR::Testing::failures());
+
+	return LRTR::Testing::failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+namespace LRTR {
+
+	//the caches of mesh workflows are in the same folder, the name of cache is the sha256 of its input
+	constexpr auto MeshCacheLocation = "./Resources/Caches/Meshes/";
+
+	template<typename T>
+	void writeCacheValue(std::vector<unsigned char>& data, const T* values, const size_t count)
+	{
+		const auto offset = data.size();
+
+		data.resize(offset + sizeof(T) * count);
+
+		if (count != 0) std::memcpy(data.data() + offset, values, sizeof(T) * count);
+	}
+
+	template<typename T>
+	auto readCacheValue(const std::vector<unsigned char>& data, size_t& offset, T* values, const size_t count) -> bool
+	{
+		if (offset + sizeof(T) * count > data.size()) return false;
+
+		if (count != 0) std::memcpy(values, data.data() + offset, sizeof(T) * count);
+
+		offset = offset + sizeof(T) * count;
+
+		return true;
+	}
+	
+}
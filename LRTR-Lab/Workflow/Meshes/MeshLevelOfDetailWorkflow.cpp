@@ -0,0 +1,91 @@
+#include "MeshLevelOfDetailWorkflow.hpp"
+
+#include "../../Scenes/Components/MeshData/TrianglesMesh.hpp"
+#include "../../Shared/Meshes/MeshOptimizer.hpp"
+#include "../../Shared/Files/FileSystem.hpp"
+#include "../../Shared/Hash.hpp"
+
+#include "MeshCache.hpp"
+
+#include <filesystem>
+
+auto LRTR::MeshLevelOfDetailInput::string() const noexcept -> std::string
+{
+	return std::to_string(MaxLevels) + " " + std::to_string(Ratio) + " " + std::to_string(MaxError);
+}
+
+auto LRTR::MeshLevelOfDetailWorkflow::readCache(
+	const WorkflowStartup<MeshLevelOfDetailInput>& startup) -> std::optional<std::vector<MeshLevelOfDetail>>
+{
+	const auto& positions = startup.InputData.Mesh->positions();
+	const auto& indices = startup.InputData.Mesh->indices();
+	
+	mSha256Key = Hash::sha256(
+		std::string(reinterpret_cast<const char*>(positions.data()), positions.size() * sizeof(Vector3f)) +
+		std::string(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(unsigned)) +
+		startup.InputData.string());
+
+	if (!std::filesystem::exists(MeshCacheLocation + mSha256Key))
+		return std::nullopt;
+
+	//the layout of cache is [level count] and [error, index count, indices] of each level
+	const auto data = FileSystem::read<unsigned char>(MeshCacheLocation + mSha256Key);
+
+	auto levels = std::vector<MeshLevelOfDetail>();
+	auto levelCount = static_cast<unsigned>(0);
+	size_t offset = 0;
+
+	if (!readCacheValue(data, offset, &levelCount, 1)) return std::nullopt;
+
+	for (unsigned level = 0; level < levelCount; level++) {
+		auto indexCount = static_cast<unsigned>(0);
+
+		levels.push_back(MeshLevelOfDetail());
+
+		if (!readCacheValue(data, offset, &levels.back().Error, 1) ||
+			!readCacheValue(data, offset, &indexCount, 1)) return std::nullopt;
+
+		levels.back().Indices.resize(indexCount);
+
+		if (!readCacheValue(data, offset, levels.back().Indices.data(), indexCount)) return std::nullopt;
+	}
+	
+	return levels;
+}
+
+void LRTR::MeshLevelOfDetailWorkflow::writeCache(
+	const WorkflowStartup<MeshLevelOfDetailInput>& startup,
+	const std::vector<MeshLevelOfDetail>& output)
+{
+	auto data = std::vector<unsigned char>();
+	auto levelCount = static_cast<unsigned>(output.size());
+
+	writeCacheValue(data, &levelCount, 1);
+
+	for (const auto& level : output) {
+		const auto indexCount = static_cast<unsigned>(level.Indices.size());
+
+		writeCacheValue(data, &level.Error, 1);
+		writeCacheValue(data, &indexCount, 1);
+		writeCacheValue(data, level.Indices.data(), level.Indices.size());
+	}
+
+	FileSystem::write(MeshCacheLocation + mSha256Key, data);
+}
+
+auto LRTR::MeshLevelOfDetailWorkflow::work(
+	const WorkflowStartup<MeshLevelOfDetailInput>& startup) -> std::vector<MeshLevelOfDetail>
+{
+	auto levels = MeshSimplifier::simplifyLevels(
+		startup.InputData.Mesh->positions(),
+		startup.InputData.Mesh->indices(),
+		startup.InputData.MaxLevels,
+		startup.InputData.Ratio,
+		startup.InputData.MaxError);
+
+	//the levels share the vertices of mesh, so we only reorder their triangles for vertex cache
+	for (auto& level : levels)
+		level.Indices = MeshOptimizer::optimizeVertexCache(level.Indices, startup.InputData.Mesh->positions().size());
+
+	return levels;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../../Shared/Meshes/MeshSimplifier.hpp"
+#include "../Workflow.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace LRTR {
+
+	class TrianglesMesh;
+
+	struct MeshLevelOfDetailInput {
+		std::shared_ptr<TrianglesMesh> Mesh = nullptr;
+
+		size_t MaxLevels = 4;
+
+		float Ratio = 0.5f;
+		float MaxError = 0.02f;
+
+		MeshLevelOfDetailInput() = default;
+
+		explicit MeshLevelOfDetailInput(
+			const std::shared_ptr<TrianglesMesh>& mesh) :
+			Mesh(mesh) {}
+
+		auto string() const noexcept -> std::string;
+	};
+
+	//simplify the mesh into the chain of levels, the levels are cached by the positions and indices of mesh
+	//so the large meshes are only simplified when they are first loaded
+	class MeshLevelOfDetailWorkflow : public Workflow<MeshLevelOfDetailInput, std::vector<MeshLevelOfDetail>> {
+	public:
+		MeshLevelOfDetailWorkflow() = default;
+
+		~MeshLevelOfDetailWorkflow() = default;
+	protected:
+		auto readCache(const WorkflowStartup<MeshLevelOfDetailInput>& startup)
+			-> std::optional<std::vector<MeshLevelOfDetail>> override;
+
+		void writeCache(
+			const WorkflowStartup<MeshLevelOfDetailInput>& startup,
+			const std::vector<MeshLevelOfDetail>& output) override;
+
+		auto work(const WorkflowStartup<MeshLevelOfDetailInput>& startup) -> std::vector<MeshLevelOfDetail> override;
+	private:
+		std::string mSha256Key;
+	};
+
+}
@@ -0,0 +1,110 @@
+#include "MeshTangentWorkflow.hpp"
+
+#include "../../Shared/Meshes/TangentGenerator.hpp"
+#include "../../Shared/Files/FileSystem.hpp"
+#include "../../Shared/Hash.hpp"
+
+#include "MeshCache.hpp"
+
+#include <filesystem>
+
+namespace LRTR {
+
+	template<typename T>
+	auto cacheBytes(const std::vector<T>& values) -> std::string
+	{
+		return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+	}
+
+}
+
+auto LRTR::MeshTangentWorkflow::readCache(
+	const WorkflowStartup<MeshTangentInput>& startup) -> std::optional<MeshTangentOutput>
+{
+	const auto& input = startup.InputData;
+
+	//the sizes are in the key, so the same bytes in different arrays are different keys
+	mSha256Key = Hash::sha256(
+		std::to_string(input.Positions.size()) + " " + cacheBytes(input.Positions) +
+		std::to_string(input.TexCoords.size()) + " " + cacheBytes(input.TexCoords) +
+		std::to_string(input.Normals.size()) + " " + cacheBytes(input.Normals) +
+		std::to_string(input.Indices.size()) + " " + cacheBytes(input.Indices) + "SplitTangents");
+
+	if (!std::filesystem::exists(MeshCacheLocation + mSha256Key))
+		return std::nullopt;
+
+	//the layout of cache is [vertex count], [split count], [normals], [tangents], [signs], [splits] and [indices]
+	//the normals, tangents and signs are for the input vertices and the split vertices
+	const auto data = FileSystem::read<unsigned char>(MeshCacheLocation + mSha256Key);
+
+	auto output = MeshTangentOutput();
+	auto vertexCount = static_cast<unsigned>(0);
+	auto splitCount = static_cast<unsigned>(0);
+	size_t offset = 0;
+
+	if (!readCacheValue(data, offset, &vertexCount, 1) || vertexCount != input.Positions.size()) return std::nullopt;
+	if (!readCacheValue(data, offset, &splitCount, 1)) return std::nullopt;
+
+	const auto outputCount = static_cast<size_t>(vertexCount) + splitCount;
+
+	output.Normals.resize(outputCount);
+	output.Tangents.resize(outputCount);
+	output.Signs.resize(outputCount);
+	output.Splits.resize(splitCount);
+	output.Indices.resize(input.Indices.size());
+
+	if (!readCacheValue(data, offset, output.Normals.data(), outputCount) ||
+		!readCacheValue(data, offset, output.Tangents.data(), outputCount) ||
+		!readCacheValue(data, offset, output.Signs.data(), outputCount) ||
+		!readCacheValue(data, offset, output.Splits.data(), splitCount) ||
+		!readCacheValue(data, offset, output.Indices.data(), output.Indices.size())) return std::nullopt;
+
+	return output;
+}
+
+void LRTR::MeshTangentWorkflow::writeCache(
+	const WorkflowStartup<MeshTangentInput>& startup,
+	const MeshTangentOutput& output)
+{
+	auto data = std::vector<unsigned char>();
+	auto vertexCount = static_cast<unsigned>(startup.InputData.Positions.size());
+	auto splitCount = static_cast<unsigned>(output.Splits.size());
+
+	writeCacheValue(data, &vertexCount, 1);
+	writeCacheValue(data, &splitCount, 1);
+	writeCacheValue(data, output.Normals.data(), output.Normals.size());
+	writeCacheValue(data, output.Tangents.data(), output.Tangents.size());
+	writeCacheValue(data, output.Signs.data(), output.Signs.size());
+	writeCacheValue(data, output.Splits.data(), output.Splits.size());
+	writeCacheValue(data, output.Indices.data(), output.Indices.size());
+
+	FileSystem::write(MeshCacheLocation + mSha256Key, data);
+}
+
+auto LRTR::MeshTangentWorkflow::work(
+	const WorkflowStartup<MeshTangentInput>& startup) -> MeshTangentOutput
+{
+	const auto& input = startup.InputData;
+
+	auto output = MeshTangentOutput();
+
+	output.Normals = input.Normals.size() >= input.Positions.size() ? input.Normals :
+		TangentGenerator::computeNormals(input.Positions, input.Indices, input.Pool);
+
+	auto frames = TangentGenerator::computeTangents(
+		input.Positions, input.TexCoords, output.Normals, input.Indices, input.Pool);
+
+	output.Tangents = std::move(frames.Tangents);
+	output.Signs = std::move(frames.Signs);
+	output.Splits = std::move(frames.Splits);
+	output.Indices = std::move(frames.Indices);
+
+	//the split vertices copy the normals of input vertices
+	for (const auto& split : output.Splits) {
+		const auto normal = output.Normals[split];
+
+		output.Normals.push_back(normal);
+	}
+	
+	return output;
+}
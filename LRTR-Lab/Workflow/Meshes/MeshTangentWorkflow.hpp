@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../../Shared/Parallel/ThreadPool.hpp"
+#include "../../Shared/Math/Math.hpp"
+#include "../Workflow.hpp"
+
+#include <string>
+#include <vector>
+
+namespace LRTR {
+
+	struct MeshTangentInput {
+		std::vector<Vector3f> Positions;
+		std::vector<Vector3f> TexCoords;
+		std::vector<Vector3f> Normals;
+
+		std::vector<unsigned> Indices;
+
+		//the thread pool is only used when we generate them, it is not the part of cache
+		ThreadPool* Pool = nullptr;
+
+		MeshTangentInput() = default;
+
+		explicit MeshTangentInput(
+			const std::vector<Vector3f>& positions,
+			const std::vector<Vector3f>& texCoords,
+			const std::vector<Vector3f>& normals,
+			const std::vector<unsigned>& indices,
+			ThreadPool* threadPool = nullptr) :
+			Positions(positions), TexCoords(texCoords), Normals(normals),
+			Indices(indices), Pool(threadPool) {}
+	};
+
+	//the normals are the input normals if they are enough for all vertices, otherwise they are generated
+	//the sign of tangent is -1 if the texture coordinates are mirrored, the bitangent is cross(normal, tangent) * sign
+	//the vertices on the mirrored seams are split, the splits[i] is the input vertex that the vertex (input count + i)
+	//copies, the normals, tangents and signs are for all vertices and the indices use the new vertices
+	struct MeshTangentOutput {
+		std::vector<Vector3f> Normals;
+		std::vector<Vector3f> Tangents;
+		std::vector<float> Signs;
+
+		std::vector<unsigned> Splits;
+		std::vector<unsigned> Indices;
+	};
+
+	//generate the normals and tangents of mesh that does not have them, the results are cached by the
+	//positions, texture coordinates, normals and indices, so the large meshes are only processed once
+	class MeshTangentWorkflow : public Workflow<MeshTangentInput, MeshTangentOutput> {
+	public:
+		MeshTangentWorkflow() = default;
+
+		~MeshTangentWorkflow() = default;
+	protected:
+		auto readCache(const WorkflowStartup<MeshTangentInput>& startup)
+			-> std::optional<MeshTangentOutput> override;
+
+		void writeCache(
+			const WorkflowStartup<MeshTangentInput>& startup,
+			const MeshTangentOutput& output) override;
+
+		auto work(const WorkflowStartup<MeshTangentInput>& startup) -> MeshTangentOutput override;
+	private:
+		std::string mSha256Key;
+	};
+
+}
@@ -94,6 +94,7 @@ LRTR::DeferredShadingWorkflow::DeferredShadingWorkflow(const std::shared_ptr<Cod
 	//resource 8 : emissive texture
 	//resource 9 : sampler
 	//resource 10 : HasBaseColor, HasRoughness, HasOcclusion, HasNormalMap, HasMetallic, HasEmissive, HasBlurred, index
+	//              offsetX, offsetY, offsetZ, scaleX, scaleY, scaleZ (only for the meshes in compressed format)
 	mResourceLayout = device->createResourceLayout(
 		{
 			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::GroupBuffer, 0),
@@ -109,7 +110,7 @@ LRTR::DeferredShadingWorkflow::DeferredShadingWorkflow(const std::shared_ptr<Cod
 		{
 			CodeRed::SamplerLayoutElement(mSampler, 0, 1)
 		},
-		CodeRed::Constant32Bits(8, 0, 2)
+		CodeRed::Constant32Bits(14, 0, 2)
 	);
 
 	mPipelineInfo = std::make_shared<CodeRed::PipelineInfo>(mDevice);
@@ -193,6 +194,7 @@ LRTR::DeferredShadingWorkflow::DeferredShadingWorkflow(const std::shared_ptr<Cod
 		TargetLanguage::eDXIL : TargetLanguage::eSPIRV;
 
 	const auto vShaderFile = "./Resources/Shaders/Workflow/HLSL/DeferredShadingVert.hlsl";
+	const auto cShaderFile = "./Resources/Shaders/Workflow/HLSL/DeferredShadingCompressedVert.hlsl";
 	const auto fShaderFile = "./Resources/Shaders/Workflow/HLSL/DeferredShadingFrag.hlsl";
 
 	mVertShader = pipelineFactory->createShaderState(
@@ -205,6 +207,16 @@ LRTR::DeferredShadingWorkflow::DeferredShadingWorkflow(const std::shared_ptr<Cod
 		) })
 	);
 
+	mCompressedVertShader = pipelineFactory->createShaderState(
+		CodeRed::ShaderType::Vertex,
+		workflow.start({ CompileShaderInput(
+			cShaderFile,
+			CodeRed::ShaderType::Vertex,
+			sourceLanguage,
+			targetLanguage
+		) })
+	);
+
 	mFragShader = pipelineFactory->createShaderState(
 		CodeRed::ShaderType::Pixel,
 		workflow.start({ CompileShaderInput(
@@ -220,6 +232,33 @@ LRTR::DeferredShadingWorkflow::DeferredShadingWorkflow(const std::shared_ptr<Cod
 	mPipelineInfo->setRenderPass(mRenderPass);
 
 	mPipelineInfo->updateState();
+
+	//the packed properties are bound as 8 bits unorm and rebuilt into 16 bits values in vertex shader
+	//the position uses 8 bytes, so it has two elements in the same slot
+	mCompressedPipelineInfo = std::make_shared<CodeRed::PipelineInfo>(mDevice);
+
+	mCompressedPipelineInfo->setInputAssemblyState(
+		pipelineFactory->createInputAssemblyState(
+			{
+				CodeRed::InputLayoutElement("POSITIONXY", CodeRed::PixelFormat::RedGreenBlueAlpha8BitUnknown, 0),
+				CodeRed::InputLayoutElement("POSITIONZW", CodeRed::PixelFormat::RedGreenBlueAlpha8BitUnknown, 0),
+				CodeRed::InputLayoutElement("TEXCOORD", CodeRed::PixelFormat::RedGreenBlueAlpha8BitUnknown, 1),
+				CodeRed::InputLayoutElement("TANGENT", CodeRed::PixelFormat::RedGreenBlueAlpha8BitUnknown, 2),
+				CodeRed::InputLayoutElement("NORMAL", CodeRed::PixelFormat::RedGreenBlueAlpha8BitUnknown, 3)
+			},
+			CodeRed::PrimitiveTopology::TriangleList
+		)
+	);
+
+	mCompressedPipelineInfo->setResourceLayout(mResourceLayout);
+	mCompressedPipelineInfo->setRasterizationState(mPipelineInfo->rasterizationState());
+	mCompressedPipelineInfo->setDepthStencilState(mPipelineInfo->depthStencilState());
+	mCompressedPipelineInfo->setBlendState(mPipelineInfo->blendState());
+	mCompressedPipelineInfo->setVertexShaderState(mCompressedVertShader);
+	mCompressedPipelineInfo->setPixelShaderState(mFragShader);
+	mCompressedPipelineInfo->setRenderPass(mRenderPass);
+
+	mCompressedPipelineInfo->updateState();
 }
 
 auto LRTR::DeferredShadingWorkflow::resourceLayout() const noexcept -> std::shared_ptr<CodeRed::GpuResourceLayout>
@@ -235,28 +274,49 @@ auto LRTR::DeferredShadingWorkflow::work(const WorkflowStartup<DeferredShadingIn
 
 	const auto commandList = startup.InputData.CommandList;
 
-	commandList->setGraphicsPipeline(mPipelineInfo->graphicsPipeline());
 	commandList->setResourceLayout(mResourceLayout);
 
-	commandList->setVertexBuffers({
-			meshDataAssetComponent->positions(),
-			meshDataAssetComponent->texCoords(),
-			meshDataAssetComponent->tangents(),
-			meshDataAssetComponent->normals()
-		});
-	commandList->setIndexBuffer(meshDataAssetComponent->indices());
-
 	commandList->beginRenderPass(mRenderPass, startup.InputData.DeferredShadingBuffer.FrameBuffer);
 
 	commandList->setViewPort(startup.InputData.DeferredShadingBuffer.FrameBuffer->fullViewPort());
 	commandList->setScissorRect(startup.InputData.DeferredShadingBuffer.FrameBuffer->fullScissorRect());
+
+	//the meshes in different formats use different pipelines and the meshes in different pages use different buffers
+	//so we only switch them when the format, vertex page or index buffer of mesh is different from the last one
+	std::shared_ptr<CodeRed::GpuBuffer> vertexBuffer;
+	std::shared_ptr<CodeRed::GpuBuffer> indexBuffer;
+
+	auto format = MeshDataFormat::Full;
+	auto formatBound = false;
 	
-	for (size_t index = 0; index < startup.InputData.DrawCalls.size(); index++) {
-		const auto drawCall = startup.InputData.DrawCalls[index];
-		const auto drawProperty = meshDataAssetComponent->get(drawCall.Mesh);
+	for (const auto& drawCall : startup.InputData.DrawCalls) {
+		const auto drawProperty = meshDataAssetComponent->get(drawCall.Mesh, drawCall.Level);
+
+		if (!formatBound || drawProperty.Format != format) {
+			format = drawProperty.Format;
+			formatBound = true;
+
+			commandList->setGraphicsPipeline(format == MeshDataFormat::Compressed ?
+				mCompressedPipelineInfo->graphicsPipeline() :
+				mPipelineInfo->graphicsPipeline());
+		}
 
-		commandList->setDescriptorHeap(startup.InputData.DescriptorHeaps[index]);
+		if (meshDataAssetComponent->positions(drawProperty) != vertexBuffer) {
+			vertexBuffer = meshDataAssetComponent->positions(drawProperty);
 
+			commandList->setVertexBuffers(meshDataAssetComponent->vertexBuffers(drawProperty));
+		}
+
+		if (meshDataAssetComponent->indices(drawProperty) != indexBuffer) {
+			indexBuffer = meshDataAssetComponent->indices(drawProperty);
+
+			commandList->setIndexBuffer(indexBuffer);
+		}
+
+		commandList->setDescriptorHeap(startup.InputData.DescriptorHeaps[drawCall.Index]);
+
+		const auto& quantization = drawProperty.Quantization;
+		
 		commandList->setConstant32Bits({
 			drawCall.HasBaseColor,
 			drawCall.HasRoughness,
@@ -265,13 +325,29 @@ auto LRTR::DeferredShadingWorkflow::work(const WorkflowStartup<DeferredShadingIn
 			drawCall.HasMetallic,
 			drawCall.HasEmissive,
 			drawCall.HasBlurred,
-			static_cast<unsigned>(index)
+			drawCall.Index,
+			quantization.Offset.x, quantization.Offset.y, quantization.Offset.z,
+			quantization.Scale.x, quantization.Scale.y, quantization.Scale.z
 			});
 
-		commandList->drawIndexed(drawProperty.IndexCount, 1,
-			drawProperty.StartIndexLocation,
-			drawProperty.StartVertexLocation,
-			0);
+		if (drawCall.RangeCount == 0) {
+			commandList->drawIndexed(drawProperty.IndexCount, 1,
+				drawProperty.StartIndexLocation,
+				drawProperty.StartVertexLocation,
+				0);
+
+			continue;
+		}
+
+		//the ranges of visible meshlets, the adjacent meshlets are merged so there are only a few draws
+		for (auto index = drawCall.RangeOffset; index < drawCall.RangeOffset + drawCall.RangeCount; index++) {
+			const auto& range = startup.InputData.Ranges[index];
+
+			commandList->drawIndexed(range.Count, 1,
+				drawProperty.StartIndexLocation + range.Offset,
+				drawProperty.StartVertexLocation,
+				0);
+		}
 	}
 
 	commandList->endRenderPass();
@@ -2,6 +2,7 @@
 
 #include <CodeRed/Core/CodeRedGraphics.hpp>
 
+#include "../../Shared/Accelerators/ClusterCuller.hpp"
 #include "../../Shared/Graphics/PipelineInfo.hpp"
 #include "../../Runtimes/RuntimeSharing.hpp"
 #include "../Workflow.hpp"
@@ -13,7 +14,7 @@ namespace LRTR {
 	class TrianglesMesh;
 	
 	struct PhysicalBasedDrawCall {
-		std::shared_ptr<TrianglesMesh> Mesh;
+		std::shared_ptr<const TrianglesMesh> Mesh;
 
 		unsigned HasBaseColor = 0;
 		unsigned HasRoughness = 0;
@@ -22,6 +23,16 @@ namespace LRTR {
 		unsigned HasMetallic = 0;
 		unsigned HasEmissive = 0;
 		unsigned HasBlurred = 0;
+
+		//the index of transform, material and descriptor heap the draw call uses
+		unsigned Index = 0;
+
+		//the level of detail of mesh, the level 0 is the mesh itself
+		unsigned Level = 0;
+
+		//the index ranges of visible meshlets in the ranges of input, the whole level is drawn if count is 0
+		unsigned RangeOffset = 0;
+		unsigned RangeCount = 0;
 	};
 
 	struct DeferredShadingBuffer {
@@ -49,6 +60,7 @@ namespace LRTR {
 		std::shared_ptr<RuntimeSharing> Sharing;
 
 		std::vector<PhysicalBasedDrawCall> DrawCalls;
+		std::vector<IndexRange> Ranges;
 
 		DeferredShadingBuffer DeferredShadingBuffer;
 
@@ -59,9 +71,10 @@ namespace LRTR {
 			const std::shared_ptr<CodeRed::GpuGraphicsCommandList>& commandList,
 			const std::shared_ptr<RuntimeSharing>& sharing,
 			const std::vector<PhysicalBasedDrawCall>& drawCalls,
+			const std::vector<IndexRange>& ranges,
 			const LRTR::DeferredShadingBuffer& deferredShadingBuffer) :
 			DescriptorHeaps(descriptorHeaps), CommandList(commandList), Sharing(sharing), DrawCalls(drawCalls),
-			DeferredShadingBuffer(deferredShadingBuffer) {}
+			Ranges(ranges), DeferredShadingBuffer(deferredShadingBuffer) {}
 	};
 
 	struct DeferredShadingOutput {
@@ -84,12 +97,16 @@ namespace LRTR {
 		std::shared_ptr<CodeRed::GpuRenderPass> mRenderPass;
 
 		std::shared_ptr<CodeRed::GpuShaderState> mVertShader;
+		std::shared_ptr<CodeRed::GpuShaderState> mCompressedVertShader;
 		std::shared_ptr<CodeRed::GpuShaderState> mFragShader;
 
 		std::shared_ptr<CodeRed::GpuSampler> mSampler;
 		
 		std::shared_ptr<CodeRed::GpuResourceLayout> mResourceLayout;
 		std::shared_ptr<CodeRed::PipelineInfo> mPipelineInfo;
+
+		//the pipeline for meshes in compressed format, it decodes the packed properties in vertex shader
+		std::shared_ptr<CodeRed::PipelineInfo> mCompressedPipelineInfo;
 	};
 	
 }
@@ -8,8 +8,12 @@
 #include "../Shaders/CompileShaderWorkflow.hpp"
 
 #include "../../Shared/Transform.hpp"
+#include "../../Shared/Frustum.hpp"
 
 namespace LRTR {
+
+	//the face index we use to clear the tile of face, the shaders output the max depth for it
+	constexpr unsigned ClearFace = 6;
 	
 	auto generateViewMatrix(const PointShadowArea& area) -> std::vector<Matrix4x4f>
 	{
@@ -39,13 +43,15 @@ LRTR::PointShadowMapWorkflow::PointShadowMapWorkflow(const std::shared_ptr<CodeR
 	// resource 0 : view buffer for camera
 	// resource 1 : transform buffer for objects
 	// resource 2 : faceIndex, transformIndex, farPlane, lightPositionX, lightPositionY, lightPositionZ
+	//              the faceIndex is ClearFace when we clear the tile of face
+	//              offsetX, offsetY, offsetZ, scaleX, scaleY, scaleZ (only for the casters in compressed format)
 	mResourceLayout = mDevice->createResourceLayout(
 		{
 			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::Buffer, 0, 0),
 			CodeRed::ResourceLayoutElement(CodeRed::ResourceType::GroupBuffer, 1, 0)
 		},
 		{},
-		CodeRed::Constant32Bits(6, 0, 2));
+		CodeRed::Constant32Bits(12, 0, 2));
 
 	mPipelineInfo = std::make_shared<CodeRed::PipelineInfo>(mDevice);
 
@@ -69,8 +75,13 @@ LRTR::PointShadowMapWorkflow::PointShadowMapWorkflow(const std::shared_ptr<CodeR
 		)
 	);
 
+	//the atlas keeps the tiles of faces we do not render in this frame, so we load it
 	mRenderPass = mDevice->createRenderPass({},
-		CodeRed::Attachment::DepthStencil(CodeRed::PixelFormat::Depth32BitFloat));
+		CodeRed::Attachment::DepthStencil(CodeRed::PixelFormat::Depth32BitFloat,
+			CodeRed::ResourceLayout::DepthStencil,
+			CodeRed::ResourceLayout::GeneralRead,
+			CodeRed::AttachmentLoad::Load,
+			CodeRed::AttachmentStore::Store));
 
 	CompileShaderWorkflow workflow;
 
@@ -80,6 +91,7 @@ LRTR::PointShadowMapWorkflow::PointShadowMapWorkflow(const std::shared_ptr<CodeR
 
 	const auto vShaderFile = "./Resources/Shaders/Workflow/HLSL/PointShadowMapVert.hlsl";
 	const auto fShaderFile = "./Resources/Shaders/Workflow/HLSL/PointShadowMapFrag.hlsl";
+	const auto cShaderFile = "./Resources/Shaders/Workflow/HLSL/PointShadowMapCompressedVert.hlsl";
 	
 	mVertShader = pipelineFactory->createShaderState(
 		CodeRed::ShaderType::Vertex,
@@ -91,6 +103,16 @@ LRTR::PointShadowMapWorkflow::PointShadowMapWorkflow(const std::shared_ptr<CodeR
 		) })
 	);
 
+	mCompressedVertShader = pipelineFactory->createShaderState(
+		CodeRed::ShaderType::Vertex,
+		workflow.start({ CompileShaderInput(
+			cShaderFile,
+			CodeRed::ShaderType::Vertex,
+			sourceLanguage,
+			targetLanguage
+		) })
+	);
+
 	mFragShader = pipelineFactory->createShaderState(
 		CodeRed::ShaderType::Pixel,
 		workflow.start({ CompileShaderInput(
@@ -106,73 +128,261 @@ LRTR::PointShadowMapWorkflow::PointShadowMapWorkflow(const std::shared_ptr<CodeR
 	mPipelineInfo->setRenderPass(mRenderPass);
 
 	mPipelineInfo->updateState();
+
+	mClearPipelineInfo = std::make_shared<CodeRed::PipelineInfo>(mDevice);
+
+	mClearPipelineInfo->setInputAssemblyState(
+		pipelineFactory->createInputAssemblyState(
+			{
+				CodeRed::InputLayoutElement("POSITION", CodeRed::PixelFormat::RedGreenBlue32BitFloat, 0)
+			},
+			CodeRed::PrimitiveTopology::TriangleList
+		)
+	);
+
+	mClearPipelineInfo->setResourceLayout(mResourceLayout);
+
+	mClearPipelineInfo->setDepthStencilState(
+		pipelineFactory->createDetphStencilState(
+			true, true, false,
+			CodeRed::CompareOperator::Always
+		)
+	);
+
+	mClearPipelineInfo->setVertexShaderState(mVertShader);
+	mClearPipelineInfo->setPixelShaderState(mFragShader);
+	mClearPipelineInfo->setRenderPass(mRenderPass);
+
+	mClearPipelineInfo->updateState();
+
+	//the quantized position is bound as two 8 bits unorm elements in the same slot
+	mCompressedPipelineInfo = std::make_shared<CodeRed::PipelineInfo>(mDevice);
+
+	mCompressedPipelineInfo->setInputAssemblyState(
+		pipelineFactory->createInputAssemblyState(
+			{
+				CodeRed::InputLayoutElement("POSITIONXY", CodeRed::PixelFormat::RedGreenBlueAlpha8BitUnknown, 0),
+				CodeRed::InputLayoutElement("POSITIONZW", CodeRed::PixelFormat::RedGreenBlueAlpha8BitUnknown, 0)
+			},
+			CodeRed::PrimitiveTopology::TriangleList
+		)
+	);
+
+	mCompressedPipelineInfo->setResourceLayout(mResourceLayout);
+	mCompressedPipelineInfo->setDepthStencilState(mPipelineInfo->depthStencilState());
+	mCompressedPipelineInfo->setVertexShaderState(mCompressedVertShader);
+	mCompressedPipelineInfo->setPixelShaderState(mFragShader);
+	mCompressedPipelineInfo->setRenderPass(mRenderPass);
+
+	mCompressedPipelineInfo->updateState();
 }
 
 auto LRTR::PointShadowMapWorkflow::work(const WorkflowStartup<PointShadowMapInput>& startup) -> PointShadowMapOutput
 {
-	assert(startup.InputData.ShadowMap->width() == startup.InputData.ShadowMap->height());
-
+	mFrame++;
+	
 	fitDescriptorHeap(startup.InputData.Areas.size());
 
 	const auto meshDataAssetComponent = std::static_pointer_cast<MeshDataAssetComponent>(
 		startup.InputData.Sharing->assetManager()->components().at("MeshData"));
 
 	const auto commandList = startup.InputData.CommandList;
+	const auto quadProperty = meshDataAssetComponent->get("Quad");
 
-	const CodeRed::ViewPort viewPort = {
-		0, 0,
-		static_cast<float>(startup.InputData.ShadowMap->width()),
-		static_cast<float>(startup.InputData.ShadowMap->height()), 0.f, 1.f
-	};
+	commandList->setResourceLayout(mResourceLayout);
 
-	const CodeRed::ScissorRect scissorRect = {
-		0, 0,
-		startup.InputData.ShadowMap->width(),
-		startup.InputData.ShadowMap->height()
-	};
+	PointShadowMapOutput output;
 
-	commandList->setGraphicsPipeline(mPipelineInfo->graphicsPipeline());
-	commandList->setResourceLayout(mResourceLayout);
+	//the faces rendered with other settings may miss the meshlets we do not cull now, so we render them again
+	if (mClusterCulled != startup.InputData.IsClusterCulled || mConeCulled != startup.InputData.IsConeCulled) {
+		for (auto& areaCache : mAreaCaches)
+			for (auto& faceCache : areaCache.second.Faces) faceCache.IsValid = false;
 
-	commandList->setVertexBuffers({ meshDataAssetComponent->positions() });
-	commandList->setIndexBuffer(meshDataAssetComponent->indices());
+		mClusterCulled = startup.InputData.IsClusterCulled;
+		mConeCulled = startup.InputData.IsConeCulled;
+	}
+
+	//the casters of current face and their index of infos, we reuse them to avoid allocating
+	std::vector<PointShadowCaster> casters;
+	std::vector<size_t> infos;
+
+	//we only begin the render pass when there are faces need to render
+	auto renderPassBegan = false;
 	
 	for (size_t light = 0; light < startup.InputData.Areas.size(); light++) {
 		const auto &area = startup.InputData.Areas[light];
 		const auto views = generateViewMatrix(area);
 
-		CodeRed::ResourceHelper::updateBuffer(mViewBuffers[light], views.data(), sizeof(Matrix4x4f) * 8);
+		//the cache is created when the slot is allocated, so all faces of new slot are rendered
+		auto& areaCache = mAreaCaches[area.Slot.Identifier];
 
-		mDescriptorHeaps[light]->bindBuffer(mViewBuffers[light], 0);
-		mDescriptorHeaps[light]->bindBuffer(startup.InputData.Transform, 1);
+		areaCache.LastUsed = mFrame;
+		
+		//if the light is moved, all faces of it need to be rendered again
+		if (areaCache.Position != area.Position || areaCache.Radius != area.Radius) {
+			for (auto& faceCache : areaCache.Faces) faceCache.IsValid = false;
 
-		commandList->setDescriptorHeap(mDescriptorHeaps[light]);
+			areaCache.Position = area.Position;
+			areaCache.Radius = area.Radius;
+		}
 
+		auto heapBound = false;
+		
 		for (size_t face = 0; face < 6; face++) {
-			commandList->beginRenderPass(mRenderPass, area.FrameBuffers[face]);
+			const auto frustum = FrustumF(views[face]);
 
+			casters.clear();
+			infos.clear();
+			
+			for (size_t index = 0; index < startup.InputData.Infos.size(); index++) {
+				const auto& info = startup.InputData.Infos[index];
+
+				//the caster outside the range of light or the frustum of face does not cast shadow into this face
+				if (!info.Bound.overlap(area.Position, area.Radius) || !frustum.intersect(info.Bound)) continue;
+
+				casters.push_back({ info.Mesh.get(), info.Index, info.Version });
+				infos.push_back(index);
+			}
+
+			auto& faceCache = areaCache.Faces[face];
+
+			output.SkippedDraws = output.SkippedDraws + startup.InputData.Infos.size() - casters.size();
+
+			//the face is not changed if the casters in it are not moved, so the shadow map is still right
+			if (faceCache.IsValid && faceCache.Casters == casters) {
+				output.SkippedFaces = output.SkippedFaces + 1;
+				output.SkippedDraws = output.SkippedDraws + casters.size();
+
+				continue;
+			}
+
+			if (!renderPassBegan) {
+				commandList->beginRenderPass(mRenderPass, startup.InputData.ShadowAtlas);
+
+				renderPassBegan = true;
+			}
+			
+			//we only update the view buffer when we need render the faces of light
+			if (!heapBound) {
+				CodeRed::ResourceHelper::updateBuffer(mViewBuffers[light], views.data(), sizeof(Matrix4x4f) * 8);
+
+				mDescriptorHeaps[light]->bindBuffer(mViewBuffers[light], 0);
+				mDescriptorHeaps[light]->bindBuffer(startup.InputData.Transform, 1);
+
+				commandList->setDescriptorHeap(mDescriptorHeaps[light]);
+
+				heapBound = true;
+			}
+
+			const auto& tile = area.Slot.Tiles[face];
+			const auto resolution = area.Slot.Resolution;
+			
+			const CodeRed::ViewPort viewPort = {
+				static_cast<float>(tile.X), static_cast<float>(tile.Y),
+				static_cast<float>(resolution), static_cast<float>(resolution), 0.f, 1.f
+			};
+
+			const CodeRed::ScissorRect scissorRect = {
+				tile.X, tile.Y,
+				tile.X + resolution,
+				tile.Y + resolution
+			};
+			
 			commandList->setViewPort(viewPort);
 			commandList->setScissorRect(scissorRect);
+
+			//the other tiles of atlas are used by other lights, so we clear the tile with a quad
+			commandList->setGraphicsPipeline(mClearPipelineInfo->graphicsPipeline());
+			commandList->setVertexBuffers({ meshDataAssetComponent->positions() });
+			commandList->setIndexBuffer(meshDataAssetComponent->indices());
+
+			commandList->setConstant32Bits({
+				static_cast<unsigned>(ClearFace), 0u,
+				area.Radius,
+				area.Position.x, area.Position.y, area.Position.z
+			});
+
+			commandList->drawIndexed(quadProperty.IndexCount, 1,
+				quadProperty.StartIndexLocation, quadProperty.StartVertexLocation);
+
+			//the quad is in the first page of full format, so the casters in it do not need to rebind the buffers
+			auto vertexBuffer = meshDataAssetComponent->positions();
+			auto indexBuffer = meshDataAssetComponent->indices();
+			auto format = MeshDataFormat::Full;
+
+			commandList->setGraphicsPipeline(mPipelineInfo->graphicsPipeline());
+
+			//the meshlets are culled with the frustum of face and back facing from light
+			//the casters are not occluded by others in shadow map, so we do not use occlusion culling
+			mClusterCuller.begin(views[face], area.Position, startup.InputData.IsConeCulled);
 			
-			for (size_t index = 0; index < startup.InputData.Infos.size(); index++) {
-				const auto drawProperty = meshDataAssetComponent->get(startup.InputData.Infos[index].Mesh);
+			for (const auto index : infos) {
+				const auto& info = startup.InputData.Infos[index];
+				const auto drawProperty = meshDataAssetComponent->get(info.Mesh);
+				const auto& quantization = drawProperty.Quantization;
+
+				mRanges.clear();
+
+				//the caster without meshlets is drawn as a whole, the caster with all meshlets culled is not drawn
+				if (startup.InputData.IsClusterCulled && info.Mesh->meshlets().size() > 1 &&
+					mClusterCuller.cull(info.Mesh->meshlets(), info.Transform, mRanges) == 0) continue;
+
+				if (drawProperty.Format != format) {
+					format = drawProperty.Format;
+
+					commandList->setGraphicsPipeline(format == MeshDataFormat::Compressed ?
+						mCompressedPipelineInfo->graphicsPipeline() :
+						mPipelineInfo->graphicsPipeline());
+				}
+
+				if (meshDataAssetComponent->positions(drawProperty) != vertexBuffer) {
+					vertexBuffer = meshDataAssetComponent->positions(drawProperty);
+
+					commandList->setVertexBuffers({ vertexBuffer });
+				}
+
+				if (meshDataAssetComponent->indices(drawProperty) != indexBuffer) {
+					indexBuffer = meshDataAssetComponent->indices(drawProperty);
+
+					commandList->setIndexBuffer(indexBuffer);
+				}
 
 				commandList->setConstant32Bits({
 					static_cast<unsigned>(face),
-					static_cast<unsigned>(startup.InputData.Infos[index].Index),
+					static_cast<unsigned>(info.Index),
 					area.Radius,
-					area.Position.x, area.Position.y, area.Position.z
+					area.Position.x, area.Position.y, area.Position.z,
+					quantization.Offset.x, quantization.Offset.y, quantization.Offset.z,
+					quantization.Scale.x, quantization.Scale.y, quantization.Scale.z
 				});
 
-				commandList->drawIndexed(drawProperty.IndexCount, 1,
-					drawProperty.StartIndexLocation, drawProperty.StartVertexLocation);
+				if (mRanges.empty()) {
+					commandList->drawIndexed(drawProperty.IndexCount, 1,
+						drawProperty.StartIndexLocation, drawProperty.StartVertexLocation);
+				}
+
+				for (const auto& range : mRanges) {
+					commandList->drawIndexed(range.Count, 1,
+						drawProperty.StartIndexLocation + range.Offset, drawProperty.StartVertexLocation);
+				}
 			}
 
-			commandList->endRenderPass();
+			output.Clusters = output.Clusters + mClusterCuller.clusters();
+			output.CulledClusters = output.CulledClusters + mClusterCuller.frustumCulled() + mClusterCuller.backFacing();
+
+			faceCache.Casters = casters;
+			faceCache.IsValid = true;
+
+			output.Faces = output.Faces + 1;
+			output.Draws = output.Draws + casters.size();
 		}
 	}
+
+	if (renderPassBegan) commandList->endRenderPass();
+
+	releaseAreaCaches();
 	
-	return { };
+	return output;
 }
 
 void LRTR::PointShadowMapWorkflow::fitDescriptorHeap(const size_t target)
@@ -192,3 +402,11 @@ void LRTR::PointShadowMapWorkflow::fitDescriptorHeap(const size_t target)
 	for (size_t index = mDescriptorHeaps.size(); index < target; index++)
 		mDescriptorHeaps.push_back(mDevice->createDescriptorHeap(mResourceLayout));
 }
+
+void LRTR::PointShadowMapWorkflow::releaseAreaCaches()
+{
+	for (auto it = mAreaCaches.begin(); it != mAreaCaches.end();) {
+		if (it->second.LastUsed != mFrame) it = mAreaCaches.erase(it);
+		else ++it;
+	}
+}
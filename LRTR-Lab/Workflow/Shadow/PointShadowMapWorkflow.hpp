@@ -2,45 +2,69 @@
 
 #include "../../Scenes/Components/MeshData/TrianglesMesh.hpp"
 
+#include "../../Shared/Allocators/ShadowAtlasAllocator.hpp"
+#include "../../Shared/Accelerators/ClusterCuller.hpp"
 #include "../../Shared/Graphics/PipelineInfo.hpp"
 #include "../../Runtimes/RuntimeSharing.hpp"
 #include "../../Shared/Math/Math.hpp"
+#include "../../Shared/Bound.hpp"
 #include "../Workflow.hpp"
 
+#include <unordered_map>
 #include <memory>
 
 namespace LRTR {
 
+	//the bound is in world space, we use it to cull the caster for each face of shadow map
+	//the version is the version of transform, the caster is moved if it is changed
+	//the transform is the world matrix of caster, we use it to cull the meshlets of caster
 	struct ShadowCastInfo {
-		std::shared_ptr<TrianglesMesh> Mesh;
+		std::shared_ptr<const TrianglesMesh> Mesh;
 		size_t Index = 0;
 
+		Bound3f Bound;
+		size_t Version = 0;
+
+		Matrix4x4f Transform = Matrix4x4f(1);
+		
 		ShadowCastInfo() = default;
 
 		ShadowCastInfo(
-			const std::shared_ptr<TrianglesMesh>& mesh,
+			const std::shared_ptr<const TrianglesMesh>& mesh,
 			const size_t& index) : Mesh(mesh), Index(index) {}
-	};
 
-	using PointShadowFrameBuffer = std::array<std::shared_ptr<CodeRed::GpuFrameBuffer>, 6>;
+		ShadowCastInfo(
+			const std::shared_ptr<const TrianglesMesh>& mesh,
+			const size_t& index,
+			const Bound3f& bound,
+			const size_t version) : Mesh(mesh), Index(index), Bound(bound), Version(version) {}
+
+		ShadowCastInfo(
+			const std::shared_ptr<const TrianglesMesh>& mesh,
+			const size_t& index,
+			const Bound3f& bound,
+			const size_t version,
+			const Matrix4x4f& transform) : Mesh(mesh), Index(index), Bound(bound), Version(version), Transform(transform) {}
+	};
 
+	//the faces of point shadow are rendered into the tiles of shadow atlas
 	struct PointShadowArea {
-		std::array<std::shared_ptr<CodeRed::GpuFrameBuffer>, 6> FrameBuffers;
+		ShadowAtlasSlot Slot;
 		Vector3f Position = Vector3f(0);
 		float Radius = 100;
 
 		PointShadowArea() = default;
 
 		PointShadowArea(
-			const std::array<std::shared_ptr<CodeRed::GpuFrameBuffer>, 6>& frameBuffers,
+			const ShadowAtlasSlot& slot,
 			const Vector3f& position,
 			const float radius = 100) :
-			FrameBuffers(frameBuffers), Position(position), Radius(radius) {}
+			Slot(slot), Position(position), Radius(radius) {}
 	};
 	
 	struct PointShadowMapInput {
 		std::shared_ptr<CodeRed::GpuGraphicsCommandList> CommandList;
-		std::shared_ptr<CodeRed::GpuTexture> ShadowMap;
+		std::shared_ptr<CodeRed::GpuFrameBuffer> ShadowAtlas;
 		std::shared_ptr<CodeRed::GpuBuffer> Transform;
 		
 		std::shared_ptr<RuntimeSharing> Sharing;
@@ -48,22 +72,69 @@ namespace LRTR {
 		std::vector<PointShadowArea> Areas;
 		std::vector<ShadowCastInfo> Infos;
 
+		//the meshlets of casters are culled with the frustum of face and the normal cone from light
+		bool IsClusterCulled = false;
+		bool IsConeCulled = false;
+
 		PointShadowMapInput() = default;
 
 		PointShadowMapInput(
 			const std::shared_ptr<CodeRed::GpuGraphicsCommandList>& commandList,
-			const std::shared_ptr<CodeRed::GpuTexture>& shadowMap,
+			const std::shared_ptr<CodeRed::GpuFrameBuffer>& shadowAtlas,
 			const std::shared_ptr<CodeRed::GpuBuffer>& transform,
 			const std::shared_ptr<RuntimeSharing>& sharing,
 			const std::vector<PointShadowArea>& area,
-			const std::vector<ShadowCastInfo>& info) :
-			CommandList(commandList), ShadowMap(shadowMap), Transform(transform), Sharing(sharing), Areas(area), Infos(info) {}
+			const std::vector<ShadowCastInfo>& info,
+			const bool clusterCulled = false,
+			const bool coneCulled = false) :
+			CommandList(commandList), ShadowAtlas(shadowAtlas), Transform(transform), Sharing(sharing), Areas(area), Infos(info),
+			IsClusterCulled(clusterCulled), IsConeCulled(coneCulled) {}
 	};
 
+	//the faces and draws we skipped are the ones we do not render in this frame
+	//the face is skipped if it is not changed, the draw is skipped if the caster is culled or the face is skipped
 	struct PointShadowMapOutput {
+		size_t Faces = 0;
+		size_t SkippedFaces = 0;
+		size_t Draws = 0;
+		size_t SkippedDraws = 0;
+
+		//the meshlets of casters in the faces we rendered and the ones we culled
+		size_t Clusters = 0;
+		size_t CulledClusters = 0;
+		
 		PointShadowMapOutput() = default;
 	};
 
+	//the caster was rendered into a face, the version is unique in all objects
+	//so the caster is moved or replaced if any of them is changed
+	struct PointShadowCaster {
+		const TrianglesMesh* Mesh = nullptr;
+		size_t Index = 0;
+		size_t Version = 0;
+
+		bool operator==(const PointShadowCaster& other) const noexcept
+		{
+			return Mesh == other.Mesh && Index == other.Index && Version == other.Version;
+		}
+
+		bool operator!=(const PointShadowCaster& other) const noexcept { return !(*this == other); }
+	};
+
+	//the casters were rendered into the face in last time, we compare them to find whether the face is changed
+	struct PointShadowFaceCache {
+		std::vector<PointShadowCaster> Casters;
+		bool IsValid = false;
+	};
+
+	struct PointShadowAreaCache {
+		std::array<PointShadowFaceCache, 6> Faces;
+		Vector3f Position = Vector3f(0);
+		float Radius = 0;
+
+		//the frame we used the cache last time, the caches of slots not used in this frame are removed
+		size_t LastUsed = 0;
+	};
 
 	class PointShadowMapWorkflow : public Workflow<PointShadowMapInput, PointShadowMapOutput, false> {
 	public:
@@ -74,19 +145,43 @@ namespace LRTR {
 		auto work(const WorkflowStartup<PointShadowMapInput>& startup) -> PointShadowMapOutput override;
 	private:
 		void fitDescriptorHeap(const size_t target);
+
+		//remove the caches of slots that are not used in this frame, the slots may be evicted or reallocated
+		void releaseAreaCaches();
 	private:
 		std::shared_ptr<CodeRed::GpuLogicalDevice> mDevice;
 
 		std::shared_ptr<CodeRed::GpuRenderPass> mRenderPass;
 
+		//the pipeline used to clear the tile of face, it writes the max depth without depth test
+		//because the atlas is shared by all lights, so we can not clear it in render pass
+		std::shared_ptr<CodeRed::PipelineInfo> mClearPipelineInfo;
+
+		//the pipeline used to render the casters in compressed format, it decodes the quantized positions
+		std::shared_ptr<CodeRed::PipelineInfo> mCompressedPipelineInfo;
+
 		std::shared_ptr<CodeRed::GpuShaderState> mVertShader;
 		std::shared_ptr<CodeRed::GpuShaderState> mFragShader;
+		std::shared_ptr<CodeRed::GpuShaderState> mCompressedVertShader;
 
 		std::shared_ptr<CodeRed::GpuResourceLayout> mResourceLayout;
 		std::shared_ptr<CodeRed::PipelineInfo> mPipelineInfo;
 
 		std::vector<std::shared_ptr<CodeRed::GpuDescriptorHeap>> mDescriptorHeaps;
 		std::vector<std::shared_ptr<CodeRed::GpuBuffer>> mViewBuffers;
+
+		//the caches of slots, the key is the identifier of slot
+		std::unordered_map<size_t, PointShadowAreaCache> mAreaCaches;
+
+		//the culler of meshlets and the ranges of current caster, we reuse them to avoid allocating
+		ClusterCuller mClusterCuller;
+		std::vector<IndexRange> mRanges;
+
+		//the faces rendered with other settings of cluster culling are not valid
+		bool mClusterCulled = false;
+		bool mConeCulled = false;
+
+		size_t mFrame = 0;
 	};
 
 }
\ No newline at end of file